@@ -0,0 +1,546 @@
+/************************************************************
+*
+* @file:      ahrs_bench.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     The fixed point AHRS against a double precision
+*             Madgwick filter on the same samples: attitude
+*             error and cost of the split update
+*
+*             Build and run from the repository root:
+*
+*               gcc -std=gnu99 -O2 -Ihost -Iinc -o ahrs_bench \
+*                   host/ahrs_bench.c src/ahrs.c src/fastmath.c \
+*                   src/tables.c -lm
+*               ./ahrs_bench [-m] [run.csv]
+*
+*             run.csv is a recording decoded by
+*             tools/telemetry_decode.py with "--mask imu", all six
+*             accel and gyro channels; telemetry carries no
+*             compass, so a recording is fused without it. With
+*             no file a synthetic run is made instead: AHRS_BENCH_
+*             SECONDS of smooth random turning on all three axes,
+*             gyro and accel at the MPU9250 scales with noise and,
+*             with -m, the compass at AHRS_BENCH_MAG_DIVIDER
+*             samples a reading. Its true attitude is kept, so
+*             both filters are also scored against the truth.
+*
+*             The reference runs the same schedule as balance.c,
+*             propagate every sample and correct every
+*             AHRS_CORRECTION_DIVIDER, at the same beta, in
+*             double: the gyro step renormalized exactly and the
+*             gradient of the Madgwick objective taken by central
+*             differences, not from the Jacobian ahrs.c uses, so
+*             a slip there shows. Angles are wrapped differences
+*             of the Euler angles over the run after the first
+*             AHRS_BENCH_SETTLE_SECONDS.
+*
+*             Cost is host nanoseconds per ahrsPropagate and
+*             ahrsCorrect, and per tick for the split schedule
+*             against correcting on every tick; on target the
+*             balance.c AHRS profile the shell prof command
+*             prints is the figure for the M0. Exit status is 1
+*             if roll or pitch part from the reference by more
+*             than AHRS_BENCH_BOUND_TILT, or yaw by more than
+*             AHRS_BENCH_BOUND_YAW.
+*
+************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "ahrs.h"
+#include "fastmath.h"
+
+#define AHRS_BENCH_SECONDS          300
+#define AHRS_BENCH_MAX_SAMPLES      (3600 * AHRS_SAMPLE_RATE_HZ)
+#define AHRS_BENCH_SETTLE_SECONDS   5
+#define AHRS_BENCH_LINE_SIZE        512
+#define AHRS_BENCH_GYRO_LSB         65.5        // per deg/s
+#define AHRS_BENCH_GYRO_NOISE       0.1         // deg/s RMS
+#define AHRS_BENCH_ACCEL_NOISE      0.01        // g RMS
+#define AHRS_BENCH_MAG_LSB          333.0       // ~50 uT at 0.15 uT per LSB
+#define AHRS_BENCH_MAG_NOISE        0.01        // of the field, RMS
+#define AHRS_BENCH_MAG_DIVIDER      10          // AK8963 at 100 Hz
+#define AHRS_BENCH_MAG_DIP          60.0        // deg, field below the horizon
+// Largest fixed point error against the reference, deg
+#define AHRS_BENCH_BOUND_TILT       0.1
+#define AHRS_BENCH_BOUND_YAW        0.1
+#define AHRS_BENCH_TIMED_PASSES     4
+
+typedef struct {
+	double worst[AHRS_ANGLE_COUNT];
+	double squares[AHRS_ANGLE_COUNT];
+	uint32_t count;
+} angleError_t;
+
+static const char *angleNames[AHRS_ANGLE_COUNT] = { "roll", "pitch", "yaw" };
+static const char *const imuColumns[IMU_AXIS_COUNT] = {
+	"accel_x", "accel_y", "accel_z", "gyro_x", "gyro_y", "gyro_z"
+};
+
+static imuSample_t *samples;
+static double (*truth)[AHRS_QUATERNION_SIZE];
+static uint32_t sampleCount = 0;
+static int failures = 0;
+
+static void check(int ok, const char *what) {
+	printf("  %-4s %s\n", ok ? "ok" : "FAIL", what);
+	if (!ok) {
+		failures++;
+	}
+}
+
+static double gaussian(void) {
+	double u = (rand() + 1.0) / (RAND_MAX + 2.0);
+	double v = (rand() + 1.0) / (RAND_MAX + 2.0);
+
+	return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+static int16_t toLsb(double value) {
+	value = floor(value + 0.5);
+	return (int16_t) (value > 32767.0 ? 32767.0 : (value < -32768.0 ? -32768.0 : value));
+}
+
+static void normalize(double *v, uint8_t count) {
+	double sum = 0.0;
+	uint8_t i;
+
+	for (i = 0; i < count; i++) {
+		sum += v[i] * v[i];
+	}
+	sum = sqrt(sum);
+	for (i = 0; i < count && sum > 0.0; i++) {
+		v[i] /= sum;
+	}
+}
+
+// v in the sensor frame of an earth frame vector, R(q)^T e
+static void toSensor(const double *q, const double *e, double *v) {
+	double w = q[AHRS_W], x = q[AHRS_X], y = q[AHRS_Y], z = q[AHRS_Z];
+
+	v[0] = (1 - 2 * (y * y + z * z)) * e[0] + 2 * (x * y + w * z) * e[1] + 2 * (x * z - w * y) * e[2];
+	v[1] = 2 * (x * y - w * z) * e[0] + (1 - 2 * (x * x + z * z)) * e[1] + 2 * (y * z + w * x) * e[2];
+	v[2] = 2 * (x * z + w * y) * e[0] + 2 * (y * z - w * x) * e[1] + (1 - 2 * (x * x + y * y)) * e[2];
+}
+
+// R(q) v, sensor to earth
+static void toEarth(const double *q, const double *v, double *e) {
+	double w = q[AHRS_W], x = q[AHRS_X], y = q[AHRS_Y], z = q[AHRS_Z];
+
+	e[0] = (1 - 2 * (y * y + z * z)) * v[0] + 2 * (x * y - w * z) * v[1] + 2 * (x * z + w * y) * v[2];
+	e[1] = 2 * (x * y + w * z) * v[0] + (1 - 2 * (x * x + z * z)) * v[1] + 2 * (y * z - w * x) * v[2];
+	e[2] = 2 * (x * z - w * y) * v[0] + 2 * (y * z + w * x) * v[1] + (1 - 2 * (x * x + y * y)) * v[2];
+}
+
+// q' = q + q x (0, h), h the half angle turned
+static void rotate(double *q, const double *h) {
+	double w = q[AHRS_W], x = q[AHRS_X], y = q[AHRS_Y], z = q[AHRS_Z];
+
+	q[AHRS_W] = w - x * h[0] - y * h[1] - z * h[2];
+	q[AHRS_X] = x + w * h[0] + y * h[2] - z * h[1];
+	q[AHRS_Y] = y + w * h[1] - x * h[2] + z * h[0];
+	q[AHRS_Z] = z + w * h[2] + x * h[1] - y * h[0];
+	normalize(q, AHRS_QUATERNION_SIZE);
+}
+
+static void toEuler(const double *q, double *angles) {
+	double w = q[AHRS_W], x = q[AHRS_X], y = q[AHRS_Y], z = q[AHRS_Z];
+	double sine = 2 * (w * y - z * x);
+
+	angles[AHRS_ROLL] = atan2(2 * (w * x + y * z), 1 - 2 * (x * x + y * y)) * 180.0 / M_PI;
+	angles[AHRS_PITCH] = asin(sine > 1.0 ? 1.0 : (sine < -1.0 ? -1.0 : sine)) * 180.0 / M_PI;
+	angles[AHRS_YAW] = atan2(2 * (w * z + x * y), 1 - 2 * (y * y + z * z)) * 180.0 / M_PI;
+}
+
+/************************************************************
+*
+* Function: makeRun
+* @brief:   synthetic samples and their true attitude
+*
+************************************************************/
+static void makeRun(uint8_t useMag) {
+	const double gravity[3] = { 0.0, 0.0, 1.0 };
+	double field[3] = {
+		cos(AHRS_BENCH_MAG_DIP * M_PI / 180.0), 0.0, -sin(AHRS_BENCH_MAG_DIP * M_PI / 180.0)
+	};
+	double q[AHRS_QUATERNION_SIZE] = { 1.0, 0.0, 0.0, 0.0 };
+	double dt = 1.0 / AHRS_SAMPLE_RATE_HZ;
+	double rate[3];
+	double half[3];
+	double v[3];
+	double t;
+	uint32_t n;
+	uint8_t i;
+
+	srand(11);
+	sampleCount = AHRS_BENCH_SECONDS * AHRS_SAMPLE_RATE_HZ;
+	for (n = 0; n < sampleCount; n++) {
+		t = n * dt;
+		// deg/s: sway in roll and pitch, turns in yaw
+		rate[0] = 40.0 * sin(2.0 * M_PI * 0.31 * t) + 15.0 * sin(2.0 * M_PI * 1.7 * t);
+		rate[1] = 35.0 * sin(2.0 * M_PI * 0.23 * t + 1.0) + 10.0 * sin(2.0 * M_PI * 2.3 * t);
+		rate[2] = 60.0 * sin(2.0 * M_PI * 0.05 * t) + 20.0 * sin(2.0 * M_PI * 0.9 * t);
+		// Level out now and then, so the tilt does not wander off
+		for (i = 0; i < 2; i++) {
+			rate[i] -= 0.5 * (i == 0 ? atan2(2 * (q[0] * q[1] + q[2] * q[3]),
+					1 - 2 * (q[1] * q[1] + q[2] * q[2])) : asin(2 * (q[0] * q[2]
+					- q[3] * q[1]))) * 180.0 / M_PI;
+		}
+		for (i = 0; i < 3; i++) {
+			samples[n].axis[IMU_GYRO_X + i] = toLsb((rate[i] + AHRS_BENCH_GYRO_NOISE * gaussian())
+					* AHRS_BENCH_GYRO_LSB);
+		}
+		toSensor(q, gravity, v);
+		for (i = 0; i < 3; i++) {
+			samples[n].axis[IMU_ACCEL_X + i] = toLsb((v[i] + AHRS_BENCH_ACCEL_NOISE * gaussian())
+					* ACCEL_LSB_PER_G);
+		}
+		toSensor(q, field, v);
+		for (i = 0; i < 3; i++) {
+			samples[n].mag[i] = toLsb((v[i] + AHRS_BENCH_MAG_NOISE * gaussian())
+					* AHRS_BENCH_MAG_LSB);
+		}
+		samples[n].temperature = 0;
+		samples[n].magValid = useMag && (n % AHRS_BENCH_MAG_DIVIDER) == 0;
+		// The truth is the attitude the sample was taken at
+		memcpy(truth[n], q, sizeof(q));
+		for (i = 0; i < 3; i++) {
+			half[i] = 0.5 * rate[i] * M_PI / 180.0 * dt;
+		}
+		rotate(q, half);
+	}
+}
+
+/************************************************************
+*
+* Function: loadRun
+* @brief:   read the six IMU channels of a decoded recording;
+*           ticks the decoder left empty are skipped
+* @return:  int, 0 on success
+*
+************************************************************/
+static int loadRun(const char *path) {
+	char line[AHRS_BENCH_LINE_SIZE];
+	int column[IMU_AXIS_COUNT];
+	int16_t values[IMU_AXIS_COUNT];
+	FILE *file = fopen(path, "r");
+	char *cursor;
+	char *end;
+	char *name;
+	int index;
+	int found = 0;
+	uint8_t i;
+
+	if (file == 0 || fgets(line, sizeof(line), file) == 0) {
+		fprintf(stderr, "cannot read %s\n", path);
+		return -1;
+	}
+	for (i = 0; i < IMU_AXIS_COUNT; i++) {
+		column[i] = -1;
+	}
+	index = 0;
+	for (name = strtok(line, ",\r\n"); name != 0; name = strtok(0, ",\r\n"), index++) {
+		for (i = 0; i < IMU_AXIS_COUNT; i++) {
+			if (strcmp(name, imuColumns[i]) == 0) {
+				column[i] = index;
+				found++;
+			}
+		}
+	}
+	if (found != IMU_AXIS_COUNT) {
+		fprintf(stderr, "%s lacks IMU channels, record with --mask imu\n", path);
+		fclose(file);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), file) != 0 && sampleCount < AHRS_BENCH_MAX_SAMPLES) {
+		found = 0;
+		cursor = line;
+		for (index = 0; cursor != 0; index++) {
+			for (i = 0; i < IMU_AXIS_COUNT; i++) {
+				if (column[i] == index) {
+					values[i] = (int16_t) strtol(cursor, &end, 10);
+					found += end != cursor;
+				}
+			}
+			cursor = strchr(cursor, ',');
+			cursor = cursor != 0 ? cursor + 1 : 0;
+		}
+		if (found == IMU_AXIS_COUNT) {
+			memset(&samples[sampleCount], 0, sizeof(imuSample_t));
+			memcpy(samples[sampleCount].axis, values, sizeof(values));
+			sampleCount++;
+		}
+	}
+	fclose(file);
+	return sampleCount > 0 ? 0 : -1;
+}
+
+/************************************************************
+*
+* Function: referenceCorrect
+* @brief:   one Madgwick gradient step in double, the gradient
+*           of |R^T g - a|^2 + |R^T b - m|^2 by central
+*           differences
+*
+************************************************************/
+static void referenceCorrect(double *q, const int16_t *accel, const int16_t *mag,
+		uint8_t useMag, double beta) {
+	const double gravity[3] = { 0.0, 0.0, 1.0 };
+	double a[3];
+	double m[3];
+	double b[3];
+	double h[3];
+	double probe[AHRS_QUATERNION_SIZE];
+	double v[3];
+	double gradient[AHRS_QUATERNION_SIZE];
+	double cost[2];
+	double step = 1e-7;
+	int8_t sign;
+	uint8_t i;
+	uint8_t j;
+
+	for (i = 0; i < 3; i++) {
+		a[i] = accel[i];
+	}
+	normalize(a, 3);
+	if (a[0] == 0.0 && a[1] == 0.0 && a[2] == 0.0) {
+		return;
+	}
+	if (useMag) {
+		for (i = 0; i < 3; i++) {
+			m[i] = mag[i];
+		}
+		normalize(m, 3);
+		// Reference field: horizontal part north, vertical kept
+		toEarth(q, m, h);
+		b[0] = sqrt(h[0] * h[0] + h[1] * h[1]);
+		b[1] = 0.0;
+		b[2] = h[2];
+	}
+	for (i = 0; i < AHRS_QUATERNION_SIZE; i++) {
+		for (sign = 0; sign < 2; sign++) {
+			memcpy(probe, q, sizeof(probe));
+			probe[i] += sign ? -step : step;
+			cost[sign] = 0.0;
+			toSensor(probe, gravity, v);
+			for (j = 0; j < 3; j++) {
+				cost[sign] += (v[j] - a[j]) * (v[j] - a[j]);
+			}
+			if (useMag) {
+				toSensor(probe, b, v);
+				for (j = 0; j < 3; j++) {
+					cost[sign] += (v[j] - m[j]) * (v[j] - m[j]);
+				}
+			}
+		}
+		gradient[i] = (cost[0] - cost[1]) / (2.0 * step);
+	}
+	normalize(gradient, AHRS_QUATERNION_SIZE);
+	for (i = 0; i < AHRS_QUATERNION_SIZE; i++) {
+		q[i] -= beta * gradient[i];
+	}
+}
+
+static void addError(angleError_t *error, const double *estimate, const double *reference) {
+	double difference;
+	uint8_t i;
+
+	for (i = 0; i < AHRS_ANGLE_COUNT; i++) {
+		difference = fabs(remainder(estimate[i] - reference[i], 360.0));
+		error->worst[i] = fmax(error->worst[i], difference);
+		error->squares[i] += difference * difference;
+	}
+	error->count++;
+}
+
+static void printError(const char *name, const angleError_t *error) {
+	uint8_t i;
+
+	printf("  %-22s", name);
+	for (i = 0; i < AHRS_ANGLE_COUNT; i++) {
+		printf(" %8.4f %8.4f", error->worst[i],
+				error->count ? sqrt(error->squares[i] / error->count) : 0.0);
+	}
+	printf("\n");
+}
+
+/************************************************************
+*
+* Function: compare
+* @brief:   both filters over the run, angle errors against
+*           each other and, if known, the truth
+*
+************************************************************/
+static void compare(uint8_t useMag, uint8_t haveTruth, angleError_t *apart,
+		angleError_t *fixedTruth, angleError_t *floatTruth) {
+	const int16_t *mag = 0;
+	double q[AHRS_QUATERNION_SIZE] = { 1.0, 0.0, 0.0, 0.0 };
+	double half[3];
+	double fixedAngles[AHRS_ANGLE_COUNT];
+	double floatAngles[AHRS_ANGLE_COUNT];
+	double trueAngles[AHRS_ANGLE_COUNT];
+	int32_t angles[AHRS_ANGLE_COUNT];
+	ahrs_t ahrs;
+	uint8_t phase = 0;
+	uint32_t n;
+	uint8_t i;
+
+	ahrsInit(&ahrs, AHRS_BETA_DEFAULT, useMag);
+	for (n = 0; n < sampleCount; n++) {
+		ahrsPropagate(&ahrs, &samples[n]);
+		for (i = 0; i < 3; i++) {
+			half[i] = 0.5 * samples[n].axis[IMU_GYRO_X + i] / AHRS_BENCH_GYRO_LSB
+					* M_PI / 180.0 / AHRS_SAMPLE_RATE_HZ;
+		}
+		rotate(q, half);
+		if (samples[n].magValid) {
+			mag = samples[n].mag;
+		}
+		if (++phase >= AHRS_CORRECTION_DIVIDER) {
+			phase = 0;
+			ahrsCorrect(&ahrs);
+			referenceCorrect(q, &samples[n].axis[IMU_ACCEL_X], mag, useMag && mag != 0,
+					(double) ahrs.beta / (1 << 30));
+			mag = 0;
+		}
+		if (n < AHRS_BENCH_SETTLE_SECONDS * AHRS_SAMPLE_RATE_HZ) {
+			continue;
+		}
+		ahrsGetEuler(ahrs.q, angles);
+		for (i = 0; i < AHRS_ANGLE_COUNT; i++) {
+			fixedAngles[i] = angles[i] / (double) ANGLE_PER_DEG;
+		}
+		toEuler(q, floatAngles);
+		addError(apart, fixedAngles, floatAngles);
+		if (haveTruth) {
+			toEuler(truth[n], trueAngles);
+			addError(fixedTruth, fixedAngles, trueAngles);
+			addError(floatTruth, floatAngles, trueAngles);
+		}
+	}
+}
+
+static double elapsed(const struct timespec *start, const struct timespec *end, uint32_t calls) {
+	return ((end->tv_sec - start->tv_sec) * 1e9 + (end->tv_nsec - start->tv_nsec)) / calls;
+}
+
+/************************************************************
+*
+* Function: timeUpdates
+* @brief:   host ns per ahrsPropagate and per ahrsCorrect over
+*           the run
+*
+************************************************************/
+static void timeUpdates(uint8_t useMag, double *propagateNs, double *correctNs) {
+	struct timespec start;
+	struct timespec end;
+	ahrs_t ahrs;
+	uint32_t pass;
+	uint32_t n;
+
+	ahrsInit(&ahrs, AHRS_BETA_DEFAULT, useMag);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (pass = 0; pass < AHRS_BENCH_TIMED_PASSES; pass++) {
+		for (n = 0; n < sampleCount; n++) {
+			ahrsPropagate(&ahrs, &samples[n]);
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	*propagateNs = elapsed(&start, &end, AHRS_BENCH_TIMED_PASSES * sampleCount);
+
+	// Every sample corrected in turn, as the pre split filter did
+	ahrsInit(&ahrs, AHRS_BETA_DEFAULT, useMag);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (pass = 0; pass < AHRS_BENCH_TIMED_PASSES; pass++) {
+		for (n = 0; n < sampleCount; n++) {
+			memcpy(ahrs.accel, &samples[n].axis[IMU_ACCEL_X], sizeof(ahrs.accel));
+			memcpy(ahrs.mag, samples[n].mag, sizeof(ahrs.mag));
+			ahrs.magValid = useMag;
+			ahrsCorrect(&ahrs);
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	*correctNs = elapsed(&start, &end, AHRS_BENCH_TIMED_PASSES * sampleCount);
+}
+
+int main(int argc, char **argv) {
+	angleError_t apart;
+	angleError_t fixedTruth;
+	angleError_t floatTruth;
+	double propagateNs;
+	double correctNs;
+	const char *path = 0;
+	char what[96];
+	uint8_t useMag = 0;
+	int arg;
+
+	for (arg = 1; arg < argc; arg++) {
+		if (strcmp(argv[arg], "-m") == 0) {
+			useMag = 1;
+		} else if (argv[arg][0] != '-' && path == 0) {
+			path = argv[arg];
+		} else {
+			fprintf(stderr, "usage: %s [-m] [run.csv]\n", argv[0]);
+			return 2;
+		}
+	}
+	samples = calloc(AHRS_BENCH_MAX_SAMPLES, sizeof(imuSample_t));
+	truth = calloc(AHRS_BENCH_MAX_SAMPLES, sizeof(*truth));
+	if (samples == 0 || truth == 0) {
+		return 2;
+	}
+	if (path != 0) {
+		// Telemetry has no compass channel
+		useMag = 0;
+		if (loadRun(path) != 0) {
+			return 2;
+		}
+		printf("%s, %lu samples, accel and gyro\n", path, (unsigned long) sampleCount);
+	} else {
+		makeRun(useMag);
+		printf("synthetic, %d s at %d Hz, %s\n", AHRS_BENCH_SECONDS, AHRS_SAMPLE_RATE_HZ,
+				useMag ? "accel, gyro and compass" : "accel and gyro");
+	}
+
+	memset(&apart, 0, sizeof(apart));
+	memset(&fixedTruth, 0, sizeof(fixedTruth));
+	memset(&floatTruth, 0, sizeof(floatTruth));
+	compare(useMag, path == 0, &apart, &fixedTruth, &floatTruth);
+	printf("  %-22s %17s %17s %17s\n", "deg, worst and RMS", angleNames[AHRS_ROLL],
+			angleNames[AHRS_PITCH], angleNames[AHRS_YAW]);
+	printError("fixed vs reference", &apart);
+	if (path == 0) {
+		printError("fixed vs truth", &fixedTruth);
+		printError("reference vs truth", &floatTruth);
+	}
+	snprintf(what, sizeof(what), "roll and pitch within %.2f deg of the reference",
+			AHRS_BENCH_BOUND_TILT);
+	check(apart.worst[AHRS_ROLL] <= AHRS_BENCH_BOUND_TILT
+			&& apart.worst[AHRS_PITCH] <= AHRS_BENCH_BOUND_TILT, what);
+	snprintf(what, sizeof(what), "yaw within %.2f deg of the reference", AHRS_BENCH_BOUND_YAW);
+	check(apart.worst[AHRS_YAW] <= AHRS_BENCH_BOUND_YAW, what);
+
+	timeUpdates(useMag, &propagateNs, &correctNs);
+	printf("\nhost ns                 mean    worst tick\n");
+	printf("  ahrsPropagate     %9.1f\n", propagateNs);
+	printf("  ahrsCorrect       %9.1f\n", correctNs);
+	printf("  tick, split       %9.1f %9.1f   correct every %d\n",
+			propagateNs + correctNs / AHRS_CORRECTION_DIVIDER, propagateNs + correctNs,
+			AHRS_CORRECTION_DIVIDER);
+	printf("  tick, unsplit     %9.1f %9.1f   correct every tick\n", propagateNs + correctNs,
+			propagateNs + correctNs);
+
+	free(samples);
+	free(truth);
+	if (failures > 0) {
+		printf("FAIL, %d checks\n", failures);
+		return 1;
+	}
+	printf("pass\n");
+	return 0;
+}
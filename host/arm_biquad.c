@@ -0,0 +1,97 @@
+/************************************************************
+*
+* @file:      arm_biquad.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Host build of the two CMSIS-DSP biquad functions
+*             the firmware links, for host/replay.c
+*
+*             The CMSIS-DSP library is not in the tree, so the
+*             host tools carry a plain C copy of the Q15 direct
+*             form I kernel. The arithmetic is that of the library
+*             built for the Cortex-M0, where __SMUAD and __SMLAD
+*             are C emulations: the five products are summed with
+*             32 bit wraparound, no 64 bit guard, shifted right by
+*             15 - postShift and saturated to 16 bits. Coefficients
+*             per stage are {b0, 0, b1, b2, a1, a2}, state per
+*             stage {x[n-1], x[n-2], y[n-1], y[n-2]}.
+*
+************************************************************/
+
+#include <string.h>
+#include "arm_math.h"
+
+/************************************************************
+*
+* Function: arm_biquad_cascade_df1_init_q15
+* @brief:   attach coefficients and clear the state
+* @param:   pState, q15_t*, 4 * numStages values
+*
+************************************************************/
+void arm_biquad_cascade_df1_init_q15(arm_biquad_casd_df1_inst_q15 *S, uint8_t numStages,
+		q15_t *pCoeffs, q15_t *pState, int8_t postShift) {
+	S->numStages = (int8_t) numStages;
+	S->pCoeffs = pCoeffs;
+	S->pState = pState;
+	S->postShift = postShift;
+	memset(pState, 0, 4 * numStages * sizeof(q15_t));
+}
+
+/************************************************************
+*
+* Function: arm_biquad_cascade_df1_fast_q15
+* @brief:   filter a block through every stage, pSrc and pDst
+*           may be the same buffer
+* @param:   blockSize, uint32_t, samples in the block
+*
+************************************************************/
+void arm_biquad_cascade_df1_fast_q15(const arm_biquad_casd_df1_inst_q15 *S, q15_t *pSrc,
+		q15_t *pDst, uint32_t blockSize) {
+	const q15_t *coeffs = S->pCoeffs;
+	q15_t *state = S->pState;
+	q15_t *input = pSrc;
+	int32_t shift = 15 - S->postShift;
+	uint32_t acc;
+	int32_t out;
+	q15_t x0;
+	q15_t x1;
+	q15_t x2;
+	q15_t y1;
+	q15_t y2;
+	uint32_t n;
+	int8_t stage;
+
+	for (stage = 0; stage < S->numStages; stage++) {
+		x1 = state[0];
+		x2 = state[1];
+		y1 = state[2];
+		y2 = state[3];
+		for (n = 0; n < blockSize; n++) {
+			x0 = input[n];
+			// Unsigned sums wrap like the emulated dual MACs
+			acc = (uint32_t) (coeffs[0] * x0) + (uint32_t) (coeffs[2] * x1)
+					+ (uint32_t) (coeffs[3] * x2) + (uint32_t) (coeffs[4] * y1)
+					+ (uint32_t) (coeffs[5] * y2);
+			out = (int32_t) acc >> shift;
+			if (out > 32767) {
+				out = 32767;
+			} else if (out < -32768) {
+				out = -32768;
+			}
+			x2 = x1;
+			x1 = x0;
+			y2 = y1;
+			y1 = (q15_t) out;
+			pDst[n] = (q15_t) out;
+		}
+		state[0] = x1;
+		state[1] = x2;
+		state[2] = y1;
+		state[3] = y2;
+		// Later stages filter the previous stage's output
+		input = pDst;
+		coeffs += 6;
+		state += 4;
+	}
+}
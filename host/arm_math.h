@@ -0,0 +1,79 @@
+/************************************************************
+*
+* @file:      arm_math.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Stand-in for the CMSIS-DSP header in the Linux
+*             build, the real one pulls in the Cortex-M core
+*             intrinsics; declares what host/arm_biquad.c,
+*             host/arm_rfft.c and host/arm_matrix.c provide
+*
+************************************************************/
+
+#ifndef _ARM_MATH_H
+#define _ARM_MATH_H
+
+#include <stdint.h>
+
+typedef int8_t q7_t;
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+
+typedef enum {
+	ARM_MATH_SUCCESS = 0,
+	ARM_MATH_ARGUMENT_ERROR = -1,
+	ARM_MATH_SIZE_MISMATCH = -3
+} arm_status;
+
+typedef struct {
+	int8_t numStages;
+	q15_t *pState;              // 4 per stage
+	q15_t *pCoeffs;             // {b0, 0, b1, b2, a1, a2} per stage
+	int8_t postShift;
+} arm_biquad_casd_df1_inst_q15;
+
+void arm_biquad_cascade_df1_init_q15(arm_biquad_casd_df1_inst_q15 *S, uint8_t numStages,
+		q15_t *pCoeffs, q15_t *pState, int8_t postShift);
+void arm_biquad_cascade_df1_fast_q15(const arm_biquad_casd_df1_inst_q15 *S, q15_t *pSrc,
+		q15_t *pDst, uint32_t blockSize);
+
+typedef struct {
+	uint16_t fftLen;            // complex points
+	uint8_t ifftFlag;
+	uint8_t bitReverseFlag;
+	q15_t *pTwiddle;            // {cos, sin} over a full turn
+	uint16_t *pBitRevTable;
+	uint16_t twidCoefModifier;
+	uint16_t bitRevFactor;
+} arm_cfft_radix4_instance_q15;
+
+typedef struct {
+	uint32_t fftLenReal;
+	uint32_t fftLenBy2;
+	uint8_t ifftFlagR;
+	uint8_t bitReverseFlagR;
+	uint32_t twidCoefRModifier;
+	q15_t *pTwiddleAReal;
+	q15_t *pTwiddleBReal;
+	arm_cfft_radix4_instance_q15 *pCfft;
+} arm_rfft_instance_q15;
+
+arm_status arm_rfft_init_q15(arm_rfft_instance_q15 *S, arm_cfft_radix4_instance_q15 *S_CFFT,
+		uint32_t fftLenReal, uint32_t ifftFlagR, uint32_t bitReverseFlag);
+void arm_rfft_q15(const arm_rfft_instance_q15 *S, q15_t *pSrc, q15_t *pDst);
+void arm_cmplx_mag_q15(q15_t *pSrc, q15_t *pDst, uint32_t numSamples);
+void arm_mult_q15(q15_t *pSrcA, q15_t *pSrcB, q15_t *pDst, uint32_t blockSize);
+
+typedef struct {
+	uint16_t numRows;
+	uint16_t numCols;
+	q15_t *pData;               // row major
+} arm_matrix_instance_q15;
+
+void arm_mat_init_q15(arm_matrix_instance_q15 *S, uint16_t nRows, uint16_t nColumns,
+		q15_t *pData);
+arm_status arm_mat_mult_q15(const arm_matrix_instance_q15 *pSrcA,
+		const arm_matrix_instance_q15 *pSrcB, arm_matrix_instance_q15 *pDst, q15_t *pState);
+
+#endif
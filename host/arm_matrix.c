@@ -0,0 +1,68 @@
+/************************************************************
+*
+* @file:      arm_matrix.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Host build of the CMSIS-DSP Q15 matrix multiply,
+*             for comparing it against lqrUpdate
+*
+*             The library's Cortex-M0 path: one multiply a term
+*             into a 64 bit sum, walking B down its columns, then
+*             the sum shifted right by 15 and saturated to Q15.
+*             pState is only used by the SIMD path and is ignored.
+*             Sizes are checked only with ARM_MATH_MATRIX_CHECK,
+*             as in the library.
+*
+************************************************************/
+
+#include "arm_math.h"
+
+void arm_mat_init_q15(arm_matrix_instance_q15 *S, uint16_t nRows, uint16_t nColumns,
+		q15_t *pData) {
+	S->numRows = nRows;
+	S->numCols = nColumns;
+	S->pData = pData;
+}
+
+/************************************************************
+*
+* Function: arm_mat_mult_q15
+* @brief:   pDst = pSrcA * pSrcB, Q15
+* @return:  arm_status, ARM_MATH_SIZE_MISMATCH if the sizes
+*           do not agree and the check is built in
+*
+************************************************************/
+arm_status arm_mat_mult_q15(const arm_matrix_instance_q15 *pSrcA,
+		const arm_matrix_instance_q15 *pSrcB, arm_matrix_instance_q15 *pDst, q15_t *pState) {
+	const q15_t *pInA;
+	const q15_t *pInB;
+	q15_t *px = pDst->pData;
+	int64_t sum;
+	int32_t shifted;
+	uint16_t row;
+	uint16_t col;
+	uint16_t k;
+
+	(void) pState;
+#ifdef ARM_MATH_MATRIX_CHECK
+	if (pSrcA->numCols != pSrcB->numRows || pSrcA->numRows != pDst->numRows
+			|| pSrcB->numCols != pDst->numCols) {
+		return ARM_MATH_SIZE_MISMATCH;
+	}
+#endif
+	for (row = 0; row < pSrcA->numRows; row++) {
+		for (col = 0; col < pSrcB->numCols; col++) {
+			pInA = &pSrcA->pData[row * pSrcA->numCols];
+			pInB = &pSrcB->pData[col];
+			sum = 0;
+			for (k = 0; k < pSrcA->numCols; k++) {
+				sum += (int32_t) *pInA++ * *pInB;
+				pInB += pSrcB->numCols;
+			}
+			shifted = (int32_t) (sum >> 15);
+			*px++ = (q15_t) (shifted > 32767 ? 32767 : (shifted < -32768 ? -32768 : shifted));
+		}
+	}
+	return ARM_MATH_SUCCESS;
+}
@@ -0,0 +1,283 @@
+/************************************************************
+*
+* @file:      arm_rfft.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Host build of the CMSIS-DSP functions src/spectrum.c
+*             links: the Q15 real FFT, complex magnitude and
+*             vector multiply
+*
+*             Plain C with the library's fixed point structure: a
+*             radix-4 decimation in frequency complex FFT of half
+*             the length, each stage dividing by four with
+*             truncating shifts and Q15 twiddles, the middle two
+*             butterfly outputs swapped so a plain bit reversal
+*             puts the result in order, then the split stage that
+*             turns it into the real spectrum with one more halving.
+*             The output is the DFT divided by the real length, the
+*             scaling the library documents (8.7 for 128 points),
+*             as 2 * fftLenReal values: every complex bin, the upper
+*             half the conjugate of the lower. The input buffer is
+*             overwritten, as in the library.
+*
+*             Forward transform only; spectrum.c never inverts.
+*             arm_sqrt_q15 is an exact floor square root here, the
+*             library's Newton iteration may differ in the last bit.
+*
+************************************************************/
+
+#include <math.h>
+#include "arm_math.h"
+
+// Largest lengths the library supports, 2048 real, 1024 complex
+#define RFFT_MAX_LEN                2048
+#define CFFT_MAX_LEN                (RFFT_MAX_LEN / 2)
+
+// {cos, sin} of 2 pi i / CFFT_MAX_LEN
+static q15_t twiddleCoef[2 * CFFT_MAX_LEN];
+// Split stage {re, im} of A = (1 - j W) / 2 and B = (1 + j W) / 2,
+// W = exp(-2 pi j k / RFFT_MAX_LEN)
+static q15_t realCoefA[2 * CFFT_MAX_LEN];
+static q15_t realCoefB[2 * CFFT_MAX_LEN];
+static uint8_t tablesReady = 0;
+
+static q15_t toQ15(double value) {
+	double scaled = floor(value * 32768.0 + 0.5);
+
+	return (q15_t) (scaled > 32767.0 ? 32767.0 : (scaled < -32768.0 ? -32768.0 : scaled));
+}
+
+static q15_t saturate(int32_t value) {
+	return (q15_t) (value > 32767 ? 32767 : (value < -32768 ? -32768 : value));
+}
+
+static void buildTables(void) {
+	double theta;
+	uint32_t i;
+
+	for (i = 0; i < CFFT_MAX_LEN; i++) {
+		theta = 2.0 * M_PI * i / CFFT_MAX_LEN;
+		twiddleCoef[2 * i] = toQ15(cos(theta));
+		twiddleCoef[2 * i + 1] = toQ15(sin(theta));
+		theta = 2.0 * M_PI * i / RFFT_MAX_LEN;
+		realCoefA[2 * i] = toQ15(0.5 * (1.0 - sin(theta)));
+		realCoefA[2 * i + 1] = toQ15(-0.5 * cos(theta));
+		realCoefB[2 * i] = toQ15(0.5 * (1.0 + sin(theta)));
+		realCoefB[2 * i + 1] = toQ15(0.5 * cos(theta));
+	}
+	tablesReady = 1;
+}
+
+/************************************************************
+*
+* Function: arm_rfft_init_q15
+* @brief:   fill both instances for a forward transform
+* @param:   fftLenReal, uint32_t, 128, 512 or 2048
+* @return:  arm_status, ARM_MATH_ARGUMENT_ERROR for any other
+*           length or an inverse transform
+*
+************************************************************/
+arm_status arm_rfft_init_q15(arm_rfft_instance_q15 *S, arm_cfft_radix4_instance_q15 *S_CFFT,
+		uint32_t fftLenReal, uint32_t ifftFlagR, uint32_t bitReverseFlag) {
+	if ((fftLenReal != 128 && fftLenReal != 512 && fftLenReal != 2048) || ifftFlagR != 0) {
+		return ARM_MATH_ARGUMENT_ERROR;
+	}
+	if (!tablesReady) {
+		buildTables();
+	}
+	S->fftLenReal = fftLenReal;
+	S->fftLenBy2 = fftLenReal / 2;
+	S->ifftFlagR = 0;
+	S->bitReverseFlagR = (uint8_t) bitReverseFlag;
+	S->twidCoefRModifier = RFFT_MAX_LEN / fftLenReal;
+	S->pTwiddleAReal = realCoefA;
+	S->pTwiddleBReal = realCoefB;
+	S->pCfft = S_CFFT;
+	S_CFFT->fftLen = (uint16_t) S->fftLenBy2;
+	S_CFFT->ifftFlag = 0;
+	S_CFFT->bitReverseFlag = (uint8_t) bitReverseFlag;
+	S_CFFT->pTwiddle = twiddleCoef;
+	S_CFFT->pBitRevTable = 0;
+	S_CFFT->twidCoefModifier = (uint16_t) (CFFT_MAX_LEN / S->fftLenBy2);
+	S_CFFT->bitRevFactor = S_CFFT->twidCoefModifier;
+	return ARM_MATH_SUCCESS;
+}
+
+// (re + j im) * (cos - j sin), Q15, then the stage's divide by four
+static void twiddle(q15_t *point, int32_t re, int32_t im, const q15_t *coef) {
+	int64_t outRe = (int64_t) re * coef[0] + (int64_t) im * coef[1];
+	int64_t outIm = (int64_t) im * coef[0] - (int64_t) re * coef[1];
+
+	point[0] = saturate((int32_t) (outRe >> 17));
+	point[1] = saturate((int32_t) (outIm >> 17));
+}
+
+static void radix4Butterfly(q15_t *data, uint32_t length, const q15_t *coef, uint32_t modifier) {
+	q15_t *a;
+	q15_t *b;
+	q15_t *c;
+	q15_t *d;
+	int32_t sumRe;
+	int32_t sumIm;
+	int32_t diffRe;
+	int32_t diffIm;
+	int32_t oddSumRe;
+	int32_t oddSumIm;
+	int32_t oddDiffRe;
+	int32_t oddDiffIm;
+	uint32_t span;
+	uint32_t quarter;
+	uint32_t group;
+	uint32_t k;
+	uint32_t step;
+
+	for (span = length; span >= 4; span >>= 2) {
+		quarter = span >> 2;
+		step = (length / span) * modifier;
+		for (group = 0; group < length; group += span) {
+			for (k = 0; k < quarter; k++) {
+				a = &data[2 * (group + k)];
+				b = a + 2 * quarter;
+				c = b + 2 * quarter;
+				d = c + 2 * quarter;
+				sumRe = a[0] + c[0];
+				sumIm = a[1] + c[1];
+				diffRe = a[0] - c[0];
+				diffIm = a[1] - c[1];
+				oddSumRe = b[0] + d[0];
+				oddSumIm = b[1] + d[1];
+				oddDiffRe = b[0] - d[0];
+				oddDiffIm = b[1] - d[1];
+				a[0] = (q15_t) ((sumRe + oddSumRe) >> 2);
+				a[1] = (q15_t) ((sumIm + oddSumIm) >> 2);
+				// Outputs 2 and 1 trade places, see the file header
+				twiddle(b, sumRe - oddSumRe, sumIm - oddSumIm, &coef[2 * (2 * k * step)]);
+				// (a - c) - j (b - d) and (a - c) + j (b - d)
+				twiddle(c, diffRe + oddDiffIm, diffIm - oddDiffRe, &coef[2 * (k * step)]);
+				twiddle(d, diffRe - oddDiffIm, diffIm + oddDiffRe, &coef[2 * (3 * k * step)]);
+			}
+		}
+	}
+}
+
+static void bitReverse(q15_t *data, uint32_t length) {
+	uint32_t i;
+	uint32_t j = 0;
+	uint32_t bit;
+	q15_t swap;
+
+	for (i = 0; i < length; i++) {
+		if (i < j) {
+			swap = data[2 * i];
+			data[2 * i] = data[2 * j];
+			data[2 * j] = swap;
+			swap = data[2 * i + 1];
+			data[2 * i + 1] = data[2 * j + 1];
+			data[2 * j + 1] = swap;
+		}
+		for (bit = length >> 1; bit > 0 && (j & bit); bit >>= 1) {
+			j ^= bit;
+		}
+		j |= bit;
+	}
+}
+
+/************************************************************
+*
+* Function: arm_rfft_q15
+* @brief:   forward real FFT
+* @param:   pSrc, q15_t*, fftLenReal samples, overwritten
+* @param:   pDst, q15_t*, 2 * fftLenReal values, {re, im} of
+*           every bin, scaled by 1 / fftLenReal
+*
+************************************************************/
+void arm_rfft_q15(const arm_rfft_instance_q15 *S, q15_t *pSrc, q15_t *pDst) {
+	uint32_t half = S->fftLenBy2;
+	const q15_t *coefA;
+	const q15_t *coefB;
+	const q15_t *z;
+	const q15_t *mirror;
+	int64_t outRe;
+	int64_t outIm;
+	uint32_t k;
+
+	// The real samples, paired, are the complex input
+	radix4Butterfly(pSrc, half, S->pCfft->pTwiddle, S->pCfft->twidCoefModifier);
+	if (S->bitReverseFlagR) {
+		bitReverse(pSrc, half);
+	}
+	for (k = 0; k < half; k++) {
+		coefA = &S->pTwiddleAReal[2 * k * S->twidCoefRModifier];
+		coefB = &S->pTwiddleBReal[2 * k * S->twidCoefRModifier];
+		z = &pSrc[2 * k];
+		mirror = &pSrc[2 * ((half - k) % half)];
+		// Z[k] A[k] + conj(Z[half - k]) B[k], halved by the >> 16
+		outRe = (int64_t) z[0] * coefA[0] - (int64_t) z[1] * coefA[1]
+				+ (int64_t) mirror[0] * coefB[0] + (int64_t) mirror[1] * coefB[1];
+		outIm = (int64_t) z[0] * coefA[1] + (int64_t) z[1] * coefA[0]
+				+ (int64_t) mirror[0] * coefB[1] - (int64_t) mirror[1] * coefB[0];
+		pDst[2 * k] = saturate((int32_t) (outRe >> 16));
+		pDst[2 * k + 1] = saturate((int32_t) (outIm >> 16));
+	}
+	pDst[2 * half] = saturate((pSrc[0] - pSrc[1]) >> 1);
+	pDst[2 * half + 1] = 0;
+	for (k = 1; k < half; k++) {
+		pDst[2 * (2 * half - k)] = pDst[2 * k];
+		pDst[2 * (2 * half - k) + 1] = saturate(-pDst[2 * k + 1]);
+	}
+}
+
+static q15_t sqrtFloorQ15(int32_t x) {
+	uint32_t square = (uint32_t) x << 15;
+	uint32_t root = 0;
+	uint32_t bit = 1u << 30;
+
+	while (bit > square) {
+		bit >>= 2;
+	}
+	while (bit != 0) {
+		if (square >= root + bit) {
+			square -= root + bit;
+			root = (root >> 1) + bit;
+		} else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+	return (q15_t) root;
+}
+
+/************************************************************
+*
+* Function: arm_cmplx_mag_q15
+* @brief:   magnitude of {re, im} pairs, 2.14 out, half the
+*           Q15 magnitude
+*
+************************************************************/
+void arm_cmplx_mag_q15(q15_t *pSrc, q15_t *pDst, uint32_t numSamples) {
+	int32_t re;
+	int32_t im;
+	uint32_t n;
+
+	for (n = 0; n < numSamples; n++) {
+		re = pSrc[2 * n];
+		im = pSrc[2 * n + 1];
+		pDst[n] = sqrtFloorQ15((int32_t) (((uint32_t) (re * re) + (uint32_t) (im * im)) >> 17));
+	}
+}
+
+/************************************************************
+*
+* Function: arm_mult_q15
+* @brief:   element wise Q15 product, saturated; the output may
+*           be either input
+*
+************************************************************/
+void arm_mult_q15(q15_t *pSrcA, q15_t *pSrcB, q15_t *pDst, uint32_t blockSize) {
+	uint32_t n;
+
+	for (n = 0; n < blockSize; n++) {
+		pDst[n] = saturate((pSrcA[n] * pSrcB[n]) >> 15);
+	}
+}
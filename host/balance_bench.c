@@ -0,0 +1,265 @@
+/************************************************************
+*
+* @file:      balance_bench.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Inner loop time of balanceStep on outer loop ticks
+*             against the other ticks, from the balance.c probes
+*
+*             Build and run from the repository root:
+*
+*               gcc -std=gnu99 -O2 -DFIRMWARE_HOST -DSENSOR_SIM \
+*                   -DHOST_SYSTICK_CLOCK -DARM_MATH_CM0 -Ihost -Iinc \
+*                   -o balance_bench host/balance_bench.c src/balance.c \
+*                   src/sensor_sim.c host/stepper.c host/debug_uart.c \
+*                   host/arm_biquad.c host/arm_rfft.c src/telemetry.c \
+*                   src/sysid.c src/autotune.c src/gain_schedule.c \
+*                   src/motion.c src/ahrs.c src/calibration.c \
+*                   src/profile.c src/kalman.c src/lqr.c src/fastmath.c \
+*                   src/tables.c src/imu_filter.c src/adaptive_notch.c \
+*                   src/spectrum.c -lm
+*               ./balance_bench
+*
+*             balance.c runs unchanged on the SENSOR_SIM backend,
+*             fed one upright, noisy sample a tick, balancing at
+*             a commanded speed so the outer loop's speed and
+*             tilt limits are live. SysTick runs on the host
+*             clock (HOST_SYSTICK_CLOCK), one count a nanosecond,
+*             so balanceInnerProfile, sensor to wheel command,
+*             reads host nanoseconds; each clock read adds its own
+*             cost to every probe alike. Inner loop times are split
+*             by whether the tick also ran the outer update, and
+*             compared by median and 99th percentile, since the
+*             host's own preemption owns the true maximum. The
+*             budget is the multi-rate split's promise: an outer
+*             tick's inner loop is the same as any other's. The
+*             medians may differ by at most half of motionUpdate,
+*             timed alone, so the check fails if the outer update
+*             lands inside the inner span (it does, ~5 ns against
+*             ~1 ns of noise); the 99th percentiles by at most
+*             BALANCE_BENCH_TOLERANCE. Exit status is 1 if either
+*             is broken, or if the inner and outer loops did not
+*             run as often as due.
+*
+*             Host nanoseconds rank the sections against each
+*             other; on target "prof" reports the same probes in
+*             M0 cycles.
+*
+************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "balance.h"
+#include "sensor.h"
+#include "motion.h"
+#include "host.h"
+
+#define BALANCE_BENCH_WARMUP        10000
+#define BALANCE_BENCH_TICKS         200000
+#define BALANCE_BENCH_SPEED         200     // steps/s
+// Outer tick inner loop over the others, 99th percentile
+#define BALANCE_BENCH_TOLERANCE     1.10
+// motionUpdate alone, best of the rounds
+#define BALANCE_BENCH_MOTION_CALLS  1000000
+#define BALANCE_BENCH_MOTION_ROUNDS 5
+
+// Provided by host/firmware.c in the firmware build
+SysTick_Type hostSysTick;
+SCB_Type hostScb;
+uint32_t SystemCoreClock = 48000000;
+volatile uint32_t tickCount = 0;
+
+static struct timespec clockBase;
+static uint32_t innerOrdinary[BALANCE_BENCH_TICKS];
+static uint32_t innerOuter[BALANCE_BENCH_TICKS / MOTION_DIVIDER + 1];
+static uint32_t outerUpdate[BALANCE_BENCH_TICKS / MOTION_DIVIDER + 1];
+static uint32_t wholeTick[BALANCE_BENCH_TICKS];
+static int failures = 0;
+
+/************************************************************
+*
+* Function: hostSysTickClock
+* @brief:   SysTick with LOAD at its maximum, so profileCycles
+*           is the down counter alone, set from nanoseconds since
+*           the start; the wrap every ~4.3 s cancels in
+*           profileStop's difference
+*
+************************************************************/
+SysTick_Type *hostSysTickClock(void) {
+	struct timespec now;
+	uint64_t ns;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	ns = (uint64_t) (now.tv_sec - clockBase.tv_sec) * 1000000000ULL
+			+ (uint64_t) now.tv_nsec - (uint64_t) clockBase.tv_nsec;
+	hostSysTick.LOAD = UINT32_MAX;
+	hostSysTick.VAL = ~(uint32_t) ns;
+	return &hostSysTick;
+}
+
+void hostOutput(hostOutput_t kind, const uint8_t *data, uint16_t length) {
+	(void) kind;
+	(void) data;
+	(void) length;
+}
+
+static void check(int ok, const char *what) {
+	printf("  %s %s\n", ok ? "ok  " : "FAIL", what);
+	if (!ok) {
+		failures++;
+	}
+}
+
+static int compareU32(const void *a, const void *b) {
+	uint32_t x = *(const uint32_t *) a;
+	uint32_t y = *(const uint32_t *) b;
+
+	return (x > y) - (x < y);
+}
+
+static double gaussian(void) {
+	double u = (rand() + 1.0) / (RAND_MAX + 2.0);
+	double v = (rand() + 1.0) / (RAND_MAX + 2.0);
+
+	return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+/************************************************************
+*
+* Function: pushSample
+* @brief:   queue an upright sample, rocking +-2 deg at 1.5 Hz,
+*           with sensor noise
+*
+************************************************************/
+static void pushSample(uint32_t tick) {
+	imuSample_t sample = { { 0 } };
+	double tilt = 2.0 * M_PI / 180.0 * sin(2.0 * M_PI * 1.5 * tick / 1000.0);
+
+	sample.axis[IMU_ACCEL_Y] = (int16_t) (ACCEL_LSB_PER_G * sin(tilt) + 30.0 * gaussian());
+	sample.axis[IMU_ACCEL_Z] = (int16_t) (ACCEL_LSB_PER_G * cos(tilt) + 30.0 * gaussian());
+	sample.axis[IMU_GYRO_X] = (int16_t) (8.0 * gaussian());
+	sensorSimPush(&sample);
+}
+
+/************************************************************
+*
+* Function: motionCost
+* @return:  double, host ns per motionUpdate at a commanded
+*           speed, without the probes' clock reads
+*
+************************************************************/
+static double motionCost(void) {
+	struct timespec begin;
+	struct timespec end;
+	motion_t motion;
+	volatile int16_t sink;
+	double best = 1e9;
+	double ns;
+	uint32_t round;
+	uint32_t i;
+
+	for (round = 0; round < BALANCE_BENCH_MOTION_ROUNDS; round++) {
+		motionInit(&motion, &MOTION_GAINS_DEFAULT);
+		motionSetSpeed(&motion, 0, BALANCE_BENCH_SPEED);
+		clock_gettime(CLOCK_MONOTONIC, &begin);
+		for (i = 0; i < BALANCE_BENCH_MOTION_CALLS; i++) {
+			sink = motionUpdate(&motion, (int32_t) (i * 19));
+		}
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		ns = ((end.tv_sec - begin.tv_sec) * 1e9 + (end.tv_nsec - begin.tv_nsec))
+				/ BALANCE_BENCH_MOTION_CALLS;
+		if (ns < best) {
+			best = ns;
+		}
+	}
+	(void) sink;
+	return best;
+}
+
+/************************************************************
+*
+* Function: report
+* @brief:   sort the times and print the median, 99th and 99.9th
+*           percentile and the maximum
+* @return:  uint32_t, the median; the 99th percentile in *p99
+*
+************************************************************/
+static uint32_t report(const char *name, uint32_t *times, uint32_t count, uint32_t *p99) {
+	qsort(times, count, sizeof(uint32_t), compareU32);
+	printf("  %-22s %7lu %8lu %8lu %8lu %8lu\n", name, (unsigned long) count,
+			(unsigned long) times[count / 2], (unsigned long) times[count * 99 / 100],
+			(unsigned long) times[count * 999 / 1000], (unsigned long) times[count - 1]);
+	if (p99 != 0) {
+		*p99 = times[count * 99 / 100];
+	}
+	return times[count / 2];
+}
+
+int main(void) {
+	uint32_t ordinary = 0;
+	uint32_t outer = 0;
+	uint32_t outerCount;
+	uint32_t innerCount;
+	uint32_t ordinaryMedian;
+	uint32_t ordinaryP99;
+	uint32_t outerMedian;
+	uint32_t outerP99;
+	uint32_t tick;
+	double cost;
+
+	clock_gettime(CLOCK_MONOTONIC, &clockBase);
+	srand(1);
+	sensorInit();
+	stepperInit();
+	balanceInit();
+	for (tick = 0; tick < BALANCE_BENCH_WARMUP; tick++) {
+		pushSample(tick);
+		tickCount++;
+		balanceStep();
+		if (tick == 100 && balanceSetSpeed(BALANCE_BENCH_SPEED) != 0) {
+			printf("not balancing\n");
+			return 1;
+		}
+	}
+	innerCount = balanceInnerProfile.count;
+	outerCount = balanceOuterProfile.count;
+	for (tick = 0; tick < BALANCE_BENCH_TICKS; tick++) {
+		pushSample(BALANCE_BENCH_WARMUP + tick);
+		tickCount++;
+		balanceStep();
+		wholeTick[tick] = balanceProfile.last;
+		if (balanceOuterProfile.count != outerCount) {
+			outerCount = balanceOuterProfile.count;
+			outerUpdate[outer] = balanceOuterProfile.last;
+			innerOuter[outer++] = balanceInnerProfile.last;
+		} else {
+			innerOrdinary[ordinary++] = balanceInnerProfile.last;
+		}
+	}
+	innerCount = balanceInnerProfile.count - innerCount;
+
+	printf("host ns per section, %d ticks\n", BALANCE_BENCH_TICKS);
+	printf("  %-22s %7s %8s %8s %8s %8s\n", "section", "runs", "median", "99%", "99.9%", "max");
+	ordinaryMedian = report("inner, other ticks", innerOrdinary, ordinary, &ordinaryP99);
+	outerMedian = report("inner, outer ticks", innerOuter, outer, &outerP99);
+	report("outer update", outerUpdate, outer, 0);
+	report("whole tick", wholeTick, BALANCE_BENCH_TICKS, 0);
+	cost = motionCost();
+	printf("  motionUpdate alone %.1f ns\n", cost);
+
+	check(innerCount == BALANCE_BENCH_TICKS, "inner loop on every tick");
+	check(outer == BALANCE_BENCH_TICKS / MOTION_DIVIDER, "outer update every MOTION_DIVIDER ticks");
+	check(outerMedian <= ordinaryMedian + cost / 2,
+			"inner loop median on outer ticks within half a motionUpdate");
+	check(outerP99 <= ordinaryP99 * BALANCE_BENCH_TOLERANCE,
+			"inner loop 99th percentile on outer ticks within budget");
+	if (failures != 0) {
+		printf("FAIL, %d checks\n", failures);
+		return 1;
+	}
+	printf("pass\n");
+	return 0;
+}
@@ -0,0 +1,206 @@
+/************************************************************
+*
+* @file:      debug_uart.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Linux build of the debug console, same line and
+*             ring semantics as src/debug_uart.c
+*
+*             Received bytes are handed over by host/firmware.c
+*             and split into lines by the receiver interrupt, with
+*             the same rules as on target: CR or LF ends a line,
+*             empty lines are skipped, lines longer than the line
+*             size or arriving with the queue full are dropped.
+*             Output drains from the TX ring at the wire rate of
+*             DEBUG_UART_BAUD, 10 bits a byte, in the DMA
+*             interrupt, so console and telemetry see the same
+*             back pressure as on target; bytes leaving the ring
+*             are outputs, folded into the run digest.
+*
+************************************************************/
+
+#include <string.h>
+#include "debug_uart.h"
+#include "divide.h"
+#include "timebase.h"
+#include "host.h"
+
+#define DEBUG_UART_BYTES_PER_SECOND (DEBUG_UART_BAUD / 10)
+
+static char rxBuffer[DEBUG_UART_RX_SIZE];
+static uint16_t rxCount = 0;            // bytes received, not yet scanned
+static char openLine[DEBUG_UART_LINE_SIZE];
+static uint16_t openLength = 0;
+static uint8_t rxDiscard = 0;
+static char lines[DEBUG_UART_LINE_QUEUE][DEBUG_UART_LINE_SIZE];
+static uint8_t lineHead = 0;
+static uint8_t lineTail = 0;
+
+static char txBuffer[DEBUG_UART_TX_SIZE];
+static uint16_t txHead = 0;
+static uint16_t txTail = 0;
+// Wire time owed, in bytes * TICK_RATE_HZ
+static uint32_t txCredit = 0;
+static uint32_t txCreditTick = 0;
+
+void debugUartInit(void) {
+	rxCount = 0;
+	openLength = 0;
+	rxDiscard = 0;
+	lineHead = 0;
+	lineTail = 0;
+	txHead = 0;
+	txTail = 0;
+	txCredit = 0;
+	txCreditTick = tickCount;
+}
+
+/************************************************************
+*
+* Function: debugUartHostReceive
+* @brief:   bytes arriving on RX, scanned at the next receiver
+*           interrupt; what does not fit is lost, as an overrun
+*
+************************************************************/
+void debugUartHostReceive(const uint8_t *data, uint16_t length) {
+	if (length > DEBUG_UART_RX_SIZE - rxCount) {
+		length = DEBUG_UART_RX_SIZE - rxCount;
+	}
+	memcpy(&rxBuffer[rxCount], data, length);
+	rxCount += length;
+}
+
+static void scanInput(void) {
+	uint16_t i;
+	char byte;
+
+	for (i = 0; i < rxCount; i++) {
+		byte = rxBuffer[i];
+		if (byte == '\r' || byte == '\n') {
+			if (!rxDiscard && openLength > 0
+					&& ((lineHead + 1) & (DEBUG_UART_LINE_QUEUE - 1)) != lineTail) {
+				memcpy(lines[lineHead], openLine, openLength);
+				lines[lineHead][openLength] = '\0';
+				lineHead = (lineHead + 1) & (DEBUG_UART_LINE_QUEUE - 1);
+			}
+			rxDiscard = 0;
+			openLength = 0;
+		} else if (openLength >= DEBUG_UART_LINE_SIZE - 1) {
+			rxDiscard = 1;
+		} else {
+			openLine[openLength++] = byte;
+		}
+	}
+	rxCount = 0;
+}
+
+const char *debugUartGetLine(void) {
+	return lineHead != lineTail ? lines[lineTail] : 0;
+}
+
+void debugUartReleaseLine(void) {
+	if (lineHead != lineTail) {
+		lineTail = (lineTail + 1) & (DEBUG_UART_LINE_QUEUE - 1);
+	}
+}
+
+uint16_t debugUartWrite(const char *text) {
+	return debugUartWriteBytes((const uint8_t *) text, (uint16_t) strlen(text));
+}
+
+uint16_t debugUartWriteBytes(const uint8_t *data, uint16_t length) {
+	uint16_t count = 0;
+	uint16_t tail = txTail;
+
+	while (count < length) {
+		if (((tail + 1) & (DEBUG_UART_TX_SIZE - 1)) == txHead) {
+			break;
+		}
+		txBuffer[tail] = (char) data[count++];
+		tail = (tail + 1) & (DEBUG_UART_TX_SIZE - 1);
+	}
+	txTail = tail;
+	return count;
+}
+
+uint16_t debugUartTxFree(void) {
+	return (uint16_t) ((txHead - txTail - 1) & (DEBUG_UART_TX_SIZE - 1));
+}
+
+void debugUartWriteInt(int32_t value) {
+	char digits[12];
+	char *cursor = &digits[sizeof(digits) - 1];
+	uint32_t magnitude = value < 0 ? -(uint32_t) value : (uint32_t) value;
+	uint32_t quotient;
+
+	*cursor = '\0';
+	do {
+		quotient = divideU32By10(magnitude);
+		*--cursor = (char) ('0' + (magnitude - quotient * 10));
+		magnitude = quotient;
+	} while (magnitude != 0);
+	if (value < 0) {
+		*--cursor = '-';
+	}
+	debugUartWrite(cursor);
+}
+
+int parseInt(const char **cursor, int32_t *value) {
+	const char *text = *cursor;
+	int32_t result = 0;
+	uint8_t negative = 0;
+
+	while (*text == ' ') {
+		text++;
+	}
+	if (*text == '-') {
+		negative = 1;
+		text++;
+	}
+	if (*text < '0' || *text > '9') {
+		return -1;
+	}
+	while (*text >= '0' && *text <= '9') {
+		// Stop before result * 10 + digit passes INT32_MAX
+		if (result > INT32_MAX / 10
+				|| (result == INT32_MAX / 10 && *text - '0' > INT32_MAX % 10)) {
+			return -1;
+		}
+		result = result * 10 + (*text++ - '0');
+	}
+	*value = negative ? -result : result;
+	*cursor = text;
+	return 0;
+}
+
+void debugUartIrqHandler(void) {
+	scanInput();
+}
+
+/************************************************************
+*
+* Function: debugUartDmaIrqHandler
+* @brief:   send what the wire carried since the last call, at
+*           most one tick's worth, as one run per buffer end
+*
+************************************************************/
+void debugUartDmaIrqHandler(void) {
+	uint32_t now = tickCount;
+	uint16_t run;
+
+	txCredit += (now - txCreditTick) * DEBUG_UART_BYTES_PER_SECOND;
+	txCreditTick = now;
+	if (txCredit > DEBUG_UART_BYTES_PER_SECOND) {
+		txCredit = DEBUG_UART_BYTES_PER_SECOND;
+	}
+	while (txHead != txTail && txCredit >= TICK_RATE_HZ) {
+		run = txTail > txHead ? txTail - txHead : DEBUG_UART_TX_SIZE - txHead;
+		if (run > txCredit / TICK_RATE_HZ) {
+			run = (uint16_t) (txCredit / TICK_RATE_HZ);
+		}
+		hostOutput(HOST_OUTPUT_UART, (const uint8_t *) &txBuffer[txHead], run);
+		txCredit -= run * TICK_RATE_HZ;
+		txHead = (txHead + run) & (DEBUG_UART_TX_SIZE - 1);
+	}
+}
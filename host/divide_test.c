@@ -0,0 +1,388 @@
+/************************************************************
+*
+* @file:      divide_test.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Exhaustive check of divide.h and its cost against
+*             the libgcc __aeabi_uidiv it replaces
+*
+*             Build and run from the repository root, about a
+*             minute:
+*
+*               gcc -std=gnu99 -O2 -DARM_MATH_CM0 -Ihost -Iinc -o divide_test \
+*                   host/divide_test.c src/tables.c -lm
+*               ./divide_test
+*
+*             Checked: divideReciprocal bounds for every divisor,
+*             divideU16 against '/' for all 2^32 (n, d) pairs,
+*             d = 0 aside, divideU32By10 for all 2^32 n, and
+*             DIVIDE_CONST_U32 for divisors at the edges of its
+*             shift and magic cases on the low and high 2^20
+*             numerators, k * d - 1 .. k * d + 1, and 2^22 random.
+*
+*             Cost: the host has a divide instruction, so host
+*             nanoseconds only compare against '/' as a sanity
+*             figure. Cortex-M0 cycles come from a step by step
+*             model of the ARMv6-M __udivsi3 in libgcc's
+*             lib1funcs.S (the non size optimized branch ladder
+*             and DoDiv steps), run on the same operands, at M0
+*             timings: one cycle an ALU op or MULS, the F051 has
+*             the single cycle multiplier, two a load, three a
+*             taken branch or return, four a BL. The model is
+*             checked to return n / d on every operand it costs.
+*             divideU16 and divideU32By10 have no data dependent
+*             branch worth the name and are counted once, on the
+*             Thumb-1 a -O2 build gives them inline. Exit status
+*             is 1 if any check fails.
+*
+************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "divide.h"
+#include "adaptive_notch.h"
+
+#define DIVIDE_TEST_EDGE            (1UL << 20)
+#define DIVIDE_TEST_RANDOM          (1UL << 22)
+#define DIVIDE_TEST_MULTIPLES       4096
+// Stride over n in the cycle model sweeps, odd so every residue shows
+#define DIVIDE_TEST_MODEL_STRIDE    257
+#define DIVIDE_TEST_TIMED           (1UL << 26)
+// adaptiveNotchBin's numerator, NOTCH_HALF_BIN_COUNTS, costed over the
+// step periods inside the notch table
+#define NOTCH_TEST_COUNTS           (2 * STEPPER_TIMER_HZ / (NOTCH_STEPS_PER_CYCLE * NOTCH_STEP_HZ))
+
+// BL to __aeabi_uidiv, CMP + BEQ of its divide by zero test
+#define M0_UIDIV_ENTRY_CYCLES       (4 + 2)
+// divideU16: four CMP/LSRS and shift steps to normalize, 4 cycles
+// each taken or not, plus the bit count (17); the table index,
+// two LDRH and the interpolation (21); the quotient multiply,
+// shift and the one step trim (10)
+#define M0_DIVIDE_U16_CYCLES        48
+// divideU32By10: the magic halves by two LDR, mulhiU32's splits,
+// four MULS and carry (24), the fix up shifts (4)
+#define M0_DIVIDE_BY_10_CYCLES      28
+
+#define DEFINE_DIVIDER(d)           static uint32_t divideBy##d(uint32_t n) { \
+		return DIVIDE_CONST_U32(n, d##UL); }
+
+DEFINE_DIVIDER(1)
+DEFINE_DIVIDER(2)
+DEFINE_DIVIDER(3)
+DEFINE_DIVIDER(7)
+DEFINE_DIVIDER(10)
+DEFINE_DIVIDER(641)
+DEFINE_DIVIDER(1000)
+DEFINE_DIVIDER(0x10000)
+DEFINE_DIVIDER(0x10001)
+DEFINE_DIVIDER(6700417)
+DEFINE_DIVIDER(0x7FFFFFFF)
+DEFINE_DIVIDER(0x80000000)
+DEFINE_DIVIDER(0x80000001)
+DEFINE_DIVIDER(0xFFFFFFFE)
+DEFINE_DIVIDER(0xFFFFFFFF)
+
+typedef struct {
+	uint32_t d;
+	uint32_t (*divide)(uint32_t n);
+} constDivider_t;
+
+static const constDivider_t dividers[] = {
+	{ 1, divideBy1 }, { 2, divideBy2 }, { 3, divideBy3 }, { 7, divideBy7 },
+	{ 10, divideBy10 }, { 641, divideBy641 }, { 1000, divideBy1000 },
+	{ 0x10000, divideBy0x10000 }, { 0x10001, divideBy0x10001 },
+	{ 6700417, divideBy6700417 }, { 0x7FFFFFFF, divideBy0x7FFFFFFF },
+	{ 0x80000000, divideBy0x80000000 }, { 0x80000001, divideBy0x80000001 },
+	{ 0xFFFFFFFE, divideBy0xFFFFFFFE }, { 0xFFFFFFFF, divideBy0xFFFFFFFF }
+};
+
+#define DIVIDER_COUNT               (sizeof(dividers) / sizeof(dividers[0]))
+
+static int failures = 0;
+
+static void check(int ok, const char *what) {
+	printf("  %-4s %s\n", ok ? "ok" : "FAIL", what);
+	if (!ok) {
+		failures++;
+	}
+}
+
+static double seconds(const struct timespec *start) {
+	struct timespec end;
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+/************************************************************
+*
+* Function: uidivModel
+* @brief:   __aeabi_uidiv as libgcc builds it for ARMv6-M, one
+*           C statement per instruction group, with its cycles
+* @param:   cycles, uint32_t*, set to the cycles from the BL to
+*           the return
+* @return:  uint32_t, n / d as the routine computes it
+*
+************************************************************/
+static uint32_t uidivModel(uint32_t n, uint32_t d, uint32_t *cycles) {
+	static const uint8_t ladder[] = { 1, 4, 8, 12, 16 };
+	uint32_t c = M0_UIDIV_ENTRY_CYCLES + 1;      // MOVS result, #0
+	uint32_t q = 0;
+	int8_t bit = -1;
+	uint8_t carry;
+	uint8_t out;
+	uint8_t i;
+
+	// BranchToDiv: LSRS, CMP, BLO into the DoDiv run for the size of n / d
+	for (i = 0; i < sizeof(ladder) && bit < 0; i++) {
+		if ((n >> ladder[i]) < d) {
+			c += 5;
+			bit = (int8_t) (ladder[i] - 1);
+		} else {
+			c += 3;
+		}
+	}
+	if (bit < 0) {
+		// Lthumb1_div_large_positive: divisor up by 8 or 16, a
+		// sentinel of ones in result counts the 8 bit passes
+		c += 5;
+		d <<= 8;
+		q = 0xFF000000;
+		if ((n >> 16) < d) {
+			c += 3;
+		} else {
+			c += 4;
+			q = 0xFFFF0000;
+			d <<= 8;
+		}
+		c += 2;
+		if ((n >> 12) < d) {
+			c += 3;
+			bit = 11;
+		} else {
+			c += 4;
+			bit = 15;
+		}
+	}
+	// DoDiv: LSRS, CMP, BCC, LSLS, SUBS, ADCS, 6 cycles either way
+	for (; bit >= 1; bit--) {
+		carry = (n >> bit) >= d;
+		if (carry) {
+			n -= d << bit;
+		}
+		out = (uint8_t) (q >> 31);
+		q = (q << 1) | carry;
+		c += 6;
+		if (bit == 8) {
+			// BCS Lthumb1_div_loop while sentinel ones carry out
+			if (out) {
+				c += 3 + 1;
+				d >>= 8;
+				bit = 16;
+			} else {
+				c += 1;
+			}
+		}
+	}
+	// Lthumb1_div1: SUBS, BCC, CPY, ADCS, CPY, BX LR
+	carry = n >= d;
+	q = (q << 1) | carry;
+	c += 1 + 3 + 1 + 1 + 3;
+	*cycles = c;
+	return q;
+}
+
+static void reciprocalBounds(void) {
+	uint8_t shift;
+	uint32_t r;
+	uint32_t d;
+	double exact;
+	double worst = 0.0;
+	int below = 0;
+
+	for (d = 1; d <= 0xFFFF; d++) {
+		r = divideReciprocal((uint16_t) d, &shift);
+		exact = (double) (1UL << (31 - shift)) / d;
+		if (r < exact) {
+			below++;
+		}
+		if ((r - exact) / exact > worst) {
+			worst = (r - exact) / exact;
+		}
+	}
+	printf("divideReciprocal: worst excess 2^%.2f relative\n", log2(worst));
+	check(below == 0 && worst <= 1.0 / 16384, "never below 1 / d, at most 2^-14 above");
+}
+
+static void divideU16All(void) {
+	struct timespec start;
+	uint32_t wrong = 0;
+	uint32_t n;
+	uint32_t d;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (d = 1; d <= 0xFFFF; d++) {
+		for (n = 0; n <= 0xFFFF; n++) {
+			wrong += divideU16((uint16_t) n, (uint16_t) d) != n / d;
+		}
+	}
+	printf("divideU16: %u wrong of 2^32 - 2^16, %.1f s\n", (unsigned) wrong, seconds(&start));
+	check(wrong == 0, "divideU16 exact for every n, d");
+}
+
+static void divideBy10All(void) {
+	struct timespec start;
+	uint32_t wrong = 0;
+	uint32_t n = 0;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	do {
+		wrong += divideU32By10(n) != n / 10;
+	} while (++n != 0);
+	printf("divideU32By10: %u wrong of 2^32, %.1f s\n", (unsigned) wrong, seconds(&start));
+	check(wrong == 0, "divideU32By10 exact for every n");
+}
+
+static uint32_t constWrong(const constDivider_t *divider, uint32_t n) {
+	return divider->divide(n) != n / divider->d;
+}
+
+static void constEdges(void) {
+	const constDivider_t *divider;
+	uint64_t multiple;
+	uint32_t wrong;
+	uint32_t bad = 0;
+	uint32_t k;
+	uint32_t n;
+	uint8_t i;
+
+	srand(1);
+	for (i = 0; i < DIVIDER_COUNT; i++) {
+		divider = &dividers[i];
+		wrong = 0;
+		for (n = 0; n < DIVIDE_TEST_EDGE; n++) {
+			wrong += constWrong(divider, n) + constWrong(divider, 0xFFFFFFFF - n);
+		}
+		for (k = 1; k <= DIVIDE_TEST_MULTIPLES; k++) {
+			multiple = (uint64_t) divider->d * (0xFFFFFFFFULL / divider->d * k / DIVIDE_TEST_MULTIPLES);
+			if (multiple > 0 && multiple < 0xFFFFFFFF) {
+				wrong += constWrong(divider, (uint32_t) multiple - 1)
+						+ constWrong(divider, (uint32_t) multiple)
+						+ constWrong(divider, (uint32_t) multiple + 1);
+			}
+		}
+		for (n = 0; n < DIVIDE_TEST_RANDOM; n++) {
+			wrong += constWrong(divider, ((uint32_t) rand() << 16) ^ (uint32_t) rand());
+		}
+		printf("DIVIDE_CONST_U32 d = 0x%08x  L = %2u  shifts %u, %2u  %u wrong\n",
+				(unsigned) divider->d, (unsigned) DIVIDE_CEIL_LOG2(divider->d),
+				(unsigned) DIVIDE_SHIFT1(divider->d), (unsigned) DIVIDE_SHIFT2(divider->d),
+				(unsigned) wrong);
+		bad += wrong;
+	}
+	check(bad == 0, "DIVIDE_CONST_U32 exact at every edge divisor");
+}
+
+/************************************************************
+* Modelled M0 cycles of __aeabi_uidiv: over all 16 bit pairs,
+* where most quotients are a bit or two and libgcc exits early,
+* over the pairs adaptiveNotchBin divides while a wheel runs in
+* the table range, and over
+* 32 bit n by 10 as debugUartWriteInt has them.
+************************************************************/
+static void cycleModel(void) {
+	uint64_t total = 0;
+	uint32_t count = 0;
+	uint32_t least = 0xFFFFFFFF;
+	uint32_t most = 0;
+	uint32_t wrong = 0;
+	uint32_t cycles;
+	uint64_t n;
+	uint32_t d;
+
+	for (d = 1; d <= 0xFFFF; d++) {
+		for (n = d % DIVIDE_TEST_MODEL_STRIDE; n <= 0xFFFF; n += DIVIDE_TEST_MODEL_STRIDE) {
+			wrong += uidivModel((uint32_t) n, d, &cycles) != n / d;
+			total += cycles;
+			count++;
+			least = cycles < least ? cycles : least;
+			most = cycles > most ? cycles : most;
+		}
+	}
+	printf("\nCortex-M0 cycles, modelled      min  mean   max\n");
+	printf("__aeabi_uidiv, 16 / 16 bit    %5u %5.1f %5u\n", (unsigned) least,
+			(double) total / count, (unsigned) most);
+	total = 0;
+	count = 0;
+	least = 0xFFFFFFFF;
+	most = 0;
+	for (d = STEPPER_TIMER_HZ / (NOTCH_LAST_HZ * NOTCH_STEPS_PER_CYCLE);
+			d <= STEPPER_TIMER_HZ / (NOTCH_FIRST_HZ * NOTCH_STEPS_PER_CYCLE); d++) {
+		wrong += uidivModel(NOTCH_TEST_COUNTS, d, &cycles) != NOTCH_TEST_COUNTS / d;
+		total += cycles;
+		count++;
+		least = cycles < least ? cycles : least;
+		most = cycles > most ? cycles : most;
+	}
+	printf("__aeabi_uidiv, notch bin      %5u %5.1f %5u\n", (unsigned) least,
+			(double) total / count, (unsigned) most);
+	printf("divideU16                     %5u %5u %5u\n", M0_DIVIDE_U16_CYCLES,
+			M0_DIVIDE_U16_CYCLES, M0_DIVIDE_U16_CYCLES);
+
+	total = 0;
+	count = 0;
+	least = 0xFFFFFFFF;
+	most = 0;
+	for (n = 0; n <= 0xFFFFFFFF; n += DIVIDE_TEST_MODEL_STRIDE * 61) {
+		wrong += uidivModel((uint32_t) n, 10, &cycles) != n / 10;
+		total += cycles;
+		count++;
+		least = cycles < least ? cycles : least;
+		most = cycles > most ? cycles : most;
+	}
+	printf("__aeabi_uidiv, 32 bit / 10    %5u %5.1f %5u\n", (unsigned) least,
+			(double) total / count, (unsigned) most);
+	printf("divideU32By10                 %5u %5u %5u\n", M0_DIVIDE_BY_10_CYCLES,
+			M0_DIVIDE_BY_10_CYCLES, M0_DIVIDE_BY_10_CYCLES);
+	check(wrong == 0, "__aeabi_uidiv model returns n / d on every operand costed");
+}
+
+static void hostTiming(void) {
+	struct timespec start;
+	volatile uint32_t sink = 0;
+	uint32_t n;
+	double ours;
+	double native;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (n = 0; n < DIVIDE_TEST_TIMED; n++) {
+		sink += divideU16((uint16_t) n, (uint16_t) ((n >> 16) | 1));
+	}
+	ours = seconds(&start);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (n = 0; n < DIVIDE_TEST_TIMED; n++) {
+		sink += (uint16_t) n / (uint16_t) ((n >> 16) | 1);
+	}
+	native = seconds(&start);
+	printf("\nhost, ns per call: divideU16 %.2f, '/' %.2f (%u)\n",
+			ours * 1e9 / DIVIDE_TEST_TIMED, native * 1e9 / DIVIDE_TEST_TIMED, (unsigned) sink);
+}
+
+int main(void) {
+	reciprocalBounds();
+	divideU16All();
+	divideBy10All();
+	constEdges();
+	cycleModel();
+	hostTiming();
+
+	if (failures > 0) {
+		printf("FAIL, %d checks\n", failures);
+		return 1;
+	}
+	printf("pass\n");
+	return 0;
+}
@@ -0,0 +1,275 @@
+/************************************************************
+*
+* @file:      fastmath_test.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Error bounds of the fastmath.h kernels against
+*             double precision libm, and a host cost table
+*
+*             Build and run from the repository root, five
+*             minutes or so, most of it libm's atan2 over 2^32 pairs:
+*
+*               gcc -std=gnu99 -O2 -Iinc -o fastmath_test \
+*                   host/fastmath_test.c src/fastmath.c src/tables.c -lm
+*               ./fastmath_test
+*
+*             Sweeps as fastmath.h states them: atan2Q15 and
+*             sqrtU32 over every input, sqrtQ15 over every Q15
+*             value, sqrtQ31 and rsqrtU32 over every third input,
+*             atan2Q31 over FASTMATH_TEST_CORDIC_VECTORS random
+*             vectors, each scaled down by a random 0 .. 31 bits
+*             so every magnitude is covered. Angle errors wrap,
+*             since +180 deg comes back as -180. Exit status is 1
+*             if a measured error passes the bound in fastmath.h.
+*
+*             The cost table is host nanoseconds per call next to
+*             libm double and float on the same inputs. It ranks
+*             the kernels against each other, not against the M0,
+*             where libm is soft float and several times slower.
+*
+************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "fastmath.h"
+
+// Bounds documented in fastmath.h
+#define FASTMATH_BOUND_ATAN2_Q15    1.3
+#define FASTMATH_BOUND_ATAN2_Q31    26.0
+#define FASTMATH_BOUND_SQRT_Q31     3.6
+#define FASTMATH_BOUND_RSQRT_LOG2   (-29.4)
+
+#define FASTMATH_TEST_CORDIC_VECTORS 20000000
+#define FASTMATH_TEST_TIMED         (1 << 20)
+#define FASTMATH_TEST_PASSES        16
+
+static int failures = 0;
+
+static void report(const char *name, double measured, double bound, const char *unit) {
+	int ok = measured <= bound;
+
+	printf("  %-4s %-10s %10.3f %s (bound %.3f)\n", ok ? "ok" : "FAIL", name, measured, unit, bound);
+	if (!ok) {
+		failures++;
+	}
+}
+
+static double wrapError(double error, double turn) {
+	return fabs(error - turn * floor(error / turn + 0.5));
+}
+
+static uint32_t random32(void) {
+	return ((uint32_t) rand() << 16) ^ (uint32_t) rand() ^ ((uint32_t) rand() << 30);
+}
+
+static void atan2Q15All(void) {
+	double worst = 0.0;
+	double error;
+	int32_t y;
+	int32_t x;
+
+	for (y = -32768; y <= 32767; y++) {
+		for (x = -32768; x <= 32767; x++) {
+			if (x == 0 && y == 0) {
+				continue;
+			}
+			error = wrapError(atan2Q15((int16_t) y, (int16_t) x) - atan2(y, x) / M_PI * 32768.0,
+					65536.0);
+			if (error > worst) {
+				worst = error;
+			}
+		}
+	}
+	report("atan2Q15", worst, FASTMATH_BOUND_ATAN2_Q15, "LSB");
+}
+
+static void atan2Q31Random(void) {
+	double worst = 0.0;
+	double error;
+	int32_t y;
+	int32_t x;
+	uint8_t scale;
+	uint32_t i;
+
+	srand(1);
+	for (i = 0; i < FASTMATH_TEST_CORDIC_VECTORS; i++) {
+		scale = (uint8_t) (rand() & 31);
+		y = (int32_t) random32() >> scale;
+		x = (int32_t) random32() >> scale;
+		if (x == 0 && y == 0) {
+			continue;
+		}
+		error = wrapError(atan2Q31(y, x) - atan2(y, x) / M_PI * 2147483648.0, 4294967296.0);
+		if (error > worst) {
+			worst = error;
+		}
+	}
+	report("atan2Q31", worst, FASTMATH_BOUND_ATAN2_Q31, "LSB");
+}
+
+static void sqrtExact(void) {
+	uint32_t wrongU32 = 0;
+	uint32_t wrongQ15 = 0;
+	uint64_t root;
+	uint32_t x = 0;
+	int32_t q;
+
+	do {
+		root = sqrtU32(x);
+		wrongU32 += root * root > x || (root + 1) * (root + 1) <= x;
+	} while (++x != 0);
+	for (q = 0; q <= 32767; q++) {
+		root = (uint64_t) sqrtQ15((int16_t) q);
+		wrongQ15 += root * root > (uint64_t) q << 15 || (root + 1) * (root + 1) <= (uint64_t) q << 15;
+	}
+	printf("  %-4s sqrtU32    exact floor, %u wrong of 2^32\n", wrongU32 == 0 ? "ok" : "FAIL",
+			(unsigned) wrongU32);
+	printf("  %-4s sqrtQ15    exact floor, %u wrong of 2^15\n", wrongQ15 == 0 ? "ok" : "FAIL",
+			(unsigned) wrongQ15);
+	failures += (wrongU32 != 0) + (wrongQ15 != 0);
+}
+
+static void sqrtRsqrtThirds(void) {
+	double worstSqrt = 0.0;
+	double worstRsqrt = 0.0;
+	double error;
+	uint64_t x;
+	uint32_t r;
+	uint8_t shift;
+
+	for (x = 1; x <= 0xFFFFFFFF; x += 3) {
+		r = rsqrtU32((uint32_t) x, &shift);
+		error = fabs(r * sqrt((double) x) / ldexp(1.0, 30 + shift) - 1.0);
+		if (error > worstRsqrt) {
+			worstRsqrt = error;
+		}
+		if (x <= INT32_MAX) {
+			error = fabs(sqrtQ31((int32_t) x) - sqrt(x * 2147483648.0));
+			if (error > worstSqrt) {
+				worstSqrt = error;
+			}
+		}
+	}
+	report("sqrtQ31", worstSqrt, FASTMATH_BOUND_SQRT_Q31, "LSB");
+	report("rsqrtU32", log2(worstRsqrt), FASTMATH_BOUND_RSQRT_LOG2, "log2 relative");
+}
+
+typedef enum {
+	KERNEL_ATAN2_Q15 = 0,
+	KERNEL_ATAN2_Q31,
+	KERNEL_ATAN2,
+	KERNEL_ATAN2F,
+	KERNEL_SQRT_U32,
+	KERNEL_SQRT_Q31,
+	KERNEL_SQRT,
+	KERNEL_SQRTF,
+	KERNEL_RSQRT_U32,
+	KERNEL_RSQRT,
+	KERNEL_COUNT
+} kernel_t;
+
+static const char *kernelNames[KERNEL_COUNT] = {
+	"atan2Q15", "atan2Q31", "atan2 double", "atan2f",
+	"sqrtU32", "sqrtQ31", "sqrt double", "sqrtf",
+	"rsqrtU32", "1/sqrt double"
+};
+
+static int32_t inputA[FASTMATH_TEST_TIMED];
+static int32_t inputB[FASTMATH_TEST_TIMED];
+
+/************************************************************
+*
+* Function: timeKernel
+* @brief:   host cost of one kernel over the shared inputs
+* @return:  double, nanoseconds per call
+*
+************************************************************/
+static double timeKernel(kernel_t kernel) {
+	struct timespec start;
+	struct timespec end;
+	volatile double sink = 0.0;
+	double sum = 0.0;
+	uint8_t shift;
+	uint32_t i;
+	uint8_t pass;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (pass = 0; pass < FASTMATH_TEST_PASSES; pass++) {
+		for (i = 0; i < FASTMATH_TEST_TIMED; i++) {
+			int32_t a = inputA[i];
+			int32_t b = inputB[i];
+
+			switch (kernel) {
+			case KERNEL_ATAN2_Q15:
+				sum += atan2Q15((int16_t) (a >> 16), (int16_t) (b >> 16));
+				break;
+			case KERNEL_ATAN2_Q31:
+				sum += atan2Q31(a, b);
+				break;
+			case KERNEL_ATAN2:
+				sum += atan2(a, b);
+				break;
+			case KERNEL_ATAN2F:
+				sum += atan2f((float) a, (float) b);
+				break;
+			case KERNEL_SQRT_U32:
+				sum += sqrtU32((uint32_t) a);
+				break;
+			case KERNEL_SQRT_Q31:
+				sum += sqrtQ31(a & INT32_MAX);
+				break;
+			case KERNEL_SQRT:
+				sum += sqrt((uint32_t) a);
+				break;
+			case KERNEL_SQRTF:
+				sum += sqrtf((float) (uint32_t) a);
+				break;
+			case KERNEL_RSQRT_U32:
+				sum += rsqrtU32((uint32_t) a | 1, &shift) >> shift;
+				break;
+			default:
+				sum += 1.0 / sqrt((uint32_t) a | 1);
+				break;
+			}
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	sink = sum;
+	(void) sink;
+	return ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec))
+			/ ((double) FASTMATH_TEST_PASSES * FASTMATH_TEST_TIMED);
+}
+
+static void costTable(void) {
+	uint32_t i;
+	uint8_t kernel;
+
+	srand(2);
+	for (i = 0; i < FASTMATH_TEST_TIMED; i++) {
+		inputA[i] = (int32_t) random32();
+		inputB[i] = (int32_t) random32();
+	}
+	printf("\nhost cost        ns per call\n");
+	for (kernel = 0; kernel < KERNEL_COUNT; kernel++) {
+		printf("%-16s %8.2f\n", kernelNames[kernel], timeKernel((kernel_t) kernel));
+	}
+}
+
+int main(void) {
+	printf("errors against libm, double precision\n");
+	atan2Q15All();
+	atan2Q31Random();
+	sqrtExact();
+	sqrtRsqrtThirds();
+	costTable();
+
+	if (failures > 0) {
+		printf("FAIL, %d bounds\n", failures);
+		return 1;
+	}
+	printf("pass\n");
+	return 0;
+}
@@ -0,0 +1,413 @@
+/************************************************************
+*
+* @file:      firmware.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     The firmware as a Linux program, on virtual time,
+*             with every input recorded to or replayed from a log
+*
+*             The modules of src/ are built unchanged; only the
+*             peripheral drivers are swapped for the ones in host/,
+*             behind the same headers. Time is tickCount and
+*             nothing else: one pass of the loop below is one
+*             SysTick, and each interrupt source runs to completion
+*             at its fixed place in it,
+*
+*               1. console bytes due this tick, then USART1
+*               2. I2C1, finishing the transactions queued so far
+*               3. HOST_POLLS_PER_TICK passes of the background loop
+*               4. TIM2 and TIM3, once per step in the tick
+*               5. SysTick, then PendSV (the control task) if pended
+*               6. DMA1 channel 4/5, the console output
+*
+*             The background loop runs while the bus is idle, as
+*             it finds it on target once the control task's burst
+*             read is done; polled after PendSV it would always
+*             see that read queued and the compass setup, which
+*             waits for an idle bus, would never advance.
+*
+*             so a run is a function of its inputs alone: the
+*             flash page at power up, the I2C answers and the
+*             console bytes. Recording takes them from host/plant.c
+*             and a script of "tick text" lines and writes them to
+*             the log; replaying feeds them back from the log and
+*             checks the run takes the same path. Every
+*             HOST_CHECK_TICKS a digest of all outputs so far
+*             (console bytes, wheel commands, flash writes) is
+*             logged, and compared when replaying, so a change in
+*             behaviour is caught within that many ticks of where
+*             it starts, even one that never touches an input.
+*
+*             There is no radio in this tree; the console is the
+*             only command link recorded.
+*
+*             Build from the repository root, -Ihost first so the
+*             device and DSP headers are the stand-ins here:
+*
+*               gcc -std=gnu99 -O2 -g -DFIRMWARE_HOST -DARM_MATH_CM0 \
+*                   -Ihost -Iinc -o firmware host/firmware.c \
+*                   host/input_log.c host/plant.c host/arm_biquad.c \
+*                   host/debug_uart.c host/i2c_master.c host/stepper.c \
+*                   host/flash_store.c host/watchdog.c host/arm_rfft.c \
+*                   src/main.c src/stm32f0xx_it.c src/timebase.c \
+*                   src/balance.c src/shell.c src/telemetry.c src/sysid.c \
+*                   src/autotune.c src/gain_schedule.c src/motion.c \
+*                   src/ahrs.c src/calibration.c src/profile.c \
+*                   src/kalman.c src/lqr.c src/fastmath.c src/tables.c \
+*                   src/imu_filter.c src/adaptive_notch.c src/mpu9250.c \
+*                   src/sensor_mpu9250.c src/spectrum.c -lm
+*
+*             Record, then replay:
+*
+*               ./firmware -w run.log -n 20000 -c script.txt -p 3000
+*               ./firmware -r run.log
+*
+*             A replay stops at its first divergence with the tick
+*             and exit status 1. Being an ordinary process it can
+*             be stepped in gdb to any tick ("break balanceStep if
+*             tickCount == 12345"), profiled with perf, or used as
+*             "git bisect run" to find the commit that changed a
+*             logged run.
+*
+************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "stm32f0xx_it.h"
+#include "timebase.h"
+#include "flash_store.h"
+#include "host.h"
+
+#define HOST_SCRIPT_LINE_SIZE       128
+#define HOST_DEFAULT_TICKS          10000
+#define HOST_DEFAULT_SEED           1
+
+typedef enum {
+	RUN_GOING = 0,
+	RUN_ENDED,                  // tick limit, or end of the log
+	RUN_RESET,                  // the watchdog fired
+	RUN_DIVERGED                // replay left the recorded path
+} runState_t;
+
+SysTick_Type hostSysTick;
+SCB_Type hostScb;
+uint32_t SystemCoreClock = 48000000;
+
+static uint8_t flashPage[FLASH_STORE_PAGE_SIZE] __attribute__((aligned(4)));
+static uint32_t digest = 0x811C9DC5;    // FNV-1a offset basis
+static uint8_t echo = 0;
+static runState_t state = RUN_GOING;
+static FILE *script = 0;
+static long scriptTick = -1;            // tick of the line read ahead
+static char scriptText[HOST_SCRIPT_LINE_SIZE];
+
+/************************************************************
+*
+* Function: hostOutput
+* @brief:   fold an output into the digest, called by the host
+*           drivers; console bytes are also echoed with -o
+*
+************************************************************/
+void hostOutput(hostOutput_t kind, const uint8_t *data, uint16_t length) {
+	uint16_t i;
+
+	digest = (digest ^ (uint8_t) kind) * 0x01000193;
+	for (i = 0; i < length; i++) {
+		digest = (digest ^ data[i]) * 0x01000193;
+	}
+	if (echo && kind == HOST_OUTPUT_UART) {
+		fwrite(data, 1, length, stdout);
+	}
+}
+
+/************************************************************
+*
+* Function: hostDiverged
+* @brief:   report the first point where a replay leaves the
+*           recorded run, and end it after this tick
+*
+************************************************************/
+void hostDiverged(const char *what) {
+	if (state == RUN_DIVERGED) {
+		return;
+	}
+	fprintf(stderr, "diverged at tick %lu: %s\n", (unsigned long) tickCount, what);
+	state = RUN_DIVERGED;
+}
+
+/************************************************************
+*
+* Function: watchdogHostReset
+* @brief:   a task missed its deadline, the IWDG would reset the
+*           board; the run ends after this tick
+*
+************************************************************/
+void watchdogHostReset(uint8_t task) {
+	fprintf(stderr, "watchdog reset at tick %lu: task %u missed its deadline\n",
+			(unsigned long) tickCount, task);
+	if (state == RUN_GOING) {
+		state = RUN_RESET;
+	}
+}
+
+/************************************************************
+*
+* Function: readScript
+* @brief:   read ahead the next "tick text" line of the console
+*           script, scriptTick is -1 at its end
+*
+************************************************************/
+static void readScript(void) {
+	char line[HOST_SCRIPT_LINE_SIZE];
+	char *text;
+
+	scriptTick = -1;
+	while (script != 0 && fgets(line, sizeof(line), script) != 0) {
+		scriptTick = strtol(line, &text, 10);
+		if (text == line || scriptTick < (long) tickCount) {
+			scriptTick = -1;
+			continue;
+		}
+		while (*text == ' ') {
+			text++;
+		}
+		text[strcspn(text, "\r\n")] = '\0';
+		snprintf(scriptText, sizeof(scriptText), "%s\r\n", text);
+		return;
+	}
+}
+
+/************************************************************
+*
+* Function: consoleInput
+* @brief:   the console bytes of this tick, from the script when
+*           recording, from the log when replaying
+*
+************************************************************/
+static void consoleInput(void) {
+	uint8_t bytes[INPUT_LOG_MAX_PAYLOAD];
+	uint16_t length = 0;
+	uint16_t size;
+
+	if (inputLogReplaying()) {
+		if (inputLogExpect(tickCount, INPUT_UART, bytes, sizeof(bytes), &length) == 0) {
+			debugUartHostReceive(bytes, length);
+		}
+		return;
+	}
+	while (scriptTick == (long) tickCount) {
+		size = (uint16_t) strlen(scriptText);
+		if (length + size > sizeof(bytes)) {
+			break;
+		}
+		memcpy(&bytes[length], scriptText, size);
+		length += size;
+		readScript();
+	}
+	if (length > 0) {
+		inputLogWrite(tickCount, INPUT_UART, bytes, length);
+		debugUartHostReceive(bytes, length);
+	}
+}
+
+/************************************************************
+*
+* Function: checkDigest
+* @brief:   log the output digest, or compare it with the log
+*
+************************************************************/
+static void checkDigest(void) {
+	uint8_t recorded[4];
+	uint16_t length;
+
+	if (!inputLogReplaying()) {
+		recorded[0] = (uint8_t) digest;
+		recorded[1] = (uint8_t) (digest >> 8);
+		recorded[2] = (uint8_t) (digest >> 16);
+		recorded[3] = (uint8_t) (digest >> 24);
+		inputLogWrite(tickCount, INPUT_CHECK, recorded, sizeof(recorded));
+		return;
+	}
+	if (inputLogExpect(tickCount, INPUT_CHECK, recorded, sizeof(recorded), &length) != 0
+			|| length != sizeof(recorded)) {
+		hostDiverged("inputs not consumed as recorded");
+	} else if ((recorded[0] | (recorded[1] << 8) | (recorded[2] << 16)
+			| ((uint32_t) recorded[3] << 24)) != digest) {
+		hostDiverged("outputs differ");
+	}
+}
+
+/************************************************************
+*
+* Function: runTick
+* @brief:   one SysTick period of virtual time, in the order
+*           given at the top of this file
+*
+************************************************************/
+static void runTick(void) {
+	uint16_t events;
+	uint8_t i;
+
+	consoleInput();
+	USART1_IRQHandler();
+	I2C1_IRQHandler();
+	for (i = 0; i < HOST_POLLS_PER_TICK; i++) {
+		firmwarePoll();
+	}
+	for (events = stepperHostDue(STEPPER_LEFT); events > 0; events--) {
+		TIM2_IRQHandler();
+	}
+	for (events = stepperHostDue(STEPPER_RIGHT); events > 0; events--) {
+		TIM3_IRQHandler();
+	}
+	SysTick_Handler();
+	if (SCB->ICSR & SCB_ICSR_PENDSVSET_Msk) {
+		SCB->ICSR &= ~SCB_ICSR_PENDSVSET_Msk;
+		PendSV_Handler();
+	}
+	DMA1_Channel4_5_IRQHandler();
+	if (!inputLogReplaying()) {
+		plantStep();
+	}
+	if (tickCount % HOST_CHECK_TICKS == 0) {
+		checkDigest();
+	}
+}
+
+/************************************************************
+*
+* Function: powerUp
+* @brief:   the flash page the firmware boots with: the -f file
+*           or an erased page when recording, the log's when
+*           replaying
+* @return:  int, 0 on success, -1 if there is none
+*
+************************************************************/
+static int powerUp(const char *flashPath) {
+	uint16_t length;
+	FILE *image;
+
+	if (inputLogReplaying()) {
+		return inputLogExpect(0, INPUT_FLASH, flashPage, sizeof(flashPage), &length) == 0
+				&& length == sizeof(flashPage) ? 0 : -1;
+	}
+	memset(flashPage, 0xFF, sizeof(flashPage));
+	if (flashPath != 0) {
+		if ((image = fopen(flashPath, "rb")) == 0) {
+			return -1;
+		}
+		fread(flashPage, 1, sizeof(flashPage), image);
+		fclose(image);
+	}
+	return inputLogWrite(0, INPUT_FLASH, flashPage, sizeof(flashPage));
+}
+
+int main(int argc, char **argv) {
+	const char *logPath = 0;
+	const char *flashPath = 0;
+	const char *scriptPath = 0;
+	uint32_t ticks = 0;
+	uint32_t seed = HOST_DEFAULT_SEED;
+	uint32_t pushTicks = 0;
+	uint32_t run = 0;
+	uint8_t replay = 0;
+	uint16_t length;
+	int option;
+	struct timespec start;
+	struct timespec end;
+	double seconds;
+
+	while ((option = getopt(argc, argv, "w:r:n:c:f:s:p:o")) != -1) {
+		switch (option) {
+		case 'w':
+		case 'r':
+			logPath = optarg;
+			replay = option == 'r';
+			break;
+		case 'n':
+			ticks = (uint32_t) strtoul(optarg, 0, 0);
+			break;
+		case 'c':
+			scriptPath = optarg;
+			break;
+		case 'f':
+			flashPath = optarg;
+			break;
+		case 's':
+			seed = (uint32_t) strtoul(optarg, 0, 0);
+			break;
+		case 'p':
+			pushTicks = (uint32_t) strtoul(optarg, 0, 0);
+			break;
+		case 'o':
+			echo = 1;
+			break;
+		default:
+			logPath = 0;
+			break;
+		}
+	}
+	if (logPath == 0 || optind != argc) {
+		fprintf(stderr, "usage: %s -w run.log [-n ticks] [-c script] [-f flash.bin] "
+				"[-s seed] [-p pushTicks] [-o]\n"
+				"       %s -r run.log [-n ticks] [-o]\n", argv[0], argv[0]);
+		return 2;
+	}
+	if (inputLogOpen(logPath, replay) != 0) {
+		fprintf(stderr, "%s: cannot %s\n", logPath, replay ? "replay, not an input log" : "create");
+		return 2;
+	}
+	if (!replay) {
+		if (scriptPath != 0 && (script = fopen(scriptPath, "r")) == 0) {
+			fprintf(stderr, "%s: cannot read\n", scriptPath);
+			return 2;
+		}
+		if (ticks == 0) {
+			ticks = HOST_DEFAULT_TICKS;
+		}
+		readScript();
+		plantInit(seed, pushTicks);
+	}
+	if (powerUp(flashPath) != 0) {
+		fprintf(stderr, "no flash page to power up with\n");
+		return 2;
+	}
+	flashStoreHostPage(flashPage);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	firmwareInit();
+	while (state == RUN_GOING) {
+		if (replay && inputLogExpect(tickCount, INPUT_END, 0, 0, &length) == 0) {
+			state = RUN_ENDED;
+			break;
+		}
+		if (ticks != 0 && run == ticks) {
+			state = RUN_ENDED;
+			break;
+		}
+		runTick();
+		run++;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	if (!replay) {
+		inputLogWrite(tickCount, INPUT_END, 0, 0);
+	}
+	if (inputLogClose() != 0) {
+		fprintf(stderr, "%s: write failed\n", logPath);
+		return 2;
+	}
+	if (script != 0) {
+		fclose(script);
+	}
+
+	seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+	fprintf(stderr, "%s %lu ticks, %.0f ticks/s, %.0fx real time, digest %08lx\n",
+			replay ? "replayed" : "recorded", (unsigned long) run,
+			seconds > 0 ? run / seconds : 0.0,
+			seconds > 0 ? run / seconds / TICK_RATE_HZ : 0.0, (unsigned long) digest);
+	return state == RUN_DIVERGED ? 1 : 0;
+}
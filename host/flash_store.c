@@ -0,0 +1,74 @@
+/************************************************************
+*
+* @file:      flash_store.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Linux build of the settings record, same layout as
+*             src/flash_store.c on a page in memory
+*
+*             host/firmware.c fills the page before power up,
+*             from a file when recording and from the log when
+*             replaying; saves only change the page and the
+*             output digest.
+*
+************************************************************/
+
+#include "flash_store.h"
+#include "host.h"
+
+static uint16_t *page = 0;
+
+static uint16_t checksum(const uint16_t *data, uint16_t count) {
+	uint16_t sum = 0;
+	uint16_t i;
+
+	for (i = 0; i < count; i++) {
+		sum += data[i];
+	}
+	return (uint16_t) ~sum;
+}
+
+/************************************************************
+*
+* Function: flashStoreHostPage
+* @brief:   attach the page image
+* @param:   image, uint8_t*, FLASH_STORE_PAGE_SIZE bytes, halfword
+*           aligned, in target byte order
+*
+************************************************************/
+void flashStoreHostPage(uint8_t *image) {
+	page = (uint16_t *) image;
+}
+
+int flashStoreLoad(uint16_t *data, uint16_t count) {
+	uint16_t i;
+
+	if (count > FLASH_STORE_MAX_DATA || page[0] != FLASH_STORE_MAGIC || page[1] != count
+			|| page[2 + count] != checksum(&page[2], count)) {
+		return -1;
+	}
+	for (i = 0; i < count; i++) {
+		data[i] = page[2 + i];
+	}
+	return 0;
+}
+
+int flashStoreSave(const uint16_t *data, uint16_t count) {
+	uint16_t i;
+
+	if (count > FLASH_STORE_MAX_DATA) {
+		return -1;
+	}
+	for (i = 0; i < FLASH_STORE_PAGE_SIZE / 2; i++) {
+		page[i] = 0xFFFF;
+	}
+	page[0] = FLASH_STORE_MAGIC;
+	page[1] = count;
+	for (i = 0; i < count; i++) {
+		page[2 + i] = data[i];
+	}
+	page[2 + count] = checksum(data, count);
+	hostOutput(HOST_OUTPUT_FLASH, (const uint8_t *) page, FLASH_STORE_PAGE_SIZE);
+	return 0;
+}
@@ -0,0 +1,83 @@
+/************************************************************
+*
+* @file:      host.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Linux build of the firmware: virtual time, the
+*             input log and the seams between the unchanged
+*             modules of src/ and the host drivers
+*
+************************************************************/
+
+#ifndef __HOST_H__
+#define __HOST_H__
+
+#include <stdint.h>
+#include "i2c_master.h"
+#include "stepper.h"
+
+// Background loop passes per tick, the target runs many more; a
+// recording only replays under the value it was made with
+#define HOST_POLLS_PER_TICK         1
+// I2C bytes one tick moves at 400 kHz, see I2C_TIMEOUT_TICKS
+#define HOST_I2C_BYTES_PER_TICK     44
+// Output digest written to the log, and checked on replay, every
+// this many ticks
+#define HOST_CHECK_TICKS            100
+
+// Input log: header magic:u32 version:u16, then records of
+//   tick:u32 type:u8 length:u16 payload[length]
+// little endian, in the order the firmware consumed them. tick is
+// tickCount at the time, the virtual timestamp; records of one tick
+// keep the order of the phases in host/firmware.c
+#define INPUT_LOG_MAGIC             0x494A4441      // "ADJI"
+#define INPUT_LOG_VERSION           2
+#define INPUT_LOG_MAX_PAYLOAD       1024
+
+typedef enum {
+	INPUT_FLASH = 'F',          // the flash store page at power up
+	INPUT_I2C = 'I',            // one finished transaction, see host/i2c_master.c
+	INPUT_UART = 'U',           // bytes received on the console
+	INPUT_CHECK = 'C',          // output digest:u32, not an input
+	INPUT_END = 'E'             // last tick, empty
+} inputType_t;
+
+// I2C payload: address reg isRead length value status data[]
+#define INPUT_I2C_HEADER            6
+
+// Kinds of output folded into the digest
+typedef enum {
+	HOST_OUTPUT_UART = 'T',     // bytes as they leave the TX ring
+	HOST_OUTPUT_STEPPER = 'S',  // wheel enable and rate commands
+	HOST_OUTPUT_FLASH = 'W'     // flash store page writes
+} hostOutput_t;
+
+// src/main.c, built with FIRMWARE_HOST
+void firmwareInit(void);
+void firmwarePoll(void);
+
+// host/firmware.c
+void hostOutput(hostOutput_t kind, const uint8_t *data, uint16_t length);
+void hostDiverged(const char *what);
+void watchdogHostReset(uint8_t task);
+
+// host/input_log.c
+int inputLogOpen(const char *path, uint8_t replay);
+int inputLogClose(void);
+uint8_t inputLogReplaying(void);
+int inputLogWrite(uint32_t tick, inputType_t type, const uint8_t *data, uint16_t length);
+int inputLogExpect(uint32_t tick, inputType_t type, uint8_t *data, uint16_t size,
+		uint16_t *length);
+
+// host/plant.c, recording only
+void plantInit(uint32_t seed, uint32_t pushTicks);
+void plantStep(void);
+i2cStatus_t plantTransfer(const i2cTransaction_t *transaction);
+
+// Host drivers, beyond the APIs they replace
+void debugUartHostReceive(const uint8_t *data, uint16_t length);
+uint16_t stepperHostDue(stepperId_t id);
+void flashStoreHostPage(uint8_t *page);
+
+#endif
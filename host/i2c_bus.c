@@ -0,0 +1,540 @@
+/************************************************************
+*
+* @file:      i2c_bus.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Register level model of I2C1, DMA1 channel 3 and
+*             the PB6/PB7 pins with one slave on the bus, for
+*             running src/i2c_master.c unchanged on Linux
+*
+*             Time moves one bus byte per i2cBusStep, address or
+*             data, with ISR flags raised as RM0091 26.4.8-9 has
+*             the master raise them: TXIS when TXDR wants the next
+*             byte, TC at NBYTES in software end mode, NACKF
+*             followed by an automatic STOP, STOPF once the STOP
+*             is out. Received bytes go through RXDR to memory if
+*             the DMA channel is on and pointed at RXDR. NACKF,
+*             STOPF and the error flags clear through ICR, TXIS on
+*             a TXDR write, TC on START or STOP, and clearing PE
+*             resets the flags and the transfer, as on silicon.
+*
+*             The slave at I2C_BUS_SLAVE has a register file and
+*             an auto incrementing pointer, set by the first byte
+*             written after its address. A slave holding SDA low
+*             lets go after a number of SCL falling edges, which
+*             only the GPIO bit banging in recoverBus produces;
+*             until then the peripheral cannot START, and loses
+*             arbitration on any bit it sends as a 1. Faults are
+*             one shot and fire at a byte counted from the next
+*             one on the bus.
+*
+*             DMA writes to CMAR as an address, so the test is
+*             linked -no-pie and reads into static buffers, which
+*             then sit below 4 GB like target memory does.
+*
+************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include "stm32f0xx.h"
+#include "i2c_bus.h"
+
+#define BUS_SCL_PIN                 GPIO_Pin_6
+#define BUS_SDA_PIN                 GPIO_Pin_7
+#define BUS_CLEARABLE_FLAGS         (I2C_ISR_NACKF | I2C_ISR_STOPF | I2C_ISR_BERR \
+		| I2C_ISR_ARLO | I2C_ISR_OVR)
+
+typedef enum {
+	BUS_IDLE = 0,
+	BUS_ADDRESS,                // START queued, address byte next
+	BUS_TRANSMIT,               // next byte comes from TXDR
+	BUS_RECEIVE,                // next byte comes from the slave
+	BUS_HELD,                   // TC, SCL stretched until START or STOP
+	BUS_STOPPING,               // STOP goes out on the next step
+	BUS_FAULTED                 // BERR or ARLO, nothing until PE is cleared
+} busState_t;
+
+I2C_TypeDef hostI2c1;
+DMA_Channel_TypeDef hostDma1Channel3;
+GPIO_TypeDef hostGpioB;
+uint8_t i2cBusRegisters[256];
+
+static busState_t state = BUS_IDLE;
+static uint8_t count = 0;           // bytes of NBYTES moved
+static uint8_t txFull = 0;          // TXDR written since TXIS
+static uint8_t pointer = 0;         // slave register pointer
+static uint8_t pointerSet = 0;      // first write byte after the address seen
+static uint32_t dmaAddress = 0;
+static uint16_t sdaHeld = 0;        // falling SCL edges until the slave lets go
+static uint8_t sclLine = 1;
+static uint8_t sdaLine = 1;
+static i2cFault_t fault = I2C_FAULT_NONE;
+static uint32_t faultAt = 0;
+static uint16_t faultClocks = 0;
+static i2cBusStats_t stats;
+
+/************************************************************
+* PB6/PB7 line levels, open drain with pull ups: low only if
+* the pin is a GPIO output driving 0 or, for SDA, the slave
+* holds it. In AF mode the peripheral releases both between
+* bytes, which is all this model needs of it.
+************************************************************/
+static uint8_t pinDrivesLow(uint16_t pin, uint8_t source) {
+	return ((GPIOB->MODER >> (2 * source)) & 3) == GPIO_Mode_OUT && !(GPIOB->ODR & pin);
+}
+
+static void linesChanged(void) {
+	uint8_t scl = !pinDrivesLow(BUS_SCL_PIN, GPIO_PinSource6);
+	uint8_t sda;
+
+	if (sclLine && !scl) {
+		stats.recoveryClocks++;
+		if (sdaHeld != 0 && sdaHeld != I2C_BUS_STUCK_FOREVER) {
+			sdaHeld--;
+		}
+	}
+	sda = !pinDrivesLow(BUS_SDA_PIN, GPIO_PinSource7) && sdaHeld == 0;
+	if (scl && sclLine && sda && !sdaLine) {
+		stats.stops++;
+		pointerSet = 0;
+	}
+	sclLine = scl;
+	sdaLine = sda;
+	GPIOB->IDR = (uint16_t) ((GPIOB->IDR & ~(BUS_SCL_PIN | BUS_SDA_PIN))
+			| (scl ? BUS_SCL_PIN : 0) | (sda ? BUS_SDA_PIN : 0));
+}
+
+static uint8_t takeFault(i2cFault_t kind) {
+	if (fault != kind || stats.bytes != faultAt) {
+		return 0;
+	}
+	fault = I2C_FAULT_NONE;
+	return 1;
+}
+
+static void stopTransfer(busState_t next, uint32_t flag) {
+	I2C1->ISR = (I2C1->ISR & ~(I2C_ISR_TXIS | I2C_ISR_TC)) | flag;
+	state = next;
+}
+
+static void arbitrationLost(void) {
+	stopTransfer(BUS_FAULTED, I2C_ISR_ARLO);
+}
+
+/************************************************************
+* Faults at the byte about to go out; 1 if the transfer is
+* over. A stuck SDA costs the master arbitration on the first
+* 1 it sends, so at once for anything but a received byte.
+************************************************************/
+static uint8_t byteFault(uint8_t masterSends) {
+	if (takeFault(I2C_FAULT_BUS_ERROR)) {
+		stopTransfer(BUS_FAULTED, I2C_ISR_BERR);
+		return 1;
+	}
+	if (takeFault(I2C_FAULT_ARB_LOST)) {
+		arbitrationLost();
+		return 1;
+	}
+	if (takeFault(I2C_FAULT_STUCK_SDA)) {
+		i2cBusHoldSda(faultClocks);
+	}
+	if (masterSends && sdaHeld != 0) {
+		arbitrationLost();
+		return 1;
+	}
+	return 0;
+}
+
+static uint8_t byteCount(void) {
+	return (uint8_t) ((I2C1->CR2 & I2C_CR2_NBYTES) >> 16);
+}
+
+// NBYTES reached: STOP in AUTOEND, else hold SCL for the software
+static void endOfCount(void) {
+	if (I2C1->CR2 & I2C_CR2_AUTOEND) {
+		state = BUS_STOPPING;
+	} else {
+		stopTransfer(BUS_HELD, I2C_ISR_TC);
+	}
+}
+
+static void nack(void) {
+	stopTransfer(BUS_STOPPING, I2C_ISR_NACKF);
+}
+
+static uint8_t sendAddress(void) {
+	uint8_t nacked;
+
+	if (sdaHeld != 0) {
+		// START needs SDA high, the peripheral waits for the bus
+		I2C1->ISR |= I2C_ISR_BUSY;
+		return 0;
+	}
+	stats.starts++;
+	I2C1->ISR |= I2C_ISR_BUSY;
+	I2C1->CR2 &= ~I2C_CR2_START;
+	if (byteFault(1)) {
+		return 1;
+	}
+	nacked = takeFault(I2C_FAULT_NACK);
+	stats.bytes++;
+	if (((I2C1->CR2 & I2C_CR2_SADD) >> 1) != I2C_BUS_SLAVE || nacked) {
+		nack();
+		return 1;
+	}
+	count = 0;
+	if (I2C1->CR2 & I2C_CR2_RD_WRN) {
+		state = BUS_RECEIVE;
+		if (byteCount() == 0) {
+			endOfCount();
+		}
+		return 1;
+	}
+	pointerSet = 0;
+	state = BUS_TRANSMIT;
+	if (byteCount() == 0) {
+		endOfCount();
+	} else {
+		I2C1->ISR |= I2C_ISR_TXIS;
+	}
+	return 1;
+}
+
+static uint8_t transmit(void) {
+	uint8_t nacked;
+
+	if (!txFull) {
+		return 0;
+	}
+	if (byteFault(1)) {
+		return 1;
+	}
+	nacked = takeFault(I2C_FAULT_NACK);
+	txFull = 0;
+	stats.bytes++;
+	count++;
+	if (nacked) {
+		nack();
+		return 1;
+	}
+	if (!pointerSet) {
+		pointer = (uint8_t) I2C1->TXDR;
+		pointerSet = 1;
+	} else {
+		i2cBusRegisters[pointer++] = (uint8_t) I2C1->TXDR;
+	}
+	if (count < byteCount()) {
+		I2C1->ISR |= I2C_ISR_TXIS;
+	} else {
+		endOfCount();
+	}
+	return 1;
+}
+
+static uint8_t receive(void) {
+	// Master stretches SCL while RXDR is unread
+	if (I2C1->ISR & I2C_ISR_RXNE) {
+		return 0;
+	}
+	if (byteFault(0)) {
+		return 1;
+	}
+	I2C1->RXDR = sdaHeld != 0 ? 0x00 : i2cBusRegisters[pointer++];
+	I2C1->ISR |= I2C_ISR_RXNE;
+	stats.bytes++;
+	count++;
+	if ((I2C1->CR1 & I2C_CR1_RXDMAEN) && (DMA1_Channel3->CCR & DMA_CCR_EN)
+			&& DMA1_Channel3->CPAR == (uint32_t) (uintptr_t) &I2C1->RXDR
+			&& DMA1_Channel3->CNDTR > 0) {
+		*(uint8_t *) (uintptr_t) dmaAddress++ = (uint8_t) I2C1->RXDR;
+		DMA1_Channel3->CNDTR--;
+		I2C1->ISR &= ~I2C_ISR_RXNE;
+	}
+	if (count < byteCount()) {
+		return 1;
+	}
+	// The master NACKs the last byte, a 1 on SDA
+	if (sdaHeld != 0) {
+		arbitrationLost();
+		return 1;
+	}
+	endOfCount();
+	return 1;
+}
+
+static void stop(void) {
+	if (sdaHeld != 0) {
+		arbitrationLost();
+		return;
+	}
+	stats.stops++;
+	I2C1->CR2 &= ~I2C_CR2_STOP;
+	stopTransfer(BUS_IDLE, I2C_ISR_STOPF);
+	I2C1->ISR &= ~I2C_ISR_BUSY;
+}
+
+/************************************************************
+*
+* Function: i2cBusReset
+* @brief:   registers out of reset, idle lines, no faults; the
+*           slave's register file is kept
+*
+************************************************************/
+void i2cBusReset(void) {
+	memset(&hostI2c1, 0, sizeof(hostI2c1));
+	memset(&hostDma1Channel3, 0, sizeof(hostDma1Channel3));
+	memset(&hostGpioB, 0, sizeof(hostGpioB));
+	memset(&stats, 0, sizeof(stats));
+	I2C1->ISR = I2C_ISR_TXE;
+	state = BUS_IDLE;
+	count = 0;
+	txFull = 0;
+	pointer = 0;
+	pointerSet = 0;
+	dmaAddress = 0;
+	sdaHeld = 0;
+	fault = I2C_FAULT_NONE;
+	sclLine = 1;
+	sdaLine = 1;
+	linesChanged();
+}
+
+/************************************************************
+*
+* Function: i2cBusInject
+* @brief:   arm a one shot fault
+* @param:   fault, i2cFault_t, what goes wrong
+* @param:   atByte, uint16_t, bus bytes to let through first,
+*           addresses included
+* @param:   clocks, uint16_t, for I2C_FAULT_STUCK_SDA, see
+*           i2cBusHoldSda
+*
+************************************************************/
+void i2cBusInject(i2cFault_t fault_, uint16_t atByte, uint16_t clocks) {
+	fault = fault_;
+	faultAt = stats.bytes + atByte;
+	faultClocks = clocks;
+}
+
+/************************************************************
+*
+* Function: i2cBusHoldSda
+* @brief:   the slave holds SDA low from now on, as after a
+*           reset in the middle of a read
+* @param:   clocks, uint16_t, SCL falling edges it needs to let
+*           go, I2C_BUS_STUCK_FOREVER for never
+*
+************************************************************/
+void i2cBusHoldSda(uint16_t clocks) {
+	sdaHeld = clocks;
+	linesChanged();
+}
+
+uint8_t i2cBusSdaStuck(void) {
+	return sdaHeld != 0;
+}
+
+/************************************************************
+*
+* Function: i2cBusStep
+* @brief:   move the bus on by one byte or condition
+* @return:  uint8_t, 0 if it is idle or waiting on software
+*
+************************************************************/
+uint8_t i2cBusStep(void) {
+	if (!(I2C1->CR1 & I2C_CR1_PE)) {
+		return 0;
+	}
+	switch (state) {
+	case BUS_ADDRESS:
+		return sendAddress();
+	case BUS_TRANSMIT:
+		return transmit();
+	case BUS_RECEIVE:
+		return receive();
+	case BUS_STOPPING:
+		stop();
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/************************************************************
+*
+* Function: i2cBusPending
+* @return:  uint8_t, 1 if a flag with its interrupt enabled is
+*           set, so I2C1_IRQHandler would run
+*
+************************************************************/
+uint8_t i2cBusPending(void) {
+	uint32_t isr = I2C1->ISR;
+	uint32_t cr1 = I2C1->CR1;
+
+	return ((isr & I2C_ISR_TXIS) && (cr1 & I2C_CR1_TXIE))
+			|| ((isr & I2C_ISR_NACKF) && (cr1 & I2C_CR1_NACKIE))
+			|| ((isr & I2C_ISR_STOPF) && (cr1 & I2C_CR1_STOPIE))
+			|| ((isr & I2C_ISR_TC) && (cr1 & I2C_CR1_TCIE))
+			|| ((isr & (I2C_ISR_BERR | I2C_ISR_ARLO | I2C_ISR_OVR)) && (cr1 & I2C_CR1_ERRIE));
+}
+
+const i2cBusStats_t *i2cBusGetStats(void) {
+	return &stats;
+}
+
+// StdPeriph calls made by src/i2c_master.c, acting on the model
+
+void RCC_AHBPeriphClockCmd(uint32_t periph, FunctionalState state_) {
+	(void) periph;
+	(void) state_;
+}
+
+void RCC_APB1PeriphClockCmd(uint32_t periph, FunctionalState state_) {
+	(void) periph;
+	(void) state_;
+}
+
+void RCC_I2CCLKConfig(uint32_t clock) {
+	(void) clock;
+}
+
+void GPIO_Init(GPIO_TypeDef *gpio, GPIO_InitTypeDef *init) {
+	uint8_t pin;
+
+	for (pin = 0; pin < 16; pin++) {
+		if (init->GPIO_Pin & (1U << pin)) {
+			gpio->MODER = (gpio->MODER & ~(3UL << (2 * pin)))
+					| ((uint32_t) init->GPIO_Mode << (2 * pin));
+			gpio->PUPDR = (gpio->PUPDR & ~(3UL << (2 * pin)))
+					| ((uint32_t) init->GPIO_PuPd << (2 * pin));
+			gpio->OTYPER = (uint16_t) ((gpio->OTYPER & ~(1U << pin))
+					| ((uint32_t) init->GPIO_OType << pin));
+		}
+	}
+	linesChanged();
+}
+
+void GPIO_PinAFConfig(GPIO_TypeDef *gpio, uint16_t source, uint8_t af) {
+	gpio->AFR[source >> 3] = (gpio->AFR[source >> 3] & ~(0xFUL << (4 * (source & 7))))
+			| ((uint32_t) af << (4 * (source & 7)));
+}
+
+void GPIO_SetBits(GPIO_TypeDef *gpio, uint16_t pins) {
+	gpio->ODR |= pins;
+	linesChanged();
+}
+
+void GPIO_ResetBits(GPIO_TypeDef *gpio, uint16_t pins) {
+	gpio->ODR &= (uint16_t) ~pins;
+	linesChanged();
+}
+
+uint8_t GPIO_ReadInputDataBit(GPIO_TypeDef *gpio, uint16_t pin) {
+	return (gpio->IDR & pin) ? Bit_SET : Bit_RESET;
+}
+
+void DMA_StructInit(DMA_InitTypeDef *init) {
+	memset(init, 0, sizeof(*init));
+}
+
+void DMA_Init(DMA_Channel_TypeDef *channel, DMA_InitTypeDef *init) {
+	channel->CCR = init->DMA_DIR | init->DMA_PeripheralInc | init->DMA_MemoryInc
+			| init->DMA_PeripheralDataSize | init->DMA_MemoryDataSize | init->DMA_Mode
+			| init->DMA_Priority | init->DMA_M2M;
+	channel->CNDTR = init->DMA_BufferSize;
+	channel->CPAR = init->DMA_PeripheralBaseAddr;
+	channel->CMAR = init->DMA_MemoryBaseAddr;
+}
+
+void DMA_Cmd(DMA_Channel_TypeDef *channel, FunctionalState state_) {
+	if (state_ == ENABLE) {
+		channel->CCR |= DMA_CCR_EN;
+		dmaAddress = channel->CMAR;
+	} else {
+		channel->CCR &= ~DMA_CCR_EN;
+	}
+}
+
+void DMA_SetCurrDataCounter(DMA_Channel_TypeDef *channel, uint16_t count_) {
+	channel->CNDTR = count_;
+}
+
+uint16_t DMA_GetCurrDataCounter(DMA_Channel_TypeDef *channel) {
+	return (uint16_t) channel->CNDTR;
+}
+
+void I2C_StructInit(I2C_InitTypeDef *init) {
+	memset(init, 0, sizeof(*init));
+}
+
+void I2C_Init(I2C_TypeDef *i2c, I2C_InitTypeDef *init) {
+	i2c->TIMINGR = init->I2C_Timing;
+}
+
+void I2C_Cmd(I2C_TypeDef *i2c, FunctionalState state_) {
+	if (state_ == ENABLE) {
+		i2c->CR1 |= I2C_CR1_PE;
+	} else {
+		i2c->CR1 &= ~I2C_CR1_PE;
+		i2c->ISR = I2C_ISR_TXE;
+		state = BUS_IDLE;
+		txFull = 0;
+	}
+}
+
+void I2C_SoftwareResetCmd(I2C_TypeDef *i2c, FunctionalState state_) {
+	// StdPeriph: ENABLE holds the peripheral in reset with PE low
+	I2C_Cmd(i2c, state_ == ENABLE ? DISABLE : ENABLE);
+}
+
+void I2C_DMACmd(I2C_TypeDef *i2c, uint32_t requests, FunctionalState state_) {
+	if (state_ == ENABLE) {
+		i2c->CR1 |= requests;
+	} else {
+		i2c->CR1 &= ~requests;
+	}
+}
+
+void I2C_ITConfig(I2C_TypeDef *i2c, uint32_t interrupts, FunctionalState state_) {
+	if (state_ == ENABLE) {
+		i2c->CR1 |= interrupts;
+	} else {
+		i2c->CR1 &= ~interrupts;
+	}
+}
+
+void I2C_ClearFlag(I2C_TypeDef *i2c, uint32_t flags) {
+	i2c->ICR = flags;
+	i2c->ISR &= ~(flags & BUS_CLEARABLE_FLAGS);
+}
+
+void I2C_SendData(I2C_TypeDef *i2c, uint8_t data) {
+	i2c->TXDR = data;
+	i2c->ISR &= ~I2C_ISR_TXIS;
+	txFull = 1;
+}
+
+void I2C_GenerateSTOP(I2C_TypeDef *i2c, FunctionalState state_) {
+	if (state_ != ENABLE) {
+		i2c->CR2 &= ~I2C_CR2_STOP;
+		return;
+	}
+	i2c->CR2 |= I2C_CR2_STOP;
+	if (state == BUS_HELD) {
+		i2c->ISR &= ~I2C_ISR_TC;
+		state = BUS_STOPPING;
+	}
+}
+
+void I2C_TransferHandling(I2C_TypeDef *i2c, uint16_t address, uint8_t count_, uint32_t endMode,
+		uint32_t startStopMode) {
+	i2c->CR2 = (i2c->CR2 & ~(I2C_CR2_SADD | I2C_CR2_NBYTES | I2C_CR2_RELOAD
+			| I2C_CR2_AUTOEND | I2C_CR2_RD_WRN | I2C_CR2_START | I2C_CR2_STOP))
+			| (address & I2C_CR2_SADD) | ((uint32_t) count_ << 16) | endMode | startStopMode;
+	if (startStopMode & I2C_CR2_START) {
+		i2c->ISR &= ~(I2C_ISR_TC | I2C_ISR_TXIS);
+		txFull = 0;
+		state = BUS_ADDRESS;
+	}
+}
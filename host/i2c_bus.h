@@ -0,0 +1,48 @@
+/************************************************************
+*
+* @file:      i2c_bus.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Register level model of I2C1, DMA1 channel 3 and
+*             the PB6/PB7 pins with one slave on the bus, for
+*             running src/i2c_master.c unchanged on Linux
+*
+************************************************************/
+
+#ifndef __I2C_BUS_H__
+#define __I2C_BUS_H__
+
+#include <stdint.h>
+
+// Address of the modelled slave
+#define I2C_BUS_SLAVE               0x68
+// Clocks of a slave that never lets go of SDA
+#define I2C_BUS_STUCK_FOREVER       0xFFFF
+
+typedef enum {
+	I2C_FAULT_NONE = 0,
+	I2C_FAULT_NACK,             // slave NACKs an address or written byte
+	I2C_FAULT_BUS_ERROR,        // misplaced START/STOP during a byte
+	I2C_FAULT_ARB_LOST,         // another master wins a byte
+	I2C_FAULT_STUCK_SDA         // slave holds SDA low from a byte on, see i2cBusHoldSda
+} i2cFault_t;
+
+typedef struct {
+	uint32_t starts;            // START and repeated START conditions
+	uint32_t stops;             // STOP conditions, by the peripheral or bit banged
+	uint32_t bytes;             // address and data bytes on the bus
+	uint32_t recoveryClocks;    // SCL pulses bit banged on the GPIO
+} i2cBusStats_t;
+
+extern uint8_t i2cBusRegisters[256];
+
+void i2cBusReset(void);
+void i2cBusInject(i2cFault_t fault, uint16_t atByte, uint16_t clocks);
+uint8_t i2cBusStep(void);
+uint8_t i2cBusPending(void);
+void i2cBusHoldSda(uint16_t clocks);
+uint8_t i2cBusSdaStuck(void);
+const i2cBusStats_t *i2cBusGetStats(void);
+
+#endif
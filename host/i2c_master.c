@@ -0,0 +1,166 @@
+/************************************************************
+*
+* @file:      i2c_master.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Linux build of the I2C master, same queue and
+*             callbacks as src/i2c_master.c
+*
+*             The bus is an input: the I2C interrupt runs once a
+*             tick on the host and finishes transactions in queue
+*             order, those its callbacks queue included, until
+*             the tick's HOST_I2C_BYTES_PER_TICK of bus time are
+*             taken; the rest wait for the next tick, as on target
+*             at 400 kHz. Recording asks host/plant.c for
+*             the outcome and logs it; replaying takes it from the
+*             log, after checking that the firmware asked for the
+*             same transfer it asked for when recorded.
+*
+************************************************************/
+
+#include <string.h>
+#include "i2c_master.h"
+#include "timebase.h"
+#include "host.h"
+
+static i2cTransaction_t queue[I2C_QUEUE_SIZE];
+static uint8_t queueHead = 0;
+static uint8_t queueTail = 0;
+static i2cStats_t stats;
+
+void i2cMasterInit(void) {
+	queueHead = 0;
+	queueTail = 0;
+	memset(&stats, 0, sizeof(stats));
+}
+
+int i2cMasterSubmit(const i2cTransaction_t *transaction) {
+	uint8_t tail = queueTail;
+
+	if (transaction->length == 0 || (!transaction->isRead && transaction->length == 0xFF)
+			|| (transaction->isRead && transaction->data == 0)) {
+		return -1;
+	}
+	if (((tail + 1) & (I2C_QUEUE_SIZE - 1)) == queueHead) {
+		return -1;
+	}
+	queue[tail] = *transaction;
+	queueTail = (tail + 1) & (I2C_QUEUE_SIZE - 1);
+	return 0;
+}
+
+int i2cMasterWriteReg(uint8_t address, uint8_t reg, uint8_t value,
+		i2cCallback_t callback, void *context) {
+	i2cTransaction_t transaction;
+
+	transaction.address = address;
+	transaction.reg = reg;
+	transaction.isRead = 0;
+	transaction.length = 1;
+	transaction.data = 0;
+	transaction.value = value;
+	transaction.callback = callback;
+	transaction.context = context;
+	return i2cMasterSubmit(&transaction);
+}
+
+int i2cMasterReadRegs(uint8_t address, uint8_t reg, uint8_t *data, uint8_t length,
+		i2cCallback_t callback, void *context) {
+	i2cTransaction_t transaction;
+
+	transaction.address = address;
+	transaction.reg = reg;
+	transaction.isRead = 1;
+	transaction.length = length;
+	transaction.data = data;
+	transaction.value = 0;
+	transaction.callback = callback;
+	transaction.context = context;
+	return i2cMasterSubmit(&transaction);
+}
+
+uint8_t i2cMasterIsIdle(void) {
+	return queueHead == queueTail;
+}
+
+void i2cMasterPoll(void) {
+}
+
+/************************************************************
+*
+* Function: transfer
+* @brief:   outcome of one transaction, from the plant when
+*           recording, from the log when replaying
+* @return:  i2cStatus_t, read data is in current->data
+*
+************************************************************/
+static i2cStatus_t transfer(i2cTransaction_t *current) {
+	uint8_t record[INPUT_I2C_HEADER + 0xFF];
+	uint8_t readLength = current->isRead ? current->length : 0;
+	uint16_t length;
+	i2cStatus_t status;
+
+	record[0] = current->address;
+	record[1] = current->reg;
+	record[2] = current->isRead;
+	record[3] = current->length;
+	record[4] = current->data == 0 ? current->value : 0;
+	if (!inputLogReplaying()) {
+		status = plantTransfer(current);
+		record[5] = (uint8_t) status;
+		if (readLength > 0) {
+			memcpy(&record[INPUT_I2C_HEADER], current->data, readLength);
+		}
+		inputLogWrite(tickCount, INPUT_I2C, record, INPUT_I2C_HEADER + readLength);
+		return status;
+	}
+	if (inputLogExpect(tickCount, INPUT_I2C, record, sizeof(record), &length) != 0
+			|| length != INPUT_I2C_HEADER + readLength || record[0] != current->address
+			|| record[1] != current->reg || record[2] != current->isRead
+			|| record[3] != current->length
+			|| record[4] != (current->data == 0 ? current->value : 0)) {
+		hostDiverged("i2c transaction");
+		return I2C_STATUS_TIMEOUT;
+	}
+	if (readLength > 0) {
+		memcpy(current->data, &record[INPUT_I2C_HEADER], readLength);
+	}
+	return (i2cStatus_t) record[5];
+}
+
+/************************************************************
+*
+* Function: i2cMasterIrqHandler
+* @brief:   finish transactions while this tick's bus time
+*           lasts; one that starts always finishes
+*
+************************************************************/
+void i2cMasterIrqHandler(void) {
+	uint16_t busBytes = 0;
+	i2cTransaction_t *current;
+	i2cStatus_t status;
+
+	while (queueHead != queueTail && busBytes < HOST_I2C_BYTES_PER_TICK) {
+		current = &queue[queueHead];
+		// Address and register, and the second address of a read
+		busBytes += current->length + (current->isRead ? 3 : 2);
+		status = transfer(current);
+		if (status == I2C_STATUS_OK) {
+			stats.completed++;
+		} else {
+			stats.errors++;
+			if (status == I2C_STATUS_TIMEOUT) {
+				stats.timeouts++;
+			}
+		}
+		queueHead = (queueHead + 1) & (I2C_QUEUE_SIZE - 1);
+		if (current->callback != 0) {
+			current->callback(status, current->context);
+		}
+	}
+}
+
+const i2cStats_t *i2cMasterGetStats(void) {
+	return &stats;
+}
@@ -0,0 +1,330 @@
+/************************************************************
+*
+* @file:      i2c_test.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     src/i2c_master.c against the register level I2C1
+*             model of host/i2c_bus.c, clean transfers and every
+*             fault the driver claims to recover from
+*
+*             Build and run from the repository root:
+*
+*               gcc -std=gnu99 -O2 -no-pie -Wno-pointer-to-int-cast \
+*                   -Ihost -Iinc -o i2c_test host/i2c_test.c \
+*                   host/i2c_bus.c src/i2c_master.c
+*               ./i2c_test
+*
+*             The loop stands in for the NVIC and SysTick: it runs
+*             the I2C1 handler while an enabled flag is pending,
+*             else moves the bus by a byte, and counts a tick each
+*             I2C_TEST_BYTES_PER_TICK bytes, or at once when the
+*             bus is stuck, calling i2cMasterPoll on each, so a
+*             255 byte read also checks that its timeout covers
+*             its six ticks of bus time. Faults:
+*             NACK of an address, of a written byte and of the
+*             register byte of a read, which ends in SOFTEND and
+*             needs the driver's STOP; BERR; ARLO; SDA held low
+*             mid read and at power up, released by the nine clock
+*             recovery; SDA held for good, so every transaction
+*             times out and the queue still drains. Exit status is
+*             1 if any check fails.
+*
+************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "i2c_master.h"
+#include "i2c_bus.h"
+
+// 400 kHz, nine clocks a byte
+#define I2C_TEST_BYTES_PER_TICK     44
+// Handler runs without the bus moving before it counts as a storm
+#define I2C_TEST_MAX_EVENTS         4
+#define I2C_TEST_MAX_TICKS          1000
+
+typedef struct {
+	uint8_t calls;
+	i2cStatus_t status;
+} outcome_t;
+
+volatile uint32_t tickCount = 0;
+
+static uint8_t readBuffer[0x100];
+static uint8_t writeBuffer[0x20];
+static int failures = 0;
+
+static void check(int ok, const char *what) {
+	printf("  %-4s %s\n", ok ? "ok" : "FAIL", what);
+	if (!ok) {
+		failures++;
+	}
+}
+
+static void record(i2cStatus_t status, void *context) {
+	outcome_t *outcome = context;
+
+	outcome->calls++;
+	outcome->status = status;
+}
+
+/************************************************************
+*
+* Function: run
+* @brief:   interrupts, bus and ticks until the driver is idle
+* @return:  uint32_t, ticks it took
+*
+************************************************************/
+static uint32_t run(void) {
+	uint32_t start = tickCount;
+	uint32_t steps = 0;
+	uint8_t events = 0;
+
+	while (!i2cMasterIsIdle()) {
+		if (i2cBusPending()) {
+			if (++events > I2C_TEST_MAX_EVENTS) {
+				check(0, "handler leaves its flags pending");
+				return tickCount - start;
+			}
+			i2cMasterIrqHandler();
+			continue;
+		}
+		events = 0;
+		if (!i2cBusStep() || ++steps % I2C_TEST_BYTES_PER_TICK == 0) {
+			tickCount++;
+			i2cMasterPoll();
+		}
+		if (tickCount - start > I2C_TEST_MAX_TICKS) {
+			check(0, "driver never goes idle");
+			break;
+		}
+	}
+	return tickCount - start;
+}
+
+static i2cStatus_t writeOne(uint8_t address, uint8_t reg, uint8_t value) {
+	outcome_t outcome = { 0, I2C_STATUS_OK };
+
+	if (i2cMasterWriteReg(address, reg, value, record, &outcome) != 0) {
+		return I2C_STATUS_TIMEOUT;
+	}
+	run();
+	return outcome.calls == 1 ? outcome.status : I2C_STATUS_TIMEOUT;
+}
+
+static i2cStatus_t readBurst(uint8_t reg, uint8_t length) {
+	outcome_t outcome = { 0, I2C_STATUS_OK };
+
+	memset(readBuffer, 0xEE, sizeof(readBuffer));
+	if (i2cMasterReadRegs(I2C_BUS_SLAVE, reg, readBuffer, length, record, &outcome) != 0) {
+		return I2C_STATUS_TIMEOUT;
+	}
+	run();
+	return outcome.calls == 1 ? outcome.status : I2C_STATUS_TIMEOUT;
+}
+
+static int burstMatches(uint8_t reg, uint16_t length) {
+	uint16_t i;
+
+	for (i = 0; i < length; i++) {
+		if (readBuffer[i] != i2cBusRegisters[(uint8_t) (reg + i)]) {
+			return 0;
+		}
+	}
+	return readBuffer[length] == 0xEE;
+}
+
+static void cleanTransfers(void) {
+	const i2cBusStats_t *bus = i2cBusGetStats();
+	i2cTransaction_t transaction;
+	outcome_t outcome = { 0, I2C_STATUS_OK };
+	uint32_t bytes;
+	uint8_t i;
+
+	printf("clean transfers\n");
+	bytes = bus->bytes;
+	check(writeOne(I2C_BUS_SLAVE, 0x1A, 0xA5) == I2C_STATUS_OK
+			&& i2cBusRegisters[0x1A] == 0xA5 && bus->bytes - bytes == 3,
+			"register write, address reg value");
+	bytes = bus->bytes;
+	check(readBurst(0x3B, 14) == I2C_STATUS_OK && burstMatches(0x3B, 14)
+			&& bus->bytes - bytes == 17, "14 byte burst read by DMA, repeated START");
+
+	for (i = 0; i < sizeof(writeBuffer); i++) {
+		writeBuffer[i] = (uint8_t) (0x80 + i);
+	}
+	transaction.address = I2C_BUS_SLAVE;
+	transaction.reg = 0x40;
+	transaction.isRead = 0;
+	transaction.length = sizeof(writeBuffer);
+	transaction.data = writeBuffer;
+	transaction.value = 0;
+	transaction.callback = record;
+	transaction.context = &outcome;
+	check(i2cMasterSubmit(&transaction) == 0, "32 byte write queued");
+	run();
+	check(outcome.calls == 1 && outcome.status == I2C_STATUS_OK
+			&& memcmp(&i2cBusRegisters[0x40], writeBuffer, sizeof(writeBuffer)) == 0,
+			"32 byte write lands");
+
+	check(readBurst(0x00, 0xFF) == I2C_STATUS_OK && burstMatches(0x00, 0xFF),
+			"255 byte read, the NBYTES limit");
+	transaction.length = 0xFF;
+	check(i2cMasterSubmit(&transaction) == -1, "255 byte write refused, reg + payload > NBYTES");
+	transaction.length = 0;
+	check(i2cMasterSubmit(&transaction) == -1, "empty transfer refused");
+	transaction.isRead = 1;
+	transaction.length = 6;
+	transaction.data = 0;
+	check(i2cMasterSubmit(&transaction) == -1, "read without a buffer refused");
+}
+
+static void nacks(void) {
+	const i2cStats_t *stats = i2cMasterGetStats();
+	const i2cBusStats_t *bus = i2cBusGetStats();
+	uint32_t recoveries = stats->recoveries;
+	uint32_t stops;
+
+	printf("NACK, no recovery needed\n");
+	stops = bus->stops;
+	check(writeOne(0x50, 0x00, 0x00) == I2C_STATUS_NACK && bus->stops - stops == 1,
+			"absent slave, automatic STOP");
+	i2cBusRegisters[0x1B] = 0x00;
+	i2cBusInject(I2C_FAULT_NACK, 2, 0);
+	check(writeOne(I2C_BUS_SLAVE, 0x1B, 0x77) == I2C_STATUS_NACK
+			&& i2cBusRegisters[0x1B] == 0x00, "written byte NACKed, register unchanged");
+	stops = bus->stops;
+	i2cBusInject(I2C_FAULT_NACK, 1, 0);
+	check(readBurst(0x3B, 6) == I2C_STATUS_NACK && bus->stops - stops == 1,
+			"read register byte NACKed in SOFTEND, bus stopped");
+	i2cBusInject(I2C_FAULT_NACK, 2, 0);
+	check(readBurst(0x3B, 6) == I2C_STATUS_NACK, "read address NACKed after repeated START");
+	check(stats->recoveries == recoveries, "no bus recovery for a NACK");
+	check(readBurst(0x3B, 6) == I2C_STATUS_OK && burstMatches(0x3B, 6), "next read clean");
+}
+
+static void busFaults(void) {
+	const i2cStats_t *stats = i2cMasterGetStats();
+	uint32_t recoveries = stats->recoveries;
+
+	printf("bus faults, recovered\n");
+	i2cBusInject(I2C_FAULT_BUS_ERROR, 4, 0);
+	check(readBurst(0x3B, 14) == I2C_STATUS_BUS_ERROR, "BERR mid read");
+	check(readBurst(0x3B, 14) == I2C_STATUS_OK && burstMatches(0x3B, 14), "next read clean");
+	i2cBusInject(I2C_FAULT_ARB_LOST, 1, 0);
+	check(writeOne(I2C_BUS_SLAVE, 0x1C, 0x42) == I2C_STATUS_ARB_LOST, "ARLO on the register byte");
+	check(writeOne(I2C_BUS_SLAVE, 0x1C, 0x42) == I2C_STATUS_OK
+			&& i2cBusRegisters[0x1C] == 0x42, "next write clean");
+	check(stats->recoveries - recoveries == 2, "one recovery each");
+}
+
+static void stuckSda(void) {
+	const i2cStats_t *stats = i2cMasterGetStats();
+	const i2cBusStats_t *bus = i2cBusGetStats();
+	outcome_t outcome[3];
+	uint32_t recoveries = stats->recoveries;
+	uint32_t timeouts = stats->timeouts;
+	uint32_t clocks;
+	uint32_t ticks;
+	uint8_t i;
+
+	printf("SDA held low\n");
+	i2cBusInject(I2C_FAULT_STUCK_SDA, 5, 7);
+	clocks = bus->recoveryClocks;
+	check(readBurst(0x3B, 14) == I2C_STATUS_ARB_LOST, "slave stuck mid read, NACK bit lost");
+	check(!i2cBusSdaStuck() && bus->recoveryClocks - clocks <= 10
+			&& stats->recoveries - recoveries == 1, "nine clock recovery frees SDA");
+	check(readBurst(0x3B, 14) == I2C_STATUS_OK && burstMatches(0x3B, 14), "next read clean");
+
+	i2cBusHoldSda(I2C_BUS_STUCK_FOREVER);
+	memset(outcome, 0, sizeof(outcome));
+	for (i = 0; i < 3; i++) {
+		i2cMasterWriteReg(I2C_BUS_SLAVE, 0x1D, i, record, &outcome[i]);
+	}
+	recoveries = stats->recoveries;
+	ticks = run();
+	check(outcome[0].status == I2C_STATUS_TIMEOUT && outcome[1].status == I2C_STATUS_TIMEOUT
+			&& outcome[2].status == I2C_STATUS_TIMEOUT && outcome[2].calls == 1,
+			"SDA held for good: each transaction times out, queue drains");
+	check(stats->timeouts - timeouts == 3 && stats->recoveries - recoveries == 3
+			&& ticks <= 3 * (I2C_TIMEOUT_TICKS + 1), "bounded by the timeout each");
+	printf("       %u ticks for 3 transactions\n", (unsigned) ticks);
+
+	i2cBusHoldSda(3);
+	check(writeOne(I2C_BUS_SLAVE, 0x1D, 0x5A) == I2C_STATUS_TIMEOUT && !i2cBusSdaStuck(),
+			"slave lets go, the timeout recovery clears it");
+	check(writeOne(I2C_BUS_SLAVE, 0x1D, 0x5A) == I2C_STATUS_OK
+			&& i2cBusRegisters[0x1D] == 0x5A, "next write clean");
+}
+
+static outcome_t chain[3];
+
+static void chained(i2cStatus_t status, void *context) {
+	outcome_t *outcome = context;
+
+	record(status, context);
+	if (outcome != &chain[2]) {
+		i2cMasterReadRegs(I2C_BUS_SLAVE, 0x3B, readBuffer, 6, chained, outcome + 1);
+	}
+}
+
+static void queueing(void) {
+	outcome_t outcome[I2C_QUEUE_SIZE];
+	uint8_t accepted = 0;
+	uint8_t i;
+
+	printf("queue\n");
+	memset(outcome, 0, sizeof(outcome));
+	for (i = 0; i < I2C_QUEUE_SIZE; i++) {
+		if (i2cMasterWriteReg(I2C_BUS_SLAVE, 0x60 + i, i, record, &outcome[i]) == 0) {
+			accepted++;
+		}
+	}
+	check(accepted == I2C_QUEUE_SIZE - 1, "full queue refuses the last");
+	run();
+	for (i = 0; i < accepted; i++) {
+		if (outcome[i].calls != 1 || outcome[i].status != I2C_STATUS_OK
+				|| i2cBusRegisters[0x60 + i] != i) {
+			break;
+		}
+	}
+	check(i == accepted, "queued writes all land in order");
+
+	memset(chain, 0, sizeof(chain));
+	i2cMasterReadRegs(I2C_BUS_SLAVE, 0x3B, readBuffer, 6, chained, &chain[0]);
+	run();
+	check(chain[0].calls == 1 && chain[1].calls == 1 && chain[2].calls == 1
+			&& chain[2].status == I2C_STATUS_OK, "callbacks queue the next transfer");
+}
+
+int main(void) {
+	const i2cStats_t *stats = i2cMasterGetStats();
+	const i2cBusStats_t *bus = i2cBusGetStats();
+	uint16_t i;
+
+	for (i = 0; i < 0x100; i++) {
+		i2cBusRegisters[i] = (uint8_t) (i * 37 + 11);
+	}
+	i2cBusReset();
+
+	printf("power up with SDA held\n");
+	i2cBusHoldSda(5);
+	i2cMasterInit();
+	check(!i2cBusSdaStuck() && bus->stops == 1, "i2cMasterInit clocks the slave free");
+
+	cleanTransfers();
+	nacks();
+	busFaults();
+	stuckSda();
+	queueing();
+
+	printf("driver stats: %u completed, %u errors, %u timeouts, %u recoveries\n",
+			(unsigned) stats->completed, (unsigned) stats->errors,
+			(unsigned) stats->timeouts, (unsigned) stats->recoveries);
+	if (failures > 0) {
+		printf("FAIL, %d checks\n", failures);
+		return 1;
+	}
+	printf("pass\n");
+	return 0;
+}
@@ -0,0 +1,164 @@
+/************************************************************
+*
+* @file:      input_log.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Record and replay of every input the firmware
+*             consumes, in consumption order
+*
+*             Recording appends each input as the host drivers
+*             hand it to the firmware. Replaying serves them back
+*             strictly in order: a driver asks for the input it
+*             is about to deliver, and gets it only if the next
+*             record has that type and tick. Anything else means
+*             the firmware no longer behaves as it did when
+*             recorded, which the caller reports as a divergence.
+*
+************************************************************/
+
+#include <stdio.h>
+#include "host.h"
+
+#define RECORD_HEADER_SIZE          7
+
+static FILE *file = 0;
+static uint8_t replaying = 0;
+// Replay: header of the next record, read ahead
+static uint8_t pending = 0;
+static uint32_t pendingTick;
+static uint8_t pendingType;
+static uint16_t pendingLength;
+
+static void putU16(uint8_t *out, uint16_t value) {
+	out[0] = (uint8_t) value;
+	out[1] = (uint8_t) (value >> 8);
+}
+
+static void putU32(uint8_t *out, uint32_t value) {
+	putU16(out, (uint16_t) value);
+	putU16(out + 2, (uint16_t) (value >> 16));
+}
+
+static uint16_t getU16(const uint8_t *in) {
+	return (uint16_t) (in[0] | (in[1] << 8));
+}
+
+static uint32_t getU32(const uint8_t *in) {
+	return getU16(in) | ((uint32_t) getU16(in + 2) << 16);
+}
+
+static void readAhead(void) {
+	uint8_t header[RECORD_HEADER_SIZE];
+
+	pending = fread(header, 1, sizeof(header), file) == sizeof(header);
+	if (pending) {
+		pendingTick = getU32(header);
+		pendingType = header[4];
+		pendingLength = getU16(header + 5);
+	}
+}
+
+/************************************************************
+*
+* Function: inputLogOpen
+* @brief:   create a log to record into, or open one to replay
+* @param:   replay, uint8_t, 1 to replay
+* @return:  int, 0 on success, -1 if the file cannot be used
+*
+************************************************************/
+int inputLogOpen(const char *path, uint8_t replay) {
+	uint8_t header[6];
+
+	file = fopen(path, replay ? "rb" : "wb");
+	if (file == 0) {
+		return -1;
+	}
+	replaying = replay;
+	if (!replay) {
+		putU32(header, INPUT_LOG_MAGIC);
+		putU16(header + 4, INPUT_LOG_VERSION);
+		return fwrite(header, 1, sizeof(header), file) == sizeof(header) ? 0 : -1;
+	}
+	if (fread(header, 1, sizeof(header), file) != sizeof(header)
+			|| getU32(header) != INPUT_LOG_MAGIC || getU16(header + 4) != INPUT_LOG_VERSION) {
+		fclose(file);
+		file = 0;
+		return -1;
+	}
+	readAhead();
+	return 0;
+}
+
+/************************************************************
+*
+* Function: inputLogClose
+* @return:  int, 0 on success, -1 if a write failed
+*
+************************************************************/
+int inputLogClose(void) {
+	int status = ferror(file) ? -1 : 0;
+
+	if (fclose(file) != 0) {
+		status = -1;
+	}
+	file = 0;
+	return status;
+}
+
+/************************************************************
+*
+* Function: inputLogReplaying
+* @return:  uint8_t, 1 if inputs come from the log
+*
+************************************************************/
+uint8_t inputLogReplaying(void) {
+	return replaying;
+}
+
+/************************************************************
+*
+* Function: inputLogWrite
+* @brief:   append one input while recording
+* @param:   tick, uint32_t, virtual time it was delivered
+* @return:  int, 0 on success, -1 if too long
+*
+************************************************************/
+int inputLogWrite(uint32_t tick, inputType_t type, const uint8_t *data, uint16_t length) {
+	uint8_t header[RECORD_HEADER_SIZE];
+
+	if (length > INPUT_LOG_MAX_PAYLOAD) {
+		return -1;
+	}
+	putU32(header, tick);
+	header[4] = (uint8_t) type;
+	putU16(header + 5, length);
+	fwrite(header, 1, sizeof(header), file);
+	fwrite(data, 1, length, file);
+	return 0;
+}
+
+/************************************************************
+*
+* Function: inputLogExpect
+* @brief:   take the next recorded input if it is of this type
+*           and tick, else leave it in place
+* @param:   size, uint16_t, room in data
+* @param:   length, uint16_t*, payload bytes copied
+* @return:  int, 0 if taken, -1 if the next record differs or
+*           the log has ended
+*
+************************************************************/
+int inputLogExpect(uint32_t tick, inputType_t type, uint8_t *data, uint16_t size,
+		uint16_t *length) {
+	if (!pending || pendingTick != tick || pendingType != (uint8_t) type || pendingLength > size) {
+		return -1;
+	}
+	if (fread(data, 1, pendingLength, file) != pendingLength) {
+		pending = 0;
+		return -1;
+	}
+	*length = pendingLength;
+	readAhead();
+	return 0;
+}
@@ -0,0 +1,303 @@
+/************************************************************
+*
+* @file:      kalman_test.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     The Q31 Kalman tilt filter against a complementary
+*             filter on identical traces: drift and cost
+*
+*             Build and run from the repository root:
+*
+*               gcc -std=gnu99 -O2 -Ihost -Iinc -o kalman_test \
+*                   host/kalman_test.c src/kalman.c src/fastmath.c \
+*                   src/tables.c -lm
+*               ./kalman_test
+*
+*             Traces are KALMAN_TEST_SECONDS at the sample rate,
+*             made once and fed to every filter: the gyro as
+*             65.5 LSB per deg/s with a bias and white noise, the
+*             accel as Y and Z at 16384 LSB per g with noise and
+*             a motor vibration, turned into a tilt by atan2Q15
+*             as balance.c does. The complementary filter is the
+*             Kalman predict and correct without the bias state,
+*             at the same angle gain as each preset, so both pass
+*             the accel noise alike and only the bias handling
+*             differs. Its steady lean is bias / gain.
+*
+*             Drift is the mean error over the second half of a
+*             trace, after the bias estimate has settled, RMS
+*             the spread around the truth over the same span.
+*             Cycles are Cortex-M0 estimates per update, counted
+*             from the Thumb-1 of a -O2 build with the
+*             KALMAN_TEST_CYCLES_ figures below, the shared
+*             atan2Q15 and gyro scaling left out; host
+*             nanoseconds are printed beside them. Exit status is
+*             1 if a Kalman preset drifts past KALMAN_TEST_BOUND_DRIFT
+*             on a biased trace, or no less than the complementary
+*             filter at its gain, or past KALMAN_TEST_BOUND_OFFSET
+*             with no bias; a truncated bias update failed that.
+*
+************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "kalman.h"
+#include "fastmath.h"
+
+#define KALMAN_TEST_SECONDS         120
+#define KALMAN_TEST_SAMPLES         (KALMAN_TEST_SECONDS * KALMAN_SAMPLE_RATE_HZ)
+#define KALMAN_TEST_GYRO_LSB        65.5        // per deg/s
+#define KALMAN_TEST_ACCEL_LSB       16384.0     // per g
+#define KALMAN_TEST_BIAS_DPS        1.5
+#define KALMAN_TEST_GYRO_NOISE      0.1         // deg/s RMS
+#define KALMAN_TEST_ACCEL_NOISE     0.01        // g RMS per axis
+#define KALMAN_TEST_VIBRATION_G     0.05        // at KALMAN_TEST_VIBRATION_HZ, on Y
+#define KALMAN_TEST_VIBRATION_HZ    37.0
+// Largest Kalman drift allowed on a biased trace, and on the one
+// without bias, where only the filter's own rounding shows, deg
+#define KALMAN_TEST_BOUND_DRIFT     0.02
+#define KALMAN_TEST_BOUND_OFFSET    0.002
+#define KALMAN_TEST_TIMED_PASSES    20
+
+// Estimated cycles: mulQ31, BL __aeabi_lmul with its four 16 x 16
+// MULS and carries, and the 64 bit >> 31
+#define KALMAN_TEST_CYCLES_MULQ31   44
+// kalmanUpdate without its products: loads and stores of angle,
+// bias and gains, predict and innovation
+#define KALMAN_TEST_CYCLES_KALMAN   22
+// The same for the complementary filter, no bias to load or store
+#define KALMAN_TEST_CYCLES_COMP     12
+
+typedef enum {
+	TRACE_STILL = 0,            // level, constant bias
+	TRACE_WARMUP,               // level, bias ramping 0 .. 2x as the die warms
+	TRACE_BALANCING,            // sway and lean steps, constant bias, vibration
+	TRACE_UNBIASED,             // the balancing trace without bias
+	TRACE_COUNT
+} trace_t;
+
+static const char *traceNames[TRACE_COUNT] = {
+	"still", "warm up", "balancing", "no bias"
+};
+
+typedef struct {
+	double drift;               // mean error, deg
+	double rms;                 // deg
+} result_t;
+
+static double truth[KALMAN_TEST_SAMPLES];
+static int16_t gyro[KALMAN_TEST_SAMPLES];
+static int32_t measured[KALMAN_TEST_SAMPLES];
+static int failures = 0;
+
+static void check(int ok, const char *what) {
+	printf("  %-4s %s\n", ok ? "ok" : "FAIL", what);
+	if (!ok) {
+		failures++;
+	}
+}
+
+static double gaussian(void) {
+	double u = (rand() + 1.0) / (RAND_MAX + 2.0);
+	double v = (rand() + 1.0) / (RAND_MAX + 2.0);
+
+	return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+static int16_t toLsb(double value) {
+	value = floor(value + 0.5);
+	return (int16_t) (value > 32767.0 ? 32767.0 : (value < -32768.0 ? -32768.0 : value));
+}
+
+/************************************************************
+*
+* Function: makeTrace
+* @brief:   fill truth, gyro and measured for one trace
+*
+************************************************************/
+static void makeTrace(trace_t trace) {
+	double dt = 1.0 / KALMAN_SAMPLE_RATE_HZ;
+	double angle;
+	double rate;
+	double bias;
+	double t;
+	double y;
+	double z;
+	uint32_t n;
+
+	srand(7);
+	for (n = 0; n < KALMAN_TEST_SAMPLES; n++) {
+		t = n * dt;
+		angle = 0.0;
+		rate = 0.0;
+		bias = KALMAN_TEST_BIAS_DPS;
+		if (trace == TRACE_BALANCING || trace == TRACE_UNBIASED) {
+			// 2 deg sway at 1.2 Hz around a lean that steps every 20 s
+			angle = 2.0 * sin(2.0 * M_PI * 1.2 * t) + 3.0 * (((uint32_t) t / 20) % 3) - 3.0;
+			rate = 2.0 * 2.0 * M_PI * 1.2 * cos(2.0 * M_PI * 1.2 * t);
+			if (n > 0 && ((uint32_t) t / 20) != ((uint32_t) (t - dt) / 20)) {
+				rate += 3.0 * ((((uint32_t) t / 20) % 3) ? 1.0 : -2.0) / dt;
+			}
+		}
+		if (trace == TRACE_WARMUP) {
+			bias *= 2.0 * t / KALMAN_TEST_SECONDS;
+		} else if (trace == TRACE_UNBIASED) {
+			bias = 0.0;
+		}
+		truth[n] = angle;
+		gyro[n] = toLsb((rate + bias + KALMAN_TEST_GYRO_NOISE * gaussian()) * KALMAN_TEST_GYRO_LSB);
+		y = sin(angle * M_PI / 180.0) + KALMAN_TEST_ACCEL_NOISE * gaussian();
+		z = cos(angle * M_PI / 180.0) + KALMAN_TEST_ACCEL_NOISE * gaussian();
+		if (trace == TRACE_BALANCING || trace == TRACE_UNBIASED) {
+			y += KALMAN_TEST_VIBRATION_G * sin(2.0 * M_PI * KALMAN_TEST_VIBRATION_HZ * t);
+		}
+		measured[n] = (int32_t) atan2Q15(toLsb(y * KALMAN_TEST_ACCEL_LSB),
+				toLsb(z * KALMAN_TEST_ACCEL_LSB)) << 16;
+	}
+}
+
+/************************************************************
+*
+* Function: complementaryUpdate
+* @brief:   the reference, kalmanUpdate without the bias state
+* @param:   gain, int32_t, Q31 weight of the accel tilt
+*
+************************************************************/
+static inline int32_t complementaryUpdate(int32_t *angle, int32_t gain, int32_t rate,
+		int32_t measuredAngle) {
+	*angle += rate;
+	*angle += mulQ31(gain, measuredAngle - *angle);
+	return *angle;
+}
+
+static result_t score(const int32_t *estimate) {
+	result_t result = { 0.0, 0.0 };
+	double error;
+	uint32_t n;
+
+	for (n = KALMAN_TEST_SAMPLES / 2; n < KALMAN_TEST_SAMPLES; n++) {
+		error = estimate[n] / (double) ANGLE_PER_DEG - truth[n];
+		result.drift += error;
+		result.rms += error * error;
+	}
+	result.drift /= KALMAN_TEST_SAMPLES / 2;
+	result.rms = sqrt(result.rms / (KALMAN_TEST_SAMPLES / 2) - result.drift * result.drift);
+	return result;
+}
+
+static double elapsed(const struct timespec *start, const struct timespec *end) {
+	return ((end->tv_sec - start->tv_sec) * 1e9 + (end->tv_nsec - start->tv_nsec))
+			/ ((double) KALMAN_TEST_TIMED_PASSES * KALMAN_TEST_SAMPLES);
+}
+
+/************************************************************
+*
+* Function: compare
+* @brief:   run one preset and its complementary filter over the
+*           current trace
+* @param:   kalmanNs, double*, host ns per kalmanUpdate, may be 0
+* @param:   compNs, double*, the same for the complementary
+*           filter, may be 0
+*
+************************************************************/
+static void compare(const kalmanGains_t *gains, result_t *kalman, result_t *comp,
+		double *kalmanNs, double *compNs) {
+	static int32_t estimate[KALMAN_TEST_SAMPLES];
+	struct timespec start;
+	struct timespec end;
+	kalman_t filter;
+	int32_t angle;
+	uint32_t pass;
+	uint32_t n;
+
+	kalmanInit(&filter, gains, measured[0]);
+	for (n = 0; n < KALMAN_TEST_SAMPLES; n++) {
+		estimate[n] = kalmanUpdate(&filter, kalmanGyroToRate(gyro[n]), measured[n]);
+	}
+	*kalman = score(estimate);
+	angle = measured[0];
+	for (n = 0; n < KALMAN_TEST_SAMPLES; n++) {
+		estimate[n] = complementaryUpdate(&angle, gains->angle, kalmanGyroToRate(gyro[n]),
+				measured[n]);
+	}
+	*comp = score(estimate);
+
+	if (kalmanNs == 0 || compNs == 0) {
+		return;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (pass = 0; pass < KALMAN_TEST_TIMED_PASSES; pass++) {
+		kalmanInit(&filter, gains, measured[0]);
+		for (n = 0; n < KALMAN_TEST_SAMPLES; n++) {
+			estimate[n] = kalmanUpdate(&filter, gyro[n], measured[n]);
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	*kalmanNs = elapsed(&start, &end);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (pass = 0; pass < KALMAN_TEST_TIMED_PASSES; pass++) {
+		angle = measured[0];
+		for (n = 0; n < KALMAN_TEST_SAMPLES; n++) {
+			estimate[n] = complementaryUpdate(&angle, gains->angle, gyro[n], measured[n]);
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	*compNs = elapsed(&start, &end);
+}
+
+int main(void) {
+	static const char *presetNames[3] = { "SMOOTH", "DEFAULT", "FAST" };
+	const kalmanGains_t *presets[3] = {
+		&KALMAN_GAINS_SMOOTH, &KALMAN_GAINS_DEFAULT, &KALMAN_GAINS_FAST
+	};
+	result_t kalman;
+	result_t comp;
+	double kalmanNs = 0.0;
+	double compNs = 0.0;
+	char what[96];
+	uint8_t trace;
+	uint8_t preset;
+
+	printf("tilt over the last %d s of %d s at %d Hz, gyro bias %.1f deg/s, deg\n",
+			KALMAN_TEST_SECONDS / 2, KALMAN_TEST_SECONDS, KALMAN_SAMPLE_RATE_HZ,
+			KALMAN_TEST_BIAS_DPS);
+	printf("  %-10s %-8s %10s %9s %10s %9s\n", "trace", "gains", "Kalman", "RMS",
+			"compl.", "RMS");
+	for (trace = 0; trace < TRACE_COUNT; trace++) {
+		makeTrace((trace_t) trace);
+		for (preset = 0; preset < 3; preset++) {
+			compare(presets[preset], &kalman, &comp,
+					trace == TRACE_BALANCING && preset == 1 ? &kalmanNs : 0,
+					trace == TRACE_BALANCING && preset == 1 ? &compNs : 0);
+			printf("  %-10s %-8s %+10.4f %9.4f %+10.4f %9.4f\n", traceNames[trace],
+					presetNames[preset], kalman.drift, kalman.rms, comp.drift, comp.rms);
+			if (trace == TRACE_UNBIASED) {
+				snprintf(what, sizeof(what), "%s, %s: Kalman offset within %.3f deg",
+						traceNames[trace], presetNames[preset], KALMAN_TEST_BOUND_OFFSET);
+				check(fabs(kalman.drift) <= KALMAN_TEST_BOUND_OFFSET, what);
+				continue;
+			}
+			snprintf(what, sizeof(what), "%s, %s: Kalman drift within %.2f deg, under the "
+					"complementary filter's", traceNames[trace], presetNames[preset],
+					KALMAN_TEST_BOUND_DRIFT);
+			check(fabs(kalman.drift) <= KALMAN_TEST_BOUND_DRIFT
+					&& fabs(kalman.drift) < fabs(comp.drift), what);
+		}
+	}
+
+	printf("\nper update           M0 cycles, est.   host ns\n");
+	printf("  kalmanUpdate       %17d %9.2f\n",
+			KALMAN_TEST_CYCLES_KALMAN + 2 * KALMAN_TEST_CYCLES_MULQ31, kalmanNs);
+	printf("  complementary      %17d %9.2f\n",
+			KALMAN_TEST_CYCLES_COMP + KALMAN_TEST_CYCLES_MULQ31, compNs);
+
+	if (failures > 0) {
+		printf("FAIL, %d checks\n", failures);
+		return 1;
+	}
+	printf("pass\n");
+	return 0;
+}
@@ -0,0 +1,194 @@
+/************************************************************
+*
+* @file:      lqr_bench.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     lqrUpdate against the same control law through
+*             arm_mat_mult_q15: agreement, error and cost
+*
+*             Build and run from the repository root:
+*
+*               gcc -std=gnu99 -O2 -Ihost -Iinc -o lqr_bench \
+*                   host/lqr_bench.c host/arm_matrix.c src/lqr.c -lm
+*               ./lqr_bench
+*
+*             Both take LQR_GAINS_DEFAULT and LQR_BENCH_STATES
+*             random Q15 states, half of them over the full range
+*             and half within the +-1/16 the balancing robot
+*             actually sees. The library path is a 1x4 gain
+*             matrix times a 4x1 state, its Q15 result shifted
+*             back up by LQR_GAIN_SHIFT and negated, which drops
+*             the low LQR_GAIN_SHIFT bits; lqrUpdate keeps them.
+*             Errors are against the exact -K x in double, in
+*             output LSB.
+*
+*             Cost: host nanoseconds per update, and Cortex-M0
+*             cycle estimates counted from the Thumb-1 of a -O2
+*             build with the LQR_BENCH_CYCLES_ figures below. On
+*             target the whole inner loop, lqrUpdate included,
+*             is the balance.c inner profile the shell prof
+*             command prints. Exit status is 1 if lqrUpdate is
+*             off by more than LQR_BENCH_BOUND_UNROLLED, the two
+*             differ by more than the library's dropped bits
+*             allow, or the library path is not the dearer.
+*
+************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "arm_math.h"
+#include "lqr.h"
+
+#define LQR_BENCH_STATES            (1 << 20)
+#define LQR_BENCH_PASSES            16
+// Worst error allowed, output LSB: the four >> 2 and the final
+// shift each truncate
+#define LQR_BENCH_BOUND_UNROLLED    2.0
+#define LQR_BENCH_BOUND_LIBRARY     (LQR_BENCH_BOUND_UNROLLED + (1 << LQR_GAIN_SHIFT))
+
+// Estimated cycles, lqrUpdate inline: four pairs of LDRSH, MULS,
+// ASRS, ADDS, then the shift, negate and saturateQ15
+#define LQR_BENCH_CYCLES_UNROLLED   (4 * 7 + 10)
+// arm_mat_mult_q15: BL and the push and pop, the instance loads
+// and loop set up, the row and column loop once
+#define LQR_BENCH_CYCLES_CALL       (4 + 12 + 24 + 16)
+// One inner loop term: two LDRSH, MULS, 64 bit add with its sign,
+// the B stride, SUBS and the taken branch
+#define LQR_BENCH_CYCLES_TERM       (4 + 1 + 3 + 1 + 1 + 3)
+// The >> 15 of the 64 bit sum, saturate, store, then the caller's
+// << LQR_GAIN_SHIFT, negate and saturateQ15
+#define LQR_BENCH_CYCLES_TAIL       (4 + 6 + 2 + 10)
+#define LQR_BENCH_CYCLES_LIBRARY    (LQR_BENCH_CYCLES_CALL + LQR_STATES * LQR_BENCH_CYCLES_TERM \
+		+ LQR_BENCH_CYCLES_TAIL)
+
+static int16_t states[LQR_BENCH_STATES][LQR_STATES];
+static q15_t gainData[LQR_STATES];
+static arm_matrix_instance_q15 gainMatrix;
+static int failures = 0;
+
+static void check(int ok, const char *what) {
+	printf("  %-4s %s\n", ok ? "ok" : "FAIL", what);
+	if (!ok) {
+		failures++;
+	}
+}
+
+/************************************************************
+*
+* Function: lqrUpdateMatrix
+* @brief:   u = -K x through arm_mat_mult_q15
+*
+************************************************************/
+static int16_t lqrUpdateMatrix(const arm_matrix_instance_q15 *gain, int16_t *state) {
+	arm_matrix_instance_q15 x;
+	arm_matrix_instance_q15 u;
+	q15_t out;
+
+	arm_mat_init_q15(&x, LQR_STATES, 1, state);
+	arm_mat_init_q15(&u, 1, 1, &out);
+	arm_mat_mult_q15(gain, &x, &u, 0);
+	return saturateQ15(-((int32_t) out << LQR_GAIN_SHIFT));
+}
+
+static double exact(const int16_t *state) {
+	double sum = 0.0;
+	uint8_t i;
+
+	for (i = 0; i < LQR_STATES; i++) {
+		sum += (double) LQR_GAINS_DEFAULT.gain[i] * state[i];
+	}
+	sum = -sum / (1 << (15 - LQR_GAIN_SHIFT));
+	return sum > 32767.0 ? 32767.0 : (sum < -32768.0 ? -32768.0 : sum);
+}
+
+static double elapsed(const struct timespec *start, const struct timespec *end) {
+	return ((end->tv_sec - start->tv_sec) * 1e9 + (end->tv_nsec - start->tv_nsec))
+			/ ((double) LQR_BENCH_PASSES * LQR_BENCH_STATES);
+}
+
+int main(void) {
+	struct timespec start;
+	struct timespec end;
+	volatile int32_t sink;
+	double worstUnrolled = 0.0;
+	double worstLibrary = 0.0;
+	double unrolledNs;
+	double libraryNs;
+	double reference;
+	int32_t sum;
+	int32_t worstApart = 0;
+	int16_t unrolled;
+	int16_t library;
+	char what[96];
+	uint32_t pass;
+	uint32_t n;
+	uint8_t i;
+
+	for (i = 0; i < LQR_STATES; i++) {
+		gainData[i] = LQR_GAINS_DEFAULT.gain[i];
+	}
+	arm_mat_init_q15(&gainMatrix, 1, LQR_STATES, gainData);
+	srand(5);
+	for (n = 0; n < LQR_BENCH_STATES; n++) {
+		for (i = 0; i < LQR_STATES; i++) {
+			states[n][i] = (int16_t) (rand() % 65536 - 32768);
+			if (n & 1) {
+				states[n][i] >>= 4;
+			}
+		}
+	}
+
+	for (n = 0; n < LQR_BENCH_STATES; n++) {
+		reference = exact(states[n]);
+		unrolled = lqrUpdate(&LQR_GAINS_DEFAULT, states[n]);
+		library = lqrUpdateMatrix(&gainMatrix, states[n]);
+		worstUnrolled = fmax(worstUnrolled, fabs(unrolled - reference));
+		worstLibrary = fmax(worstLibrary, fabs(library - reference));
+		worstApart = abs(unrolled - library) > worstApart ? abs(unrolled - library) : worstApart;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	sum = 0;
+	for (pass = 0; pass < LQR_BENCH_PASSES; pass++) {
+		for (n = 0; n < LQR_BENCH_STATES; n++) {
+			sum += lqrUpdate(&LQR_GAINS_DEFAULT, states[n]);
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	sink = sum;
+	unrolledNs = elapsed(&start, &end);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	sum = 0;
+	for (pass = 0; pass < LQR_BENCH_PASSES; pass++) {
+		for (n = 0; n < LQR_BENCH_STATES; n++) {
+			sum += lqrUpdateMatrix(&gainMatrix, states[n]);
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	sink = sum;
+	(void) sink;
+	libraryNs = elapsed(&start, &end);
+
+	printf("u = -K x, LQR_GAINS_DEFAULT, %d states\n", LQR_BENCH_STATES);
+	printf("  %-18s %10s %17s %9s\n", "", "worst LSB", "M0 cycles, est.", "host ns");
+	printf("  %-18s %10.2f %17d %9.2f\n", "lqrUpdate", worstUnrolled,
+			LQR_BENCH_CYCLES_UNROLLED, unrolledNs);
+	printf("  %-18s %10.2f %17d %9.2f\n", "arm_mat_mult_q15", worstLibrary,
+			LQR_BENCH_CYCLES_LIBRARY, libraryNs);
+	snprintf(what, sizeof(what), "lqrUpdate within %.0f LSB of -K x", LQR_BENCH_BOUND_UNROLLED);
+	check(worstUnrolled <= LQR_BENCH_BOUND_UNROLLED, what);
+	snprintf(what, sizeof(what), "arm_mat_mult_q15 within %.0f LSB, %d apart at most",
+			LQR_BENCH_BOUND_LIBRARY, (int) worstApart);
+	check(worstLibrary <= LQR_BENCH_BOUND_LIBRARY && worstApart <= LQR_BENCH_BOUND_LIBRARY, what);
+	check(libraryNs > unrolledNs, "arm_mat_mult_q15 dearer on the host too");
+
+	if (failures > 0) {
+		printf("FAIL, %d checks\n", failures);
+		return 1;
+	}
+	printf("pass\n");
+	return 0;
+}
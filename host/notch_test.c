@@ -0,0 +1,196 @@
+/************************************************************
+*
+* @file:      notch_test.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Attenuation, restart transient and per sample cost
+*             of the adaptive step notch on synthetic step
+*             synchronous vibration
+*
+*             Build and run from the repository root:
+*
+*               gcc -std=gnu99 -O2 -DARM_MATH_CM0 -Ihost -Iinc \
+*                   -o notch_test host/notch_test.c host/arm_biquad.c \
+*                   src/adaptive_notch.c src/tables.c -lm
+*               ./notch_test
+*
+*             The gyro axis carries a slow 1 Hz motion plus a tone
+*             at the step cycle frequency, rate / 16, and the wheel
+*             period is fed to adaptiveNotchTune each tick as
+*             stepperGetPeriod returns it. Attenuation is the tone
+*             amplitude out over in, by a single bin DFT after the
+*             notch settles, at a bin centre and half a bin off it,
+*             where the rounding in adaptiveNotchBin is worst. The
+*             restart case stops the wheel for two seconds while
+*             the signal moves, then runs it up into the table
+*             range again; a stage whose history froze in bypass
+*             rings there. The host cost is per sample, filtering
+*             one sample a call and a SENSOR_MAX_BATCH batch a
+*             call as balanceStep does after a late read. Exit
+*             status is 1 if a centre attenuates less than
+*             NOTCH_TEST_MIN_DB, the restart error exceeds
+*             NOTCH_TEST_MAX_RING or the batch costs more per
+*             sample than single calls.
+*
+************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "adaptive_notch.h"
+
+#define NOTCH_TEST_TONE             3000.0
+#define NOTCH_TEST_MOTION           2000.0
+#define NOTCH_TEST_SETTLE           1000
+#define NOTCH_TEST_WINDOW           2000
+#define NOTCH_TEST_MIN_DB           20.0
+// Largest output error after a restart, LSB of a full scale 32768
+#define NOTCH_TEST_MAX_RING         200
+#define NOTCH_TEST_TIMED_SAMPLES    4000000
+
+static adaptiveNotch_t notch;
+
+static uint16_t periodOf(double rate) {
+	return rate < STEPPER_MIN_RATE ? 0 : (uint16_t) (STEPPER_TIMER_HZ / rate);
+}
+
+static int16_t runTick(uint16_t period, double value) {
+	imuSample_t sample;
+
+	memset(&sample, 0, sizeof(sample));
+	sample.axis[IMU_GYRO_X] = (int16_t) lrint(value);
+	adaptiveNotchTune(&notch, STEPPER_LEFT, period);
+	adaptiveNotchTune(&notch, STEPPER_RIGHT, period);
+	adaptiveNotchProcess(&notch, &sample, 1);
+	return sample.axis[IMU_GYRO_X];
+}
+
+/************************************************************
+*
+* Function: attenuation
+* @brief:   steady tone at the step cycle frequency of rate
+* @return:  double, attenuation of the tone in dB
+*
+************************************************************/
+static double attenuation(double rate) {
+	double hz = rate / NOTCH_STEPS_PER_CYCLE;
+	double re = 0.0;
+	double im = 0.0;
+	double phase;
+	int16_t out;
+	int n;
+
+	adaptiveNotchInit(&notch, 1 << IMU_GYRO_X);
+	for (n = 0; n < NOTCH_TEST_SETTLE + NOTCH_TEST_WINDOW; n++) {
+		phase = 2.0 * M_PI * hz * n / NOTCH_SAMPLE_HZ;
+		out = runTick(periodOf(rate), NOTCH_TEST_MOTION * sin(2.0 * M_PI * n / NOTCH_SAMPLE_HZ)
+				+ NOTCH_TEST_TONE * sin(phase));
+		if (n >= NOTCH_TEST_SETTLE) {
+			re += out * cos(phase);
+			im += out * sin(phase);
+		}
+	}
+	return 20.0 * log10(NOTCH_TEST_TONE / (2.0 * hypot(re, im) / NOTCH_TEST_WINDOW));
+}
+
+/************************************************************
+*
+* Function: restartError
+* @brief:   run at rate, stop while the signal steps from +level
+*           to -level, run at rate again
+* @return:  int, largest |out - in| in the 200 ms after restart
+*
+************************************************************/
+static int restartError(double rate) {
+	double level = 8000.0;
+	int worst = 0;
+	int error;
+	int n;
+
+	adaptiveNotchInit(&notch, 1 << IMU_GYRO_X);
+	for (n = 0; n < 1000; n++) {
+		runTick(periodOf(rate), level);
+	}
+	for (n = 0; n < 2000; n++) {
+		runTick(0, n < 1000 ? level : -level);
+	}
+	for (n = 0; n < 200; n++) {
+		error = abs(runTick(periodOf(rate), -level) + (int) level);
+		if (error > worst) {
+			worst = error;
+		}
+	}
+	return worst;
+}
+
+/************************************************************
+*
+* Function: timeBatch
+* @brief:   NOTCH_TEST_TIMED_SAMPLES through the notch, count
+*           samples a call
+* @return:  double, host ns per sample
+*
+************************************************************/
+static double timeBatch(imuSample_t *samples, uint16_t count) {
+	struct timespec start;
+	struct timespec end;
+	uint32_t n;
+	uint16_t k;
+	uint8_t i;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (n = 0; n < NOTCH_TEST_TIMED_SAMPLES; n += count) {
+		for (k = 0; k < count; k++) {
+			for (i = 0; i < IMU_AXIS_COUNT; i++) {
+				samples[k].axis[i] = (int16_t) ((n + k) * (i + 7));
+			}
+		}
+		adaptiveNotchProcess(&notch, samples, count);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	return ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec))
+			/ NOTCH_TEST_TIMED_SAMPLES;
+}
+
+int main(void) {
+	static imuSample_t samples[IMU_FILTER_MAX_BATCH];
+	double centre;
+	double offset;
+	double worstCentre = 1e9;
+	double single;
+	double batch;
+	int ring;
+	int hz;
+
+	printf("  Hz  rate   centre dB  half bin dB\n");
+	for (hz = NOTCH_FIRST_HZ; hz <= NOTCH_LAST_HZ; hz += 5 * NOTCH_STEP_HZ) {
+		centre = attenuation(hz * NOTCH_STEPS_PER_CYCLE);
+		offset = attenuation((hz + 0.49 * NOTCH_STEP_HZ) * NOTCH_STEPS_PER_CYCLE);
+		printf("%4d %5d %10.1f %12.1f\n", hz, hz * NOTCH_STEPS_PER_CYCLE, centre, offset);
+		if (centre < worstCentre) {
+			worstCentre = centre;
+		}
+	}
+	ring = restartError((NOTCH_FIRST_HZ + NOTCH_STEP_HZ) * NOTCH_STEPS_PER_CYCLE);
+	printf("restart after 2 s stopped: max error %d LSB\n", ring);
+
+	// Cost as balanceStep runs it: both wheels in range, four axes
+	adaptiveNotchInit(&notch, (1 << IMU_ACCEL_X) | (1 << IMU_ACCEL_Y)
+			| (1 << IMU_ACCEL_Z) | (1 << IMU_GYRO_X));
+	adaptiveNotchTune(&notch, STEPPER_LEFT, periodOf(1600));
+	adaptiveNotchTune(&notch, STEPPER_RIGHT, periodOf(1700));
+	single = timeBatch(samples, 1);
+	batch = timeBatch(samples, SENSOR_MAX_BATCH);
+	printf("host cost: %.1f ns per sample, %.1f in batches of %d, 4 axes x %d stages (%d)\n",
+			single, batch, SENSOR_MAX_BATCH, STEPPER_COUNT, samples[0].axis[IMU_GYRO_X]);
+
+	if (worstCentre < NOTCH_TEST_MIN_DB || ring > NOTCH_TEST_MAX_RING || batch > single) {
+		printf("FAIL\n");
+		return 1;
+	}
+	printf("pass\n");
+	return 0;
+}
@@ -0,0 +1,265 @@
+/************************************************************
+*
+* @file:      plant.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Simulated robot for recording in the Linux build:
+*             an inverted pendulum on the left wheel and the
+*             MPU9250 on the I2C bus
+*
+*             Only recording runs the plant; a replay takes the
+*             bus from the log and needs neither the model nor
+*             its random numbers. The pendulum is the body's tilt,
+*             driven by the wheel acceleration from the commanded
+*             step rate, theta'' = (g sin theta - a cos theta) / l,
+*             with sensor noise, step frequency vibration and,
+*             optionally, a random push every pushTicks. The
+*             sensor answers with the register layout the driver
+*             reads: a FIFO of accel/temp/gyro records with the
+*             AK8963 copy behind each, valid once SLV1 has put the
+*             AK8963 in 16 bit continuous mode, and the fuse ROM
+*             while SLV1 points there. Its sample clock runs a
+*             little fast against the tick, so every
+*             PLANT_CLOCK_SLIP_TICKS a second record is waiting.
+*             Anything else on the bus is not acknowledged.
+*
+************************************************************/
+
+#include <math.h>
+#include "mpu9250.h"
+#include "timebase.h"
+#include "host.h"
+
+#define PLANT_GRAVITY               9.81
+#define PLANT_LENGTH                0.12            // m, axle to centre of mass
+#define PLANT_WHEEL_RADIUS          0.065           // m
+#define PLANT_TILT_LIMIT            1.4             // rad, lying on the bumper
+#define PLANT_DT                    (1.0 / TICK_RATE_HZ)
+// +-4 g and +-500 dps full scale
+#define PLANT_ACCEL_LSB             8192.0
+#define PLANT_GYRO_LSB              (65.5 * 180.0 / M_PI)
+#define PLANT_ACCEL_NOISE           60.0
+#define PLANT_GYRO_NOISE            15.0
+#define PLANT_GYRO_BIAS             20.0
+#define PLANT_PUSH_RATE             3.0             // rad/s, largest push
+// The vibration comes from the full step rate, 16 microsteps each
+#define PLANT_MICROSTEPS            16
+// AK8963 field, its own axis order, little endian counts
+#define PLANT_MAG_X                 120
+#define PLANT_MAG_Y                 -80
+#define PLANT_MAG_Z                 -300
+#define PLANT_ASA                   128
+#define PLANT_MAG_MODE              0x16            // CNTL1, 16 bit continuous 2
+// 0.25% fast, one extra sample every this many ticks
+#define PLANT_CLOCK_SLIP_TICKS      400
+
+static double tilt;
+static double tiltRate;
+static double lastSpeed;
+static double vibrationPhase;
+static uint32_t noiseState;
+static uint32_t pushPeriod;
+static uint8_t registers[128];
+static uint8_t fifo[MPU9250_FIFO_SIZE];
+static uint16_t fifoLength;
+static uint8_t magMode;             // AK8963 CNTL1 as SLV1 last wrote it
+
+static uint32_t nextRandom(void) {
+	noiseState ^= noiseState << 13;
+	noiseState ^= noiseState >> 17;
+	noiseState ^= noiseState << 5;
+	return noiseState;
+}
+
+static double uniform(void) {
+	return (nextRandom() + 1.0) / 4294967297.0;
+}
+
+static double gaussian(void) {
+	return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+}
+
+static int16_t reading(double value) {
+	value = floor(value + 0.5);
+	if (value > 32767.0) {
+		return 32767;
+	}
+	if (value < -32768.0) {
+		return -32768;
+	}
+	return (int16_t) value;
+}
+
+static void putBigEndian(uint8_t *out, int16_t value) {
+	out[0] = (uint8_t) ((uint16_t) value >> 8);
+	out[1] = (uint8_t) value;
+}
+
+static void putLittleEndian(uint8_t *out, int16_t value) {
+	out[0] = (uint8_t) value;
+	out[1] = (uint8_t) ((uint16_t) value >> 8);
+}
+
+/************************************************************
+*
+* Function: plantInit
+* @brief:   stand the robot up, slightly off balance
+* @param:   seed, uint32_t, noise and push seed, not 0
+* @param:   pushTicks, uint32_t, ticks between pushes, 0 for none
+*
+************************************************************/
+void plantInit(uint32_t seed, uint32_t pushTicks) {
+	tilt = 0.03;
+	tiltRate = 0.0;
+	lastSpeed = 0.0;
+	vibrationPhase = 0.0;
+	noiseState = seed != 0 ? seed : 1;
+	pushPeriod = pushTicks;
+	fifoLength = 0;
+	magMode = 0;
+}
+
+static void makeRecord(uint8_t *data) {
+	uint8_t magValid = magMode == PLANT_MAG_MODE && registers[MPU9250_I2C_SLV0_REG] == AK8963_HXL;
+
+	putBigEndian(&data[0], reading(40.0 * gaussian()));
+	putBigEndian(&data[2], reading(PLANT_ACCEL_LSB * sin(tilt)
+			+ PLANT_ACCEL_NOISE * gaussian() + 300.0 * sin(vibrationPhase)));
+	putBigEndian(&data[4], reading(PLANT_ACCEL_LSB * cos(tilt)
+			+ PLANT_ACCEL_NOISE * gaussian() + 200.0 * cos(vibrationPhase)));
+	putBigEndian(&data[6], 0);
+	putBigEndian(&data[8], reading(PLANT_GYRO_LSB * tiltRate + PLANT_GYRO_NOISE * gaussian()
+			+ 40.0 * sin(vibrationPhase) + PLANT_GYRO_BIAS));
+	putBigEndian(&data[10], reading(PLANT_GYRO_NOISE * gaussian()));
+	putBigEndian(&data[12], reading(PLANT_GYRO_NOISE * gaussian()));
+	putLittleEndian(&data[14], magValid ? PLANT_MAG_X : 0);
+	putLittleEndian(&data[16], magValid ? PLANT_MAG_Y : 0);
+	putLittleEndian(&data[18], magValid ? PLANT_MAG_Z : 0);
+	data[20] = magValid ? AK8963_ST2_BITM : 0;
+}
+
+/************************************************************
+*
+* Function: sampleFifo
+* @brief:   one sensor sample into the FIFO while it is enabled;
+*           a full FIFO keeps what fits, as with CONFIG FIFO_MODE
+*
+************************************************************/
+static void sampleFifo(void) {
+	uint8_t record[MPU9250_RECORD_LENGTH];
+	uint16_t i;
+
+	if (!(registers[MPU9250_USER_CTRL] & MPU9250_USER_FIFO_EN)
+			|| registers[MPU9250_FIFO_EN] != MPU9250_FIFO_RECORD_SOURCES) {
+		return;
+	}
+	makeRecord(record);
+	for (i = 0; i < MPU9250_RECORD_LENGTH && fifoLength < MPU9250_FIFO_SIZE; i++) {
+		fifo[fifoLength++] = record[i];
+	}
+}
+
+/************************************************************
+*
+* Function: plantStep
+* @brief:   advance the robot by one tick under the wheel rate
+*           commanded now
+*
+************************************************************/
+void plantStep(void) {
+	int32_t rate = stepperGetRate(STEPPER_LEFT);
+	double speed = rate * 2.0 * M_PI * PLANT_WHEEL_RADIUS / STEPPER_STEPS_PER_REV;
+	double acceleration = (speed - lastSpeed) / PLANT_DT;
+
+	lastSpeed = speed;
+	tiltRate += (PLANT_GRAVITY * sin(tilt) - acceleration * cos(tilt)) / PLANT_LENGTH * PLANT_DT;
+	tilt += tiltRate * PLANT_DT;
+	vibrationPhase += 2.0 * M_PI * (rate < 0 ? -rate : rate) / PLANT_MICROSTEPS * PLANT_DT;
+	if (pushPeriod != 0 && tickCount % pushPeriod == 0) {
+		tiltRate += PLANT_PUSH_RATE * (2.0 * uniform() - 1.0);
+	}
+	if (tilt > PLANT_TILT_LIMIT || tilt < -PLANT_TILT_LIMIT) {
+		tilt = tilt > 0 ? PLANT_TILT_LIMIT : -PLANT_TILT_LIMIT;
+		tiltRate = 0.0;
+	}
+	sampleFifo();
+	if (tickCount % PLANT_CLOCK_SLIP_TICKS == 0) {
+		sampleFifo();
+	}
+}
+
+/************************************************************
+*
+* Function: writeRegister
+* @brief:   store a register, with the side effects the driver
+*           relies on: FIFO reset and AK8963 commands through SLV1
+*
+************************************************************/
+static void writeRegister(uint8_t reg, uint8_t value) {
+	reg &= 0x7F;
+	if (reg == MPU9250_USER_CTRL && (value & MPU9250_USER_FIFO_RST)) {
+		fifoLength = 0;
+		value &= ~MPU9250_USER_FIFO_RST;
+	}
+	registers[reg] = value;
+	if (reg == MPU9250_I2C_SLV1_CTRL && (value & 0x80)
+			&& registers[MPU9250_I2C_SLV1_ADDR] == AK8963_ADDRESS
+			&& registers[MPU9250_I2C_SLV1_REG] == AK8963_CNTL1) {
+		magMode = registers[MPU9250_I2C_SLV1_DO];
+	}
+}
+
+static void readFifo(uint8_t *data, uint8_t length) {
+	uint16_t taken = length < fifoLength ? length : fifoLength;
+	uint16_t i;
+
+	for (i = 0; i < length; i++) {
+		data[i] = i < taken ? fifo[i] : 0xFF;
+	}
+	for (i = taken; i < fifoLength; i++) {
+		fifo[i - taken] = fifo[i];
+	}
+	fifoLength -= taken;
+}
+
+/************************************************************
+*
+* Function: plantTransfer
+* @brief:   answer one bus transaction as the MPU9250 would
+* @return:  i2cStatus_t, NACK for any other device or read
+*
+************************************************************/
+i2cStatus_t plantTransfer(const i2cTransaction_t *transaction) {
+	uint8_t i;
+
+	if (transaction->address != MPU9250_ADDRESS) {
+		return I2C_STATUS_NACK;
+	}
+	if (!transaction->isRead) {
+		if (transaction->data == 0) {
+			writeRegister(transaction->reg, transaction->value);
+		} else {
+			for (i = 0; i < transaction->length; i++) {
+				writeRegister(transaction->reg + i, transaction->data[i]);
+			}
+		}
+		return I2C_STATUS_OK;
+	}
+	if (transaction->reg == MPU9250_FIFO_COUNTH && transaction->length == 2) {
+		transaction->data[0] = (uint8_t) (fifoLength >> 8);
+		transaction->data[1] = (uint8_t) fifoLength;
+	} else if (transaction->reg == MPU9250_FIFO_R_W) {
+		readFifo(transaction->data, transaction->length);
+	} else if (transaction->reg == MPU9250_EXT_SENS_DATA_00 + AK8963_READ_LENGTH
+			&& registers[MPU9250_I2C_SLV1_REG] == AK8963_ASAX && transaction->length <= 3) {
+		for (i = 0; i < transaction->length; i++) {
+			transaction->data[i] = PLANT_ASA;
+		}
+	} else if (transaction->reg == MPU9250_WHO_AM_I && transaction->length == 1) {
+		transaction->data[0] = MPU9250_WHO_AM_I_VALUE;
+	} else {
+		return I2C_STATUS_NACK;
+	}
+	return I2C_STATUS_OK;
+}
@@ -0,0 +1,392 @@
+/************************************************************
+*
+* @file:      replay.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Rerun a recorded run through the host compiled
+*             filters, tilt estimate and LQR, and report where
+*             the outputs part from the recorded ones
+*
+*             Record with "tel" and TELEMETRY_REPLAY_MASK, then
+*             decode to CSV:
+*
+*               python3 tools/telemetry_decode.py --port /dev/ttyUSB0 \
+*                   --baud 3000000 --mask replay --save run.bin --csv run.csv
+*
+*             and build and run from the repository root, against
+*             whatever src/ holds now:
+*
+*               gcc -std=gnu99 -O2 -DARM_MATH_CM0 -DSTM32F051 \
+*                   -DUSE_STDPERIPH_DRIVER -ICMSIS/core -ICMSIS/device \
+*                   -IStdPeriph_Driver/inc -Iinc -o replay host/replay.c \
+*                   host/arm_biquad.c src/adaptive_notch.c src/imu_filter.c \
+*                   src/kalman.c src/lqr.c src/fastmath.c src/tables.c -lm
+*               ./replay [-b] [-s ticks] [-l tilt,rate,pos,vel] \
+*                   [-k angle,bias] [-v] run.csv
+*
+*             Each tick mirrors balanceStep: a fresh sample is
+*             notched at the recorded step periods and low passed,
+*             the Kalman tilt runs every tick, and on LQR ticks
+*             the command is rebuilt from the replayed tilt and
+*             rate and the recorded hold error, setpoint and last
+*             velocity. Ticks under the PID, the auto-tune relay or
+*             the PRBS are not compared. Gains are the firmware
+*             defaults unless given as after "set".
+*
+*             A recording started with TELEMETRY_BOOT_MASK holds
+*             every tick from power up; with -b the replay starts
+*             from the firmware's reset state and must match bit
+*             for bit. Otherwise the Kalman angle is seeded from
+*             the first recorded tilt, with the bias and filter
+*             histories unknown, and -s ticks settle before
+*             anything is compared; the same after every gap.
+*             A tick that filtered a batch of samples logs only
+*             the newest, so it counts as a gap too.
+*             Exit status is 1 if any compared tick differs.
+*
+************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <unistd.h>
+#include "telemetry.h"
+#include "imu_filter.h"
+#include "adaptive_notch.h"
+#include "kalman.h"
+#include "lqr.h"
+#include "fastmath.h"
+#include "timebase.h"
+
+#define REPLAY_LINE_SIZE            512
+#define REPLAY_SETTLE_TICKS         200
+#define REPLAY_VERBOSE_LINES        20
+
+static const char *const channelNames[TELEMETRY_CHANNEL_COUNT] = {
+	"accel_x", "accel_y", "accel_z", "gyro_x", "gyro_y", "gyro_z",
+	"tilt", "setpoint", "command", "velocity", "position",
+	"step_left", "step_right", "hold_error", "mode",
+};
+
+typedef struct {
+	uint32_t compared;
+	uint32_t differ;
+	int32_t maxError;
+	double squares;
+} replayError_t;
+
+static imuFilter_t imuFilter;
+static adaptiveNotch_t stepNotch;
+static kalman_t tiltFilter;
+static kalmanGains_t kalmanGains;
+static lqrGains_t gains;
+static imuSample_t sample;
+
+static void resetFilters(void) {
+	imuFilterInit(&imuFilter);
+	imuFilterConfigure(&imuFilter, IMU_ACCEL_X, &IMU_FILTER_LOWPASS_40HZ);
+	imuFilterConfigure(&imuFilter, IMU_ACCEL_Y, &IMU_FILTER_LOWPASS_40HZ);
+	imuFilterConfigure(&imuFilter, IMU_ACCEL_Z, &IMU_FILTER_LOWPASS_40HZ);
+	adaptiveNotchInit(&stepNotch, (1 << IMU_ACCEL_X) | (1 << IMU_ACCEL_Y)
+			| (1 << IMU_ACCEL_Z) | (1 << IMU_GYRO_X));
+	memset(&sample, 0, sizeof(sample));
+}
+
+static int parseList(const char *text, int32_t *values, int count) {
+	char *end;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		values[i] = (int32_t) strtol(text, &end, 0);
+		if (end == text || *end != (i == count - 1 ? '\0' : ',')) {
+			return -1;
+		}
+		text = end + 1;
+	}
+	return 0;
+}
+
+/************************************************************
+*
+* Function: parseHeader
+* @brief:   map the decoder's CSV columns to channels
+* @param:   column, int*, telemetryChannel_t of each column after
+*           the tick, -1 if unknown
+* @return:  uint16_t, mask of the channels present
+*
+************************************************************/
+static uint16_t parseHeader(char *line, int *column, int *columns) {
+	uint16_t mask = 0;
+	char *name;
+	int i;
+
+	*columns = 0;
+	strtok(line, ",\r\n");
+	while ((name = strtok(0, ",\r\n")) != 0 && *columns < TELEMETRY_CHANNEL_COUNT) {
+		column[*columns] = -1;
+		for (i = 0; i < TELEMETRY_CHANNEL_COUNT; i++) {
+			if (strcmp(name, channelNames[i]) == 0) {
+				column[*columns] = i;
+				mask |= 1 << i;
+			}
+		}
+		(*columns)++;
+	}
+	return mask;
+}
+
+/************************************************************
+*
+* Function: parseRow
+* @brief:   read one tick of the CSV
+* @return:  int, 1 for a record, 0 for a tick the decoder left
+*           empty, -1 for a malformed line
+*
+************************************************************/
+static int parseRow(const char *line, const int *column, int columns, long *tick,
+		int16_t channels[TELEMETRY_CHANNEL_COUNT]) {
+	const char *cursor = line;
+	char *end;
+	long value;
+	int i;
+
+	*tick = strtol(cursor, &end, 10);
+	if (end == cursor || *end != ',') {
+		return -1;
+	}
+	for (i = 0; i < columns; i++) {
+		cursor = end + 1;
+		if (*cursor == ',' || *cursor == '\r' || *cursor == '\n' || *cursor == '\0') {
+			return 0;
+		}
+		value = strtol(cursor, &end, 10);
+		if (end == cursor) {
+			return -1;
+		}
+		if (column[i] >= 0) {
+			// Unsigned channels come back as the same bits
+			channels[column[i]] = (int16_t) (uint16_t) value;
+		}
+	}
+	return 1;
+}
+
+static void addError(replayError_t *error, int32_t difference) {
+	int32_t magnitude = difference < 0 ? -difference : difference;
+
+	error->compared++;
+	if (magnitude != 0) {
+		error->differ++;
+	}
+	if (magnitude > error->maxError) {
+		error->maxError = magnitude;
+	}
+	error->squares += (double) difference * difference;
+}
+
+static void printError(const char *name, const replayError_t *error) {
+	printf("%-8s %lu compared, %lu differ, max %ld, rms %.2f\n", name,
+			(unsigned long) error->compared, (unsigned long) error->differ,
+			(long) error->maxError,
+			error->compared ? sqrt(error->squares / error->compared) : 0.0);
+}
+
+int main(int argc, char **argv) {
+	char line[REPLAY_LINE_SIZE];
+	int column[TELEMETRY_CHANNEL_COUNT];
+	int16_t channels[TELEMETRY_CHANNEL_COUNT];
+	int16_t state[LQR_STATES];
+	int32_t values[LQR_STATES];
+	replayError_t tiltError = { 0, 0, 0, 0.0 };
+	replayError_t commandError = { 0, 0, 0, 0.0 };
+	uint32_t ticks = 0;
+	uint32_t gaps = 0;
+	uint32_t skipped = 0;
+	uint32_t printed = 0;
+	long firstDivergence = -1;
+	long expected = 0;
+	long tick;
+	uint32_t settle = REPLAY_SETTLE_TICKS;
+	uint32_t settling;
+	uint8_t fromBoot = 0;
+	uint8_t verbose = 0;
+	uint8_t seeded = 0;
+	uint8_t velocityKnown = 0;
+	uint8_t compare;
+	int16_t velocity = 0;
+	int16_t tilt;
+	int16_t command;
+	uint16_t mode;
+	uint16_t mask;
+	int columns;
+	int status;
+	int option;
+	int i;
+	FILE *input;
+	clock_t start;
+	double seconds;
+
+	kalmanGains = KALMAN_GAINS_DEFAULT;
+	gains = LQR_GAINS_DEFAULT;
+	while ((option = getopt(argc, argv, "bs:l:k:v")) != -1) {
+		switch (option) {
+		case 'b':
+			fromBoot = 1;
+			break;
+		case 's':
+			settle = (uint32_t) strtoul(optarg, 0, 0);
+			break;
+		case 'l':
+			if (parseList(optarg, values, LQR_STATES) != 0) {
+				fprintf(stderr, "-l takes tilt,rate,pos,vel gains\n");
+				return 2;
+			}
+			for (i = 0; i < LQR_STATES; i++) {
+				gains.gain[i] = (int16_t) values[i];
+			}
+			break;
+		case 'k':
+			if (parseList(optarg, values, 2) != 0) {
+				fprintf(stderr, "-k takes angle,bias gains\n");
+				return 2;
+			}
+			kalmanGains.angle = values[0];
+			kalmanGains.bias = values[1];
+			break;
+		case 'v':
+			verbose = 1;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-b] [-s ticks] [-l tilt,rate,pos,vel] "
+					"[-k angle,bias] [-v] run.csv\n", argv[0]);
+			return 2;
+		}
+	}
+	if (optind != argc - 1 || (input = fopen(argv[optind], "r")) == 0) {
+		fprintf(stderr, "%s: need one readable CSV from tools/telemetry_decode.py\n", argv[0]);
+		return 2;
+	}
+	if (fgets(line, sizeof(line), input) == 0) {
+		fprintf(stderr, "%s: empty file\n", argv[optind]);
+		return 2;
+	}
+	mask = parseHeader(line, column, &columns);
+	if ((mask & TELEMETRY_REPLAY_MASK) != TELEMETRY_REPLAY_MASK) {
+		fprintf(stderr, "%s: recorded without TELEMETRY_REPLAY_MASK (\"--mask replay\")\n",
+				argv[optind]);
+		return 2;
+	}
+
+	memset(channels, 0, sizeof(channels));
+	resetFilters();
+	kalmanInit(&tiltFilter, &kalmanGains, 0);
+	settling = fromBoot ? 0 : settle;
+	seeded = fromBoot;
+	velocityKnown = fromBoot;
+	start = clock();
+	while (fgets(line, sizeof(line), input) != 0) {
+		status = parseRow(line, column, columns, &tick, channels);
+		if (status < 0) {
+			fprintf(stderr, "malformed line after tick %ld\n", expected - 1);
+			return 2;
+		}
+		if (status == 0 || (ticks != 0 && tick != expected)
+				|| ((uint16_t) channels[TELEMETRY_MODE] & TELEMETRY_MODE_BATCH)) {
+			// Records lost or a batch: start over from the next recorded tilt
+			if (seeded) {
+				gaps++;
+			}
+			seeded = 0;
+			velocityKnown = 0;
+			expected = tick + 1;
+			continue;
+		}
+		expected = tick + 1;
+		ticks++;
+		mode = (uint16_t) channels[TELEMETRY_MODE];
+		if (!seeded) {
+			if (!(mode & TELEMETRY_MODE_FRESH)) {
+				continue;
+			}
+			// The bias learnt so far is the best guess left
+			resetFilters();
+			tiltFilter.angle = (int32_t) channels[TELEMETRY_TILT] << 16;
+			settling = settle;
+			seeded = 1;
+		}
+
+		if (mode & TELEMETRY_MODE_FRESH) {
+			for (i = 0; i < IMU_AXIS_COUNT; i++) {
+				sample.axis[i] = channels[TELEMETRY_ACCEL_X + i];
+			}
+			adaptiveNotchTune(&stepNotch, STEPPER_LEFT, (uint16_t) channels[TELEMETRY_STEP_LEFT]);
+			adaptiveNotchTune(&stepNotch, STEPPER_RIGHT, (uint16_t) channels[TELEMETRY_STEP_RIGHT]);
+			adaptiveNotchProcess(&stepNotch, &sample, 1);
+			imuFilterProcess(&imuFilter, &sample, 1);
+		}
+		tilt = (int16_t) (kalmanUpdate(&tiltFilter, kalmanGyroToRate(sample.axis[IMU_GYRO_X]),
+				(int32_t) atan2Q15(sample.axis[IMU_ACCEL_Y], sample.axis[IMU_ACCEL_Z]) << 16) >> 16);
+
+		command = 0;
+		compare = 1;
+		if (!(mode & TELEMETRY_MODE_RUNNING) || !velocityKnown
+				|| (mode & (TELEMETRY_MODE_PID | TELEMETRY_MODE_AUTOTUNE | TELEMETRY_MODE_SYSID))) {
+			compare = 0;
+		} else if (mode & TELEMETRY_MODE_MOTION) {
+			state[LQR_TILT] = saturateQ15((int32_t) tilt - channels[TELEMETRY_SETPOINT]);
+			state[LQR_RATE] = sample.axis[IMU_GYRO_X];
+			state[LQR_POSITION] = 0;
+			state[LQR_VELOCITY] = 0;
+			command = lqrUpdate(&gains, state);
+		} else {
+			state[LQR_TILT] = tilt;
+			state[LQR_RATE] = sample.axis[IMU_GYRO_X];
+			state[LQR_POSITION] = channels[TELEMETRY_HOLD_ERROR];
+			state[LQR_VELOCITY] = velocity;
+			command = lqrUpdate(&gains, state);
+		}
+		velocity = channels[TELEMETRY_VELOCITY];
+		velocityKnown = 1;
+
+		if (settling > 0) {
+			settling--;
+			continue;
+		}
+		addError(&tiltError, (int32_t) tilt - channels[TELEMETRY_TILT]);
+		if (!compare) {
+			skipped++;
+		} else {
+			addError(&commandError, (int32_t) command - channels[TELEMETRY_COMMAND]);
+		}
+		if (tilt != channels[TELEMETRY_TILT] || (compare && command != channels[TELEMETRY_COMMAND])) {
+			if (firstDivergence < 0) {
+				firstDivergence = tick;
+			}
+			if (verbose && printed++ < REPLAY_VERBOSE_LINES) {
+				printf("tick %ld: tilt %d recorded %d, command %d recorded %d%s\n", tick,
+						tilt, channels[TELEMETRY_TILT], command, channels[TELEMETRY_COMMAND],
+						compare ? "" : " (not compared)");
+			}
+		}
+	}
+	seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+	fclose(input);
+
+	printf("%lu ticks replayed, %lu gaps, %.0f ticks/s (%.0fx real time)\n",
+			(unsigned long) ticks, (unsigned long) gaps,
+			seconds > 0 ? ticks / seconds : 0.0,
+			seconds > 0 ? ticks / seconds / TICK_RATE_HZ : 0.0);
+	printError("tilt", &tiltError);
+	printError("command", &commandError);
+	printf("command  %lu ticks not compared: fallen, PID, auto-tune, PRBS or no last velocity\n",
+			(unsigned long) skipped);
+	if (firstDivergence < 0) {
+		printf("no divergence\n");
+		return 0;
+	}
+	printf("first divergence at tick %ld\n", firstDivergence);
+	return 1;
+}
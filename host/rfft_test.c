@@ -0,0 +1,228 @@
+/************************************************************
+*
+* @file:      rfft_test.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     The spectrum.c FFT path against a double precision
+*             DFT of the same windowed input
+*
+*             Build and run from the repository root:
+*
+*               gcc -std=gnu99 -O2 -DARM_MATH_CM0 -Ihost -Iinc \
+*                   -o rfft_test host/rfft_test.c host/arm_rfft.c \
+*                   src/fastmath.c src/tables.c -lm
+*               ./rfft_test
+*
+*             Each signal is windowed with arm_mult_q15 and
+*             hannWindow as prepareWindow does, at the level
+*             prepareWindow normalizes to, a peak between 1/4 and
+*             1/2 of full scale. That Q15 window is the input to
+*             both arm_rfft_q15 and the DFT, so the errors are the
+*             FFT's alone: every complex bin against DFT / N, and
+*             every magnitude as spectrumPoll takes it against
+*             |DFT| / 2N, in LSB. arm_cmplx_mag_q15's error on the
+*             same bins is printed beside it, the reason spectrumPoll
+*             does not use it. A bin centred sine of amplitude A
+*             must peak at A / 8, as the spectrum.c header says.
+*             Exit status is 1 if any bound is passed.
+*
+************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "arm_math.h"
+#include "tables.h"
+#include "fastmath.h"
+
+#define RFFT_TEST_LEN               HANN_WINDOW_LEN
+#define RFFT_TEST_BINS              (RFFT_TEST_LEN / 2)
+// Worst truncation error allowed, LSB of the output
+#define RFFT_TEST_BOUND_BIN         3.0
+#define RFFT_TEST_BOUND_MAG         2.0
+// Peak of a bin centred sine against A / 8, relative
+#define RFFT_TEST_BOUND_PEAK        0.01
+#define RFFT_TEST_NOISE_RUNS        200
+
+typedef enum {
+	SIGNAL_SINE_CENTRED = 0,
+	SIGNAL_SINE_BETWEEN,
+	SIGNAL_TWO_TONES,
+	SIGNAL_NYQUIST,
+	SIGNAL_STEP,
+	SIGNAL_NOISE,
+	SIGNAL_COUNT
+} signal_t;
+
+static const char *signalNames[SIGNAL_COUNT] = {
+	"sine on bin 10", "sine at bin 20.5", "bins 3 and 41", "alternating",
+	"step", "noise"
+};
+
+static arm_rfft_instance_q15 rfft;
+static arm_cfft_radix4_instance_q15 cfft;
+static int failures = 0;
+
+static void check(int ok, const char *what) {
+	printf("  %-4s %s\n", ok ? "ok" : "FAIL", what);
+	if (!ok) {
+		failures++;
+	}
+}
+
+static void makeSignal(signal_t signal, double amplitude, q15_t *samples) {
+	double value;
+	uint16_t n;
+
+	for (n = 0; n < RFFT_TEST_LEN; n++) {
+		switch (signal) {
+		case SIGNAL_SINE_CENTRED:
+			value = amplitude * sin(2.0 * M_PI * 10.0 * n / RFFT_TEST_LEN);
+			break;
+		case SIGNAL_SINE_BETWEEN:
+			value = amplitude * sin(2.0 * M_PI * 20.5 * n / RFFT_TEST_LEN + 0.3);
+			break;
+		case SIGNAL_TWO_TONES:
+			value = 0.5 * amplitude * (sin(2.0 * M_PI * 3.0 * n / RFFT_TEST_LEN)
+					+ cos(2.0 * M_PI * 41.0 * n / RFFT_TEST_LEN));
+			break;
+		case SIGNAL_NYQUIST:
+			value = (n & 1) ? -amplitude : amplitude;
+			break;
+		case SIGNAL_STEP:
+			value = n < RFFT_TEST_LEN / 2 ? -amplitude : amplitude;
+			break;
+		default:
+			value = amplitude * (2.0 * rand() / RAND_MAX - 1.0);
+			break;
+		}
+		samples[n] = (q15_t) floor(value + 0.5);
+	}
+	arm_mult_q15(samples, (q15_t *) hannWindow, samples, RFFT_TEST_LEN);
+}
+
+/************************************************************
+*
+* Function: compare
+* @brief:   one window through arm_rfft_q15 and the DFT
+* @param:   worstBin, double*, raised to the worst complex bin
+*           error, LSB
+* @param:   worstMag, double*, raised to the worst magnitude
+*           error, LSB
+* @param:   worstLibrary, double*, the same for
+*           arm_cmplx_mag_q15
+* @param:   peak, q15_t*, largest magnitude bin, may be 0
+*
+************************************************************/
+static void compare(const q15_t *windowed, double *worstBin, double *worstMag,
+		double *worstLibrary, q15_t *peak) {
+	q15_t input[RFFT_TEST_LEN];
+	q15_t output[2 * RFFT_TEST_LEN];
+	q15_t library[RFFT_TEST_BINS];
+	q15_t magnitude[RFFT_TEST_BINS];
+	int32_t binRe;
+	int32_t binIm;
+	double re;
+	double im;
+	double error;
+	uint16_t k;
+	uint16_t n;
+
+	for (n = 0; n < RFFT_TEST_LEN; n++) {
+		input[n] = windowed[n];
+	}
+	arm_rfft_q15(&rfft, input, output);
+	arm_cmplx_mag_q15(output, library, RFFT_TEST_BINS);
+	// spectrumPoll's magnitude
+	for (k = 0; k < RFFT_TEST_BINS; k++) {
+		binRe = output[2 * k];
+		binIm = output[2 * k + 1];
+		magnitude[k] = (q15_t) (sqrtU32((uint32_t) (binRe * binRe)
+				+ (uint32_t) (binIm * binIm)) >> 1);
+	}
+
+	for (k = 0; k < RFFT_TEST_LEN; k++) {
+		re = 0.0;
+		im = 0.0;
+		for (n = 0; n < RFFT_TEST_LEN; n++) {
+			re += windowed[n] * cos(2.0 * M_PI * k * n / RFFT_TEST_LEN);
+			im -= windowed[n] * sin(2.0 * M_PI * k * n / RFFT_TEST_LEN);
+		}
+		re /= RFFT_TEST_LEN;
+		im /= RFFT_TEST_LEN;
+		error = fmax(fabs(output[2 * k] - re), fabs(output[2 * k + 1] - im));
+		if (error > *worstBin) {
+			*worstBin = error;
+		}
+		if (k < RFFT_TEST_BINS) {
+			error = fabs(magnitude[k] - sqrt(re * re + im * im) / 2.0);
+			if (error > *worstMag) {
+				*worstMag = error;
+			}
+			error = fabs(library[k] - sqrt(re * re + im * im) / 2.0);
+			if (error > *worstLibrary) {
+				*worstLibrary = error;
+			}
+			if (peak != 0 && magnitude[k] > *peak) {
+				*peak = magnitude[k];
+			}
+		}
+	}
+}
+
+int main(void) {
+	q15_t windowed[RFFT_TEST_LEN];
+	char what[96];
+	double worstBin;
+	double worstMag;
+	double worstLibrary;
+	double amplitude;
+	q15_t peak;
+	uint8_t signal;
+	uint16_t run;
+
+	printf("arm_rfft_q15, %d points, against DFT / N\n", RFFT_TEST_LEN);
+	check(arm_rfft_init_q15(&rfft, &cfft, 256, 0, 1) == ARM_MATH_ARGUMENT_ERROR,
+			"256 points refused, as the library does");
+	check(arm_rfft_init_q15(&rfft, &cfft, RFFT_TEST_LEN, 0, 1) == ARM_MATH_SUCCESS,
+			"128 points accepted");
+
+	srand(1);
+	for (signal = 0; signal < SIGNAL_COUNT; signal++) {
+		worstBin = 0.0;
+		worstMag = 0.0;
+		worstLibrary = 0.0;
+		// prepareWindow leaves the peak in [8192, 16384)
+		for (amplitude = 8192.0; amplitude < 16384.0; amplitude += 2047.0) {
+			for (run = 0; run < (signal == SIGNAL_NOISE ? RFFT_TEST_NOISE_RUNS : 1); run++) {
+				makeSignal((signal_t) signal, amplitude, windowed);
+				compare(windowed, &worstBin, &worstMag, &worstLibrary, 0);
+			}
+		}
+		snprintf(what, sizeof(what), "%-16s bin %.2f LSB, magnitude %.2f LSB",
+				signalNames[signal], worstBin, worstMag);
+		check(worstBin <= RFFT_TEST_BOUND_BIN && worstMag <= RFFT_TEST_BOUND_MAG, what);
+		printf("       arm_cmplx_mag_q15 would be off by %.2f LSB\n", worstLibrary);
+	}
+
+	// The scaling spectrum.c documents: Hann gain 1/2, one sided
+	// 1/2, magnitude 1/2
+	amplitude = 16000.0;
+	makeSignal(SIGNAL_SINE_CENTRED, amplitude, windowed);
+	worstBin = 0.0;
+	worstMag = 0.0;
+	worstLibrary = 0.0;
+	peak = 0;
+	compare(windowed, &worstBin, &worstMag, &worstLibrary, &peak);
+	snprintf(what, sizeof(what), "sine of %.0f peaks at %d, A / 8 = %.0f", amplitude, peak,
+			amplitude / 8.0);
+	check(fabs(peak - amplitude / 8.0) <= RFFT_TEST_BOUND_PEAK * amplitude / 8.0, what);
+
+	if (failures > 0) {
+		printf("FAIL, %d checks\n", failures);
+		return 1;
+	}
+	printf("pass\n");
+	return 0;
+}
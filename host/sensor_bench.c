@@ -0,0 +1,262 @@
+/************************************************************
+*
+* @file:      sensor_bench.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Cost of the sensor.h interface on the SENSOR_SIM
+*             backend, against direct access and a function
+*             pointer table
+*
+*             Build and run from the repository root:
+*
+*               gcc -std=gnu99 -O2 -DSENSOR_SIM -Ihost -Iinc \
+*                   -o sensor_bench host/sensor_bench.c \
+*                   src/sensor_sim.c src/kalman.c src/fastmath.c \
+*                   src/tables.c -lm
+*               ./sensor_bench
+*
+*             Each variant runs the balance.c read path over the
+*             same trace: queue a sample, start the read, test
+*             ready, take the batch, and the Kalman tilt step on
+*             its newest sample, so the fusion code is the same in
+*             all three. "sensor.h" goes through the backend's
+*             static inline calls as balance.c does, "direct"
+*             writes the backend's variables by hand, and "vtable"
+*             calls the same functions through a table of
+*             pointers, the design sensor.h avoids. The best of
+*             SENSOR_BENCH_ROUNDS interleaved rounds is taken for
+*             each. Exit status is 1 if sensor.h is more than
+*             SENSOR_BENCH_TOLERANCE slower than direct, or the
+*             three do not produce the same tilt. With gcc -O2
+*             runSensor and runDirect disassemble to the same
+*             instructions; the few percent either way between
+*             them is code placement, hence the tolerance.
+*
+*             The MPU9250 backend has the same shape, inline calls
+*             on the driver's buffer and ready flag that leave
+*             direct calls into mpu9250.c, so the target build
+*             compiles to what calling the driver by hand would.
+*
+************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "sensor.h"
+#include "kalman.h"
+#include "fastmath.h"
+
+#if !defined(SENSOR_SIM)
+#error "sensor_bench needs the SENSOR_SIM backend"
+#endif
+
+#define SENSOR_BENCH_SAMPLES        (1 << 16)
+#define SENSOR_BENCH_PASSES         64
+#define SENSOR_BENCH_ROUNDS         9
+// Largest slowdown of sensor.h against direct, relative
+#define SENSOR_BENCH_TOLERANCE      0.10
+
+typedef enum {
+	VARIANT_SENSOR = 0,
+	VARIANT_DIRECT,
+	VARIANT_VTABLE,
+	VARIANT_COUNT
+} variant_t;
+
+static const char *variantNames[VARIANT_COUNT] = {
+	"sensor.h", "direct", "vtable"
+};
+
+typedef struct {
+	void (*push)(const imuSample_t *sample);
+	int (*startRead)(void);
+	uint8_t (*sampleReady)(void);
+	imuSample_t *(*getSamples)(uint8_t *count);
+} sensorTable_t;
+
+static imuSample_t trace[SENSOR_BENCH_SAMPLES];
+static int failures = 0;
+
+static void check(int ok, const char *what) {
+	printf("  %-4s %s\n", ok ? "ok" : "FAIL", what);
+	if (!ok) {
+		failures++;
+	}
+}
+
+// Out of line copies of the backend for the table; the table is
+// volatile so the compiler cannot see through it
+static __attribute__((noinline)) void tablePush(const imuSample_t *sample) {
+	sensorSimPush(sample);
+}
+
+static __attribute__((noinline)) int tableStartRead(void) {
+	return sensorStartRead();
+}
+
+static __attribute__((noinline)) uint8_t tableSampleReady(void) {
+	return sensorSampleReady();
+}
+
+static __attribute__((noinline)) imuSample_t *tableGetSamples(uint8_t *count) {
+	return sensorGetSamples(count);
+}
+
+static const sensorTable_t * volatile table;
+static const sensorTable_t simTable = {
+	tablePush, tableStartRead, tableSampleReady, tableGetSamples
+};
+
+static void makeTrace(void) {
+	uint32_t n;
+
+	srand(3);
+	for (n = 0; n < SENSOR_BENCH_SAMPLES; n++) {
+		trace[n].axis[IMU_ACCEL_X] = (int16_t) (rand() % 64 - 32);
+		trace[n].axis[IMU_ACCEL_Y] = (int16_t) (rand() % 2048 - 1024);
+		trace[n].axis[IMU_ACCEL_Z] = (int16_t) (ACCEL_LSB_PER_G + rand() % 64 - 32);
+		trace[n].axis[IMU_GYRO_X] = (int16_t) (rand() % 512 - 256);
+		trace[n].axis[IMU_GYRO_Y] = (int16_t) (rand() % 64 - 32);
+		trace[n].axis[IMU_GYRO_Z] = (int16_t) (rand() % 64 - 32);
+		trace[n].temperature = 0;
+		trace[n].magValid = 0;
+	}
+}
+
+static inline int32_t fuse(kalman_t *filter, const imuSample_t *sample) {
+	return kalmanUpdate(filter, kalmanGyroToRate(sample->axis[IMU_GYRO_X]),
+			(int32_t) atan2Q15(sample->axis[IMU_ACCEL_Y], sample->axis[IMU_ACCEL_Z]) << 16);
+}
+
+static __attribute__((noinline)) int32_t runSensor(kalman_t *filter) {
+	imuSample_t *samples;
+	int32_t tilt = 0;
+	uint32_t n;
+	uint8_t count;
+
+	for (n = 0; n < SENSOR_BENCH_SAMPLES; n++) {
+		sensorSimPush(&trace[n]);
+		sensorStartRead();
+		if (sensorSampleReady()) {
+			samples = sensorGetSamples(&count);
+			tilt = fuse(filter, &samples[count - 1]);
+		}
+	}
+	return tilt;
+}
+
+static __attribute__((noinline)) int32_t runDirect(kalman_t *filter) {
+	imuSample_t *samples;
+	int32_t tilt = 0;
+	uint32_t n;
+	uint8_t count;
+
+	for (n = 0; n < SENSOR_BENCH_SAMPLES; n++) {
+		if (sensorSimPending < SENSOR_MAX_BATCH) {
+			sensorSimSamples[sensorSimPending++] = trace[n];
+		}
+		sensorSimReady = sensorSimPending;
+		sensorSimPending = 0;
+		if (sensorSimReady) {
+			count = sensorSimReady;
+			samples = sensorSimSamples;
+			sensorSimReady = 0;
+			tilt = fuse(filter, &samples[count - 1]);
+		}
+	}
+	return tilt;
+}
+
+static __attribute__((noinline)) int32_t runVtable(kalman_t *filter) {
+	imuSample_t *samples;
+	int32_t tilt = 0;
+	uint32_t n;
+	uint8_t count;
+
+	for (n = 0; n < SENSOR_BENCH_SAMPLES; n++) {
+		table->push(&trace[n]);
+		table->startRead();
+		if (table->sampleReady()) {
+			samples = table->getSamples(&count);
+			tilt = fuse(filter, &samples[count - 1]);
+		}
+	}
+	return tilt;
+}
+
+/************************************************************
+*
+* Function: timeVariant
+* @brief:   one round of SENSOR_BENCH_PASSES over the trace
+* @param:   tilt, int32_t*, set to the last tilt of the round
+* @return:  double, host ns per sample
+*
+************************************************************/
+static double timeVariant(variant_t variant, int32_t *tilt) {
+	struct timespec start;
+	struct timespec end;
+	kalman_t filter;
+	uint32_t pass;
+
+	kalmanInit(&filter, &KALMAN_GAINS_DEFAULT, 0);
+	sensorInit();
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (pass = 0; pass < SENSOR_BENCH_PASSES; pass++) {
+		switch (variant) {
+		case VARIANT_SENSOR:
+			*tilt = runSensor(&filter);
+			break;
+		case VARIANT_DIRECT:
+			*tilt = runDirect(&filter);
+			break;
+		default:
+			*tilt = runVtable(&filter);
+			break;
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	return ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec))
+			/ ((double) SENSOR_BENCH_PASSES * SENSOR_BENCH_SAMPLES);
+}
+
+int main(void) {
+	double best[VARIANT_COUNT];
+	int32_t tilt[VARIANT_COUNT];
+	double ns;
+	char what[96];
+	uint8_t round;
+	uint8_t variant;
+
+	table = &simTable;
+	makeTrace();
+	for (variant = 0; variant < VARIANT_COUNT; variant++) {
+		best[variant] = 1e9;
+	}
+	for (round = 0; round < SENSOR_BENCH_ROUNDS; round++) {
+		for (variant = 0; variant < VARIANT_COUNT; variant++) {
+			ns = timeVariant((variant_t) variant, &tilt[variant]);
+			best[variant] = ns < best[variant] ? ns : best[variant];
+		}
+	}
+
+	printf("read and Kalman step, %d samples x %d, best of %d\n", SENSOR_BENCH_SAMPLES,
+			SENSOR_BENCH_PASSES, SENSOR_BENCH_ROUNDS);
+	printf("  %-10s %9s %9s\n", "variant", "ns", "vs direct");
+	for (variant = 0; variant < VARIANT_COUNT; variant++) {
+		printf("  %-10s %9.3f %+8.1f %%\n", variantNames[variant], best[variant],
+				100.0 * (best[variant] / best[VARIANT_DIRECT] - 1.0));
+	}
+	check(tilt[VARIANT_SENSOR] == tilt[VARIANT_DIRECT] && tilt[VARIANT_VTABLE] == tilt[VARIANT_DIRECT],
+			"same tilt through every variant");
+	snprintf(what, sizeof(what), "sensor.h within %.0f %% of direct",
+			100.0 * SENSOR_BENCH_TOLERANCE);
+	check(best[VARIANT_SENSOR] <= (1.0 + SENSOR_BENCH_TOLERANCE) * best[VARIANT_DIRECT], what);
+
+	if (failures > 0) {
+		printf("FAIL, %d checks\n", failures);
+		return 1;
+	}
+	printf("pass\n");
+	return 0;
+}
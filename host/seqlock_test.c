@@ -0,0 +1,249 @@
+/************************************************************
+*
+* @file:      seqlock_test.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Deterministic interleavings of a seqlock.h writer
+*             and reader, as the ISR and the task it preempts
+*
+*             Build and run from the repository root:
+*
+*               gcc -std=gnu99 -O2 -Iinc -o seqlock_test \
+*                   host/seqlock_test.c
+*               ./seqlock_test
+*
+*             The reader copies SEQLOCK_TEST_WORDS words, one per
+*             step, and calls preemptionPoint before every shared
+*             access. The writer runs to completion there when
+*             the schedule says so, as an ISR does on the M0, and
+*             stamps every word with its generation, so a torn
+*             copy is one whose words differ. Schedules: one write
+*             at every point of the read, two writes at every pair
+*             of points, a write at every point for the first
+*             retries, and writes across the counter wrapping.
+*             The unlocked copy runs the single write schedule
+*             too, and must tear, so the harness is known to see
+*             it. Exit status is 1 if a locked copy tears, a
+*             retry is missed or taken without cause, or the
+*             unlocked copy never tears.
+*
+************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "seqlock.h"
+
+#define SEQLOCK_TEST_WORDS          4
+// Points per read attempt: begin, each word, retry check
+#define SEQLOCK_TEST_POINTS         (SEQLOCK_TEST_WORDS + 2)
+// Preemption points the schedules reach, a few attempts' worth
+#define SEQLOCK_TEST_SPAN           (4 * SEQLOCK_TEST_POINTS)
+#define SEQLOCK_TEST_STORM          5
+#define SEQLOCK_TEST_MAX_ATTEMPTS   100
+
+typedef struct {
+	seqlock_t lock;
+	uint32_t word[SEQLOCK_TEST_WORDS];
+} shared_t;
+
+typedef struct {
+	uint32_t point;             // preemption points passed so far
+	uint32_t attempts;          // read attempts, 1 if no retry
+	uint32_t writesDuringCopy;  // writes that landed inside the accepted attempt
+} readTrace_t;
+
+static shared_t shared;
+static uint32_t generation = 0;
+// Schedule: a write at point p if writeAt[p]
+static uint8_t writeAt[SEQLOCK_TEST_SPAN + SEQLOCK_TEST_MAX_ATTEMPTS * SEQLOCK_TEST_POINTS];
+static int failures = 0;
+
+static void check(int ok, const char *what) {
+	printf("  %-4s %s\n", ok ? "ok" : "FAIL", what);
+	if (!ok) {
+		failures++;
+	}
+}
+
+// The ISR: one complete write, never preempted by the reader
+static void writer(void) {
+	uint8_t i;
+
+	generation++;
+	seqlockWriteBegin(&shared.lock);
+	for (i = 0; i < SEQLOCK_TEST_WORDS; i++) {
+		shared.word[i] = generation;
+	}
+	seqlockWriteEnd(&shared.lock);
+}
+
+static uint8_t preemptionPoint(readTrace_t *trace) {
+	uint8_t wrote = 0;
+
+	if (trace->point < sizeof(writeAt) && writeAt[trace->point]) {
+		writer();
+		wrote = 1;
+	}
+	trace->point++;
+	return wrote;
+}
+
+static uint8_t torn(const uint32_t *copy) {
+	uint8_t i;
+
+	for (i = 1; i < SEQLOCK_TEST_WORDS; i++) {
+		if (copy[i] != copy[0]) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/************************************************************
+*
+* Function: lockedRead
+* @brief:   the do { begin; copy; } while (retry) pattern of
+*           profileSnapshot and balanceGetAttitude, with a
+*           preemption point before every shared access
+* @return:  uint8_t, 1 if the accepted copy is torn
+*
+************************************************************/
+static uint8_t lockedRead(readTrace_t *trace, uint32_t *copy) {
+	uint32_t sequence;
+	uint8_t writes;
+	uint8_t i;
+
+	memset(trace, 0, sizeof(*trace));
+	do {
+		trace->attempts++;
+		writes = 0;
+		preemptionPoint(trace);
+		sequence = seqlockReadBegin(&shared.lock);
+		for (i = 0; i < SEQLOCK_TEST_WORDS; i++) {
+			writes += preemptionPoint(trace);
+			copy[i] = shared.word[i];
+		}
+		writes += preemptionPoint(trace);
+		trace->writesDuringCopy = writes;
+	} while (seqlockReadRetry(&shared.lock, sequence)
+			&& trace->attempts < SEQLOCK_TEST_MAX_ATTEMPTS);
+	return torn(copy);
+}
+
+static uint8_t unlockedRead(readTrace_t *trace, uint32_t *copy) {
+	uint8_t i;
+
+	memset(trace, 0, sizeof(*trace));
+	trace->attempts = 1;
+	for (i = 0; i < SEQLOCK_TEST_WORDS; i++) {
+		preemptionPoint(trace);
+		copy[i] = shared.word[i];
+	}
+	return torn(copy);
+}
+
+static void reset(uint32_t sequence) {
+	memset(writeAt, 0, sizeof(writeAt));
+	seqlockInit(&shared.lock);
+	shared.lock.sequence = sequence;
+	generation = 0;
+	writer();
+}
+
+/************************************************************
+*
+* Function: runSchedule
+* @brief:   one read under the current writeAt schedule
+* @return:  uint8_t, 1 if the read broke a seqlock promise: a
+*           torn copy, a write inside the accepted attempt, a
+*           retry with no write, or no end
+*
+************************************************************/
+static uint8_t runSchedule(void) {
+	readTrace_t trace;
+	uint32_t copy[SEQLOCK_TEST_WORDS];
+	uint32_t writes = 0;
+	uint32_t p;
+
+	if (lockedRead(&trace, copy) || trace.writesDuringCopy != 0
+			|| trace.attempts >= SEQLOCK_TEST_MAX_ATTEMPTS) {
+		return 1;
+	}
+	// Every retry needs a write in the attempt it threw away
+	for (p = 0; p < trace.point; p++) {
+		writes += writeAt[p];
+	}
+	return trace.attempts > 1 + writes;
+}
+
+int main(void) {
+	readTrace_t trace;
+	uint32_t copy[SEQLOCK_TEST_WORDS];
+	uint32_t bad;
+	uint32_t runs;
+	uint32_t tornUnlocked = 0;
+	uint32_t p;
+	uint32_t q;
+
+	printf("seqlock, %d word copy, %d preemption points per attempt\n",
+			SEQLOCK_TEST_WORDS, SEQLOCK_TEST_POINTS);
+
+	bad = 0;
+	for (p = 0; p < SEQLOCK_TEST_SPAN; p++) {
+		reset(0);
+		writeAt[p] = 1;
+		bad += runSchedule();
+		reset(0);
+		writeAt[p] = 1;
+		tornUnlocked += unlockedRead(&trace, copy);
+	}
+	check(bad == 0, "one write at every point: never torn, retried only for it");
+	printf("       unlocked copy torn in %u of %d\n", (unsigned) tornUnlocked, SEQLOCK_TEST_SPAN);
+	check(tornUnlocked > 0, "the same schedules tear an unlocked copy");
+
+	bad = 0;
+	runs = 0;
+	for (p = 0; p < SEQLOCK_TEST_SPAN; p++) {
+		for (q = p; q < SEQLOCK_TEST_SPAN; q++) {
+			reset(0);
+			writeAt[p] = 1;
+			writeAt[q] = 1;
+			bad += runSchedule();
+			runs++;
+		}
+	}
+	printf("       %u two write schedules\n", (unsigned) runs);
+	check(bad == 0, "two writes at every pair of points");
+
+	reset(0);
+	for (p = 0; p < SEQLOCK_TEST_STORM * SEQLOCK_TEST_POINTS; p++) {
+		writeAt[p] = 1;
+	}
+	check(lockedRead(&trace, copy) == 0 && trace.attempts == SEQLOCK_TEST_STORM + 1
+			&& copy[0] == generation, "write storm: retries until it passes, then the latest");
+
+	bad = 0;
+	for (p = 0; p < SEQLOCK_TEST_SPAN; p++) {
+		reset(0xFFFFFFFC);
+		writeAt[p] = 1;
+		writeAt[p + 1] = 1;
+		bad += runSchedule();
+	}
+	check(bad == 0, "writes across the counter wrap");
+
+	// Rules in seqlock.h: a reader that preempts the writer sees it
+	// open and must not take the copy
+	reset(0);
+	seqlockWriteBegin(&shared.lock);
+	check(seqlockReadRetry(&shared.lock, seqlockReadBegin(&shared.lock)) == 1,
+			"a copy taken inside a write is always retried");
+	seqlockWriteEnd(&shared.lock);
+
+	if (failures > 0) {
+		printf("FAIL, %d checks\n", failures);
+		return 1;
+	}
+	printf("pass\n");
+	return 0;
+}
@@ -0,0 +1,133 @@
+/************************************************************
+*
+* @file:      stepper.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Linux build of the wheel stepper driver, same rate
+*             and period arithmetic as src/stepper.c
+*
+*             The timers become a phase accumulator per wheel,
+*             advanced one tick of STEPPER_TIMER_HZ counts at a
+*             time by host/firmware.c, which runs the update
+*             handler once for every period that elapsed. As on
+*             target a new period applies from the next step.
+*             Enable and rate commands are outputs, folded into
+*             the run digest.
+*
+************************************************************/
+
+#include "stepper.h"
+#include "divide.h"
+#include "timebase.h"
+#include "host.h"
+
+#define PERIOD_EXPONENT             6
+#define PERIOD_MANTISSA             (STEPPER_TIMER_HZ >> PERIOD_EXPONENT)
+#if (PERIOD_MANTISSA << PERIOD_EXPONENT) != STEPPER_TIMER_HZ || PERIOD_MANTISSA > 0xFFFF
+#error "STEPPER_TIMER_HZ needs another PERIOD_EXPONENT"
+#endif
+#define COUNTS_PER_TICK             (STEPPER_TIMER_HZ / TICK_RATE_HZ)
+
+static int32_t position[STEPPER_COUNT];
+static int8_t direction[STEPPER_COUNT];
+static int32_t rate[STEPPER_COUNT];
+// Auto-reload value + 1, 0x10000 out of reset
+static uint32_t period[STEPPER_COUNT];
+// Counts since the last update event
+static uint32_t phase[STEPPER_COUNT];
+
+static void outputCommand(uint8_t what, int32_t value) {
+	uint8_t command[5];
+
+	command[0] = what;
+	command[1] = (uint8_t) value;
+	command[2] = (uint8_t) (value >> 8);
+	command[3] = (uint8_t) (value >> 16);
+	command[4] = (uint8_t) (value >> 24);
+	hostOutput(HOST_OUTPUT_STEPPER, command, sizeof(command));
+}
+
+void stepperInit(void) {
+	uint8_t id;
+
+	for (id = 0; id < STEPPER_COUNT; id++) {
+		position[id] = 0;
+		direction[id] = 0;
+		rate[id] = 0;
+		period[id] = 0x10000;
+		phase[id] = 0;
+	}
+	stepperEnable(0);
+}
+
+void stepperEnable(uint8_t enable) {
+	outputCommand('E', enable);
+}
+
+static uint32_t stepPeriod(uint16_t stepRate) {
+	uint8_t shift;
+	uint32_t reciprocal = divideReciprocal(stepRate, &shift);
+	uint32_t result = (PERIOD_MANTISSA * reciprocal) >> (31 - PERIOD_EXPONENT - shift);
+
+	if (result * stepRate > STEPPER_TIMER_HZ) {
+		result--;
+	}
+	return result;
+}
+
+void stepperSetRate(stepperId_t id, int32_t newRate) {
+	uint32_t magnitude = newRate < 0 ? -newRate : newRate;
+
+	if (magnitude < STEPPER_MIN_RATE) {
+		direction[id] = 0;
+		rate[id] = 0;
+		outputCommand((uint8_t) ('L' + id), 0);
+		return;
+	}
+	if (magnitude > STEPPER_MAX_RATE) {
+		magnitude = STEPPER_MAX_RATE;
+	}
+	direction[id] = newRate < 0 ? -1 : 1;
+	rate[id] = newRate < 0 ? -(int32_t) magnitude : (int32_t) magnitude;
+	period[id] = stepPeriod((uint16_t) magnitude);
+	outputCommand((uint8_t) ('L' + id), rate[id]);
+}
+
+int32_t stepperGetRate(stepperId_t id) {
+	return rate[id];
+}
+
+int32_t stepperGetPosition(stepperId_t id) {
+	return position[id];
+}
+
+uint16_t stepperGetPeriod(stepperId_t id) {
+	if (direction[id] == 0) {
+		return 0;
+	}
+	return (uint16_t) period[id];
+}
+
+void stepperUpdateHandler(stepperId_t id) {
+	position[id] += direction[id];
+}
+
+/************************************************************
+*
+* Function: stepperHostDue
+* @brief:   run the wheel timer for one tick
+* @return:  uint16_t, update events in that tick, the times to
+*           run its interrupt handler
+*
+************************************************************/
+uint16_t stepperHostDue(stepperId_t id) {
+	uint16_t events = 0;
+
+	phase[id] += COUNTS_PER_TICK;
+	while (phase[id] >= period[id]) {
+		phase[id] -= period[id];
+		events++;
+	}
+	return events;
+}
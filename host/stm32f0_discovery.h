@@ -0,0 +1,17 @@
+/************************************************************
+*
+* @file:      stm32f0_discovery.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Empty stand-in for the board header in the Linux
+*             build, main.c includes it but uses none of it
+*
+************************************************************/
+
+#ifndef __STM32F0_DISCOVERY_H
+#define __STM32F0_DISCOVERY_H
+
+#include "stm32f0xx.h"
+
+#endif
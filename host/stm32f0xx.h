@@ -0,0 +1,444 @@
+/************************************************************
+*
+* @file:      stm32f0xx.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Stand-in for the device header in the Linux build,
+*             found ahead of CMSIS/device through -Ihost
+*
+*             Only what the modules built unchanged from src/
+*             touch: the SysTick and SCB registers as plain
+*             memory owned by host/firmware.c, or SysTick on a
+*             host clock with HOST_SYSTICK_CLOCK, the interrupt
+*             masking intrinsics as no-ops, since handlers run to
+*             completion on one thread, and the SysTick and NVIC
+*             setup timebase.c calls. Drivers of the other
+*             peripherals are replaced as a whole in host/, except
+*             in host/i2c_test.c, which runs src/i2c_master.c on
+*             I2C1, its RX DMA channel and GPIOB as register
+*             blocks, with the StdPeriph calls it makes modelled
+*             in host/i2c_bus.c, and host/uart_test.c, which runs
+*             src/debug_uart.c the same way on USART1, DMA1
+*             channels 4 and 5 and GPIOA, host/usart_dma.c. The
+*             two models each carry their own GPIO and DMA calls
+*             and are never linked together.
+*
+************************************************************/
+
+#ifndef __STM32F0XX_H
+#define __STM32F0XX_H
+
+#include <stdint.h>
+
+typedef enum {
+	PendSV_IRQn = -2,
+	SysTick_IRQn = -1,
+	DMA1_Channel4_5_IRQn = 11,
+	I2C1_IRQn = 23,
+	USART1_IRQn = 27
+} IRQn_Type;
+
+typedef enum {
+	DISABLE = 0,
+	ENABLE = !DISABLE
+} FunctionalState;
+
+typedef enum {
+	Bit_RESET = 0,
+	Bit_SET
+} BitAction;
+
+typedef struct {
+	volatile uint32_t CTRL;
+	volatile uint32_t LOAD;
+	volatile uint32_t VAL;
+	volatile uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct {
+	volatile uint32_t CPUID;
+	volatile uint32_t ICSR;
+} SCB_Type;
+
+#define SCB_ICSR_PENDSVSET_Msk      (1UL << 28)
+#define SCB_ICSR_PENDSTSET_Msk      (1UL << 26)
+
+extern SysTick_Type hostSysTick;
+extern SCB_Type hostScb;
+extern uint32_t SystemCoreClock;
+
+#ifdef HOST_SYSTICK_CLOCK
+// Benchmarks only: the down counter follows a host clock, refreshed
+// on every access, so profile.h probes time real work; the
+// firmware build keeps it still to stay deterministic
+SysTick_Type *hostSysTickClock(void);
+#define SysTick                     (hostSysTickClock())
+#else
+#define SysTick                     (&hostSysTick)
+#endif
+#define SCB                         (&hostScb)
+
+static inline void __disable_irq(void) {
+}
+
+static inline void __enable_irq(void) {
+}
+
+static inline uint32_t __get_PRIMASK(void) {
+	return 0;
+}
+
+static inline void __set_PRIMASK(uint32_t primask) {
+	(void) primask;
+}
+
+static inline void NVIC_SetPriority(IRQn_Type irq, uint32_t priority) {
+	(void) irq;
+	(void) priority;
+}
+
+static inline uint32_t SysTick_Config(uint32_t ticks) {
+	SysTick->LOAD = ticks - 1;
+	SysTick->VAL = 0;
+	return 0;
+}
+
+// I2C1, DMA1 channel 3 and GPIOB, host/i2c_bus.c; register layouts,
+// bits and StdPeriph values as in CMSIS/device and StdPeriph_Driver
+typedef struct {
+	volatile uint32_t CR1;
+	volatile uint32_t CR2;
+	volatile uint32_t OAR1;
+	volatile uint32_t OAR2;
+	volatile uint32_t TIMINGR;
+	volatile uint32_t TIMEOUTR;
+	volatile uint32_t ISR;
+	volatile uint32_t ICR;
+	volatile uint32_t PECR;
+	volatile uint32_t RXDR;
+	volatile uint32_t TXDR;
+} I2C_TypeDef;
+
+typedef struct {
+	volatile uint32_t CCR;
+	volatile uint32_t CNDTR;
+	volatile uint32_t CPAR;
+	volatile uint32_t CMAR;
+} DMA_Channel_TypeDef;
+
+typedef struct {
+	volatile uint32_t MODER;
+	volatile uint16_t OTYPER;
+	uint16_t RESERVED0;
+	volatile uint32_t OSPEEDR;
+	volatile uint32_t PUPDR;
+	volatile uint16_t IDR;
+	uint16_t RESERVED1;
+	volatile uint16_t ODR;
+	uint16_t RESERVED2;
+	volatile uint32_t BSRR;
+	volatile uint32_t LCKR;
+	volatile uint32_t AFR[2];
+	volatile uint16_t BRR;
+	uint16_t RESERVED3;
+} GPIO_TypeDef;
+
+extern I2C_TypeDef hostI2c1;
+extern DMA_Channel_TypeDef hostDma1Channel3;
+extern GPIO_TypeDef hostGpioB;
+
+#define I2C1                        (&hostI2c1)
+#define DMA1_Channel3               (&hostDma1Channel3)
+#define GPIOB                       (&hostGpioB)
+
+#define I2C_CR1_PE                  0x00000001UL
+#define I2C_CR1_TXIE                0x00000002UL
+#define I2C_CR1_RXIE                0x00000004UL
+#define I2C_CR1_NACKIE              0x00000010UL
+#define I2C_CR1_STOPIE              0x00000020UL
+#define I2C_CR1_TCIE                0x00000040UL
+#define I2C_CR1_ERRIE               0x00000080UL
+#define I2C_CR1_RXDMAEN             0x00008000UL
+#define I2C_CR2_SADD                0x000003FFUL
+#define I2C_CR2_RD_WRN              0x00000400UL
+#define I2C_CR2_START               0x00002000UL
+#define I2C_CR2_STOP                0x00004000UL
+#define I2C_CR2_NBYTES              0x00FF0000UL
+#define I2C_CR2_RELOAD              0x01000000UL
+#define I2C_CR2_AUTOEND             0x02000000UL
+#define I2C_ISR_TXE                 0x00000001UL
+#define I2C_ISR_TXIS                0x00000002UL
+#define I2C_ISR_RXNE                0x00000004UL
+#define I2C_ISR_NACKF               0x00000010UL
+#define I2C_ISR_STOPF               0x00000020UL
+#define I2C_ISR_TC                  0x00000040UL
+#define I2C_ISR_BERR                0x00000100UL
+#define I2C_ISR_ARLO                0x00000200UL
+#define I2C_ISR_OVR                 0x00000400UL
+#define I2C_ISR_BUSY                0x00008000UL
+#define DMA_CCR_EN                  0x00000001UL
+
+#define I2C_IT_ERRI                 I2C_CR1_ERRIE
+#define I2C_IT_TCI                  I2C_CR1_TCIE
+#define I2C_IT_STOPI                I2C_CR1_STOPIE
+#define I2C_IT_NACKI                I2C_CR1_NACKIE
+#define I2C_IT_RXI                  I2C_CR1_RXIE
+#define I2C_IT_TXI                  I2C_CR1_TXIE
+#define I2C_DMAReq_Rx               I2C_CR1_RXDMAEN
+#define I2C_AutoEnd_Mode            I2C_CR2_AUTOEND
+#define I2C_SoftEnd_Mode            0x00000000UL
+#define I2C_Generate_Start_Write    I2C_CR2_START
+#define I2C_Generate_Start_Read     (I2C_CR2_START | I2C_CR2_RD_WRN)
+#define I2C_AnalogFilter_Enable     0x00000000UL
+#define I2C_Mode_I2C                0x00000000UL
+#define I2C_Ack_Enable              0x00000000UL
+#define I2C_AcknowledgedAddress_7bit 0x00000000UL
+
+#define DMA_DIR_PeripheralSRC       0x00000000UL
+#define DMA_PeripheralInc_Disable   0x00000000UL
+#define DMA_MemoryInc_Enable        0x00000080UL
+#define DMA_PeripheralDataSize_Byte 0x00000000UL
+#define DMA_MemoryDataSize_Byte     0x00000000UL
+#define DMA_Mode_Normal             0x00000000UL
+#define DMA_Priority_High           0x00002000UL
+#define DMA_M2M_Disable             0x00000000UL
+
+#define GPIO_Pin_6                  0x0040
+#define GPIO_Pin_7                  0x0080
+#define GPIO_PinSource6             6
+#define GPIO_PinSource7             7
+#define GPIO_AF_1                   1
+
+#define RCC_AHBPeriph_GPIOB         0x00040000UL
+#define RCC_AHBPeriph_DMA1          0x00000001UL
+#define RCC_APB1Periph_I2C1         0x00200000UL
+#define RCC_I2C1CLK_HSI             0x00000000UL
+
+typedef enum {
+	GPIO_Mode_IN = 0,
+	GPIO_Mode_OUT = 1,
+	GPIO_Mode_AF = 2,
+	GPIO_Mode_AN = 3
+} GPIOMode_TypeDef;
+
+typedef enum {
+	GPIO_OType_PP = 0,
+	GPIO_OType_OD = 1
+} GPIOOType_TypeDef;
+
+typedef enum {
+	GPIO_Speed_Level_1 = 1,
+	GPIO_Speed_Level_2 = 2,
+	GPIO_Speed_Level_3 = 3
+} GPIOSpeed_TypeDef;
+
+#define GPIO_Speed_50MHz            GPIO_Speed_Level_3
+
+typedef enum {
+	GPIO_PuPd_NOPULL = 0,
+	GPIO_PuPd_UP = 1,
+	GPIO_PuPd_DOWN = 2
+} GPIOPuPd_TypeDef;
+
+typedef struct {
+	uint32_t GPIO_Pin;
+	GPIOMode_TypeDef GPIO_Mode;
+	GPIOSpeed_TypeDef GPIO_Speed;
+	GPIOOType_TypeDef GPIO_OType;
+	GPIOPuPd_TypeDef GPIO_PuPd;
+} GPIO_InitTypeDef;
+
+typedef struct {
+	uint32_t I2C_Timing;
+	uint32_t I2C_AnalogFilter;
+	uint32_t I2C_DigitalFilter;
+	uint32_t I2C_Mode;
+	uint32_t I2C_OwnAddress1;
+	uint32_t I2C_Ack;
+	uint32_t I2C_AcknowledgedAddress;
+} I2C_InitTypeDef;
+
+typedef struct {
+	uint32_t DMA_PeripheralBaseAddr;
+	uint32_t DMA_MemoryBaseAddr;
+	uint32_t DMA_DIR;
+	uint32_t DMA_BufferSize;
+	uint32_t DMA_PeripheralInc;
+	uint32_t DMA_MemoryInc;
+	uint32_t DMA_PeripheralDataSize;
+	uint32_t DMA_MemoryDataSize;
+	uint32_t DMA_Mode;
+	uint32_t DMA_Priority;
+	uint32_t DMA_M2M;
+} DMA_InitTypeDef;
+
+void RCC_AHBPeriphClockCmd(uint32_t periph, FunctionalState state);
+void RCC_APB1PeriphClockCmd(uint32_t periph, FunctionalState state);
+void RCC_I2CCLKConfig(uint32_t clock);
+void GPIO_Init(GPIO_TypeDef *gpio, GPIO_InitTypeDef *init);
+void GPIO_PinAFConfig(GPIO_TypeDef *gpio, uint16_t source, uint8_t af);
+void GPIO_SetBits(GPIO_TypeDef *gpio, uint16_t pins);
+void GPIO_ResetBits(GPIO_TypeDef *gpio, uint16_t pins);
+uint8_t GPIO_ReadInputDataBit(GPIO_TypeDef *gpio, uint16_t pin);
+void DMA_StructInit(DMA_InitTypeDef *init);
+void DMA_Init(DMA_Channel_TypeDef *channel, DMA_InitTypeDef *init);
+void DMA_Cmd(DMA_Channel_TypeDef *channel, FunctionalState state);
+void DMA_SetCurrDataCounter(DMA_Channel_TypeDef *channel, uint16_t count);
+uint16_t DMA_GetCurrDataCounter(DMA_Channel_TypeDef *channel);
+void I2C_StructInit(I2C_InitTypeDef *init);
+void I2C_Init(I2C_TypeDef *i2c, I2C_InitTypeDef *init);
+void I2C_Cmd(I2C_TypeDef *i2c, FunctionalState state);
+void I2C_SoftwareResetCmd(I2C_TypeDef *i2c, FunctionalState state);
+void I2C_DMACmd(I2C_TypeDef *i2c, uint32_t requests, FunctionalState state);
+void I2C_ITConfig(I2C_TypeDef *i2c, uint32_t interrupts, FunctionalState state);
+void I2C_ClearFlag(I2C_TypeDef *i2c, uint32_t flags);
+void I2C_SendData(I2C_TypeDef *i2c, uint8_t data);
+void I2C_GenerateSTOP(I2C_TypeDef *i2c, FunctionalState state);
+void I2C_TransferHandling(I2C_TypeDef *i2c, uint16_t address, uint8_t count, uint32_t endMode,
+		uint32_t startStopMode);
+
+static inline void NVIC_EnableIRQ(IRQn_Type irq) {
+	(void) irq;
+}
+
+static inline void NVIC_DisableIRQ(IRQn_Type irq) {
+	(void) irq;
+}
+
+// USART1, DMA1 channels 4 and 5 and GPIOA, host/usart_dma.c
+typedef struct {
+	volatile uint32_t CR1;
+	volatile uint32_t CR2;
+	volatile uint32_t CR3;
+	volatile uint32_t BRR;
+	volatile uint32_t GTPR;
+	volatile uint32_t RTOR;
+	volatile uint32_t RQR;
+	volatile uint32_t ISR;
+	volatile uint32_t ICR;
+	volatile uint16_t RDR;
+	uint16_t RESERVED1;
+	volatile uint16_t TDR;
+	uint16_t RESERVED2;
+} USART_TypeDef;
+
+typedef struct {
+	volatile uint32_t ISR;
+	volatile uint32_t IFCR;
+} DMA_TypeDef;
+
+extern USART_TypeDef hostUsart1;
+extern DMA_TypeDef hostDma1;
+extern DMA_Channel_TypeDef hostDma1Channel4;
+extern DMA_Channel_TypeDef hostDma1Channel5;
+extern GPIO_TypeDef hostGpioA;
+
+#define USART1                      (&hostUsart1)
+#define DMA1                        (&hostDma1)
+#define DMA1_Channel4               (&hostDma1Channel4)
+#define DMA1_Channel5               (&hostDma1Channel5)
+#define GPIOA                       (&hostGpioA)
+
+#define USART_CR1_UE                0x00000001UL
+#define USART_CR1_RE                0x00000004UL
+#define USART_CR1_TE                0x00000008UL
+#define USART_CR1_RXNEIE            0x00000020UL
+#define USART_CR1_CMIE              0x00004000UL
+#define USART_CR1_OVER8             0x00008000UL
+#define USART_CR1_RTOIE             0x04000000UL
+#define USART_CR2_ADDM7             0x00000010UL
+#define USART_CR2_RTOEN             0x00800000UL
+#define USART_CR2_ADD               0xFF000000UL
+#define USART_CR3_EIE               0x00000001UL
+#define USART_CR3_DMAR              0x00000040UL
+#define USART_CR3_DMAT              0x00000080UL
+#define USART_RTOR_RTO              0x00FFFFFFUL
+#define USART_RQR_RXFRQ             0x00000008UL
+#define USART_ISR_ORE               0x00000008UL
+#define USART_ISR_RXNE              0x00000020UL
+#define USART_ISR_TC                0x00000040UL
+#define USART_ISR_TXE               0x00000080UL
+#define USART_ISR_RTOF              0x00000800UL
+#define USART_ISR_CMF               0x00020000UL
+#define DMA_CCR_TCIE                0x00000002UL
+#define DMA_CCR_HTIE                0x00000004UL
+#define DMA_CCR_DIR                 0x00000010UL
+#define DMA_CCR_CIRC                0x00000020UL
+#define DMA_ISR_GIF4                0x00001000UL
+#define DMA_ISR_TCIF4               0x00002000UL
+#define DMA_ISR_HTIF4               0x00004000UL
+#define DMA_ISR_GIF5                0x00010000UL
+#define DMA_ISR_TCIF5               0x00020000UL
+#define DMA_ISR_HTIF5               0x00040000UL
+
+#define USART_WordLength_8b         0x00000000UL
+#define USART_StopBits_1            0x00000000UL
+#define USART_Parity_No             0x00000000UL
+#define USART_Mode_Rx               USART_CR1_RE
+#define USART_Mode_Tx               USART_CR1_TE
+#define USART_HardwareFlowControl_None 0x00000000UL
+#define USART_DMAReq_Tx             USART_CR3_DMAT
+#define USART_DMAReq_Rx             USART_CR3_DMAR
+#define USART_FLAG_RTO              USART_ISR_RTOF
+#define USART_FLAG_ORE              USART_ISR_ORE
+#define USART_FLAG_CM               USART_ISR_CMF
+#define USART_AddressLength_7b      USART_CR2_ADDM7
+#define USART_Request_RXFRQ         USART_RQR_RXFRQ
+// Register (bits 8-15, 1 = CR1) and bit (0-4) of the enable
+#define USART_IT_RTO                0x000B011AUL
+#define USART_IT_RXNE               0x00050105UL
+#define USART_IT_CM                 0x0011010EUL
+
+#define DMA_DIR_PeripheralDST       DMA_CCR_DIR
+#define DMA_Mode_Circular           DMA_CCR_CIRC
+#define DMA_Priority_Low            0x00000000UL
+#define DMA_IT_TC                   DMA_CCR_TCIE
+#define DMA_IT_HT                   DMA_CCR_HTIE
+#define DMA1_IT_GL4                 DMA_ISR_GIF4
+#define DMA1_IT_TC4                 DMA_ISR_TCIF4
+#define DMA1_IT_GL5                 DMA_ISR_GIF5
+#define DMA1_IT_TC5                 DMA_ISR_TCIF5
+#define DMA1_IT_HT5                 DMA_ISR_HTIF5
+
+#define GPIO_Pin_9                  0x0200
+#define GPIO_Pin_10                 0x0400
+#define GPIO_PinSource9             9
+#define GPIO_PinSource10            10
+
+#define RCC_AHBPeriph_GPIOA         0x00020000UL
+#define RCC_APB2Periph_SYSCFG       0x00000001UL
+#define RCC_APB2Periph_USART1       0x00004000UL
+#define SYSCFG_DMARemap_USART1Tx    0x00000200UL
+#define SYSCFG_DMARemap_USART1Rx    0x00000400UL
+
+typedef struct {
+	uint32_t USART_BaudRate;
+	uint32_t USART_WordLength;
+	uint32_t USART_StopBits;
+	uint32_t USART_Parity;
+	uint32_t USART_Mode;
+	uint32_t USART_HardwareFlowControl;
+} USART_InitTypeDef;
+
+void RCC_APB2PeriphClockCmd(uint32_t periph, FunctionalState state);
+void SYSCFG_DMAChannelRemapConfig(uint32_t remap, FunctionalState state);
+void GPIO_StructInit(GPIO_InitTypeDef *init);
+void DMA_ITConfig(DMA_Channel_TypeDef *channel, uint32_t interrupts, FunctionalState state);
+uint8_t DMA_GetITStatus(uint32_t interrupt);
+void DMA_ClearITPendingBit(uint32_t interrupt);
+void USART_StructInit(USART_InitTypeDef *init);
+void USART_Init(USART_TypeDef *usart, USART_InitTypeDef *init);
+void USART_OverSampling8Cmd(USART_TypeDef *usart, FunctionalState state);
+void USART_Cmd(USART_TypeDef *usart, FunctionalState state);
+void USART_SetReceiverTimeOut(USART_TypeDef *usart, uint32_t timeout);
+void USART_ReceiverTimeOutCmd(USART_TypeDef *usart, FunctionalState state);
+void USART_SetAddress(USART_TypeDef *usart, uint8_t address);
+void USART_AddressDetectionConfig(USART_TypeDef *usart, uint32_t length);
+void USART_ITConfig(USART_TypeDef *usart, uint32_t interrupt, FunctionalState state);
+void USART_DMACmd(USART_TypeDef *usart, uint32_t requests, FunctionalState state);
+void USART_RequestCmd(USART_TypeDef *usart, uint32_t request, FunctionalState state);
+void USART_ClearFlag(USART_TypeDef *usart, uint32_t flags);
+void NVIC_SetPendingIRQ(IRQn_Type irq);
+
+#endif
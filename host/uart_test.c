@@ -0,0 +1,367 @@
+/************************************************************
+*
+* @file:      uart_test.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     src/debug_uart.c at DEBUG_UART_BAUD against the USART1
+*             and DMA model of host/usart_dma.c: line delivery,
+*             stalls, output, interrupt rate and CPU load
+*
+*             Build and run from the repository root:
+*
+*               gcc -std=gnu99 -O2 -no-pie -Wno-pointer-to-int-cast -Ihost -Iinc \
+*                   -o uart_test host/uart_test.c host/usart_dma.c \
+*                   src/debug_uart.c src/tables.c
+*               ./uart_test
+*
+*             -DDEBUG_UART_BAUD=921600 runs it at another rate,
+*             with the same gaps and stalls in real time.
+*
+*             The loop stands in for the NVIC and the background
+*             loop: after every character time it runs the DMA1
+*             channel 4/5 handler, then the USART1 one, while
+*             either is pending, and every UART_TEST_POLL_CHARS
+*             characters takes the queued lines as main() does.
+*             Each line carries its sequence number, so a line
+*             delivered out of order, twice or torn is caught.
+*             Runs: bursts of one command with the line idle in
+*             between, a continuous stream of commands, the same
+*             stream with the background loop held off for
+*             UART_TEST_STALL_CHARS, lines too long for the queue,
+*             and console output through the TX ring.
+*
+*             Interrupt counts are the model's. Cycles are
+*             estimates, the UART_TEST_CYCLES_ figures below
+*             counted from the Thumb-1 code of the handlers with
+*             one flash wait state, and set against the same
+*             traffic taken by one RXNE interrupt per byte. Exit
+*             status is 1 if any check fails.
+*
+************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "debug_uart.h"
+#include "usart_dma.h"
+
+#define UART_TEST_PCLK              48000000.0
+// Timing is in character times, 10 bits each
+#define UART_TEST_CHARS_PER_MS      (DEBUG_UART_BAUD / 10000)
+// Background loop passes, ~220 us
+#define UART_TEST_POLL_CHARS        (UART_TEST_CHARS_PER_MS * 22 / 100)
+// Background loop held off, ~5 ms, a spectrum FFT and more
+#define UART_TEST_STALL_CHARS       (UART_TEST_CHARS_PER_MS * 5)
+#define UART_TEST_BURSTS            200
+#define UART_TEST_BURST_GAP         UART_TEST_CHARS_PER_MS  // ~1 ms between commands
+#define UART_TEST_STREAM_LINES      20000
+#define UART_TEST_WRITES            400
+#define UART_TEST_MAX_EVENTS        8
+
+// Estimated cycles: exception entry and exit with the vector's call
+#define UART_TEST_CYCLES_IRQ        44
+// scanInput without its loop: DMA counter, held check, returns
+#define UART_TEST_CYCLES_SCAN       80
+// One byte through the scan loop
+#define UART_TEST_CYCLES_BYTE       22
+// TC bookkeeping and startTransmit
+#define UART_TEST_CYCLES_TX_RUN     70
+// A per byte RXNE handler: read RDR, store, advance, test CR/LF
+#define UART_TEST_CYCLES_RXNE       30
+
+typedef struct {
+	uint32_t lines;             // lines taken by the background loop
+	uint32_t expected;          // next sequence number due
+	uint32_t bad;               // torn, repeated or out of order
+	uint32_t skipped;           // sequence numbers never delivered
+	uint32_t usartIrqs;
+	uint32_t dmaIrqs;
+	uint64_t cycles;            // estimated handler cycles
+	uint32_t scannedWrites;     // DMA writes already scanned
+	uint32_t characters;        // at the start of the run
+	double perByteLoad;         // report's RXNE per byte estimate, percent
+} run_t;
+
+static run_t run;
+static char written[UART_TEST_WRITES * 32];
+static uint32_t charsSincePoll = 0;
+static uint8_t heldOff = 0;
+static uint8_t stormed = 0;
+static int failures = 0;
+
+static void check(int ok, const char *what) {
+	printf("  %-4s %s\n", ok ? "ok" : "FAIL", what);
+	if (!ok) {
+		failures++;
+	}
+}
+
+static void scanCost(void) {
+	uint32_t writes = usartDmaGetStats()->dmaWrites;
+
+	run.cycles += UART_TEST_CYCLES_SCAN + (uint64_t) UART_TEST_CYCLES_BYTE
+			* (writes - run.scannedWrites);
+	run.scannedWrites = writes;
+}
+
+/************************************************************
+*
+* Function: serviceInterrupts
+* @brief:   run the two console handlers while pending, the DMA
+*           one first as the NVIC orders equal priorities
+*
+************************************************************/
+static void serviceInterrupts(void) {
+	uint8_t events = 0;
+
+	for (;;) {
+		if (usartDmaTakeIrq(DMA1_Channel4_5_IRQn)) {
+			run.dmaIrqs++;
+			run.cycles += UART_TEST_CYCLES_IRQ;
+			if (DMA_GetITStatus(DMA1_IT_GL5)) {
+				scanCost();
+			} else {
+				run.cycles += UART_TEST_CYCLES_TX_RUN;
+			}
+			debugUartDmaIrqHandler();
+		} else if (usartDmaTakeIrq(USART1_IRQn)) {
+			run.usartIrqs++;
+			run.cycles += UART_TEST_CYCLES_IRQ;
+			scanCost();
+			debugUartIrqHandler();
+		} else {
+			return;
+		}
+		if (++events > UART_TEST_MAX_EVENTS && !stormed) {
+			stormed = 1;
+			check(0, "a handler leaves its flags pending");
+		}
+	}
+}
+
+// Every line is "<sequence> <command>", the command long or short
+static uint16_t makeLine(uint32_t sequence, char *line) {
+	static const char *commands[] = {
+		"speed 200", "hold", "set lqr_tilt 3000", "tel 255", "move -500 300",
+		"sysid 800 3", "prof", "spec 2 1"
+	};
+
+	return (uint16_t) sprintf(line, "%lu %s%s", (unsigned long) sequence,
+			commands[sequence % 8], (sequence % 3) == 0 ? "\r\n" : "\r");
+}
+
+static void takeLine(const char *line) {
+	unsigned long sequence;
+	char expected[64];
+	uint16_t length;
+
+	run.lines++;
+	if (sscanf(line, "%lu", &sequence) != 1 || sequence < run.expected) {
+		run.bad++;
+		return;
+	}
+	length = makeLine((uint32_t) sequence, expected);
+	while (length > 0 && (expected[length - 1] == '\r' || expected[length - 1] == '\n')) {
+		expected[--length] = '\0';
+	}
+	if (strcmp(line, expected) != 0) {
+		run.bad++;
+	}
+	run.skipped += (uint32_t) sequence - run.expected;
+	run.expected = (uint32_t) sequence + 1;
+}
+
+static void poll(void) {
+	const char *line;
+
+	while ((line = debugUartGetLine()) != 0) {
+		takeLine(line);
+		debugUartReleaseLine();
+		serviceInterrupts();
+	}
+}
+
+static void character(int16_t byte) {
+	usartDmaStep(byte);
+	serviceInterrupts();
+	if (++charsSincePoll >= UART_TEST_POLL_CHARS && !heldOff) {
+		charsSincePoll = 0;
+		poll();
+	}
+}
+
+static void idle(uint32_t characters) {
+	while (characters-- > 0) {
+		character(USART_DMA_IDLE);
+	}
+}
+
+static void sendLine(uint32_t sequence) {
+	char line[64];
+	uint16_t length = makeLine(sequence, line);
+	uint16_t i;
+
+	for (i = 0; i < length; i++) {
+		character((uint8_t) line[i]);
+	}
+}
+
+static void startRun(void) {
+	memset(&run, 0, sizeof(run));
+	run.scannedWrites = usartDmaGetStats()->dmaWrites;
+	run.characters = usartDmaGetStats()->characters;
+}
+
+/************************************************************
+*
+* Function: report
+* @brief:   interrupt rate and estimated load of the run so far,
+*           and of one RXNE interrupt per byte on the same input
+* @return:  double, estimated CPU load, percent; the per byte
+*           one is left in run.perByteLoad
+*
+************************************************************/
+static double report(const char *name, uint32_t bytes) {
+	double seconds = (usartDmaGetStats()->characters - run.characters)
+			* (double) usartDmaCyclesPerCharacter() / UART_TEST_PCLK;
+	uint32_t irqs = run.usartIrqs + run.dmaIrqs;
+	double load = 100.0 * run.cycles / (seconds * UART_TEST_PCLK);
+	double perByte = 100.0 * bytes * (UART_TEST_CYCLES_IRQ + UART_TEST_CYCLES_RXNE)
+			/ (seconds * UART_TEST_PCLK);
+
+	printf("  %-10s %7u %8.0f %9.0f %7.3f %%   %9.0f %7.3f %%\n", name, (unsigned) bytes,
+			(double) irqs, irqs / seconds, load, bytes / seconds, perByte);
+	run.perByteLoad = perByte;
+	return load;
+}
+
+static void parseChecks(void) {
+	const char *cursor;
+	int32_t value = 0;
+
+	cursor = "2147483647";
+	check(parseInt(&cursor, &value) == 0 && value == INT32_MAX && *cursor == '\0',
+			"parseInt takes INT32_MAX");
+	cursor = "-2147483647";
+	check(parseInt(&cursor, &value) == 0 && value == -INT32_MAX, "parseInt takes -INT32_MAX");
+	cursor = " 2147483648";
+	check(parseInt(&cursor, &value) == -1 && cursor[0] == ' ',
+			"parseInt refuses INT32_MAX + 1 and leaves the cursor");
+	cursor = "99999999999";
+	check(parseInt(&cursor, &value) == -1, "parseInt refuses 11 digits");
+}
+
+int main(void) {
+	char text[48];
+	uint32_t sent;
+	uint32_t length;
+	uint32_t queued;
+	uint32_t mismatched;
+	uint16_t accepted;
+	const uint8_t *log;
+	double load;
+	uint32_t i;
+
+	usartDmaReset();
+	debugUartInit();
+	printf("console at %d baud, %lu cycles a character\n", DEBUG_UART_BAUD,
+			(unsigned long) usartDmaCyclesPerCharacter());
+	printf("  %-10s %7s %8s %9s %9s   %9s %9s\n", "run", "bytes", "irqs", "irqs/s", "load",
+			"RXNE irq/s", "load");
+
+	// One command at a time, the line idle in between
+	startRun();
+	for (i = 0; i < UART_TEST_BURSTS; i++) {
+		sendLine(i);
+		idle(UART_TEST_BURST_GAP);
+	}
+	sent = usartDmaGetStats()->received;
+	load = report("bursts", sent);
+	check(run.lines == UART_TEST_BURSTS && run.bad == 0 && run.skipped == 0,
+			"bursts: every command delivered once, intact, in order");
+	check(run.usartIrqs == 2 * UART_TEST_BURSTS && run.dmaIrqs <= sent / (DEBUG_UART_RX_SIZE / 2) + 1,
+			"bursts: one match and one receiver timeout interrupt each");
+	check(load < 2.0, "bursts: under 2 % of the CPU");
+
+	// Back to back commands, the wire never idle
+	startRun();
+	length = usartDmaGetStats()->overruns;
+	for (i = 0; i < UART_TEST_STREAM_LINES; i++) {
+		sendLine(i);
+	}
+	idle(UART_TEST_BURST_GAP);
+	sent = usartDmaGetStats()->received - sent;
+	load = report("stream", sent);
+	check(run.lines == UART_TEST_STREAM_LINES && run.bad == 0 && run.skipped == 0,
+			"stream: every command delivered once, intact, in order");
+	check(usartDmaGetStats()->overruns == length, "stream: no overruns");
+	check(run.usartIrqs == UART_TEST_STREAM_LINES + 1
+			&& run.dmaIrqs <= sent / (DEBUG_UART_RX_SIZE / 2) + 2,
+			"stream: one match per line, the marks, one timeout at the end");
+	check(load < 0.5 * run.perByteLoad, "stream: under half the load of an RXNE interrupt per byte");
+
+	// The same with the background loop held off now and then
+	startRun();
+	length = usartDmaGetStats()->overruns;
+	for (i = 0; i < UART_TEST_STREAM_LINES; i++) {
+		if (i % 500 == 100) {
+			heldOff = 1;
+		} else if (i % 500 == 100 + UART_TEST_STALL_CHARS / 20) {
+			heldOff = 0;
+		}
+		sendLine(i);
+	}
+	heldOff = 0;
+	idle(UART_TEST_BURST_GAP);
+	report("stalls", usartDmaGetStats()->received - sent - UART_TEST_BURSTS);
+	printf("       %u of %u lines delivered, %u lost, %u overruns\n", (unsigned) run.lines,
+			UART_TEST_STREAM_LINES, (unsigned) run.skipped,
+			(unsigned) (usartDmaGetStats()->overruns - length));
+	check(run.bad == 0, "stalls: no line torn, repeated or out of order");
+	check(run.skipped > 0 && run.expected == UART_TEST_STREAM_LINES,
+			"stalls: lines are lost while held, and input resumes after");
+	check((USART1->CR3 & USART_CR3_DMAR) != 0, "stalls: RX DMA requests back on");
+
+	// Lines over DEBUG_UART_LINE_SIZE are dropped, the next is not
+	startRun();
+	run.expected = 7;
+	for (i = 0; i < 3 * DEBUG_UART_LINE_SIZE; i++) {
+		character('x');
+	}
+	character('\r');
+	sendLine(7);
+	idle(UART_TEST_BURST_GAP);
+	check(run.lines == 1 && run.bad == 0, "long line dropped, the next delivered");
+
+	// Output: whatever the ring took comes out in order
+	startRun();
+	usartDmaTxLog(&length);
+	queued = 0;
+	for (i = 0; i < UART_TEST_WRITES; i++) {
+		sprintf(text, "tick %lu angle %ld\r\n", (unsigned long) i, (long) (i * 37) - 5000);
+		accepted = debugUartWrite(text);
+		memcpy(&written[queued], text, accepted);
+		queued += accepted;
+		idle(3);
+	}
+	idle(DEBUG_UART_TX_SIZE);
+	log = usartDmaTxLog(&sent);
+	mismatched = 0;
+	for (i = 0; i < queued && i < sent - length; i++) {
+		mismatched += log[(length + i) % USART_DMA_TX_LOG] != (uint8_t) written[i];
+	}
+	report("output", 0);
+	printf("       %u of %u bytes taken by the ring\n", (unsigned) queued,
+			(unsigned) (UART_TEST_WRITES * strlen(text)));
+	check(sent - length == queued && mismatched == 0,
+			"output: every byte the ring took sent, in order");
+
+	parseChecks();
+
+	if (failures > 0) {
+		printf("FAIL, %d checks\n", failures);
+		return 1;
+	}
+	printf("pass\n");
+	return 0;
+}
@@ -0,0 +1,448 @@
+/************************************************************
+*
+* @file:      usart_dma.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Register level model of USART1 and DMA1 channels
+*             4 and 5, for running src/debug_uart.c unchanged on
+*             Linux
+*
+*             Time moves one character, ten bit times, per
+*             usartDmaStep, with or without a byte arriving on RX.
+*             A received byte lands in RDR and sets RXNE; with
+*             DMAR on and channel 5 enabled the channel takes it
+*             the same step, else the next byte finds RXNE set and
+*             is lost with ORE, as RM0091 27.5.3 has it. A byte
+*             equal to ADD sets CMF, the whole byte compared as in
+*             normal reception. The receiver timeout counts idle
+*             bit times from the last stop bit and raises RTOF once
+*             per idle period when it reaches RTOR, with RTOEN set. Channel 5 counts CNDTR
+*             down, raises HTIF at half and TCIF at zero and, in
+*             circular mode, reloads. Channel 4 sends one byte a
+*             step from memory while DMAT is on and CNDTR is not
+*             zero, then raises TCIF. Flags clear through ICR and
+*             IFCR; a global DMA clear takes all of its channel's.
+*             RXFRQ drops RDR with its RXNE.
+*
+*             An interrupt is pending while an enabled flag is
+*             set or software pended it, and usartDmaTakeIrq
+*             takes it as the NVIC does on entry: the software
+*             pend is cleared, flags stay until the handler clears
+*             them. The line rate follows BRR, 16 clocks a bit
+*             unless OVER8.
+*
+*             DMA writes through CMAR as an address, so the test
+*             is linked -no-pie, as host/i2c_test.c is.
+*
+************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include "usart_dma.h"
+
+#define USART_DMA_PCLK              48000000UL
+#define USART_DMA_BITS_PER_CHAR     10
+#define DMA_CCR_MINC                DMA_MemoryInc_Enable
+#define DMA_FLAGS_CH4               0x0000F000UL
+#define DMA_FLAGS_CH5               0x000F0000UL
+
+USART_TypeDef hostUsart1;
+DMA_TypeDef hostDma1;
+DMA_Channel_TypeDef hostDma1Channel4;
+DMA_Channel_TypeDef hostDma1Channel5;
+GPIO_TypeDef hostGpioA;
+
+static uint16_t rxReload = 0;           // channel 5 CNDTR at enable
+static uint16_t txLength = 0;           // channel 4 CNDTR at enable
+static uint32_t idleBits = 0;
+static uint8_t timeoutArmed = 0;        // a byte since the last RTOF
+static uint8_t softwarePending[2];      // USART1, DMA1 channel 4/5
+static uint8_t txLog[USART_DMA_TX_LOG];
+static usartDmaStats_t stats;
+
+/************************************************************
+*
+* Function: usartDmaReset
+* @brief:   power up state, every register and count cleared
+*
+************************************************************/
+void usartDmaReset(void) {
+	memset(&hostUsart1, 0, sizeof(hostUsart1));
+	memset(&hostDma1, 0, sizeof(hostDma1));
+	memset(&hostDma1Channel4, 0, sizeof(hostDma1Channel4));
+	memset(&hostDma1Channel5, 0, sizeof(hostDma1Channel5));
+	memset(&hostGpioA, 0, sizeof(hostGpioA));
+	hostUsart1.ISR = USART_ISR_TXE | USART_ISR_TC;
+	rxReload = 0;
+	txLength = 0;
+	idleBits = 0;
+	timeoutArmed = 0;
+	memset(softwarePending, 0, sizeof(softwarePending));
+	memset(&stats, 0, sizeof(stats));
+}
+
+static void setDmaFlags(uint32_t flags, uint32_t global) {
+	hostDma1.ISR |= flags | global;
+}
+
+static void receiveByDma(void) {
+	DMA_Channel_TypeDef *channel = DMA1_Channel5;
+	uint8_t *memory;
+
+	if (!(hostUsart1.ISR & USART_ISR_RXNE) || !(hostUsart1.CR3 & USART_CR3_DMAR)
+			|| !(channel->CCR & DMA_CCR_EN) || channel->CNDTR == 0) {
+		return;
+	}
+	memory = (uint8_t *) (uintptr_t) channel->CMAR;
+	if (channel->CCR & DMA_CCR_MINC) {
+		memory += rxReload - channel->CNDTR;
+	}
+	*memory = (uint8_t) hostUsart1.RDR;
+	hostUsart1.ISR &= ~USART_ISR_RXNE;
+	stats.dmaWrites++;
+	if (--channel->CNDTR == rxReload / 2) {
+		setDmaFlags(DMA_ISR_HTIF5, DMA_ISR_GIF5);
+	}
+	if (channel->CNDTR == 0) {
+		setDmaFlags(DMA_ISR_TCIF5, DMA_ISR_GIF5);
+		if (channel->CCR & DMA_CCR_CIRC) {
+			channel->CNDTR = rxReload;
+		}
+	}
+}
+
+static void transmitByDma(void) {
+	DMA_Channel_TypeDef *channel = DMA1_Channel4;
+	const uint8_t *memory;
+
+	if (!(hostUsart1.CR1 & USART_CR1_TE) || !(hostUsart1.CR3 & USART_CR3_DMAT)
+			|| !(channel->CCR & DMA_CCR_EN) || channel->CNDTR == 0) {
+		return;
+	}
+	memory = (const uint8_t *) (uintptr_t) channel->CMAR + (txLength - channel->CNDTR);
+	txLog[stats.transmitted % USART_DMA_TX_LOG] = *memory;
+	stats.transmitted++;
+	if (--channel->CNDTR == 0) {
+		setDmaFlags(DMA_ISR_TCIF4, DMA_ISR_GIF4);
+	}
+}
+
+/************************************************************
+*
+* Function: usartDmaStep
+* @brief:   one character time on both wires
+* @param:   rxByte, int16_t, byte arriving on RX, or
+*           USART_DMA_IDLE
+*
+************************************************************/
+void usartDmaStep(int16_t rxByte) {
+	uint8_t receiving = (hostUsart1.CR1 & (USART_CR1_UE | USART_CR1_RE))
+			== (USART_CR1_UE | USART_CR1_RE);
+
+	stats.characters++;
+	// A request left from a stall is served before the next byte
+	receiveByDma();
+	if (rxByte != USART_DMA_IDLE && receiving) {
+		stats.received++;
+		if (hostUsart1.ISR & USART_ISR_RXNE) {
+			hostUsart1.ISR |= USART_ISR_ORE;
+			stats.overruns++;
+		} else {
+			hostUsart1.RDR = (uint16_t) (uint8_t) rxByte;
+			hostUsart1.ISR |= USART_ISR_RXNE;
+		}
+		if ((uint8_t) rxByte == hostUsart1.CR2 >> 24) {
+			hostUsart1.ISR |= USART_ISR_CMF;
+		}
+		idleBits = 0;
+		timeoutArmed = 1;
+		receiveByDma();
+	} else {
+		idleBits += USART_DMA_BITS_PER_CHAR;
+		if (timeoutArmed && (hostUsart1.CR2 & USART_CR2_RTOEN)
+				&& idleBits >= (hostUsart1.RTOR & USART_RTOR_RTO)) {
+			hostUsart1.ISR |= USART_ISR_RTOF;
+			timeoutArmed = 0;
+		}
+	}
+	if (hostUsart1.CR1 & USART_CR1_UE) {
+		transmitByDma();
+	}
+}
+
+/************************************************************
+*
+* Function: usartDmaTakeIrq
+* @brief:   enter the handler if its interrupt is pending
+* @param:   irq, IRQn_Type, USART1_IRQn or DMA1_Channel4_5_IRQn
+* @return:  uint8_t, 1 if pending, the software pend is then
+*           cleared
+*
+************************************************************/
+uint8_t usartDmaTakeIrq(IRQn_Type irq) {
+	uint8_t pending;
+
+	if (irq == USART1_IRQn) {
+		pending = softwarePending[0]
+				|| ((hostUsart1.ISR & USART_ISR_RTOF) && (hostUsart1.CR1 & USART_CR1_RTOIE))
+				|| ((hostUsart1.ISR & USART_ISR_CMF) && (hostUsart1.CR1 & USART_CR1_CMIE))
+				|| ((hostUsart1.ISR & USART_ISR_RXNE) && (hostUsart1.CR1 & USART_CR1_RXNEIE))
+				|| ((hostUsart1.ISR & USART_ISR_ORE) && (hostUsart1.CR3 & USART_CR3_EIE));
+		softwarePending[0] = 0;
+	} else {
+		pending = softwarePending[1]
+				|| ((hostDma1.ISR & DMA_ISR_TCIF4) && (DMA1_Channel4->CCR & DMA_CCR_TCIE))
+				|| ((hostDma1.ISR & DMA_ISR_HTIF4) && (DMA1_Channel4->CCR & DMA_CCR_HTIE))
+				|| ((hostDma1.ISR & DMA_ISR_TCIF5) && (DMA1_Channel5->CCR & DMA_CCR_TCIE))
+				|| ((hostDma1.ISR & DMA_ISR_HTIF5) && (DMA1_Channel5->CCR & DMA_CCR_HTIE));
+		softwarePending[1] = 0;
+	}
+	return pending;
+}
+
+/************************************************************
+*
+* Function: usartDmaCyclesPerCharacter
+* @return:  uint32_t, PCLK cycles per usartDmaStep at the BRR
+*           and oversampling set
+*
+************************************************************/
+uint32_t usartDmaCyclesPerCharacter(void) {
+	uint32_t divider = hostUsart1.BRR;
+
+	if (hostUsart1.CR1 & USART_CR1_OVER8) {
+		// BRR[2:0] holds USARTDIV[3:0] shifted right by one
+		divider = (divider & ~0xFUL) | ((divider & 0x7) << 1);
+		divider /= 2;
+	}
+	return divider * USART_DMA_BITS_PER_CHAR;
+}
+
+/************************************************************
+*
+* Function: usartDmaTxLog
+* @param:   length, uint32_t*, bytes sent since reset
+* @return:  const uint8_t*, the last USART_DMA_TX_LOG of them, in
+*           a ring indexed by count
+*
+************************************************************/
+const uint8_t *usartDmaTxLog(uint32_t *length) {
+	*length = stats.transmitted;
+	return txLog;
+}
+
+const usartDmaStats_t *usartDmaGetStats(void) {
+	return &stats;
+}
+
+// StdPeriph calls made by src/debug_uart.c, acting on the model
+
+void RCC_AHBPeriphClockCmd(uint32_t periph, FunctionalState state) {
+	(void) periph;
+	(void) state;
+}
+
+void RCC_APB2PeriphClockCmd(uint32_t periph, FunctionalState state) {
+	(void) periph;
+	(void) state;
+}
+
+void SYSCFG_DMAChannelRemapConfig(uint32_t remap, FunctionalState state) {
+	(void) remap;
+	(void) state;
+}
+
+void GPIO_StructInit(GPIO_InitTypeDef *init) {
+	init->GPIO_Pin = 0xFFFF;
+	init->GPIO_Mode = GPIO_Mode_IN;
+	init->GPIO_Speed = GPIO_Speed_Level_2;
+	init->GPIO_OType = GPIO_OType_PP;
+	init->GPIO_PuPd = GPIO_PuPd_NOPULL;
+}
+
+void GPIO_Init(GPIO_TypeDef *gpio, GPIO_InitTypeDef *init) {
+	uint8_t pin;
+
+	for (pin = 0; pin < 16; pin++) {
+		if (init->GPIO_Pin & (1U << pin)) {
+			gpio->MODER = (gpio->MODER & ~(3UL << (2 * pin)))
+					| ((uint32_t) init->GPIO_Mode << (2 * pin));
+			gpio->PUPDR = (gpio->PUPDR & ~(3UL << (2 * pin)))
+					| ((uint32_t) init->GPIO_PuPd << (2 * pin));
+		}
+	}
+}
+
+void GPIO_PinAFConfig(GPIO_TypeDef *gpio, uint16_t source, uint8_t af) {
+	gpio->AFR[source >> 3] = (gpio->AFR[source >> 3] & ~(0xFUL << (4 * (source & 7))))
+			| ((uint32_t) af << (4 * (source & 7)));
+}
+
+void DMA_StructInit(DMA_InitTypeDef *init) {
+	memset(init, 0, sizeof(*init));
+}
+
+void DMA_Init(DMA_Channel_TypeDef *channel, DMA_InitTypeDef *init) {
+	channel->CCR = init->DMA_DIR | init->DMA_PeripheralInc | init->DMA_MemoryInc
+			| init->DMA_PeripheralDataSize | init->DMA_MemoryDataSize | init->DMA_Mode
+			| init->DMA_Priority | init->DMA_M2M;
+	channel->CNDTR = init->DMA_BufferSize;
+	channel->CPAR = init->DMA_PeripheralBaseAddr;
+	channel->CMAR = init->DMA_MemoryBaseAddr;
+}
+
+void DMA_Cmd(DMA_Channel_TypeDef *channel, FunctionalState state) {
+	if (state == ENABLE) {
+		channel->CCR |= DMA_CCR_EN;
+		if (channel == DMA1_Channel5) {
+			rxReload = (uint16_t) channel->CNDTR;
+		} else {
+			txLength = (uint16_t) channel->CNDTR;
+		}
+	} else {
+		channel->CCR &= ~DMA_CCR_EN;
+	}
+}
+
+void DMA_SetCurrDataCounter(DMA_Channel_TypeDef *channel, uint16_t count) {
+	// Written only with the channel off, as RM0091 10.4.4 requires
+	if (!(channel->CCR & DMA_CCR_EN)) {
+		channel->CNDTR = count;
+	}
+}
+
+uint16_t DMA_GetCurrDataCounter(DMA_Channel_TypeDef *channel) {
+	return (uint16_t) channel->CNDTR;
+}
+
+void DMA_ITConfig(DMA_Channel_TypeDef *channel, uint32_t interrupts, FunctionalState state) {
+	if (state == ENABLE) {
+		channel->CCR |= interrupts;
+	} else {
+		channel->CCR &= ~interrupts;
+	}
+}
+
+uint8_t DMA_GetITStatus(uint32_t interrupt) {
+	return (hostDma1.ISR & interrupt) != 0;
+}
+
+void DMA_ClearITPendingBit(uint32_t interrupt) {
+	// A global flag clears every flag of its channel
+	if (interrupt & DMA_ISR_GIF4) {
+		interrupt |= DMA_FLAGS_CH4;
+	}
+	if (interrupt & DMA_ISR_GIF5) {
+		interrupt |= DMA_FLAGS_CH5;
+	}
+	hostDma1.ISR &= ~interrupt;
+	if (!(hostDma1.ISR & (DMA_FLAGS_CH4 & ~DMA_ISR_GIF4))) {
+		hostDma1.ISR &= ~DMA_ISR_GIF4;
+	}
+	if (!(hostDma1.ISR & (DMA_FLAGS_CH5 & ~DMA_ISR_GIF5))) {
+		hostDma1.ISR &= ~DMA_ISR_GIF5;
+	}
+}
+
+void USART_StructInit(USART_InitTypeDef *init) {
+	init->USART_BaudRate = 9600;
+	init->USART_WordLength = USART_WordLength_8b;
+	init->USART_StopBits = USART_StopBits_1;
+	init->USART_Parity = USART_Parity_No;
+	init->USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
+	init->USART_HardwareFlowControl = USART_HardwareFlowControl_None;
+}
+
+void USART_Init(USART_TypeDef *usart, USART_InitTypeDef *init) {
+	uint32_t divider;
+
+	usart->CR1 |= init->USART_Mode;
+	if (usart->CR1 & USART_CR1_OVER8) {
+		divider = (2 * USART_DMA_PCLK + init->USART_BaudRate / 2) / init->USART_BaudRate;
+		usart->BRR = (divider & ~0xFUL) | ((divider & 0xF) >> 1);
+	} else {
+		usart->BRR = (USART_DMA_PCLK + init->USART_BaudRate / 2) / init->USART_BaudRate;
+	}
+}
+
+void USART_OverSampling8Cmd(USART_TypeDef *usart, FunctionalState state) {
+	if (state == ENABLE) {
+		usart->CR1 |= USART_CR1_OVER8;
+	} else {
+		usart->CR1 &= ~USART_CR1_OVER8;
+	}
+}
+
+void USART_Cmd(USART_TypeDef *usart, FunctionalState state) {
+	if (state == ENABLE) {
+		usart->CR1 |= USART_CR1_UE;
+	} else {
+		usart->CR1 &= ~USART_CR1_UE;
+	}
+}
+
+void USART_SetReceiverTimeOut(USART_TypeDef *usart, uint32_t timeout) {
+	usart->RTOR = (usart->RTOR & ~USART_RTOR_RTO) | timeout;
+}
+
+void USART_ReceiverTimeOutCmd(USART_TypeDef *usart, FunctionalState state) {
+	if (state == ENABLE) {
+		usart->CR2 |= USART_CR2_RTOEN;
+	} else {
+		usart->CR2 &= ~USART_CR2_RTOEN;
+	}
+}
+
+void USART_SetAddress(USART_TypeDef *usart, uint8_t address) {
+	usart->CR2 = (usart->CR2 & ~USART_CR2_ADD) | ((uint32_t) address << 24);
+}
+
+void USART_AddressDetectionConfig(USART_TypeDef *usart, uint32_t length) {
+	usart->CR2 = (usart->CR2 & ~USART_CR2_ADDM7) | length;
+}
+
+void USART_ITConfig(USART_TypeDef *usart, uint32_t interrupt, FunctionalState state) {
+	uint32_t bit = 1UL << (interrupt & 0x1F);
+	volatile uint32_t *reg;
+
+	switch ((interrupt >> 8) & 0xFF) {
+	case 1:
+		reg = &usart->CR1;
+		break;
+	case 2:
+		reg = &usart->CR2;
+		break;
+	default:
+		reg = &usart->CR3;
+		break;
+	}
+	if (state == ENABLE) {
+		*reg |= bit;
+	} else {
+		*reg &= ~bit;
+	}
+}
+
+void USART_DMACmd(USART_TypeDef *usart, uint32_t requests, FunctionalState state) {
+	if (state == ENABLE) {
+		usart->CR3 |= requests;
+	} else {
+		usart->CR3 &= ~requests;
+	}
+}
+
+void USART_RequestCmd(USART_TypeDef *usart, uint32_t request, FunctionalState state) {
+	if (state == ENABLE && (request & USART_RQR_RXFRQ)) {
+		usart->ISR &= ~USART_ISR_RXNE;
+	}
+}
+
+void USART_ClearFlag(USART_TypeDef *usart, uint32_t flags) {
+	usart->ICR = flags;
+	usart->ISR &= ~flags;
+}
+
+void NVIC_SetPendingIRQ(IRQn_Type irq) {
+	softwarePending[irq == USART1_IRQn ? 0 : 1] = 1;
+}
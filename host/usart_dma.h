@@ -0,0 +1,39 @@
+/************************************************************
+*
+* @file:      usart_dma.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Register level model of USART1 and DMA1 channels
+*             4 and 5, for running src/debug_uart.c unchanged on
+*             Linux
+*
+************************************************************/
+
+#ifndef __USART_DMA_H__
+#define __USART_DMA_H__
+
+#include <stdint.h>
+#include "stm32f0xx.h"
+
+// usartDmaStep with the line idle
+#define USART_DMA_IDLE              (-1)
+// Bytes of transmitted output kept for the test to read
+#define USART_DMA_TX_LOG            4096
+
+typedef struct {
+	uint32_t characters;        // character times stepped
+	uint32_t received;          // bytes on RX
+	uint32_t overruns;          // bytes lost with RXNE still set
+	uint32_t dmaWrites;         // bytes the RX channel stored
+	uint32_t transmitted;       // bytes the TX channel sent
+} usartDmaStats_t;
+
+void usartDmaReset(void);
+void usartDmaStep(int16_t rxByte);
+uint8_t usartDmaTakeIrq(IRQn_Type irq);
+uint32_t usartDmaCyclesPerCharacter(void);
+const uint8_t *usartDmaTxLog(uint32_t *length);
+const usartDmaStats_t *usartDmaGetStats(void);
+
+#endif
@@ -0,0 +1,60 @@
+/************************************************************
+*
+* @file:      watchdog.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Linux build of the task supervisor, same deadline
+*             checks as src/watchdog.c
+*
+*             There is no IWDG to starve: a missed deadline is
+*             reported to host/firmware.c, which ends the run as
+*             the reset would. No run follows a reset, so there
+*             is never a previous failure to report.
+*
+************************************************************/
+
+#include "watchdog.h"
+#include "host.h"
+
+watchdogTask_t watchdogTasks[WATCHDOG_MAX_TASKS];
+
+static uint8_t taskCount = 0;
+static uint8_t failedTask = WATCHDOG_NO_TASK;
+
+void watchdogInit(void) {
+	taskCount = 0;
+	failedTask = WATCHDOG_NO_TASK;
+}
+
+uint8_t watchdogRegister(uint32_t deadline) {
+	uint8_t id = taskCount;
+
+	if (id >= WATCHDOG_MAX_TASKS) {
+		return WATCHDOG_NO_TASK;
+	}
+	watchdogTasks[id].deadline = deadline;
+	watchdogTasks[id].lastCheckIn = tickCount;
+	taskCount = id + 1;
+	return id;
+}
+
+void watchdogService(void) {
+	uint32_t now = tickCount;
+	uint8_t i;
+
+	if (failedTask != WATCHDOG_NO_TASK) {
+		return;
+	}
+	for (i = 0; i < taskCount; i++) {
+		if (now - watchdogTasks[i].lastCheckIn > watchdogTasks[i].deadline) {
+			failedTask = i;
+			watchdogHostReset(i);
+			return;
+		}
+	}
+}
+
+uint8_t watchdogLastFailure(void) {
+	return WATCHDOG_NO_TASK;
+}
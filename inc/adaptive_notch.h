@@ -0,0 +1,39 @@
+/************************************************************
+*
+* @file:      adaptive_notch.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     IMU notch filters that follow the wheel step
+*             frequency, retuned from the stepper timer period
+*
+************************************************************/
+
+#ifndef __ADAPTIVE_NOTCH_H__
+#define __ADAPTIVE_NOTCH_H__
+
+#include "imu_filter.h"
+#include "stepper.h"
+#include "tables.h"
+
+// notchCoefficients covers NOTCH_FIRST_HZ to NOTCH_LAST_HZ every
+// NOTCH_STEP_HZ, designed for NOTCH_SAMPLE_HZ
+// Torque ripple repeats every full step, i.e. every 16 microstep pulses
+#define NOTCH_STEPS_PER_CYCLE       16
+#define NOTCH_BYPASS                0xFF
+
+typedef struct {
+	arm_biquad_casd_df1_inst_q15 instance[IMU_AXIS_COUNT];
+	q15_t state[IMU_AXIS_COUNT][4 * STEPPER_COUNT];
+	// One notch stage per wheel, shared by every axis
+	q15_t coeffs[6 * STEPPER_COUNT];
+	uint8_t bin[STEPPER_COUNT];
+	uint8_t enabled;            // bit per imuAxis_t
+} adaptiveNotch_t;
+
+void adaptiveNotchInit(adaptiveNotch_t *notch, uint8_t axisMask);
+uint8_t adaptiveNotchBin(uint16_t stepPeriod);
+void adaptiveNotchTune(adaptiveNotch_t *notch, stepperId_t wheel, uint16_t stepPeriod);
+void adaptiveNotchProcess(adaptiveNotch_t *notch, imuSample_t *samples, uint16_t count);
+
+#endif
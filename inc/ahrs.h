@@ -0,0 +1,72 @@
+/************************************************************
+*
+* @file:      ahrs.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Madgwick quaternion attitude and heading filter
+*             in fixed point, host buildable
+*
+************************************************************/
+
+#ifndef __AHRS_H__
+#define __AHRS_H__
+
+#include <stdint.h>
+#include "fixmath.h"
+#include "sensor_types.h"
+
+#ifndef AHRS_SAMPLE_RATE_HZ
+#define AHRS_SAMPLE_RATE_HZ         1000
+#endif
+
+// Q16 factor from gyro LSB (65.5 LSB per deg/s) to the Q30 half
+// angle turned over one sample; a Q8 one alone would be a 1e-5
+// scale error, which adds up to a degree within minutes of turning
+#define AHRS_GYRO_TO_HALF_Q16       (9375315087LL / AHRS_SAMPLE_RATE_HZ)
+#if AHRS_GYRO_TO_HALF_Q16 > 0xFFFFFF
+#error "AHRS_GYRO_TO_HALF_Q16 must keep gyro products in 32 bits"
+#endif
+
+// Samples per accel and compass correction, the gyro is
+// integrated on every one
+#ifndef AHRS_CORRECTION_DIVIDER
+#define AHRS_CORRECTION_DIVIDER     10
+#endif
+#define AHRS_CORRECTION_RATE_HZ     (AHRS_SAMPLE_RATE_HZ / AHRS_CORRECTION_DIVIDER)
+
+// Q30 step per correction for a filter gain beta in rad/s
+#define AHRS_BETA(radPerSec)        (int32_t) ((radPerSec) * (1 << 30) / AHRS_CORRECTION_RATE_HZ)
+// sqrt(3/4) of a ~2 deg/s gyro error, as Madgwick suggests
+#define AHRS_BETA_DEFAULT           AHRS_BETA(0.03)
+
+typedef enum {
+	AHRS_W = 0,
+	AHRS_X,
+	AHRS_Y,
+	AHRS_Z,
+	AHRS_QUATERNION_SIZE
+} ahrsComponent_t;
+
+typedef enum {
+	AHRS_ROLL = 0,              // about X
+	AHRS_PITCH,                 // about Y
+	AHRS_YAW,                   // about Z, heading once the compass is in
+	AHRS_ANGLE_COUNT
+} ahrsAngle_t;
+
+typedef struct {
+	int32_t q[AHRS_QUATERNION_SIZE]; // Q30 unit quaternion, sensor to earth
+	int16_t accel[3];           // latest accel sample
+	int16_t mag[3];             // latest valid compass reading
+	int32_t beta;               // Q30 per correction, below 2^21
+	uint8_t useMag;             // 0 runs accel and gyro only
+	uint8_t magValid;           // mag[] arrived since the last correction
+} ahrs_t;
+
+void ahrsInit(ahrs_t *ahrs, int32_t beta, uint8_t useMag);
+void ahrsPropagate(ahrs_t *ahrs, const imuSample_t *sample);
+void ahrsCorrect(ahrs_t *ahrs);
+void ahrsGetEuler(const int32_t q[AHRS_QUATERNION_SIZE], int32_t angles[AHRS_ANGLE_COUNT]);
+
+#endif
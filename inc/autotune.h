@@ -0,0 +1,68 @@
+/************************************************************
+*
+* @file:      autotune.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Relay feedback (Astrom-Hagglund) auto-tuner for the
+*             tilt PID, run one step per control tick
+*
+************************************************************/
+
+#ifndef __AUTOTUNE_H__
+#define __AUTOTUNE_H__
+
+#include <stdint.h>
+#include "pid.h"
+
+#ifndef AUTOTUNE_SAMPLE_RATE_HZ
+#define AUTOTUNE_SAMPLE_RATE_HZ     1000
+#endif
+
+// Full relay cycles ignored while the oscillation settles
+#define AUTOTUNE_SETTLE_CYCLES      2
+// Cycles averaged for amplitude and period, power of two
+#define AUTOTUNE_MEASURE_SHIFT      2
+#define AUTOTUNE_MEASURE_CYCLES     (1 << AUTOTUNE_MEASURE_SHIFT)
+// Give up if the cycles take longer than this, or the period is
+// so long it cannot be a balance oscillation
+#define AUTOTUNE_TIMEOUT_TICKS      (10 * AUTOTUNE_SAMPLE_RATE_HZ)
+#define AUTOTUNE_MAX_PERIOD_TICKS   (2 * AUTOTUNE_SAMPLE_RATE_HZ)
+// Q11 ultimate gain of a relay: 4 d / (pi a) = d * (4 * 2^11 / pi) / a
+#define AUTOTUNE_KU_SCALE           2608
+// Q15 kp / Ku, Tyreus-Luyben 1 / 2.2
+#define AUTOTUNE_KP_FRACTION        14895
+
+typedef enum {
+	AUTOTUNE_IDLE = 0,
+	AUTOTUNE_RUNNING,
+	AUTOTUNE_DONE,
+	AUTOTUNE_FAILED
+} autotuneStatus_t;
+
+typedef struct {
+	int32_t ultimateGain;       // Q11, same units as the PID gains
+	uint16_t period;            // ultimate period in ticks
+	pidGains_t gains;           // Tyreus-Luyben PID from the above
+} autotuneResult_t;
+
+typedef struct {
+	autotuneStatus_t status;
+	int16_t relay;              // Q15 relay amplitude d
+	int16_t hysteresis;         // Q15 band around zero
+	int16_t lead;               // Q11 kd / kp ratio of the relay input
+	int8_t output;              // +1 or -1, current relay side
+	int16_t peakHigh;           // of the relay input
+	int16_t peakLow;
+	uint8_t cycles;             // rising switches seen
+	uint32_t ticks;             // since start
+	uint32_t measureStart;      // tick of the first measured cycle
+	int32_t swingSum;           // peak to peak over measured cycles
+	autotuneResult_t result;
+} autotune_t;
+
+void autotuneStart(autotune_t *tuner, int16_t relay, int16_t hysteresis, int16_t lead);
+int16_t autotuneStep(autotune_t *tuner, int16_t tilt, int16_t rate);
+void autotuneAbort(autotune_t *tuner);
+
+#endif
@@ -0,0 +1,71 @@
+/************************************************************
+*
+* @file:      balance.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Fixed rate balance task: sensor, tilt estimate,
+*             state feedback and wheel commands
+*
+************************************************************/
+
+#ifndef __BALANCE_H__
+#define __BALANCE_H__
+
+#include "stm32f0xx.h"
+#include "calibration.h"
+#include "profile.h"
+#include "autotune.h"
+#include "ahrs.h"
+
+// Beyond this tilt the robot has fallen, motors are released
+#define BALANCE_TILT_LIMIT          (45 * ANGLE_PER_DEG)
+
+typedef enum {
+	BALANCE_CONTROLLER_LQR = 0, // full state feedback
+	BALANCE_CONTROLLER_PID      // gain scheduled PID on tilt
+} balanceController_t;
+
+// Gains tunable at run time through balanceSetParam
+typedef enum {
+	BALANCE_PARAM_LQR_TILT = 0, // lqrGains_t, in lqrStateIndex_t order
+	BALANCE_PARAM_LQR_RATE,
+	BALANCE_PARAM_LQR_POSITION,
+	BALANCE_PARAM_LQR_VELOCITY,
+	BALANCE_PARAM_SPEED_KP,     // motionGains_t, max speed above 0
+	BALANCE_PARAM_SPEED_KI,
+	BALANCE_PARAM_POSITION_KP,
+	BALANCE_PARAM_MAX_SPEED,
+	BALANCE_PARAM_MAX_TILT,
+	BALANCE_PARAM_KALMAN_ANGLE, // kalmanGains_t, angle above 0, bias below
+	BALANCE_PARAM_KALMAN_BIAS,
+	BALANCE_PARAM_AHRS_BETA,    // ahrs_t, 0 .. 2^21 - 1
+	BALANCE_PARAM_COUNT
+} balanceParam_t;
+
+// Whole tick, sensor to wheel command, the outer loop and the AHRS alone
+extern profileProbe_t balanceProfile;
+extern profileProbe_t balanceInnerProfile;
+extern profileProbe_t balanceOuterProfile;
+extern profileProbe_t balanceAhrsProfile;
+
+void balanceInit(void);
+void balanceStep(void);
+void balanceSetCalibration(const imuCalibration_t *calibration);
+void balanceSetMagCalibration(const magCalibration_t *calibration);
+void balanceSetController(balanceController_t controller);
+int32_t balanceGetTilt(void);
+void balanceGetAttitude(int32_t angles[AHRS_ANGLE_COUNT]);
+uint8_t balanceIsRunning(void);
+int balanceInhibitMotors(uint8_t inhibit);
+int balanceStartAutotune(int16_t relay, int16_t hysteresis, int16_t lead);
+autotuneStatus_t balanceTakeAutotune(autotuneResult_t *result);
+void balanceHold(void);
+int balanceSetSpeed(int16_t speed);
+int balanceMove(int32_t distance);
+int balanceGetParam(balanceParam_t param, int32_t *value);
+int balanceSetParam(balanceParam_t param, int32_t value);
+void balanceCaptureRaw(uint8_t enable);
+uint32_t balanceGetRawSample(imuSample_t *copy);
+
+#endif
@@ -0,0 +1,143 @@
+/************************************************************
+*
+* @file:      calibration.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Gyro bias, accel offset/scale and compass hard/soft
+*             iron calibration with single pass integer statistics
+*
+************************************************************/
+
+#ifndef __CALIBRATION_H__
+#define __CALIBRATION_H__
+
+#include "sensor_types.h"
+
+#define CAL_SCALE_SHIFT             14
+#define CAL_SCALE_ONE               (1 << CAL_SCALE_SHIFT)
+// Welford mean is kept in Q8 raw LSB
+#define CAL_MEAN_SHIFT              8
+// Max variance (raw LSB^2) tolerated while the robot must be still
+#define CAL_GYRO_MAX_VARIANCE       400
+#define CAL_ACCEL_MAX_VARIANCE      2500
+// Single sample deviation from the running mean that aborts at once
+#define CAL_GYRO_MAX_DEVIATION      300
+// Warm up samples before deviation checks are trusted
+#define CAL_WARMUP_SAMPLES          32
+// Pose axis must read > 0.8 g and the other two < 0.2 g
+#define CAL_POSE_MAJOR              (ACCEL_LSB_PER_G * 4 / 5)
+#define CAL_POSE_MINOR              (ACCEL_LSB_PER_G / 5)
+// +X, -X, +Y, -Y, +Z, -Z
+#define CAL_POSE_COUNT              6
+#define CAL_ALL_POSES               ((1 << CAL_POSE_COUNT) - 1)
+
+// Smallest max - min span (raw LSB, 0.15 uT) accepted per compass axis
+#define MAG_CAL_MIN_SPAN            300
+// Smallest axis radius accepted, 1/2^n of the mean of the three; a
+// flatter ellipse is a bad sweep, and its scale would not fit Q14
+#define MAG_CAL_MIN_RADIUS_SHIFT    1
+
+typedef struct {
+	uint32_t count;
+	int32_t mean;               // Q8 raw LSB
+	int32_t remainder;          // of the mean's division, carried over
+	uint64_t m2;                // sum of squared deviations, Q16 raw LSB^2
+} welford_t;
+
+// Corrected = (raw * scale + offset) >> CAL_SCALE_SHIFT; naturally
+// aligned, word and halfword loads in calibrationApply, and saved
+// field by field (main.c), so the layout is free
+typedef struct {
+	int32_t offset[IMU_AXIS_COUNT];     // Q14 LSB, already multiplied by scale
+	int16_t scale[IMU_AXIS_COUNT];      // Q14, 1.0 = CAL_SCALE_ONE
+} imuCalibration_t;
+
+typedef enum {
+	CAL_RUNNING = 0,
+	CAL_POSE_DONE,              // pose accepted, place the next one
+	CAL_MOTION,                 // pose rejected, robot moved
+	CAL_BAD_POSE,               // pose rejected, not axis aligned
+	CAL_DONE,                   // gyro and all six accel poses done
+	CAL_INCOMPLETE              // gyro done, accel poses missing
+} calStatus_t;
+
+typedef struct {
+	welford_t stats[IMU_AXIS_COUNT];
+	uint32_t samplesPerPose;
+	int32_t poseMean[CAL_POSE_COUNT];   // Q8, dominant accel axis per pose
+	int32_t gyroBiasSum[3];             // Q8, sum of per pose gyro means
+	uint8_t gyroPoses;
+	uint8_t poseMask;
+	uint8_t aborted;
+} calibration_t;
+
+// Compass, corrected = ((raw - offset) * scale) >> CAL_SCALE_SHIFT
+typedef struct {
+	int16_t offset[3];          // hard iron, raw LSB
+	int16_t scale[3];           // Q14, soft iron and factory ASA combined
+} magCalibration_t;
+
+// Running extremes while the robot is turned through all headings
+typedef struct {
+	int16_t min[3];
+	int16_t max[3];
+	uint32_t count;
+} magCalCollector_t;
+
+void welfordReset(welford_t *stats);
+void welfordAdd(welford_t *stats, int16_t value);
+uint32_t welfordVariance(const welford_t *stats);
+
+void calibrationBegin(calibration_t *cal, uint32_t samplesPerPose);
+void calibrationStartPose(calibration_t *cal);
+calStatus_t calibrationAddSample(calibration_t *cal, const imuSample_t *sample);
+calStatus_t calibrationFinish(const calibration_t *cal, imuCalibration_t *result);
+void calibrationIdentity(imuCalibration_t *result);
+
+void magCalIdentity(magCalibration_t *result);
+void magCalBegin(magCalCollector_t *collector);
+void magCalAddSample(magCalCollector_t *collector, const imuSample_t *sample);
+calStatus_t magCalFinish(const magCalCollector_t *collector, const uint8_t *asa,
+		magCalibration_t *result);
+
+/************************************************************
+*
+* Function: calibrationApply
+* @brief:   correct all six axes, one multiply-add per axis
+* @param:   cal, const imuCalibration_t*, coefficients
+* @param:   sample, imuSample_t*, corrected in place
+*
+************************************************************/
+static inline void calibrationApply(const imuCalibration_t *cal, imuSample_t *sample) {
+	int32_t corrected;
+	uint8_t i;
+
+	for (i = 0; i < IMU_AXIS_COUNT; i++) {
+		corrected = (sample->axis[i] * cal->scale[i] + cal->offset[i]) >> CAL_SCALE_SHIFT;
+		if (corrected > INT16_MAX) {
+			corrected = INT16_MAX;
+		} else if (corrected < INT16_MIN) {
+			corrected = INT16_MIN;
+		}
+		sample->axis[i] = (int16_t) corrected;
+	}
+}
+
+/************************************************************
+*
+* Function: magCalApply
+* @brief:   remove hard iron and apply soft iron/ASA scale in
+*           place, one subtract and one multiply per axis
+*
+************************************************************/
+static inline void magCalApply(const magCalibration_t *cal, imuSample_t *sample) {
+	uint8_t i;
+
+	for (i = 0; i < 3; i++) {
+		sample->mag[i] = (int16_t) (((int32_t) (sample->mag[i] - cal->offset[i])
+				* cal->scale[i]) >> CAL_SCALE_SHIFT);
+	}
+}
+
+#endif
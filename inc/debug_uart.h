@@ -0,0 +1,50 @@
+/************************************************************
+*
+* @file:      debug_uart.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     USART1 debug console, DMA line input and buffered
+*             output
+*
+************************************************************/
+
+#ifndef __DEBUG_UART_H__
+#define __DEBUG_UART_H__
+
+#include "stm32f0xx.h"
+
+// 3 Mbaud carries TELEMETRY_REPLAY_MASK and is the most the 48 MHz
+// PCLK reaches sampling each bit 16 times (BRR = 16). Above it the
+// USART samples 8 times, up to 6 Mbaud, but at 80 cycles a
+// character a continuous input stream overruns (host/uart_test.c)
+#ifndef DEBUG_UART_BAUD
+#define DEBUG_UART_BAUD             3000000
+#endif
+#define DEBUG_UART_OVER16_MAX       (48000000 / 16)
+#define DEBUG_UART_LINE_SIZE        64
+// Must be a power of two, and hold a whole telemetry frame
+#define DEBUG_UART_TX_SIZE          512
+// Circular DMA input, a power of two; lines are read in place, so
+// it must hold whatever arrives while one is handled, 0.85 ms of
+// continuous input at 3 Mbaud
+#define DEBUG_UART_RX_SIZE          256
+// Complete lines waiting for the background loop, a power of two;
+// one scan at the end of a burst may find several
+#define DEBUG_UART_LINE_QUEUE       16
+// Idle bit times after the last byte that close a burst, two characters
+#define DEBUG_UART_RX_TIMEOUT       20
+
+void debugUartInit(void);
+const char *debugUartGetLine(void);
+void debugUartReleaseLine(void);
+uint16_t debugUartWrite(const char *text);
+uint16_t debugUartWriteBytes(const uint8_t *data, uint16_t length);
+uint16_t debugUartTxFree(void);
+void debugUartWriteInt(int32_t value);
+void debugUartIrqHandler(void);
+void debugUartDmaIrqHandler(void);
+
+int parseInt(const char **cursor, int32_t *value);
+
+#endif
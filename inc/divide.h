@@ -0,0 +1,146 @@
+/************************************************************
+*
+* @file:      divide.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Division without the Cortex-M0 libgcc divide calls:
+*             reciprocal LUT division and constant divisors
+*
+************************************************************/
+
+#ifndef __DIVIDE_H__
+#define __DIVIDE_H__
+
+#include <stdint.h>
+#include "tables.h"
+
+// divideReciprocalTable: 2^31 / x - 2^15, rounded up, for
+// x = 2^15 + i * 2^(15 - DIVIDE_LUT_BITS), i = 0 .. 2^DIVIDE_LUT_BITS
+#define DIVIDE_LUT_FRAC_BITS        (15 - DIVIDE_LUT_BITS)
+
+/************************************************************
+* Constant divisors, Granlund-Montgomery: for any 32 bit n
+* and constant d >= 1, with L = ceil(log2(d)),
+*   t = (m * n) >> 32,  m = floor(2^32 * (2^L - d) / d) + 1
+*   n / d = (t + ((n - t) >> min(L, 1))) >> max(L - 1, 0)
+* All of m, L and the shifts fold to constants at compile time.
+************************************************************/
+#define DIVIDE_CEIL_LOG2(d) ( \
+	((d) > 0x1u) + ((d) > 0x2u) + ((d) > 0x4u) + ((d) > 0x8u) + \
+	((d) > 0x10u) + ((d) > 0x20u) + ((d) > 0x40u) + ((d) > 0x80u) + \
+	((d) > 0x100u) + ((d) > 0x200u) + ((d) > 0x400u) + ((d) > 0x800u) + \
+	((d) > 0x1000u) + ((d) > 0x2000u) + ((d) > 0x4000u) + ((d) > 0x8000u) + \
+	((d) > 0x10000u) + ((d) > 0x20000u) + ((d) > 0x40000u) + ((d) > 0x80000u) + \
+	((d) > 0x100000u) + ((d) > 0x200000u) + ((d) > 0x400000u) + ((d) > 0x800000u) + \
+	((d) > 0x1000000u) + ((d) > 0x2000000u) + ((d) > 0x4000000u) + ((d) > 0x8000000u) + \
+	((d) > 0x10000000u) + ((d) > 0x20000000u) + ((d) > 0x40000000u) + ((d) > 0x80000000u))
+#define DIVIDE_MAGIC(d)             ((uint32_t) ((((1ULL << DIVIDE_CEIL_LOG2(d)) - (d)) << 32) / (d) + 1))
+#define DIVIDE_SHIFT1(d)            (DIVIDE_CEIL_LOG2(d) > 0 ? 1 : 0)
+#define DIVIDE_SHIFT2(d)            (DIVIDE_CEIL_LOG2(d) > 0 ? DIVIDE_CEIL_LOG2(d) - 1 : 0)
+#define DIVIDE_CONST_U32(n, d)      divideByMagic((n), DIVIDE_MAGIC(d), DIVIDE_SHIFT1(d), DIVIDE_SHIFT2(d))
+
+/************************************************************
+*
+* Function: mulhiU32
+* @brief:   high word of a 32 x 32 bit product from four 16 bit
+*           multiplies; the M0 MULS only keeps the low word and
+*           a 64 bit multiply would call __aeabi_lmul
+*
+************************************************************/
+static inline uint32_t mulhiU32(uint32_t a, uint32_t b) {
+	uint32_t aLow = a & 0xFFFF;
+	uint32_t aHigh = a >> 16;
+	uint32_t bLow = b & 0xFFFF;
+	uint32_t bHigh = b >> 16;
+	uint32_t low = aLow * bLow;
+	uint32_t cross1 = aHigh * bLow;
+	uint32_t cross2 = aLow * bHigh;
+	uint32_t carry = ((low >> 16) + (cross1 & 0xFFFF) + (cross2 & 0xFFFF)) >> 16;
+
+	return aHigh * bHigh + (cross1 >> 16) + (cross2 >> 16) + carry;
+}
+
+static inline uint32_t divideByMagic(uint32_t n, uint32_t magic, uint8_t shift1, uint8_t shift2) {
+	uint32_t t = mulhiU32(magic, n);
+
+	return (t + ((n - t) >> shift1)) >> shift2;
+}
+
+/************************************************************
+*
+* Function: divideReciprocal
+* @brief:   reciprocal of d from the table with linear
+*           interpolation, never below the exact value and at
+*           most 2^-14 above it, the table's rounding up plus
+*           the truncated interpolation step
+* @param:   d, uint16_t, divisor, not 0
+* @param:   shift, uint8_t*, set so that r ~ 2^(31 - shift) / d
+* @return:  uint32_t, r in [2^15, 2^16]
+*
+************************************************************/
+static inline uint32_t divideReciprocal(uint16_t d, uint8_t *shift) {
+	uint32_t x = d;
+	uint32_t index;
+	uint32_t frac;
+	uint32_t r0;
+	uint32_t r1;
+	uint8_t bits = 0;
+
+	// The M0 has no CLZ, normalize x into [2^15, 2^16) by halving steps
+	if (x < 0x0100) {
+		x <<= 8;
+		bits += 8;
+	}
+	if (x < 0x1000) {
+		x <<= 4;
+		bits += 4;
+	}
+	if (x < 0x4000) {
+		x <<= 2;
+		bits += 2;
+	}
+	if (x < 0x8000) {
+		x <<= 1;
+		bits += 1;
+	}
+	*shift = bits;
+
+	index = (x >> DIVIDE_LUT_FRAC_BITS) - (1 << DIVIDE_LUT_BITS);
+	frac = x & ((1 << DIVIDE_LUT_FRAC_BITS) - 1);
+	r0 = 0x8000 + divideReciprocalTable[index];
+	r1 = 0x8000 + divideReciprocalTable[index + 1];
+	// 1 / x is convex, the chord and the truncation both stay above it
+	return r0 - (((r0 - r1) * frac) >> DIVIDE_LUT_FRAC_BITS);
+}
+
+/************************************************************
+*
+* Function: divideU16
+* @brief:   exact n / d, rounded down, by table reciprocal and
+*           one multiply back to fix the last bit
+* @param:   d, uint16_t, divisor, not 0
+*
+************************************************************/
+static inline uint16_t divideU16(uint16_t n, uint16_t d) {
+	uint8_t shift;
+	uint32_t r = divideReciprocal(d, &shift);
+	uint32_t q = ((uint32_t) n * r) >> (31 - shift);
+
+	if (q * d > n) {
+		q--;
+	}
+	return (uint16_t) q;
+}
+
+/************************************************************
+*
+* Function: divideU32By10
+* @brief:   n / 10 for decimal printing
+*
+************************************************************/
+static inline uint32_t divideU32By10(uint32_t n) {
+	return DIVIDE_CONST_U32(n, 10);
+}
+
+#endif
@@ -0,0 +1,39 @@
+/************************************************************
+*
+* @file:      fastmath.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Integer atan2, sqrt and inverse sqrt for the
+*             Cortex-M0, host buildable
+*
+*             Angles follow fixmath.h: fractions of pi that wrap
+*             like binary angles, so +180 deg comes back as -180.
+*             Max errors below were measured on the host against
+*             double precision libm, exhaustively for the 16 bit
+*             kernels and over dense sweeps for the 32 bit ones:
+*
+*             atan2Q15   polynomial, <= 1.3 LSB (0.0072 deg)
+*             atan2Q31   CORDIC,     <= 26 LSB  (2.2e-6 deg)
+*             sqrtU32    exact floor
+*             sqrtQ15    exact floor
+*             sqrtQ31    <= 3.6 LSB
+*             rsqrtU32   relative error <= 2^-29.4
+*
+************************************************************/
+
+#ifndef __FASTMATH_H__
+#define __FASTMATH_H__
+
+#include <stdint.h>
+#include "fixmath.h"
+#include "tables.h"
+
+int16_t atan2Q15(int16_t y, int16_t x);
+int32_t atan2Q31(int32_t y, int32_t x);
+uint16_t sqrtU32(uint32_t x);
+int16_t sqrtQ15(int16_t x);
+int32_t sqrtQ31(int32_t x);
+uint32_t rsqrtU32(uint32_t x, uint8_t *shift);
+
+#endif
@@ -0,0 +1,91 @@
+/************************************************************
+*
+* @file:      fixmath.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Fixed point helpers and angle units shared by the
+*             estimators and controllers, host buildable
+*
+*             Angles are Q31 fractions of pi: INT32_MAX is just
+*             under +180 deg and the type wraps like a binary
+*             angle, so heading arithmetic needs no range checks.
+*
+************************************************************/
+
+#ifndef __FIXMATH_H__
+#define __FIXMATH_H__
+
+#include <stdint.h>
+
+#define Q31_ONE                     0x7FFFFFFF
+#define Q15_ONE                     0x7FFF
+
+// Q31 angle of one degree, 2^31 / 180
+#define ANGLE_PER_DEG               11930465
+
+/************************************************************
+*
+* Function: mulQ31
+* @brief:   Q31 x Q31 with a 64 bit intermediate, truncating
+*
+************************************************************/
+static inline int32_t mulQ31(int32_t a, int32_t b) {
+	return (int32_t) (((int64_t) a * b) >> 31);
+}
+
+/************************************************************
+*
+* Function: mulQ31Round
+* @brief:   Q31 x Q31 rounded to nearest, for products that are
+*           accumulated, where truncation would add -1/2 LSB a
+*           step
+*
+************************************************************/
+static inline int32_t mulQ31Round(int32_t a, int32_t b) {
+	return (int32_t) (((int64_t) a * b + (1LL << 30)) >> 31);
+}
+
+/************************************************************
+*
+* Function: mulQ15
+* @brief:   Q15 x Q15 with a 32 bit intermediate, truncating
+*
+************************************************************/
+static inline int16_t mulQ15(int16_t a, int16_t b) {
+	return (int16_t) (((int32_t) a * b) >> 15);
+}
+
+/************************************************************
+*
+* Function: saturateQ15
+* @brief:   clamp a 32 bit value into the int16_t range
+*
+************************************************************/
+static inline int16_t saturateQ15(int32_t value) {
+	if (value > INT16_MAX) {
+		return INT16_MAX;
+	}
+	if (value < INT16_MIN) {
+		return INT16_MIN;
+	}
+	return (int16_t) value;
+}
+
+/************************************************************
+*
+* Function: addSatQ31
+* @brief:   saturating Q31 addition
+*
+************************************************************/
+static inline int32_t addSatQ31(int32_t a, int32_t b) {
+	int32_t sum = (int32_t) ((uint32_t) a + (uint32_t) b);
+
+	// Overflow iff both operands share a sign the sum does not
+	if (((a ^ sum) & (b ^ sum)) < 0) {
+		return a < 0 ? INT32_MIN : INT32_MAX;
+	}
+	return sum;
+}
+
+#endif
@@ -0,0 +1,29 @@
+/************************************************************
+*
+* @file:      flash_store.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Settings record kept in a reserved flash page
+*
+************************************************************/
+
+#ifndef __FLASH_STORE_H__
+#define __FLASH_STORE_H__
+
+#include "stm32f0xx.h"
+
+// Last 1 KB page of the 64 KB STM32F051R8, the linker script must
+// end the FLASH region below it (LENGTH = 63K); linking with
+// startup/flash_store.ld fails the build if the image reaches it
+#define FLASH_STORE_ADDRESS         0x0800FC00
+#define FLASH_STORE_PAGE_SIZE       1024
+// Bump when the record layout changes, old records are then ignored
+#define FLASH_STORE_MAGIC           0xAD02
+// Halfwords of payload, magic, count and checksum included below
+#define FLASH_STORE_MAX_DATA        ((FLASH_STORE_PAGE_SIZE / 2) - 3)
+
+int flashStoreLoad(uint16_t *data, uint16_t count);
+int flashStoreSave(const uint16_t *data, uint16_t count);
+
+#endif
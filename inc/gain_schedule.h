@@ -0,0 +1,32 @@
+/************************************************************
+*
+* @file:      gain_schedule.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     PID gains interpolated from a tilt x wheel speed
+*             table
+*
+************************************************************/
+
+#ifndef __GAIN_SCHEDULE_H__
+#define __GAIN_SCHEDULE_H__
+
+#include <stdint.h>
+#include "pid.h"
+
+// Breakpoints are power of two spaced so indexing is a shift
+// |tilt| in Q15 angle: 0, 5.6, 11.3, 16.9, 22.5 deg and beyond
+#define GS_TILT_POINTS              5
+#define GS_TILT_SHIFT               10
+// |wheel speed| in steps/s: 0, 2048, 4096, 6144 and beyond
+#define GS_SPEED_POINTS             4
+#define GS_SPEED_SHIFT              11
+
+extern pidGains_t gainTable[GS_TILT_POINTS][GS_SPEED_POINTS];
+
+void gainScheduleLookup(int16_t tilt, int16_t speed, pidGains_t *gains);
+int gainScheduleSet(uint8_t tiltIndex, uint8_t speedIndex, const pidGains_t *gains);
+void gainScheduleFill(const pidGains_t *gains);
+
+#endif
@@ -0,0 +1,68 @@
+/************************************************************
+*
+* @file:      i2c_master.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Interrupt driven, timeout bounded I2C1 master with
+*             a transaction queue and completion callbacks
+*
+************************************************************/
+
+#ifndef __I2C_MASTER_H__
+#define __I2C_MASTER_H__
+
+#include "stm32f0xx.h"
+
+// Queue depth, must be a power of two
+#define I2C_QUEUE_SIZE          8
+// A transaction not finished after this many ticks, plus one for
+// every 1 << I2C_TIMEOUT_BYTES_SHIFT bytes it moves, is aborted;
+// 400 kHz moves 44 bytes a tick, so a 255 byte read fits
+#define I2C_TIMEOUT_TICKS       3
+#define I2C_TIMEOUT_BYTES_SHIFT 5
+// TIMINGR for 400 kHz from the 8 MHz HSI I2C kernel clock (RM0091 table 76)
+#define I2C_TIMING_400KHZ       0x00310309
+
+typedef enum {
+	I2C_STATUS_OK = 0,
+	I2C_STATUS_NACK,            // address or data byte not acknowledged
+	I2C_STATUS_BUS_ERROR,       // misplaced START/STOP seen on the bus
+	I2C_STATUS_ARB_LOST,        // arbitration lost
+	I2C_STATUS_OVERRUN,         // overrun/underrun
+	I2C_STATUS_TIMEOUT          // no completion within the timeout
+} i2cStatus_t;
+
+// Called from interrupt context once the transaction is over
+typedef void (*i2cCallback_t)(i2cStatus_t status, void *context);
+
+typedef struct {
+	uint8_t address;            // 7 bit slave address
+	uint8_t reg;                // register written before the payload
+	uint8_t isRead;             // 1: burst read from reg, 0: write to reg
+	uint8_t length;             // payload length in bytes
+	uint8_t *data;              // payload, NULL for a one byte write of value
+	uint8_t value;              // payload of a one byte register write
+	i2cCallback_t callback;     // may be NULL
+	void *context;              // passed back to callback
+} i2cTransaction_t;
+
+typedef struct {
+	uint32_t completed;
+	uint32_t errors;
+	uint32_t timeouts;
+	uint32_t recoveries;
+} i2cStats_t;
+
+void i2cMasterInit(void);
+int i2cMasterSubmit(const i2cTransaction_t *transaction);
+int i2cMasterWriteReg(uint8_t address, uint8_t reg, uint8_t value,
+		i2cCallback_t callback, void *context);
+int i2cMasterReadRegs(uint8_t address, uint8_t reg, uint8_t *data, uint8_t length,
+		i2cCallback_t callback, void *context);
+uint8_t i2cMasterIsIdle(void);
+void i2cMasterPoll(void);
+void i2cMasterIrqHandler(void);
+const i2cStats_t *i2cMasterGetStats(void);
+
+#endif
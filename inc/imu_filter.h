@@ -0,0 +1,57 @@
+/************************************************************
+*
+* @file:      imu_filter.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Per axis biquad cascade for IMU vibration
+*             rejection on CMSIS arm_biquad_cascade_df1_fast_q15
+*
+************************************************************/
+
+#ifndef __IMU_FILTER_H__
+#define __IMU_FILTER_H__
+
+#ifndef ARM_MATH_CM0
+#define ARM_MATH_CM0
+#endif
+
+#include "stm32f0xx.h"
+#include "arm_math.h"
+#include "sensor_types.h"
+#include "fixmath.h"
+
+#define IMU_FILTER_MAX_STAGES       2
+// Largest batch of samples handed to one imuFilterProcess call
+#define IMU_FILTER_MAX_BATCH        8
+#if SENSOR_MAX_BATCH > IMU_FILTER_MAX_BATCH
+#error "a sensor read must fit one imuFilterProcess call"
+#endif
+// Q14 coefficients, see tools/design_biquad.py
+#define IMU_FILTER_POST_SHIFT       1
+// The fast q15 kernel needs two bits of input headroom
+#define IMU_FILTER_HEADROOM         2
+
+typedef struct {
+	uint8_t numStages;
+	// {b0, 0, b1, b2, -a1, -a2} per stage
+	q15_t coeffs[6 * IMU_FILTER_MAX_STAGES];
+} imuFilterPreset_t;
+
+// Presets for a 1 kHz sample rate
+extern const imuFilterPreset_t IMU_FILTER_LOWPASS_40HZ;
+extern const imuFilterPreset_t IMU_FILTER_LOWPASS_20HZ;
+extern const imuFilterPreset_t IMU_FILTER_LOWPASS_40HZ_NOTCH_100HZ;
+extern const imuFilterPreset_t IMU_FILTER_NOTCH_100HZ;
+
+typedef struct {
+	arm_biquad_casd_df1_inst_q15 instance[IMU_AXIS_COUNT];
+	q15_t state[IMU_AXIS_COUNT][4 * IMU_FILTER_MAX_STAGES];
+	uint8_t enabled;            // bit per imuAxis_t
+} imuFilter_t;
+
+void imuFilterInit(imuFilter_t *filter);
+void imuFilterConfigure(imuFilter_t *filter, imuAxis_t axis, const imuFilterPreset_t *preset);
+void imuFilterProcess(imuFilter_t *filter, imuSample_t *samples, uint16_t count);
+
+#endif
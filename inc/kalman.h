@@ -0,0 +1,83 @@
+/************************************************************
+*
+* @file:      kalman.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Two state (tilt angle, gyro bias) steady state
+*             Kalman filter in Q31
+*
+************************************************************/
+
+#ifndef __KALMAN_H__
+#define __KALMAN_H__
+
+#include <stdint.h>
+#include "fixmath.h"
+
+#ifndef KALMAN_SAMPLE_RATE_HZ
+#define KALMAN_SAMPLE_RATE_HZ       1000
+#endif
+
+// Q16 factor from gyro LSB (65.5 LSB per deg/s) to Q31 angle per sample
+#define KALMAN_GYRO_TO_RATE_Q16     (int32_t) (11937022LL * 1000 / KALMAN_SAMPLE_RATE_HZ)
+
+typedef struct {
+	int32_t angle;              // Q31 angle gain K0
+	int32_t bias;               // Q31 bias gain K1, negative
+} kalmanGains_t;
+
+/************************************************************
+* Steady state gains for F = [1 -1; 0 1], H = [1 0] at one
+* update per sample, from tools/kalman_gains.py. Noise per
+* sample, angles in deg:
+*   SMOOTH:  q_angle 1e-6, q_bias 1e-11, r 4.0
+*   DEFAULT: q_angle 1e-5, q_bias 1e-10, r 1.0
+*   FAST:    q_angle 1e-4, q_bias 1e-9,  r 0.5
+************************************************************/
+extern const kalmanGains_t KALMAN_GAINS_SMOOTH;
+extern const kalmanGains_t KALMAN_GAINS_DEFAULT;
+extern const kalmanGains_t KALMAN_GAINS_FAST;
+
+typedef struct {
+	int32_t angle;              // Q31 angle, fraction of pi
+	int32_t bias;               // Q31 angle per sample
+	kalmanGains_t gains;
+} kalman_t;
+
+void kalmanInit(kalman_t *filter, const kalmanGains_t *gains, int32_t initialAngle);
+void kalmanSetGains(kalman_t *filter, const kalmanGains_t *gains);
+
+/************************************************************
+*
+* Function: kalmanGyroToRate
+* @brief:   gyro LSB to Q31 angle change over one sample
+*
+************************************************************/
+static inline int32_t kalmanGyroToRate(int16_t gyro) {
+	return (int32_t) (((int64_t) gyro * KALMAN_GYRO_TO_RATE_Q16) >> 16);
+}
+
+/************************************************************
+*
+* Function: kalmanUpdate
+* @brief:   one predict/correct step, two 64 bit products
+* @param:   rate, int32_t, gyro rate as Q31 angle per sample
+* @param:   measuredAngle, int32_t, accel tilt as Q31 angle
+* @return:  int32_t, filtered Q31 angle
+*
+************************************************************/
+static inline int32_t kalmanUpdate(kalman_t *filter, int32_t rate, int32_t measuredAngle) {
+	int32_t innovation;
+
+	filter->angle += rate - filter->bias;
+	innovation = measuredAngle - filter->angle;
+	filter->angle += mulQ31(filter->gains.angle, innovation);
+	// Rounded: the bias integrates its correction, and truncated
+	// the -1/2 LSB a step held a 0.026 deg lean at SMOOTH
+	// (host/kalman_test.c)
+	filter->bias += mulQ31Round(filter->gains.bias, innovation);
+	return filter->angle;
+}
+
+#endif
@@ -0,0 +1,69 @@
+/************************************************************
+*
+* @file:      lqr.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Q15 full state feedback u = -K x for (tilt, tilt
+*             rate, wheel position, wheel velocity)
+*
+************************************************************/
+
+#ifndef __LQR_H__
+#define __LQR_H__
+
+#include <stdint.h>
+#include "fixmath.h"
+
+/************************************************************
+* Q15 state and output units, tools/lqr_gains.py uses the
+* same scales to convert the SI gain:
+*   tilt      fraction of pi (Q31 angle >> 16)
+*   rate      raw gyro LSB, full scale 500 dps
+*   position  wheel steps >> LQR_POS_SHIFT
+*   velocity  wheel steps/s
+*   output    wheel acceleration, full scale
+*             LQR_ACCEL_FULL_SCALE steps/s^2, which is exactly
+*             1/256 steps/s per control tick per LSB at 1 kHz
+************************************************************/
+#define LQR_STATES                  4
+#define LQR_POS_SHIFT               2
+#define LQR_ACCEL_FULL_SCALE        128000
+// Gains are Q(15 - LQR_GAIN_SHIFT): |K| < 16 in state units
+#define LQR_GAIN_SHIFT              4
+
+typedef enum {
+	LQR_TILT = 0,
+	LQR_RATE,
+	LQR_POSITION,
+	LQR_VELOCITY
+} lqrStateIndex_t;
+
+typedef struct {
+	int16_t gain[LQR_STATES];
+} lqrGains_t;
+
+// tools/lqr_gains.py --l 0.12 --wheel 0.065 --q 100,1,10,1 --r 1
+extern const lqrGains_t LQR_GAINS_DEFAULT;
+
+/************************************************************
+*
+* Function: lqrUpdate
+* @brief:   u = -K x, unrolled; each product is pre-shifted by
+*           two so the four term sum cannot overflow int32
+* @param:   gains, const lqrGains_t*, Q(15 - LQR_GAIN_SHIFT)
+* @param:   state, const int16_t*, LQR_STATES Q15 values
+* @return:  int16_t, saturated Q15 wheel acceleration
+*
+************************************************************/
+static inline int16_t lqrUpdate(const lqrGains_t *gains, const int16_t *state) {
+	int32_t sum;
+
+	sum = ((int32_t) gains->gain[0] * state[0]) >> 2;
+	sum += ((int32_t) gains->gain[1] * state[1]) >> 2;
+	sum += ((int32_t) gains->gain[2] * state[2]) >> 2;
+	sum += ((int32_t) gains->gain[3] * state[3]) >> 2;
+	return saturateQ15(-(sum >> (13 - LQR_GAIN_SHIFT)));
+}
+
+#endif
@@ -0,0 +1,64 @@
+/************************************************************
+*
+* @file:      motion.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Outer speed/distance loop producing the tilt
+*             setpoint of the balance loop at a lower rate
+*
+************************************************************/
+
+#ifndef __MOTION_H__
+#define __MOTION_H__
+
+#include <stdint.h>
+#include "fixmath.h"
+
+#ifndef MOTION_INNER_RATE_HZ
+#define MOTION_INNER_RATE_HZ        1000
+#endif
+// Outer loop runs once every MOTION_DIVIDER inner ticks
+#define MOTION_DIVIDER              10
+#define MOTION_RATE_HZ              (MOTION_INNER_RATE_HZ / MOTION_DIVIDER)
+// Gains are Q(15 - MOTION_GAIN_SHIFT)
+#define MOTION_GAIN_SHIFT           4
+#define MOTION_GAIN_FRAC            (15 - MOTION_GAIN_SHIFT)
+
+typedef enum {
+	MOTION_HOLD = 0,            // outer loop off, tilt setpoint 0
+	MOTION_SPEED,               // follow a wheel speed
+	MOTION_DISTANCE             // drive to a wheel position
+} motionMode_t;
+
+typedef struct {
+	int16_t speedKp;            // Q15 tilt per step/s of speed error
+	int16_t speedKi;            // same, per outer tick
+	int16_t positionKp;         // step/s of speed per step of error
+	int16_t maxSpeed;           // step/s, limit in distance mode
+	int16_t maxTilt;            // Q15, limit of the tilt setpoint
+} motionGains_t;
+
+typedef struct {
+	motionMode_t mode;
+	motionGains_t gains;
+	int32_t targetPosition;     // steps, distance mode
+	int16_t targetSpeed;        // steps/s, speed mode
+	int16_t speed;              // measured steps/s
+	int32_t lastPosition;
+	int32_t integral;           // Q15 tilt << MOTION_GAIN_FRAC
+	int16_t tiltSetpoint;       // Q15, last output
+} motion_t;
+
+// 0.25 deg per 1000 steps/s, ~0.9 s integral time, 0.25 /s position
+// gain; the speed loop must stay well below the sqrt(g / l) zero
+// the pendulum puts in the tilt to speed response
+extern const motionGains_t MOTION_GAINS_DEFAULT;
+
+void motionInit(motion_t *motion, const motionGains_t *gains);
+void motionHold(motion_t *motion);
+void motionSetSpeed(motion_t *motion, int32_t position, int16_t speed);
+void motionSetDistance(motion_t *motion, int32_t position, int32_t distance);
+int16_t motionUpdate(motion_t *motion, int32_t position);
+
+#endif
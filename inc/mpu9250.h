@@ -0,0 +1,83 @@
+/************************************************************
+*
+* @file:      mpu9250.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     MPU9250 accelerometer, gyroscope and AK8963 compass
+*             driver on top of the I2C master queue
+*
+************************************************************/
+
+#ifndef __MPU9250_H__
+#define __MPU9250_H__
+
+#include "stm32f0xx.h"
+#include "i2c_master.h"
+#include "sensor_types.h"
+
+#define MPU9250_ADDRESS             0x68
+#define MPU9250_WHO_AM_I_VALUE      0x71
+
+// Register map
+#define MPU9250_SMPLRT_DIV          0x19
+#define MPU9250_CONFIG              0x1A
+#define MPU9250_GYRO_CONFIG         0x1B
+#define MPU9250_ACCEL_CONFIG        0x1C
+#define MPU9250_ACCEL_CONFIG2       0x1D
+#define MPU9250_FIFO_EN             0x23
+#define MPU9250_I2C_MST_CTRL        0x24
+#define MPU9250_I2C_SLV0_ADDR       0x25
+#define MPU9250_I2C_SLV0_REG        0x26
+#define MPU9250_I2C_SLV0_CTRL       0x27
+#define MPU9250_I2C_SLV1_ADDR       0x28
+#define MPU9250_I2C_SLV1_REG        0x29
+#define MPU9250_I2C_SLV1_CTRL       0x2A
+#define MPU9250_ACCEL_XOUT_H        0x3B
+#define MPU9250_EXT_SENS_DATA_00    0x49
+#define MPU9250_I2C_SLV0_DO         0x63
+#define MPU9250_I2C_SLV1_DO         0x64
+#define MPU9250_USER_CTRL           0x6A
+#define MPU9250_PWR_MGMT_1          0x6B
+#define MPU9250_FIFO_COUNTH         0x72
+#define MPU9250_FIFO_R_W            0x74
+#define MPU9250_WHO_AM_I            0x75
+
+// USER_CTRL and FIFO_EN bits
+#define MPU9250_USER_FIFO_EN        0x40
+#define MPU9250_USER_I2C_MST_EN     0x20
+#define MPU9250_USER_FIFO_RST       0x04
+// Temperature, gyro XYZ, accel XYZ and SLV0
+#define MPU9250_FIFO_RECORD_SOURCES 0xF9
+
+// AK8963 behind the MPU9250 auxiliary I2C master
+#define AK8963_ADDRESS              0x0C
+#define AK8963_HXL                  0x03
+#define AK8963_CNTL1                0x0A
+#define AK8963_CNTL2                0x0B
+#define AK8963_ASAX                 0x10
+#define AK8963_ST2_HOFL             0x08    // magnetic sensor overflow
+#define AK8963_ST2_BITM             0x10    // 16 bit output, set once configured
+
+// One FIFO record: accel XYZ, temperature, gyro XYZ, then HXL..ST2
+// as SLV0 mirrors it into EXT_SENS_DATA
+#define MPU9250_RECORD_LENGTH       21
+#define AK8963_READ_LENGTH          7
+#define MPU9250_FIFO_SIZE           512
+
+typedef enum {
+	MAG_INIT_BUSY = 0,
+	MAG_INIT_DONE,
+	MAG_INIT_FAILED
+} magInitStatus_t;
+
+int mpu9250Init(void);
+void mpu9250MagInitStart(void);
+magInitStatus_t mpu9250MagInitPoll(void);
+const uint8_t *mpu9250MagAdjustment(void);
+int mpu9250StartCount(uint8_t *count, i2cCallback_t callback, void *context);
+uint8_t mpu9250StartFifoRead(const uint8_t *count, uint8_t *buffer, uint8_t maxRecords,
+		i2cCallback_t callback, void *context);
+void mpu9250Decode(const uint8_t *record, imuSample_t *sample);
+
+#endif
@@ -0,0 +1,71 @@
+/************************************************************
+*
+* @file:      pid.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Q15 PID on tilt with derivative on the gyro rate
+*
+************************************************************/
+
+#ifndef __PID_H__
+#define __PID_H__
+
+#include <stdint.h>
+#include "fixmath.h"
+
+// Gains are Q(15 - PID_GAIN_SHIFT), same units as the LQR gains
+#define PID_GAIN_SHIFT              4
+#define PID_GAIN_FRAC               (15 - PID_GAIN_SHIFT)
+// Integral is kept with this many extra fraction bits
+#define PID_INTEGRAL_SHIFT          8
+#define PID_INTEGRAL_LIMIT          ((int32_t) INT16_MAX << PID_INTEGRAL_SHIFT)
+
+typedef struct {
+	int16_t kp;
+	int16_t ki;
+	int16_t kd;
+} pidGains_t;
+
+typedef struct {
+	// Sum of ki * error already in output units, so a new ki
+	// only affects future error and never bumps the output
+	int32_t integral;
+} pidState_t;
+
+/************************************************************
+*
+* Function: pidReset
+* @brief:   clear the integrator
+*
+************************************************************/
+static inline void pidReset(pidState_t *pid) {
+	pid->integral = 0;
+}
+
+/************************************************************
+*
+* Function: pidUpdate
+* @brief:   u = kp * error + sum(ki * error) + kd * rate
+* @param:   error, int16_t, Q15 tilt minus tilt setpoint
+* @param:   rate, int16_t, Q15 tilt rate (raw gyro)
+* @return:  int16_t, saturated Q15 output
+*
+************************************************************/
+static inline int16_t pidUpdate(pidState_t *pid, const pidGains_t *gains, int16_t error, int16_t rate) {
+	int32_t output;
+
+	pid->integral += ((int32_t) gains->ki * error) >> (PID_GAIN_FRAC - PID_INTEGRAL_SHIFT);
+	if (pid->integral > PID_INTEGRAL_LIMIT) {
+		pid->integral = PID_INTEGRAL_LIMIT;
+	} else if (pid->integral < -PID_INTEGRAL_LIMIT) {
+		pid->integral = -PID_INTEGRAL_LIMIT;
+	}
+
+	output = ((int32_t) gains->kp * error) >> PID_GAIN_FRAC;
+	output += ((int32_t) gains->kd * rate) >> PID_GAIN_FRAC;
+	output += pid->integral >> PID_INTEGRAL_SHIFT;
+	return saturateQ15(output);
+}
+
+#endif
@@ -0,0 +1,74 @@
+/************************************************************
+*
+* @file:      profile.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Cycle accurate section timing from SysTick, the M0
+*             has no DWT cycle counter
+*
+************************************************************/
+
+#ifndef __PROFILE_H__
+#define __PROFILE_H__
+
+#include "stm32f0xx.h"
+#include "timebase.h"
+#include "seqlock.h"
+
+typedef struct {
+	seqlock_t lock;             // read through profileSnapshot
+	uint32_t last;              // cycles of the latest run
+	uint32_t max;               // worst case since reset
+	uint32_t total;             // sum for the average, wraps after ~89 s of load
+	uint32_t count;
+} profileProbe_t;
+
+/************************************************************
+*
+* Function: profileCycles
+* @brief:   free running core cycle count built from the tick
+*           and the SysTick down counter
+* @return:  uint32_t, cycles, wraps every ~89 s at 48 MHz
+*
+************************************************************/
+static inline uint32_t profileCycles(void) {
+	uint32_t tick;
+	uint32_t value;
+
+	do {
+		tick = tickCount;
+		value = SysTick->VAL;
+	} while (tick != tickCount);
+	// Inside a higher priority ISR the wrap may not be counted yet
+	if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) {
+		value = SysTick->VAL;
+		tick++;
+	}
+	return tick * (SysTick->LOAD + 1) + (SysTick->LOAD - value);
+}
+
+/************************************************************
+*
+* Function: profileStop
+* @brief:   record one run that started at start cycles
+*
+************************************************************/
+static inline void profileStop(profileProbe_t *probe, uint32_t start) {
+	uint32_t cycles = profileCycles() - start;
+
+	seqlockWriteBegin(&probe->lock);
+	probe->last = cycles;
+	if (cycles > probe->max) {
+		probe->max = cycles;
+	}
+	probe->total += cycles;
+	probe->count++;
+	seqlockWriteEnd(&probe->lock);
+}
+
+void profileReset(profileProbe_t *probe);
+void profileSnapshot(const profileProbe_t *probe, profileProbe_t *copy);
+uint32_t profileAverage(const profileProbe_t *probe);
+
+#endif
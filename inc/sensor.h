@@ -0,0 +1,46 @@
+/************************************************************
+*
+* @file:      sensor.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Generic accel/gyro/compass interface, the backend
+*             is picked at compile time
+*
+*             Every backend header defines the same set of static
+*             inline functions, so callers compile down to direct
+*             (usually fully inlined) calls, with no function
+*             pointer on the hot path:
+*
+*               int sensorInit(void);
+*                   start the sensor, 0 on success
+*               int sensorStartRead(void);
+*                   request the next sample, 0 if it was queued
+*               uint8_t sensorSampleReady(void);
+*                   non zero once the requested samples arrived
+*               imuSample_t *sensorGetSamples(uint8_t *count);
+*                   decode the arrived batch, oldest first, into
+*                   the backend's SENSOR_MAX_BATCH slots and clear
+*                   ready; count is set to 1..SENSOR_MAX_BATCH.
+*                   The samples may be changed in place and stay
+*                   valid until the next sensorStartRead
+*
+*             Build with SENSOR_SIM defined to get the simulated
+*             sensor (host builds), otherwise the MPU9250 is used.
+*             Code above this layer includes only sensor.h and
+*             sensor_types.h, so it builds unchanged on both.
+*
+************************************************************/
+
+#ifndef __SENSOR_H__
+#define __SENSOR_H__
+
+#include "sensor_types.h"
+
+#if defined(SENSOR_SIM)
+#include "sensor_sim.h"
+#else
+#include "sensor_mpu9250.h"
+#endif
+
+#endif
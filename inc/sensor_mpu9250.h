@@ -0,0 +1,63 @@
+/************************************************************
+*
+* @file:      sensor_mpu9250.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     sensor.h backend for the MPU9250 on I2C1
+*
+************************************************************/
+
+#ifndef __SENSOR_MPU9250_H__
+#define __SENSOR_MPU9250_H__
+
+#include "mpu9250.h"
+
+extern uint8_t sensorBuffer[SENSOR_MAX_BATCH * MPU9250_RECORD_LENGTH];
+extern imuSample_t sensorSamples[SENSOR_MAX_BATCH];
+extern uint8_t sensorCount[2];
+extern volatile uint8_t sensorReady;       // records in sensorBuffer
+extern volatile uint8_t sensorBusy;        // count or FIFO read on the bus
+
+void sensorCountDone(i2cStatus_t status, void *context);
+
+static inline int sensorInit(void) {
+	sensorReady = 0;
+	sensorBusy = 0;
+	if (mpu9250Init() != 0) {
+		return -1;
+	}
+	mpu9250MagInitStart();
+	return 0;
+}
+
+// A read still on the bus keeps its place, the FIFO holds the
+// samples meanwhile
+static inline int sensorStartRead(void) {
+	if (sensorBusy) {
+		return -1;
+	}
+	sensorBusy = 1;
+	if (mpu9250StartCount(sensorCount, sensorCountDone, 0) != 0) {
+		sensorBusy = 0;
+		return -1;
+	}
+	return 0;
+}
+
+static inline uint8_t sensorSampleReady(void) {
+	return sensorReady;
+}
+
+static inline imuSample_t *sensorGetSamples(uint8_t *count) {
+	uint8_t i;
+
+	*count = sensorReady;
+	for (i = 0; i < *count; i++) {
+		mpu9250Decode(&sensorBuffer[i * MPU9250_RECORD_LENGTH], &sensorSamples[i]);
+	}
+	sensorReady = 0;
+	return sensorSamples;
+}
+
+#endif
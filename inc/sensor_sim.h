@@ -0,0 +1,57 @@
+/************************************************************
+*
+* @file:      sensor_sim.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     sensor.h backend for host builds, samples are fed
+*             by the harness with sensorSimPush
+*
+************************************************************/
+
+#ifndef __SENSOR_SIM_H__
+#define __SENSOR_SIM_H__
+
+#include "sensor_types.h"
+
+extern imuSample_t sensorSimSamples[SENSOR_MAX_BATCH];
+extern uint8_t sensorSimPending;    // pushed since the last read
+extern uint8_t sensorSimReady;      // samples the last read returned
+
+/************************************************************
+*
+* Function: sensorSimPush
+* @brief:   queue a sample for the next read, like the FIFO a
+*           full batch drops newer samples; call it after the
+*           last batch was used, it is the same storage
+*
+************************************************************/
+static inline void sensorSimPush(const imuSample_t *sample) {
+	if (sensorSimPending < SENSOR_MAX_BATCH) {
+		sensorSimSamples[sensorSimPending++] = *sample;
+	}
+}
+
+static inline int sensorInit(void) {
+	sensorSimPending = 0;
+	sensorSimReady = 0;
+	return 0;
+}
+
+static inline int sensorStartRead(void) {
+	sensorSimReady = sensorSimPending;
+	sensorSimPending = 0;
+	return 0;
+}
+
+static inline uint8_t sensorSampleReady(void) {
+	return sensorSimReady;
+}
+
+static inline imuSample_t *sensorGetSamples(uint8_t *count) {
+	*count = sensorSimReady;
+	sensorSimReady = 0;
+	return sensorSimSamples;
+}
+
+#endif
@@ -0,0 +1,41 @@
+/************************************************************
+*
+* @file:      sensor_types.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Platform independent IMU sample layout and scales,
+*             shared by target drivers and host builds
+*
+************************************************************/
+
+#ifndef __SENSOR_TYPES_H__
+#define __SENSOR_TYPES_H__
+
+#include <stdint.h>
+
+// Full scale ranges configured on the sensor
+#define ACCEL_LSB_PER_G             8192    // +-4 g
+#define GYRO_LSB_PER_DPS_X10        655     // +-500 dps, 65.5 LSB/(deg/s)
+// Most samples one read returns; usually one per tick, more after
+// a late read or when the sensor clock runs ahead of the tick
+#define SENSOR_MAX_BATCH            4
+
+typedef enum {
+	IMU_ACCEL_X = 0,
+	IMU_ACCEL_Y,
+	IMU_ACCEL_Z,
+	IMU_GYRO_X,
+	IMU_GYRO_Y,
+	IMU_GYRO_Z,
+	IMU_AXIS_COUNT
+} imuAxis_t;
+
+typedef struct {
+	int16_t axis[IMU_AXIS_COUNT];
+	int16_t temperature;
+	int16_t mag[3];             // compass in the accel frame
+	uint8_t magValid;           // 0 if not configured or on overflow
+} imuSample_t;
+
+#endif
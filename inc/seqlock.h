@@ -0,0 +1,92 @@
+/************************************************************
+*
+* @file:      seqlock.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Sequence counter snapshots of state written in an
+*             ISR and read at a lower priority, host buildable
+*
+*             The writer makes the counter odd, updates the data
+*             and makes it even again; it never waits. A reader
+*             copies the data between two reads of the counter
+*             and starts over if it was odd or has moved, i.e.
+*             the writer preempted the copy. On the single core
+*             M0 without a cache only the compiler can reorder
+*             the accesses, so a compiler barrier is all the
+*             ordering needed.
+*
+*             Rules: one writer context per lock, and readers at
+*             a lower priority than it. A reader preempting the
+*             writer would see the count odd until it returns,
+*             which it never does, so that reader would spin.
+*
+************************************************************/
+
+#ifndef __SEQLOCK_H__
+#define __SEQLOCK_H__
+
+#include <stdint.h>
+
+typedef struct {
+	volatile uint32_t sequence; // odd while a write is in progress
+} seqlock_t;
+
+// Keeps the compiler from moving data accesses across the counter
+#define seqlockBarrier()            __asm volatile ("" ::: "memory")
+
+static inline void seqlockInit(seqlock_t *lock) {
+	lock->sequence = 0;
+}
+
+/************************************************************
+*
+* Function: seqlockWriteBegin
+* @brief:   open a write, from the writer context only
+*
+************************************************************/
+static inline void seqlockWriteBegin(seqlock_t *lock) {
+	lock->sequence++;
+	seqlockBarrier();
+}
+
+/************************************************************
+*
+* Function: seqlockWriteEnd
+* @brief:   publish the write opened by seqlockWriteBegin
+*
+************************************************************/
+static inline void seqlockWriteEnd(seqlock_t *lock) {
+	seqlockBarrier();
+	lock->sequence++;
+}
+
+/************************************************************
+*
+* Function: seqlockReadBegin
+* @return:  uint32_t, counter to pass to seqlockReadRetry after
+*           copying the data
+*
+************************************************************/
+static inline uint32_t seqlockReadBegin(const seqlock_t *lock) {
+	uint32_t sequence = lock->sequence;
+
+	seqlockBarrier();
+	return sequence;
+}
+
+/************************************************************
+*
+* Function: seqlockReadRetry
+* @brief:   check a copy taken since seqlockReadBegin, as in
+*           do { s = begin; copy; } while (retry(s))
+* @return:  uint8_t, 1 if the copy may be torn and must be
+*           taken again
+*
+************************************************************/
+static inline uint8_t seqlockReadRetry(const seqlock_t *lock, uint32_t sequence) {
+	seqlockBarrier();
+	return (sequence & 1) != 0 || lock->sequence != sequence;
+}
+
+#endif
@@ -0,0 +1,57 @@
+/************************************************************
+*
+* @file:      shell.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Console command interpreter on perfect hashed
+*             static tables, parsing lines in place
+*
+************************************************************/
+
+#ifndef __SHELL_H__
+#define __SHELL_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SHELL_MAX_ARGS              5
+// FNV-1a multiplier, a single cycle multiply on the M0
+#define SHELL_HASH_PRIME            16777619u
+
+// Handler results: reply "ok", the handler replied itself, reply "err"
+#define SHELL_OK                    0
+#define SHELL_REPLIED               1
+#define SHELL_ERROR                 (-1)
+
+// Arguments after the command name, pointing into the line
+typedef struct {
+	const char *text[SHELL_MAX_ARGS];   // not terminated, see length
+	uint8_t length[SHELL_MAX_ARGS];
+	int32_t value[SHELL_MAX_ARGS];      // where bit i of numbers is set
+	uint8_t numbers;
+	uint8_t count;
+} shellArgs_t;
+
+typedef int (*shellHandler_t)(const shellArgs_t *args);
+
+typedef struct {
+	const char *name;           // 0 in an empty slot
+	shellHandler_t handler;     // commands only
+	uint8_t id;                 // keywords only, e.g. a parameter
+} shellEntry_t;
+
+// Slots in hash order from tools/shell_hash.py, every name in its own
+typedef struct {
+	const shellEntry_t *slots;  // 1 << bits
+	uint32_t seed;
+	uint8_t bits;
+} shellTable_t;
+
+uint8_t shellHash(const char *word, size_t length, uint32_t seed, uint8_t bits);
+const shellEntry_t *shellLookup(const shellTable_t *table, const char *word, size_t length);
+void shellExecute(const shellTable_t *table, const char *line);
+uint8_t shellNumbers(const shellArgs_t *args, uint8_t count);
+uint8_t shellIsWord(const shellArgs_t *args, uint8_t index, const char *word);
+
+#endif
@@ -0,0 +1,48 @@
+/************************************************************
+*
+* @file:      spectrum.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     On target vibration spectrum of one IMU axis,
+*             Hann windowed arm_rfft_q15 streamed as magnitude bins
+*
+************************************************************/
+
+#ifndef __SPECTRUM_H__
+#define __SPECTRUM_H__
+
+#ifndef ARM_MATH_CM0
+#define ARM_MATH_CM0
+#endif
+
+#include "stm32f0xx.h"
+#include "arm_math.h"
+#include "sensor_types.h"
+#include "profile.h"
+
+// arm_rfft_q15 in this CMSIS takes 128, 512 or 2048 points; 128
+// gives 7.8 Hz bins at 1 kHz and keeps the buffers near 1.3 KB
+#define SPECTRUM_FFT_LEN            128
+#define SPECTRUM_BINS               (SPECTRUM_FFT_LEN / 2)
+// Up to 2^SPECTRUM_MAX_AVERAGE_SHIFT windows are averaged per frame
+#define SPECTRUM_MAX_AVERAGE_SHIFT  4
+
+// Binary frame on the debug UART, little endian:
+//   sync0 sync1 'S' axis averages exponent fftLen:u16
+//   sampleRate:u16 bins:u16[SPECTRUM_BINS] checksum
+// checksum is the 8 bit sum of every byte after the sync pair
+#define SPECTRUM_SYNC0              0xA5
+#define SPECTRUM_SYNC1              0x5A
+#define SPECTRUM_FRAME_TYPE         'S'
+#define SPECTRUM_FRAME_SIZE         (10 + 2 * SPECTRUM_BINS + 1)
+
+extern profileProbe_t spectrumProfile;
+
+void spectrumInit(void);
+int spectrumStart(imuAxis_t axis, uint8_t averageShift);
+void spectrumCapture(const imuSample_t *sample);
+void spectrumPoll(void);
+uint8_t spectrumBusy(void);
+
+#endif
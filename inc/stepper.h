@@ -0,0 +1,41 @@
+/************************************************************
+*
+* @file:      stepper.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Step/direction driver (A4988) for the two wheel
+*             steppers, step pulses come from timer PWM outputs
+*
+************************************************************/
+
+#ifndef __STEPPER_H__
+#define __STEPPER_H__
+
+#include "stm32f0xx.h"
+
+// Timer counts at 1 MHz, step period = STEPPER_TIMER_HZ / rate
+#define STEPPER_TIMER_HZ            1000000
+// A4988 needs >= 1 us high, pulse is this many timer counts
+#define STEPPER_PULSE_TICKS         2
+// Rates below this cannot be reached with a 16 bit period
+#define STEPPER_MIN_RATE            16
+#define STEPPER_MAX_RATE            20000
+// 200 full steps per revolution at 1/16 microstepping
+#define STEPPER_STEPS_PER_REV       3200
+
+typedef enum {
+	STEPPER_LEFT = 0,
+	STEPPER_RIGHT,
+	STEPPER_COUNT
+} stepperId_t;
+
+void stepperInit(void);
+void stepperEnable(uint8_t enable);
+void stepperSetRate(stepperId_t id, int32_t rate);
+int32_t stepperGetRate(stepperId_t id);
+int32_t stepperGetPosition(stepperId_t id);
+uint16_t stepperGetPeriod(stepperId_t id);
+void stepperUpdateHandler(stepperId_t id);
+
+#endif
@@ -0,0 +1,50 @@
+/************************************************************
+*
+* @file:      sysid.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     System identification mode: PRBS excitation on the
+*             wheel acceleration command and a binary log of
+*             (command, tilt, rate) at the control rate
+*
+************************************************************/
+
+#ifndef __SYSID_H__
+#define __SYSID_H__
+
+#include "stm32f0xx.h"
+
+// 9 bit maximal length LFSR, x^9 + x^5 + 1, period 511 bits
+#define SYSID_LFSR_MASK             0x0110
+#define SYSID_LFSR_SEED             0x01FF
+// Records buffered between the control task and the main loop
+#define SYSID_RING_SIZE             32
+#define SYSID_FRAME_RECORDS         16
+
+// Binary frame on the debug UART, little endian:
+//   sync0 sync1 'I' count sequence:u16
+//   {command, tilt, rate}:i16[count] checksum
+// sequence numbers the first record, so a gap marks dropped records;
+// checksum is the 8 bit sum of every byte after the sync pair
+#define SYSID_SYNC0                 0xA5
+#define SYSID_SYNC1                 0x5A
+#define SYSID_FRAME_TYPE            'I'
+#define SYSID_RECORD_SIZE           6
+#define SYSID_FRAME_SIZE            (6 + SYSID_RECORD_SIZE * SYSID_FRAME_RECORDS + 1)
+
+typedef struct {
+	int16_t command;            // Q15 wheel acceleration actually applied
+	int16_t tilt;               // Q15 fraction of pi
+	int16_t rate;               // raw gyro X
+} sysidRecord_t;
+
+int sysidStart(int16_t amplitude, uint8_t bitTicks, uint8_t openLoop);
+void sysidStop(void);
+uint8_t sysidIsActive(void);
+int16_t sysidExcite(int16_t command);
+void sysidLog(int16_t command, int16_t tilt, int16_t rate);
+void sysidPoll(void);
+uint16_t sysidDropped(void);
+
+#endif
@@ -0,0 +1,45 @@
+/************************************************************
+*
+* @file:      tables.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Sizes and declarations of the const lookup tables
+*
+*             Generated, do not edit; rerun:
+*             tools/gen_tables.py --divide-bits 8 --cordic-steps 28 --rsqrt-bits 6
+*             --hann-len 128 --notch 1000:20:450:5 --notch-q 4,
+*             or pass --check to verify.
+*
+************************************************************/
+
+#ifndef __TABLES_H__
+#define __TABLES_H__
+
+#include <stdint.h>
+
+// divide.h reciprocal, 2^bits intervals
+#define DIVIDE_LUT_BITS             8
+#define DIVIDE_LUT_SIZE             ((1 << DIVIDE_LUT_BITS) + 1)
+// fastmath.h atan2Q31 rotations
+#define ATAN_CORDIC_STEPS           28
+// fastmath.h rsqrt seed, index bits
+#define RSQRT_LUT_BITS              6
+#define RSQRT_LUT_SIZE              ((3 << (RSQRT_LUT_BITS - 2)) + 1)
+// spectrum.c window
+#define HANN_WINDOW_LEN             128
+// adaptive_notch.c bins
+#define NOTCH_SAMPLE_HZ             1000
+#define NOTCH_FIRST_HZ              20
+#define NOTCH_LAST_HZ               450
+#define NOTCH_STEP_HZ               5
+#define NOTCH_BINS                  ((NOTCH_LAST_HZ - NOTCH_FIRST_HZ) / NOTCH_STEP_HZ + 1)
+#define NOTCH_Q                     4
+
+extern const uint16_t divideReciprocalTable[DIVIDE_LUT_SIZE];
+extern const int32_t atanCordicTable[ATAN_CORDIC_STEPS];
+extern const uint16_t rsqrtSeedTable[RSQRT_LUT_SIZE];
+extern const int16_t hannWindow[HANN_WINDOW_LEN];
+extern const int16_t notchCoefficients[NOTCH_BINS][6];
+
+#endif
@@ -0,0 +1,97 @@
+/************************************************************
+*
+* @file:      telemetry.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Every tick binary telemetry of selected state,
+*             delta and zigzag varint coded frames on the debug
+*             UART
+*
+************************************************************/
+
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+#include "stm32f0xx.h"
+
+// One int16_t per channel and tick; the first six are the
+// calibrated sample in imuAxis_t order, ahead of the filters
+typedef enum {
+	TELEMETRY_ACCEL_X = 0,
+	TELEMETRY_ACCEL_Y,
+	TELEMETRY_ACCEL_Z,
+	TELEMETRY_GYRO_X,
+	TELEMETRY_GYRO_Y,
+	TELEMETRY_GYRO_Z,
+	TELEMETRY_TILT,             // Kalman, Q15 fraction of pi
+	TELEMETRY_SETPOINT,         // tilt setpoint of the outer loop, Q15
+	TELEMETRY_COMMAND,          // wheel acceleration applied, Q15
+	TELEMETRY_VELOCITY,         // commanded wheel rate, steps/s
+	TELEMETRY_POSITION,         // mean wheel position, low 16 bits of steps
+	TELEMETRY_STEP_LEFT,        // step periods the notch was tuned to, as uint16_t
+	TELEMETRY_STEP_RIGHT,
+	TELEMETRY_HOLD_ERROR,       // LQR position state, Q15
+	TELEMETRY_MODE,             // TELEMETRY_MODE_ bits
+	TELEMETRY_CHANNEL_COUNT
+} telemetryChannel_t;
+
+// TELEMETRY_MODE, what this tick's outputs depend on
+#define TELEMETRY_MODE_FRESH        0x01    // a new sample went through the filters
+#define TELEMETRY_MODE_RUNNING      0x02    // balancing, the command is live
+#define TELEMETRY_MODE_PID          0x04    // gain scheduled PID instead of the LQR
+#define TELEMETRY_MODE_MOTION       0x08    // outer loop owns position and speed
+#define TELEMETRY_MODE_AUTOTUNE     0x10    // relay experiment drives the command
+#define TELEMETRY_MODE_SYSID        0x20    // PRBS added to the command
+#define TELEMETRY_MODE_BATCH        0x40    // several samples filtered, the newest is logged
+
+// Everything host/replay.c needs to rerun the filters, the tilt
+// estimate and the LQR; ~14 KB/s, 5% of the default 3 Mbaud and
+// more than 115200 baud carries
+#define TELEMETRY_REPLAY_MASK       ((1 << TELEMETRY_ACCEL_Y) | (1 << TELEMETRY_ACCEL_Z) \
+		| (1 << TELEMETRY_GYRO_X) | (1 << TELEMETRY_TILT) | (1 << TELEMETRY_SETPOINT) \
+		| (1 << TELEMETRY_COMMAND) | (1 << TELEMETRY_VELOCITY) | (1 << TELEMETRY_STEP_LEFT) \
+		| (1 << TELEMETRY_STEP_RIGHT) | (1 << TELEMETRY_HOLD_ERROR) | (1 << TELEMETRY_MODE))
+// The raw accel and gyro host/ahrs_bench.c fuses, 12 KB/s
+#define TELEMETRY_IMU_MASK          ((1 << TELEMETRY_ACCEL_X) | (1 << TELEMETRY_ACCEL_Y) \
+		| (1 << TELEMETRY_ACCEL_Z) | (1 << TELEMETRY_GYRO_X) | (1 << TELEMETRY_GYRO_Y) \
+		| (1 << TELEMETRY_GYRO_Z))
+// Channels logged from the first tick on, 0 waits for "tel"; a
+// replay is only bit exact from boot, when the estimator state is
+// known
+#ifndef TELEMETRY_BOOT_MASK
+#define TELEMETRY_BOOT_MASK         0
+#endif
+
+// Channels selected at once, and records buffered between the
+// control task and the main loop, a power of two
+#define TELEMETRY_MAX_CHANNELS      12
+#define TELEMETRY_RING_SIZE         32
+#define TELEMETRY_FRAME_RECORDS     10
+
+// Binary frame on the debug UART:
+//   sync0 sync1 'T' count size:u16 sequence:u16 mask:u16
+//   payload[size] checksum
+// u16 little endian. sequence numbers the first record, so a gap
+// marks dropped records; mask has bit i set for each
+// telemetryChannel_t sent, in ascending order. The payload holds
+// count records of one varint per channel: the first record
+// zigzag(value), the others zigzag(value - previous) in int16_t
+// arithmetic, 7 bits per byte from the least significant, bit 7
+// set on all but the last. Each frame decodes on its own.
+// checksum is the 8 bit sum of every byte after the sync pair
+#define TELEMETRY_SYNC0             0xA5
+#define TELEMETRY_SYNC1             0x5A
+#define TELEMETRY_FRAME_TYPE        'T'
+#define TELEMETRY_HEADER_SIZE       10
+#define TELEMETRY_VARINT_MAX        3
+#define TELEMETRY_FRAME_MAX         (TELEMETRY_HEADER_SIZE + TELEMETRY_FRAME_RECORDS \
+		* TELEMETRY_MAX_CHANNELS * TELEMETRY_VARINT_MAX + 1)
+
+int telemetryStart(uint16_t mask);
+void telemetryStop(void);
+void telemetryLog(const int16_t channels[TELEMETRY_CHANNEL_COUNT]);
+void telemetryPoll(void);
+uint16_t telemetryDropped(void);
+
+#endif
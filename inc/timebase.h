@@ -0,0 +1,47 @@
+/************************************************************
+*
+* @file:      timebase.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     SysTick based system tick shared by all tasks
+*
+************************************************************/
+
+#ifndef __TIMEBASE_H__
+#define __TIMEBASE_H__
+
+#include "stm32f0xx.h"
+
+// Rate of the system tick, also the rate of the control task
+#define TICK_RATE_HZ    1000
+
+// Interrupt priorities, lower is more urgent. SysTick shares the
+// I2C level so the transfer timeout never preempts the I2C state
+// machine; control runs from PendSV below both and preempts the
+// background main loop.
+#define TICK_IRQ_PRIORITY       1
+#define CONTROL_IRQ_PRIORITY    2
+
+// Incremented by SysTick_Handler, never written anywhere else
+extern volatile uint32_t tickCount;
+
+void timebaseInit(void);
+void timebaseStartControl(void);
+void timebaseTick(void);
+
+// Defined by the application, runs from PendSV once per tick
+void controlTick(void);
+
+/************************************************************
+*
+* Function: timebaseGetTick
+* @brief:   current system tick, wraps after ~49 days
+* @return:  uint32_t, ticks since timebaseInit
+*
+************************************************************/
+static inline uint32_t timebaseGetTick(void) {
+	return tickCount;
+}
+
+#endif
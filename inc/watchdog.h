@@ -0,0 +1,54 @@
+/************************************************************
+*
+* @file:      watchdog.h
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     IWDG supervisor feeding the watchdog only while
+*             every registered task checks in on time
+*
+************************************************************/
+
+#ifndef __WATCHDOG_H__
+#define __WATCHDOG_H__
+
+#include "stm32f0xx.h"
+#include "timebase.h"
+
+#define WATCHDOG_MAX_TASKS          8
+// IWDG timeout, must stay below 3276 ms (prescaler 32, 12 bit reload)
+#define WATCHDOG_TIMEOUT_MS         100
+// Deadlines are checked from SysTick once every this many ticks
+#define WATCHDOG_SERVICE_PERIOD     8
+// Returned by watchdogRegister / watchdogLastFailure
+#define WATCHDOG_NO_TASK            0xFF
+// Backup register layout: magic in the upper half, task id below
+#define WATCHDOG_BKP_REG            RTC_BKP_DR0
+#define WATCHDOG_BKP_MAGIC          0xAD150000
+
+typedef struct {
+	// Tick of the last check in, stored by tasks and read by
+	// watchdogService in SysTick
+	volatile uint32_t lastCheckIn;
+	uint32_t deadline;          // max ticks allowed between check ins
+} watchdogTask_t;
+
+extern watchdogTask_t watchdogTasks[WATCHDOG_MAX_TASKS];
+
+void watchdogInit(void);
+uint8_t watchdogRegister(uint32_t deadline);
+void watchdogService(void);
+uint8_t watchdogLastFailure(void);
+
+/************************************************************
+*
+* Function: watchdogCheckIn
+* @brief:   mark a task alive, one load and one store
+* @param:   id, uint8_t, id returned by watchdogRegister
+*
+************************************************************/
+static inline void watchdogCheckIn(uint8_t id) {
+	watchdogTasks[id].lastCheckIn = tickCount;
+}
+
+#endif
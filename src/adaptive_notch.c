@@ -0,0 +1,141 @@
+/************************************************************
+*
+* @file:      adaptive_notch.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     IMU notch filters that follow the wheel step
+*             frequency, retuned from the stepper timer period
+*
+*             The vibration frequency follows directly from the
+*             step period in the wheel timer's ARR, so no spectral
+*             tracking is needed. Coefficients come from a flash
+*             table indexed by frequency bin, so tracking costs a
+*             table reciprocal divide (divide.h) per wheel and tick
+*             plus a 6 word copy when the bin changes; no trig runs
+*             on target. The DF1 history is
+*             kept across retunes, which keeps the output
+*             continuous while the frequency sweeps. A stopped
+*             wheel's stage keeps running as a pass-through, so its
+*             history is the recent input, not seconds old, when
+*             the wheel speeds back into the table range.
+*
+************************************************************/
+
+#include "adaptive_notch.h"
+#include "divide.h"
+#include "timebase.h"
+
+#if NOTCH_SAMPLE_HZ != TICK_RATE_HZ
+#error "notchCoefficients are designed for another rate, rerun tools/gen_tables.py --notch"
+#endif
+
+// Timer counts per step at a step cycle of NOTCH_STEP_HZ / 2
+#define NOTCH_HALF_BIN_COUNTS       (2 * STEPPER_TIMER_HZ / (NOTCH_STEPS_PER_CYCLE * NOTCH_STEP_HZ))
+#if NOTCH_HALF_BIN_COUNTS > 0xFFFF
+#error "NOTCH_HALF_BIN_COUNTS must fit divideU16"
+#endif
+
+// Unity pass-through section for a stopped wheel or an out of range frequency
+static const q15_t passThrough[6] = { 1 << (15 - IMU_FILTER_POST_SHIFT), 0, 0, 0, 0, 0 };
+
+static void loadStage(adaptiveNotch_t *notch, stepperId_t wheel, const q15_t *source) {
+	q15_t *target = &notch->coeffs[6 * wheel];
+	uint8_t i;
+
+	for (i = 0; i < 6; i++) {
+		target[i] = source[i];
+	}
+}
+
+/************************************************************
+*
+* Function: adaptiveNotchInit
+* @brief:   start with both stages passing through
+* @param:   axisMask, uint8_t, bit per imuAxis_t to filter
+*
+************************************************************/
+void adaptiveNotchInit(adaptiveNotch_t *notch, uint8_t axisMask) {
+	uint8_t axis;
+	uint8_t wheel;
+
+	for (wheel = 0; wheel < STEPPER_COUNT; wheel++) {
+		loadStage(notch, (stepperId_t) wheel, passThrough);
+		notch->bin[wheel] = NOTCH_BYPASS;
+	}
+	for (axis = 0; axis < IMU_AXIS_COUNT; axis++) {
+		arm_biquad_cascade_df1_init_q15(&notch->instance[axis], STEPPER_COUNT,
+				notch->coeffs, notch->state[axis], IMU_FILTER_POST_SHIFT);
+	}
+	notch->enabled = axisMask;
+}
+
+/************************************************************
+*
+* Function: adaptiveNotchBin
+* @brief:   table bin for a step period
+* @param:   stepPeriod, uint16_t, timer counts per step, 0 when
+*           the wheel is stopped
+* @return:  uint8_t, bin index or NOTCH_BYPASS
+*
+************************************************************/
+uint8_t adaptiveNotchBin(uint16_t stepPeriod) {
+	uint32_t halfBins;
+
+	if (stepPeriod == 0) {
+		return NOTCH_BYPASS;
+	}
+	// Twice the frequency in NOTCH_STEP_HZ units, then round
+	halfBins = divideU16(NOTCH_HALF_BIN_COUNTS, stepPeriod);
+	halfBins = (halfBins + 1) >> 1;
+	if (halfBins < NOTCH_FIRST_HZ / NOTCH_STEP_HZ || halfBins > NOTCH_LAST_HZ / NOTCH_STEP_HZ) {
+		return NOTCH_BYPASS;
+	}
+	return (uint8_t) (halfBins - NOTCH_FIRST_HZ / NOTCH_STEP_HZ);
+}
+
+/************************************************************
+*
+* Function: adaptiveNotchTune
+* @brief:   follow one wheel's current step period, call once
+*           per control tick
+*
+************************************************************/
+void adaptiveNotchTune(adaptiveNotch_t *notch, stepperId_t wheel, uint16_t stepPeriod) {
+	uint8_t bin = adaptiveNotchBin(stepPeriod);
+
+	if (bin == notch->bin[wheel]) {
+		return;
+	}
+	notch->bin[wheel] = bin;
+	loadStage(notch, wheel, bin == NOTCH_BYPASS ? passThrough : notchCoefficients[bin]);
+}
+
+/************************************************************
+*
+* Function: adaptiveNotchProcess
+* @brief:   filter a batch of samples in place, same batching
+*           and headroom handling as imuFilterProcess
+*
+************************************************************/
+void adaptiveNotchProcess(adaptiveNotch_t *notch, imuSample_t *samples, uint16_t count) {
+	q15_t block[IMU_FILTER_MAX_BATCH];
+	uint16_t i;
+	uint8_t axis;
+
+	if (count > IMU_FILTER_MAX_BATCH) {
+		count = IMU_FILTER_MAX_BATCH;
+	}
+	for (axis = 0; axis < IMU_AXIS_COUNT; axis++) {
+		if (!(notch->enabled & (1 << axis))) {
+			continue;
+		}
+		for (i = 0; i < count; i++) {
+			block[i] = samples[i].axis[axis] >> IMU_FILTER_HEADROOM;
+		}
+		arm_biquad_cascade_df1_fast_q15(&notch->instance[axis], block, block, count);
+		for (i = 0; i < count; i++) {
+			samples[i].axis[axis] = saturateQ15((int32_t) block[i] * (1 << IMU_FILTER_HEADROOM));
+		}
+	}
+}
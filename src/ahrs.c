@@ -0,0 +1,392 @@
+/************************************************************
+*
+* @file:      ahrs.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Madgwick gradient descent AHRS with accel, gyro
+*             and optional compass
+*
+*             The quaternion is kept in Q30 since one sample at
+*             1 kHz only turns it by ~1e-5 per deg/s. The gyro
+*             step multiplies it by the small Q30 half angle with
+*             three 32 bit products per term, which keeps ten
+*             minutes of pure gyro integration within 0.02 deg of
+*             a float filter. The gradient only sets a direction,
+*             so it runs in Q14 on 32 bit products, and every
+*             normalization goes through rsqrtU32. No 64 bit
+*             multiply or division is left in the update.
+*
+*             The accel and compass step is split from the gyro
+*             step: gravity and the field only change slowly, so
+*             correcting at AHRS_CORRECTION_RATE_HZ with a
+*             proportionally larger beta tracks as well as on every
+*             sample, while the gyro is integrated at the full rate.
+*             The correction takes the newest accel sample; the mean
+*             over the interval would lag by half of it, 0.5 deg at
+*             2 rad/s and 100 Hz.
+*
+*             Without the compass the step is made orthogonal to a
+*             turn about the vertical before it is applied. In
+*             exact arithmetic the accel gradient already is, but
+*             the Q10 step truncates every component the same way,
+*             and that bias alone turned the heading 0.8 deg in
+*             five minutes against a float filter
+*             (host/ahrs_bench.c); the projection rounds.
+*
+*             All quaternion formulas follow Madgwick's report
+*             with the common factor 2 dropped from the gradient,
+*             which the normalization removes anyway.
+*
+************************************************************/
+
+#include "ahrs.h"
+#include "fastmath.h"
+
+// Working format of the gradient terms
+#define AHRS_FRAC                   14
+#define AHRS_ONE                    (1 << AHRS_FRAC)
+// Format of the normalized gradient, scaled by beta
+#define AHRS_STEP_FRAC              10
+#define AHRS_Q_ONE                  0x40000000
+
+/************************************************************
+*
+* Function: mulFrac
+* @brief:   Q14 x Q14, operands within +-2
+*
+************************************************************/
+static inline int32_t mulFrac(int32_t a, int32_t b) {
+	return (a * b) >> AHRS_FRAC;
+}
+
+/************************************************************
+*
+* Function: mulSmall
+* @brief:   Q30 x Q30 for |q| <= 2^30 and |small| < 2^23 from
+*           three 32 bit products, rounded; the low x low term is
+*           under one LSB
+*
+************************************************************/
+static inline int32_t mulSmall(int32_t q, int32_t small) {
+	int32_t qHigh = q >> 15;
+	int32_t qLow = q & 0x7FFF;
+	int32_t sHigh = small >> 8;
+	int32_t sLow = small & 0xFF;
+
+	return (qHigh * sHigh + ((qHigh * sLow) >> 8) + ((qLow * sHigh) >> 15) + (1 << 6)) >> 7;
+}
+
+/************************************************************
+*
+* Function: gyroToHalfAngle
+* @brief:   gyro LSB to the Q30 half angle of one sample, the
+*           Q16 factor split in two so both products fit 32 bits
+*
+************************************************************/
+static inline int32_t gyroToHalfAngle(int16_t rate) {
+	int32_t high = (int32_t) (AHRS_GYRO_TO_HALF_Q16 >> 8);
+	int32_t low = (int32_t) (AHRS_GYRO_TO_HALF_Q16 & 0xFF);
+
+	return (rate * high + ((rate * low + (1 << 7)) >> 8) + (1 << 7)) >> 8;
+}
+
+/************************************************************
+*
+* Function: normalizeVector
+* @brief:   scale a vector to unit length
+* @param:   unit, int32_t*, result in Q(frac)
+* @param:   count, uint8_t, at most 4 components
+* @return:  uint8_t, 0 for a zero vector, unit left untouched
+*
+************************************************************/
+static uint8_t normalizeVector(const int32_t *v, int32_t *unit, uint8_t count, uint8_t frac) {
+	int32_t scaled[AHRS_QUATERNION_SIZE];
+	uint32_t max = 0;
+	uint32_t sum = 0;
+	uint32_t r;
+	uint8_t shift;
+	uint8_t down = 0;
+	uint8_t i;
+
+	for (i = 0; i < count; i++) {
+		r = v[i] < 0 ? 0u - (uint32_t) v[i] : (uint32_t) v[i];
+		if (r > max) {
+			max = r;
+		}
+	}
+	// Four squares below 2^30 each keep the sum in 32 bits
+	while (max >= 0x8000) {
+		max >>= 1;
+		down++;
+	}
+	for (i = 0; i < count; i++) {
+		scaled[i] = v[i] >> down;
+		sum += (uint32_t) (scaled[i] * scaled[i]);
+	}
+	if (sum == 0) {
+		return 0;
+	}
+	// r ~ 2^(30 + shift) / |v|, 15 bits of it are plenty here
+	r = rsqrtU32(sum, &shift) >> 16;
+	for (i = 0; i < count; i++) {
+		unit[i] = (scaled[i] * (int32_t) r) >> (shift + 14 - frac);
+	}
+	return 1;
+}
+
+/************************************************************
+*
+* Function: ahrsInit
+* @brief:   start level, facing the X axis
+* @param:   beta, int32_t, Q30 step per correction, see AHRS_BETA
+* @param:   useMag, uint8_t, fuse the compass when valid
+*
+************************************************************/
+void ahrsInit(ahrs_t *ahrs, int32_t beta, uint8_t useMag) {
+	uint8_t i;
+
+	ahrs->q[AHRS_W] = AHRS_Q_ONE;
+	ahrs->q[AHRS_X] = 0;
+	ahrs->q[AHRS_Y] = 0;
+	ahrs->q[AHRS_Z] = 0;
+	for (i = 0; i < 3; i++) {
+		ahrs->accel[i] = 0;
+		ahrs->mag[i] = 0;
+	}
+	ahrs->beta = beta;
+	ahrs->useMag = useMag;
+	ahrs->magValid = 0;
+}
+
+/************************************************************
+*
+* Function: ahrsGradient
+* @brief:   objective function gradient for the accel and,
+*           if given, the compass direction
+* @param:   q, const int32_t*, Q14 quaternion
+* @param:   a, const int32_t*, Q14 unit gravity in the sensor frame
+* @param:   m, const int32_t*, Q14 unit field or NULL
+* @param:   s, int32_t*, Q14 gradient, not normalized
+*
+************************************************************/
+static void ahrsGradient(const int32_t *q, const int32_t *a, const int32_t *m, int32_t *s) {
+	int32_t q0q1 = mulFrac(q[0], q[1]);
+	int32_t q0q2 = mulFrac(q[0], q[2]);
+	int32_t q0q3 = mulFrac(q[0], q[3]);
+	int32_t q1q1 = mulFrac(q[1], q[1]);
+	int32_t q1q2 = mulFrac(q[1], q[2]);
+	int32_t q1q3 = mulFrac(q[1], q[3]);
+	int32_t q2q2 = mulFrac(q[2], q[2]);
+	int32_t q2q3 = mulFrac(q[2], q[3]);
+	int32_t q3q3 = mulFrac(q[3], q[3]);
+	// Bottom row of the sensor to earth rotation, gravity as seen by the sensor
+	int32_t r20 = 2 * (q1q3 - q0q2);
+	int32_t r21 = 2 * (q2q3 + q0q1);
+	int32_t r22 = AHRS_ONE - 2 * (q1q1 + q2q2);
+	int32_t f1 = r20 - a[0];
+	int32_t f2 = r21 - a[1];
+	int32_t f3 = r22 - a[2];
+	int32_t r00, r01, r02, r10, r11, r12;
+	int32_t hx, hy, bx, bz;
+	int32_t f4, f5, f6;
+	int32_t bxq0, bxq1, bxq2, bxq3, bzq0, bzq1, bzq2, bzq3;
+
+	s[0] = -mulFrac(q[2], f1) + mulFrac(q[1], f2);
+	s[1] = mulFrac(q[3], f1) + mulFrac(q[0], f2) - 2 * mulFrac(q[1], f3);
+	s[2] = -mulFrac(q[0], f1) + mulFrac(q[3], f2) - 2 * mulFrac(q[2], f3);
+	s[3] = mulFrac(q[1], f1) + mulFrac(q[2], f2);
+	if (m == 0) {
+		return;
+	}
+
+	r00 = AHRS_ONE - 2 * (q2q2 + q3q3);
+	r01 = 2 * (q1q2 - q0q3);
+	r02 = 2 * (q1q3 + q0q2);
+	r10 = 2 * (q1q2 + q0q3);
+	r11 = AHRS_ONE - 2 * (q1q1 + q3q3);
+	r12 = 2 * (q2q3 - q0q1);
+	// Field in the earth frame, its horizontal part defines north
+	hx = mulFrac(r00, m[0]) + mulFrac(r01, m[1]) + mulFrac(r02, m[2]);
+	hy = mulFrac(r10, m[0]) + mulFrac(r11, m[1]) + mulFrac(r12, m[2]);
+	bz = mulFrac(r20, m[0]) + mulFrac(r21, m[1]) + mulFrac(r22, m[2]);
+	bx = sqrtU32((uint32_t) (hx * hx + hy * hy));
+	// Reference field seen by the sensor, minus the measurement
+	f4 = mulFrac(bx, r00) + mulFrac(bz, r20) - m[0];
+	f5 = mulFrac(bx, r01) + mulFrac(bz, r21) - m[1];
+	f6 = mulFrac(bx, r02) + mulFrac(bz, r22) - m[2];
+
+	bxq0 = mulFrac(bx, q[0]);
+	bxq1 = mulFrac(bx, q[1]);
+	bxq2 = mulFrac(bx, q[2]);
+	bxq3 = mulFrac(bx, q[3]);
+	bzq0 = mulFrac(bz, q[0]);
+	bzq1 = mulFrac(bz, q[1]);
+	bzq2 = mulFrac(bz, q[2]);
+	bzq3 = mulFrac(bz, q[3]);
+	s[0] += -mulFrac(bzq2, f4) + mulFrac(bzq1 - bxq3, f5) + mulFrac(bxq2, f6);
+	s[1] += mulFrac(bzq3, f4) + mulFrac(bxq2 + bzq0, f5) + mulFrac(bxq3 - 2 * bzq1, f6);
+	s[2] += -mulFrac(2 * bxq2 + bzq0, f4) + mulFrac(bxq1 + bzq3, f5) + mulFrac(bxq0 - 2 * bzq2, f6);
+	s[3] += mulFrac(bzq1 - 2 * bxq3, f4) + mulFrac(bzq2 - bxq0, f5) + mulFrac(bxq1, f6);
+}
+
+/************************************************************
+*
+* Function: dropHeading
+* @brief:   remove from a step its part along the turn about the
+*           earth vertical, d = (0, 0, 0, 1) x q = (-z, -y, x, w)
+* @param:   q, const int32_t*, Q14 unit quaternion
+* @param:   step, int32_t*, Q(AHRS_STEP_FRAC), at most unit
+*
+************************************************************/
+static void dropHeading(const int32_t *q, int32_t *step) {
+	int32_t d[AHRS_QUATERNION_SIZE];
+	int32_t dot;
+	uint8_t i;
+
+	d[AHRS_W] = -q[AHRS_Z];
+	d[AHRS_X] = -q[AHRS_Y];
+	d[AHRS_Y] = q[AHRS_X];
+	d[AHRS_Z] = q[AHRS_W];
+	dot = 0;
+	for (i = 0; i < AHRS_QUATERNION_SIZE; i++) {
+		dot += step[i] * d[i];
+	}
+	dot = (dot + (1 << (AHRS_FRAC - 1))) >> AHRS_FRAC;
+	for (i = 0; i < AHRS_QUATERNION_SIZE; i++) {
+		step[i] -= (dot * d[i] + (1 << (AHRS_FRAC - 1))) >> AHRS_FRAC;
+	}
+}
+
+/************************************************************
+*
+* Function: ahrsPropagate
+* @brief:   gyro step, run on every sample; also keeps the accel
+*           and the latest valid compass reading for the next
+*           ahrsCorrect
+* @param:   sample, const imuSample_t*, calibrated sample
+*
+************************************************************/
+void ahrsPropagate(ahrs_t *ahrs, const imuSample_t *sample) {
+	int32_t *q = ahrs->q;
+	int32_t delta[AHRS_QUATERNION_SIZE];
+	int32_t hx = gyroToHalfAngle(sample->axis[IMU_GYRO_X]);
+	int32_t hy = gyroToHalfAngle(sample->axis[IMU_GYRO_Y]);
+	int32_t hz = gyroToHalfAngle(sample->axis[IMU_GYRO_Z]);
+	int32_t q15;
+	int32_t correction;
+	uint32_t sum = 0;
+	uint32_t r;
+	uint8_t shift;
+	uint8_t i;
+
+	for (i = 0; i < 3; i++) {
+		ahrs->accel[i] = sample->axis[IMU_ACCEL_X + i];
+	}
+	if (sample->magValid) {
+		for (i = 0; i < 3; i++) {
+			ahrs->mag[i] = sample->mag[i];
+		}
+		ahrs->magValid = 1;
+	}
+
+	// q' = q + q x (0, w dt / 2)
+	delta[AHRS_W] = -mulSmall(q[AHRS_X], hx) - mulSmall(q[AHRS_Y], hy) - mulSmall(q[AHRS_Z], hz);
+	delta[AHRS_X] = mulSmall(q[AHRS_W], hx) + mulSmall(q[AHRS_Y], hz) - mulSmall(q[AHRS_Z], hy);
+	delta[AHRS_Y] = mulSmall(q[AHRS_W], hy) - mulSmall(q[AHRS_X], hz) + mulSmall(q[AHRS_Z], hx);
+	delta[AHRS_Z] = mulSmall(q[AHRS_W], hz) + mulSmall(q[AHRS_X], hy) - mulSmall(q[AHRS_Y], hx);
+	for (i = 0; i < AHRS_QUATERNION_SIZE; i++) {
+		q[i] += delta[i];
+	}
+
+	// Scale by 1 + (1 / |q| - 1): rescaling the Q15 rounded copy
+	// directly would drop the low bits the gyro step just added.
+	// This also takes out what the last correction step added.
+	for (i = 0; i < AHRS_QUATERNION_SIZE; i++) {
+		q15 = (q[i] + (1 << 14)) >> 15;
+		sum += (uint32_t) (q15 * q15);
+	}
+	if (sum < (1u << 28)) {
+		// |q| under 1/2 cannot come from a sane step, start over
+		ahrsInit(ahrs, ahrs->beta, ahrs->useMag);
+		return;
+	}
+	// r ~ 2^(30 + shift) / (2^15 |q|), so 1 / |q| in Q30 is r 2^(15 - shift)
+	r = rsqrtU32(sum, &shift);
+	correction = (int32_t) (shift == 16 ? r >> 1 : r) - AHRS_Q_ONE;
+	for (i = 0; i < AHRS_QUATERNION_SIZE; i++) {
+		q[i] += mulSmall(q[i], correction);
+	}
+}
+
+/************************************************************
+*
+* Function: ahrsCorrect
+* @brief:   one gradient step towards the last accel sample and,
+*           if enabled and seen since the last call, the compass;
+*           run every AHRS_CORRECTION_DIVIDER samples
+*
+************************************************************/
+void ahrsCorrect(ahrs_t *ahrs) {
+	int32_t *q = ahrs->q;
+	int32_t vector[AHRS_QUATERNION_SIZE];
+	int32_t accel[3];
+	int32_t field[3];
+	int32_t qFrac[AHRS_QUATERNION_SIZE];
+	int32_t step[AHRS_QUATERNION_SIZE];
+	uint8_t withMag;
+	uint8_t i;
+
+	for (i = 0; i < 3; i++) {
+		vector[i] = ahrs->accel[i];
+	}
+	if (normalizeVector(vector, accel, 3, AHRS_FRAC)) {
+		for (i = 0; i < AHRS_QUATERNION_SIZE; i++) {
+			qFrac[i] = (q[i] + (1 << 15)) >> 16;
+		}
+		for (i = 0; i < 3; i++) {
+			vector[i] = ahrs->mag[i];
+		}
+		withMag = ahrs->useMag && ahrs->magValid && normalizeVector(vector, field, 3, AHRS_FRAC);
+		ahrsGradient(qFrac, accel, withMag ? field : 0, vector);
+		if (normalizeVector(vector, step, AHRS_QUATERNION_SIZE, AHRS_STEP_FRAC)) {
+			if (!withMag) {
+				dropHeading(qFrac, step);
+			}
+			for (i = 0; i < AHRS_QUATERNION_SIZE; i++) {
+				q[i] -= (step[i] * ahrs->beta) >> AHRS_STEP_FRAC;
+			}
+		}
+	}
+	ahrs->magValid = 0;
+}
+
+/************************************************************
+*
+* Function: ahrsGetEuler
+* @brief:   roll, pitch and yaw (Z-Y-X order) of a quaternion,
+*           for reports rather than the control path
+* @param:   q, const int32_t*, Q30 unit quaternion
+* @param:   angles, int32_t*, Q31 fractions of pi
+*
+************************************************************/
+void ahrsGetEuler(const int32_t q[AHRS_QUATERNION_SIZE], int32_t angles[AHRS_ANGLE_COUNT]) {
+	int32_t w = (q[AHRS_W] + (1 << 14)) >> 15;
+	int32_t x = (q[AHRS_X] + (1 << 14)) >> 15;
+	int32_t y = (q[AHRS_Y] + (1 << 14)) >> 15;
+	int32_t z = (q[AHRS_Z] + (1 << 14)) >> 15;
+	int32_t sine = 2 * (w * y - z * x);
+	int32_t cosine;
+
+	// Products of the Q15 components are Q30, within +-1 for a unit q
+	angles[AHRS_ROLL] = atan2Q31(2 * (w * x + y * z), AHRS_Q_ONE - 2 * (x * x + y * y));
+	angles[AHRS_YAW] = atan2Q31(2 * (w * z + x * y), AHRS_Q_ONE - 2 * (y * y + z * z));
+	// asin(s) = atan2(s, sqrt(1 - s^2)), clamped against rounding
+	if (sine > AHRS_Q_ONE) {
+		sine = AHRS_Q_ONE;
+	} else if (sine < -AHRS_Q_ONE) {
+		sine = -AHRS_Q_ONE;
+	}
+	cosine = AHRS_Q_ONE - ((sine >> 15) * (sine >> 15));
+	angles[AHRS_PITCH] = atan2Q31(sine, sqrtQ31(cosine < Q31_ONE / 2 ? cosine * 2 : Q31_ONE) >> 1);
+}
@@ -0,0 +1,155 @@
+/************************************************************
+*
+* @file:      autotune.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Relay feedback (Astrom-Hagglund) auto-tuner for the
+*             tilt PID, run one step per control tick
+*
+*             An inverted pendulum driven by wheel acceleration
+*             has -180 deg of phase at every frequency, so a relay
+*             on the tilt alone never settles into a limit cycle
+*             once any delay is present. The relay therefore acts on
+*             e = tilt + lead * rate, the same PD combination the
+*             tilt PID uses with lead = kd / kp; the lead supplies
+*             the phase that makes the loop oscillate at its
+*             ultimate period Tu.
+*
+*             The relay drives the wheel acceleration to +d while e
+*             is above +h and to -d below -h. Each rising switch
+*             starts a cycle; over the measured cycles the swing 2a
+*             of e and the period are averaged, giving
+*             Ku = 4 d / (pi a) for the kp (1 + lead) loop. The gains
+*             follow Tyreus-Luyben, kp = Ku / 2.2 and Ti = 2.2 Tu,
+*             with the derivative ratio kept at the lead the
+*             ultimate point was measured with. Ziegler-Nichols
+*             (kp = 0.6 Ku) leaves too little gain margin for this
+*             unstable plant and overflows the Q11 gain range. Every step is a
+*             handful of compares; the two divisions only run once,
+*             on the tick the result is computed.
+*
+************************************************************/
+
+#include "autotune.h"
+
+/************************************************************
+*
+* Function: computeGains
+* @brief:   turn the averaged swing and period into gains
+* @return:  int, 0 on success, -1 if the result is unusable
+*
+************************************************************/
+static int computeGains(autotune_t *tuner, uint32_t periodTicks) {
+	int32_t amplitude = tuner->swingSum >> (AUTOTUNE_MEASURE_SHIFT + 1);
+	int32_t ultimate;
+	int32_t kp;
+
+	if (amplitude <= 0 || periodTicks == 0 || periodTicks > AUTOTUNE_MAX_PERIOD_TICKS) {
+		return -1;
+	}
+	ultimate = ((int32_t) tuner->relay * AUTOTUNE_KU_SCALE) / amplitude;
+	kp = (ultimate * AUTOTUNE_KP_FRACTION) >> 15;
+	tuner->result.ultimateGain = ultimate;
+	tuner->result.period = (uint16_t) periodTicks;
+	// Capping kp to the Q11 range only adds gain margin
+	if (kp > INT16_MAX) {
+		kp = INT16_MAX;
+	}
+	tuner->result.gains.kp = (int16_t) kp;
+	// ki per tick = kp / Ti = kp / (2.2 Tu)
+	tuner->result.gains.ki = (int16_t) ((kp * 5) / (11 * (int32_t) periodTicks));
+	tuner->result.gains.kd = (int16_t) ((kp * tuner->lead) >> PID_GAIN_FRAC);
+	return 0;
+}
+
+/************************************************************
+*
+* Function: autotuneStart
+* @brief:   arm the relay experiment
+* @param:   relay, int16_t, Q15 acceleration amplitude d
+* @param:   hysteresis, int16_t, Q15 band h, keep it above the
+*           noise of e and well below the expected swing
+* @param:   lead, int16_t, Q11 kd / kp of the relay input
+*
+*           On host/plant.c d 3000..16000, h up to d / 6 and
+*           lead 400..900 converge; d under 3000 or lead under
+*           300 mostly fail. A larger d tolerates more h and
+*           less lead.
+*
+************************************************************/
+void autotuneStart(autotune_t *tuner, int16_t relay, int16_t hysteresis, int16_t lead) {
+	tuner->relay = relay;
+	tuner->hysteresis = hysteresis;
+	tuner->lead = lead;
+	tuner->output = 1;
+	tuner->peakHigh = INT16_MIN;
+	tuner->peakLow = INT16_MAX;
+	tuner->cycles = 0;
+	tuner->ticks = 0;
+	tuner->measureStart = 0;
+	tuner->swingSum = 0;
+	tuner->status = AUTOTUNE_RUNNING;
+}
+
+/************************************************************
+*
+* Function: autotuneStep
+* @brief:   one tick of the experiment, constant time
+* @param:   tilt, int16_t, Q15 tilt
+* @param:   rate, int16_t, raw gyro rate, as fed to pidUpdate
+* @return:  int16_t, Q15 acceleration command, 0 unless running
+*
+************************************************************/
+int16_t autotuneStep(autotune_t *tuner, int16_t tilt, int16_t rate) {
+	int16_t error;
+
+	if (tuner->status != AUTOTUNE_RUNNING) {
+		return 0;
+	}
+	if (++tuner->ticks > AUTOTUNE_TIMEOUT_TICKS) {
+		tuner->status = AUTOTUNE_FAILED;
+		return 0;
+	}
+
+	error = saturateQ15(tilt + (((int32_t) tuner->lead * rate) >> PID_GAIN_FRAC));
+	if (error > tuner->peakHigh) {
+		tuner->peakHigh = error;
+	}
+	if (error < tuner->peakLow) {
+		tuner->peakLow = error;
+	}
+
+	if (tuner->output < 0 && error > tuner->hysteresis) {
+		// Rising switch: one full cycle since the previous one
+		tuner->output = 1;
+		tuner->cycles++;
+		if (tuner->cycles == AUTOTUNE_SETTLE_CYCLES + 1) {
+			tuner->measureStart = tuner->ticks;
+		} else if (tuner->cycles > AUTOTUNE_SETTLE_CYCLES + 1) {
+			tuner->swingSum += (int32_t) tuner->peakHigh - tuner->peakLow;
+		}
+		tuner->peakHigh = error;
+		tuner->peakLow = error;
+		if (tuner->cycles == AUTOTUNE_SETTLE_CYCLES + 1 + AUTOTUNE_MEASURE_CYCLES) {
+			tuner->status = computeGains(tuner, (tuner->ticks - tuner->measureStart)
+					>> AUTOTUNE_MEASURE_SHIFT) == 0 ? AUTOTUNE_DONE : AUTOTUNE_FAILED;
+			return 0;
+		}
+	} else if (tuner->output > 0 && error < -tuner->hysteresis) {
+		tuner->output = -1;
+	}
+	return tuner->output > 0 ? tuner->relay : -tuner->relay;
+}
+
+/************************************************************
+*
+* Function: autotuneAbort
+* @brief:   stop the experiment, e.g. when the robot falls
+*
+************************************************************/
+void autotuneAbort(autotune_t *tuner) {
+	if (tuner->status == AUTOTUNE_RUNNING) {
+		tuner->status = AUTOTUNE_FAILED;
+	}
+}
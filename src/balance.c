@@ -0,0 +1,686 @@
+/************************************************************
+*
+* @file:      balance.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Fixed rate balance task: sensor, tilt estimate,
+*             state feedback and wheel commands
+*
+*             Each tick consumes the samples requested on the
+*             previous tick and immediately queues the next read,
+*             so the I2C transfer overlaps the rest of the loop. A
+*             read returns every sample the sensor FIFO holds,
+*             normally one; the whole batch goes through the
+*             filters in one call each and the newest drives the
+*             control law.
+*             Tilt is about the IMU X axis, positive leaning
+*             forward. The LQR output is a wheel acceleration that
+*             is integrated here into the commanded step rate;
+*             that command also serves as wheel velocity feedback.
+*             The gain scheduled PID produces the same output and
+*             can replace the LQR at run time.
+*
+*             Speed and distance commands go through the outer
+*             loop in motion.c, run every MOTION_DIVIDER ticks
+*             after the wheels are commanded. It supplies a tilt
+*             setpoint and, under the LQR, takes over the position
+*             and velocity terms. balanceInnerProfile times sensor
+*             to wheel command on every tick; host/balance_bench.c
+*             fails if outer ticks lengthen it.
+*
+*             The full attitude for heading comes from the AHRS,
+*             also run after the wheels are commanded; balancing
+*             keeps the single axis Kalman tilt. Its gyro step runs
+*             on every tick, its accel and compass correction once
+*             per AHRS_CORRECTION_DIVIDER ticks, half way between
+*             two outer ticks so the two never share one.
+*
+************************************************************/
+
+#include "balance.h"
+#include "sensor.h"
+#include "kalman.h"
+#include "lqr.h"
+#include "gain_schedule.h"
+#include "imu_filter.h"
+#include "adaptive_notch.h"
+#include "stepper.h"
+#include "spectrum.h"
+#include "sysid.h"
+#include "telemetry.h"
+#include "motion.h"
+#include "fastmath.h"
+#include "ahrs.h"
+#include "timebase.h"
+#include "seqlock.h"
+
+#if AHRS_SAMPLE_RATE_HZ != TICK_RATE_HZ
+#error "AHRS_SAMPLE_RATE_HZ must match the balance tick"
+#endif
+#if AHRS_CORRECTION_DIVIDER < 2 || MOTION_DIVIDER % AHRS_CORRECTION_DIVIDER != 0
+#error "AHRS corrections must fall between outer loop ticks"
+#endif
+
+// Tick of the AHRS correction within its divider, outer ticks are at 0
+#define BALANCE_AHRS_PHASE          (AHRS_CORRECTION_DIVIDER / 2)
+
+profileProbe_t balanceProfile;
+profileProbe_t balanceInnerProfile;
+profileProbe_t balanceOuterProfile;
+profileProbe_t balanceAhrsProfile;
+
+static imuCalibration_t imuCalibration;
+static magCalibration_t magCalibration;
+static imuSample_t sample;              // newest of the last batch
+static imuFilter_t imuFilter;
+static adaptiveNotch_t stepNotch;
+static kalman_t tiltFilter;
+static ahrs_t attitude;
+static seqlock_t attitudeLock;
+static lqrGains_t gains;
+static pidState_t tiltPid;
+static autotune_t tuner;
+static motion_t motion;
+static uint8_t outerPhase = 0;
+static uint8_t attitudePhase = 0;
+static int16_t tiltSetpoint = 0;     // Q15, from the outer loop
+static balanceController_t controller = BALANCE_CONTROLLER_LQR;
+static int32_t velocityQ8 = 0;       // commanded wheel rate, Q8 steps/s
+static int32_t positionSetpoint = 0; // wheel steps
+static uint8_t running = 0;
+static volatile uint8_t motorInhibit = 0;   // no auto-start while set
+// Uncorrected samples for a calibration run in the main loop
+static imuSample_t rawSample;
+static seqlock_t rawLock;
+static volatile uint8_t rawCapture = 0;
+// This tick's telemetry, the sample part kept from the last read
+static int16_t channels[TELEMETRY_CHANNEL_COUNT];
+
+/************************************************************
+*
+* Function: updateAttitude
+* @brief:   AHRS step on this tick's sample, off the sensor to
+*           motor path and also while fallen; the correction
+*           phase advances with outerPhase, so it stays locked
+*           between outer ticks
+*
+************************************************************/
+static void updateAttitude(void) {
+	uint32_t ahrsStart = profileCycles();
+
+	seqlockWriteBegin(&attitudeLock);
+	ahrsPropagate(&attitude, &sample);
+	if (++attitudePhase >= AHRS_CORRECTION_DIVIDER) {
+		attitudePhase = 0;
+	}
+	if (attitudePhase == BALANCE_AHRS_PHASE) {
+		ahrsCorrect(&attitude);
+	}
+	seqlockWriteEnd(&attitudeLock);
+	profileStop(&balanceAhrsProfile, ahrsStart);
+}
+
+/************************************************************
+*
+* Function: logTelemetry
+* @brief:   complete this tick's channels and hand them to the
+*           telemetry ring
+* @param:   tilt, int32_t, Q31 Kalman tilt
+* @param:   command, int16_t, Q15 wheel acceleration applied
+* @param:   holdError, int16_t, LQR position state, 0 when fallen
+* @param:   mode, uint8_t, TELEMETRY_MODE_ bits of this tick
+*
+************************************************************/
+static void logTelemetry(int32_t tilt, int16_t command, int32_t position,
+		int16_t holdError, uint8_t mode) {
+	channels[TELEMETRY_TILT] = (int16_t) (tilt >> 16);
+	channels[TELEMETRY_SETPOINT] = tiltSetpoint;
+	channels[TELEMETRY_COMMAND] = command;
+	channels[TELEMETRY_VELOCITY] = (int16_t) (velocityQ8 >> 8);
+	channels[TELEMETRY_POSITION] = (int16_t) position;
+	channels[TELEMETRY_HOLD_ERROR] = holdError;
+	channels[TELEMETRY_MODE] = mode;
+	telemetryLog(channels);
+}
+
+static void stopMotors(void) {
+	sysidStop();
+	autotuneAbort(&tuner);
+	motionHold(&motion);
+	tiltSetpoint = 0;
+	velocityQ8 = 0;
+	pidReset(&tiltPid);
+	stepperSetRate(STEPPER_LEFT, 0);
+	stepperSetRate(STEPPER_RIGHT, 0);
+	stepperEnable(0);
+	running = 0;
+}
+
+/************************************************************
+*
+* Function: balanceInit
+* @brief:   reset the estimator and controller, motors off
+*
+************************************************************/
+void balanceInit(void) {
+	calibrationIdentity(&imuCalibration);
+	magCalIdentity(&magCalibration);
+	// Accel carries the stepper vibration; the gyro stays unfiltered for phase
+	imuFilterInit(&imuFilter);
+	imuFilterConfigure(&imuFilter, IMU_ACCEL_X, &IMU_FILTER_LOWPASS_40HZ);
+	imuFilterConfigure(&imuFilter, IMU_ACCEL_Y, &IMU_FILTER_LOWPASS_40HZ);
+	imuFilterConfigure(&imuFilter, IMU_ACCEL_Z, &IMU_FILTER_LOWPASS_40HZ);
+	adaptiveNotchInit(&stepNotch, (1 << IMU_ACCEL_X) | (1 << IMU_ACCEL_Y)
+			| (1 << IMU_ACCEL_Z) | (1 << IMU_GYRO_X));
+	kalmanInit(&tiltFilter, &KALMAN_GAINS_DEFAULT, 0);
+	seqlockWriteBegin(&attitudeLock);
+	// Compass off until balanceSetMagCalibration, the raw field is
+	// off by the hard iron of the motors and the frame
+	ahrsInit(&attitude, AHRS_BETA_DEFAULT, 0);
+	seqlockWriteEnd(&attitudeLock);
+	gains = LQR_GAINS_DEFAULT;
+	motionInit(&motion, &MOTION_GAINS_DEFAULT);
+	profileReset(&balanceProfile);
+	profileReset(&balanceInnerProfile);
+	profileReset(&balanceOuterProfile);
+	profileReset(&balanceAhrsProfile);
+	stopMotors();
+	sensorStartRead();
+}
+
+/************************************************************
+*
+* Function: balanceSetCalibration
+* @brief:   install new IMU correction coefficients
+*
+************************************************************/
+void balanceSetCalibration(const imuCalibration_t *calibration) {
+	__disable_irq();
+	imuCalibration = *calibration;
+	__enable_irq();
+}
+
+/************************************************************
+*
+* Function: balanceSetMagCalibration
+* @brief:   install new compass hard and soft iron coefficients
+*           and fuse the compass in the AHRS from now on
+*
+************************************************************/
+void balanceSetMagCalibration(const magCalibration_t *calibration) {
+	__disable_irq();
+	magCalibration = *calibration;
+	attitude.useMag = 1;
+	__enable_irq();
+}
+
+/************************************************************
+*
+* Function: balanceSetController
+* @brief:   switch between LQR and gain scheduled PID, the PID
+*           integrator restarts from zero
+*
+************************************************************/
+void balanceSetController(balanceController_t newController) {
+	__disable_irq();
+	pidReset(&tiltPid);
+	controller = newController;
+	__enable_irq();
+}
+
+/************************************************************
+*
+* Function: balanceGetTilt
+* @return:  int32_t, current Q31 tilt estimate
+*
+************************************************************/
+int32_t balanceGetTilt(void) {
+	return tiltFilter.angle;
+}
+
+/************************************************************
+*
+* Function: balanceGetAttitude
+* @brief:   roll, pitch and yaw of a snapshot of the AHRS
+*           quaternion, the tick is never held off
+* @param:   angles, int32_t*, Q31 fractions of pi
+*
+************************************************************/
+void balanceGetAttitude(int32_t angles[AHRS_ANGLE_COUNT]) {
+	int32_t q[AHRS_QUATERNION_SIZE];
+	uint32_t sequence;
+	uint8_t i;
+
+	do {
+		sequence = seqlockReadBegin(&attitudeLock);
+		for (i = 0; i < AHRS_QUATERNION_SIZE; i++) {
+			q[i] = attitude.q[i];
+		}
+	} while (seqlockReadRetry(&attitudeLock, sequence));
+	ahrsGetEuler(q, angles);
+}
+
+/************************************************************
+*
+* Function: balanceIsRunning
+* @return:  uint8_t, 1 while balancing with the motors enabled
+*
+************************************************************/
+uint8_t balanceIsRunning(void) {
+	return running;
+}
+
+/************************************************************
+*
+* Function: balanceInhibitMotors
+* @brief:   keep the motors from starting while the robot is
+*           handled, however upright it is held; checked and set
+*           with the control task held off, so it cannot start
+*           them in between
+* @param:   inhibit, uint8_t, 1 to hold the motors off, 0 to
+*           release them
+* @return:  int, 0, or -1 if asked to inhibit while balancing
+*
+************************************************************/
+int balanceInhibitMotors(uint8_t inhibit) {
+	int status = 0;
+
+	__disable_irq();
+	if (inhibit && running) {
+		status = -1;
+	} else {
+		motorInhibit = inhibit;
+	}
+	__enable_irq();
+	return status;
+}
+
+/************************************************************
+*
+* Function: balanceStartAutotune
+* @brief:   replace the tilt feedback by the auto-tune relay; the
+*           LQR position and velocity terms stay on so the robot
+*           does not wander off during the experiment
+* @return:  int, 0 if started, -1 if not balancing or busy
+*
+************************************************************/
+int balanceStartAutotune(int16_t relay, int16_t hysteresis, int16_t lead) {
+	int result = -1;
+
+	__disable_irq();
+	if (running && tuner.status != AUTOTUNE_RUNNING) {
+		autotuneStart(&tuner, relay, hysteresis, lead);
+		result = 0;
+	}
+	__enable_irq();
+	return result;
+}
+
+/************************************************************
+*
+* Function: balanceTakeAutotune
+* @brief:   collect a finished experiment, the tuner then goes
+*           back to idle
+* @param:   result, autotuneResult_t*, filled when DONE
+* @return:  autotuneStatus_t, DONE or FAILED once, else the
+*           current status
+*
+************************************************************/
+autotuneStatus_t balanceTakeAutotune(autotuneResult_t *result) {
+	autotuneStatus_t status;
+
+	__disable_irq();
+	status = tuner.status;
+	if (status == AUTOTUNE_DONE || status == AUTOTUNE_FAILED) {
+		*result = tuner.result;
+		tuner.status = AUTOTUNE_IDLE;
+	}
+	__enable_irq();
+	return status;
+}
+
+/************************************************************
+*
+* Function: balanceHold
+* @brief:   stop following speed or distance commands; the LQR
+*           holds the position reached from here on
+*
+************************************************************/
+void balanceHold(void) {
+	__disable_irq();
+	if (motion.mode != MOTION_HOLD) {
+		positionSetpoint = (stepperGetPosition(STEPPER_LEFT)
+				+ stepperGetPosition(STEPPER_RIGHT)) >> 1;
+	}
+	motionHold(&motion);
+	tiltSetpoint = 0;
+	__enable_irq();
+}
+
+/************************************************************
+*
+* Function: balanceSetSpeed
+* @param:   speed, int16_t, wheel steps/s, positive forward
+* @return:  int, 0 if accepted, -1 while not balancing
+*
+************************************************************/
+int balanceSetSpeed(int16_t speed) {
+	int result = -1;
+
+	__disable_irq();
+	if (running) {
+		motionSetSpeed(&motion, (stepperGetPosition(STEPPER_LEFT)
+				+ stepperGetPosition(STEPPER_RIGHT)) >> 1, speed);
+		result = 0;
+	}
+	__enable_irq();
+	return result;
+}
+
+/************************************************************
+*
+* Function: balanceMove
+* @param:   distance, int32_t, wheel steps from here
+* @return:  int, 0 if accepted, -1 while not balancing
+*
+************************************************************/
+int balanceMove(int32_t distance) {
+	int result = -1;
+
+	__disable_irq();
+	if (running) {
+		motionSetDistance(&motion, (stepperGetPosition(STEPPER_LEFT)
+				+ stepperGetPosition(STEPPER_RIGHT)) >> 1, distance);
+		result = 0;
+	}
+	__enable_irq();
+	return result;
+}
+
+/************************************************************
+*
+* Function: balanceGetParam
+* @param:   value, int32_t*, current setting
+* @return:  int, 0 on success, -1 for an unknown parameter
+*
+************************************************************/
+int balanceGetParam(balanceParam_t param, int32_t *value) {
+	switch (param) {
+	case BALANCE_PARAM_LQR_TILT:
+	case BALANCE_PARAM_LQR_RATE:
+	case BALANCE_PARAM_LQR_POSITION:
+	case BALANCE_PARAM_LQR_VELOCITY:
+		*value = gains.gain[param - BALANCE_PARAM_LQR_TILT];
+		return 0;
+	case BALANCE_PARAM_SPEED_KP:
+		*value = motion.gains.speedKp;
+		return 0;
+	case BALANCE_PARAM_SPEED_KI:
+		*value = motion.gains.speedKi;
+		return 0;
+	case BALANCE_PARAM_POSITION_KP:
+		*value = motion.gains.positionKp;
+		return 0;
+	case BALANCE_PARAM_MAX_SPEED:
+		*value = motion.gains.maxSpeed;
+		return 0;
+	case BALANCE_PARAM_MAX_TILT:
+		*value = motion.gains.maxTilt;
+		return 0;
+	case BALANCE_PARAM_KALMAN_ANGLE:
+		*value = tiltFilter.gains.angle;
+		return 0;
+	case BALANCE_PARAM_KALMAN_BIAS:
+		*value = tiltFilter.gains.bias;
+		return 0;
+	case BALANCE_PARAM_AHRS_BETA:
+		*value = attitude.beta;
+		return 0;
+	default:
+		return -1;
+	}
+}
+
+/************************************************************
+*
+* Function: balanceSetParam
+* @brief:   change one gain while running, the control task
+*           picks it up on its next tick
+* @return:  int, 0 on success, -1 if unknown or out of range
+*
+************************************************************/
+int balanceSetParam(balanceParam_t param, int32_t value) {
+	int result = 0;
+
+	if (param < BALANCE_PARAM_KALMAN_ANGLE && (value < INT16_MIN || value > INT16_MAX)) {
+		return -1;
+	}
+	__disable_irq();
+	switch (param) {
+	case BALANCE_PARAM_LQR_TILT:
+	case BALANCE_PARAM_LQR_RATE:
+	case BALANCE_PARAM_LQR_POSITION:
+	case BALANCE_PARAM_LQR_VELOCITY:
+		gains.gain[param - BALANCE_PARAM_LQR_TILT] = (int16_t) value;
+		break;
+	case BALANCE_PARAM_SPEED_KP:
+		motion.gains.speedKp = (int16_t) value;
+		break;
+	case BALANCE_PARAM_SPEED_KI:
+		motion.gains.speedKi = (int16_t) value;
+		break;
+	case BALANCE_PARAM_POSITION_KP:
+		motion.gains.positionKp = (int16_t) value;
+		break;
+	case BALANCE_PARAM_MAX_SPEED:
+		if (value > 0 && value <= STEPPER_MAX_RATE) {
+			motion.gains.maxSpeed = (int16_t) value;
+		} else {
+			result = -1;
+		}
+		break;
+	case BALANCE_PARAM_MAX_TILT:
+		if (value >= 0) {
+			motion.gains.maxTilt = (int16_t) value;
+		} else {
+			result = -1;
+		}
+		break;
+	case BALANCE_PARAM_KALMAN_ANGLE:
+		if (value > 0) {
+			tiltFilter.gains.angle = value;
+		} else {
+			result = -1;
+		}
+		break;
+	case BALANCE_PARAM_KALMAN_BIAS:
+		if (value < 0) {
+			tiltFilter.gains.bias = value;
+		} else {
+			result = -1;
+		}
+		break;
+	case BALANCE_PARAM_AHRS_BETA:
+		if (value >= 0 && value < (1 << 21)) {
+			attitude.beta = value;
+		} else {
+			result = -1;
+		}
+		break;
+	default:
+		result = -1;
+		break;
+	}
+	__enable_irq();
+	return result;
+}
+
+/************************************************************
+*
+* Function: balanceCaptureRaw
+* @brief:   start or stop publishing each sample ahead of the
+*           calibration, for balanceGetRawSample
+*
+************************************************************/
+void balanceCaptureRaw(uint8_t enable) {
+	rawCapture = enable;
+}
+
+/************************************************************
+*
+* Function: balanceGetRawSample
+* @brief:   snapshot of the latest uncorrected sample
+* @param:   copy, imuSample_t*, filled with the sample
+* @return:  uint32_t, changes with every new sample, so a poll
+*           faster than the tick can skip repeats
+*
+************************************************************/
+uint32_t balanceGetRawSample(imuSample_t *copy) {
+	uint32_t sequence;
+
+	do {
+		sequence = seqlockReadBegin(&rawLock);
+		*copy = rawSample;
+	} while (seqlockReadRetry(&rawLock, sequence));
+	return sequence;
+}
+
+/************************************************************
+*
+* Function: balanceStep
+* @brief:   one control tick, called from controlTick in PendSV;
+*           setters called from the main loop mask interrupts
+*           around their writes
+*
+************************************************************/
+void balanceStep(void) {
+	uint32_t start = profileCycles();
+	uint32_t outerStart;
+	int16_t state[LQR_STATES];
+	int16_t drift[LQR_STATES];
+	pidGains_t pidGains;
+	int16_t error;
+	int16_t accel;
+	int32_t tilt;
+	int32_t position;
+	imuSample_t *samples;
+	uint16_t period;
+	uint8_t mode = 0;
+	uint8_t count;
+	uint8_t n;
+	uint8_t i;
+
+	if (sensorSampleReady()) {
+		samples = sensorGetSamples(&count);
+		if (rawCapture) {
+			seqlockWriteBegin(&rawLock);
+			rawSample = samples[count - 1];
+			seqlockWriteEnd(&rawLock);
+		}
+		for (n = 0; n < count; n++) {
+			calibrationApply(&imuCalibration, &samples[n]);
+			magCalApply(&magCalibration, &samples[n]);
+			// Diagnostic tap ahead of the filters, a no-op unless capturing
+			spectrumCapture(&samples[n]);
+		}
+		for (i = 0; i < IMU_AXIS_COUNT; i++) {
+			channels[TELEMETRY_ACCEL_X + i] = samples[count - 1].axis[i];
+		}
+		period = stepperGetPeriod(STEPPER_LEFT);
+		channels[TELEMETRY_STEP_LEFT] = (int16_t) period;
+		adaptiveNotchTune(&stepNotch, STEPPER_LEFT, period);
+		period = stepperGetPeriod(STEPPER_RIGHT);
+		channels[TELEMETRY_STEP_RIGHT] = (int16_t) period;
+		adaptiveNotchTune(&stepNotch, STEPPER_RIGHT, period);
+		adaptiveNotchProcess(&stepNotch, samples, count);
+		imuFilterProcess(&imuFilter, samples, count);
+		sample = samples[count - 1];
+		mode = count > 1 ? TELEMETRY_MODE_FRESH | TELEMETRY_MODE_BATCH : TELEMETRY_MODE_FRESH;
+	}
+	sensorStartRead();
+	// Every tick, fallen or not, to keep the AHRS phase in step
+	if (++outerPhase >= MOTION_DIVIDER) {
+		outerPhase = 0;
+	}
+
+	// Z points up when upright; atan2 keeps the accel angle true at
+	// the 45 deg limit where the small angle form reads 10% low
+	tilt = kalmanUpdate(&tiltFilter, kalmanGyroToRate(sample.axis[IMU_GYRO_X]),
+			(int32_t) atan2Q15(sample.axis[IMU_ACCEL_Y], sample.axis[IMU_ACCEL_Z]) << 16);
+
+	position = (stepperGetPosition(STEPPER_LEFT) + stepperGetPosition(STEPPER_RIGHT)) >> 1;
+
+	// Fallen, or held by hand for calibration or a flash save
+	if (motorInhibit || tilt > BALANCE_TILT_LIMIT || tilt < -BALANCE_TILT_LIMIT) {
+		if (running) {
+			stopMotors();
+		}
+		logTelemetry(tilt, 0, position, 0, mode);
+		updateAttitude();
+		profileStop(&balanceProfile, start);
+		return;
+	}
+	if (!running) {
+		positionSetpoint = position;
+		stepperEnable(1);
+		running = 1;
+	}
+
+	state[LQR_TILT] = (int16_t) (tilt >> 16);
+	state[LQR_RATE] = sample.axis[IMU_GYRO_X];
+	state[LQR_POSITION] = saturateQ15((position - positionSetpoint) >> LQR_POS_SHIFT);
+	state[LQR_VELOCITY] = saturateQ15(velocityQ8 >> 8);
+	error = saturateQ15((int32_t) state[LQR_TILT] - tiltSetpoint);
+	mode |= TELEMETRY_MODE_RUNNING;
+
+	if (tuner.status == AUTOTUNE_RUNNING) {
+		mode |= TELEMETRY_MODE_AUTOTUNE;
+		accel = autotuneStep(&tuner, state[LQR_TILT], state[LQR_RATE]);
+		drift[LQR_TILT] = 0;
+		drift[LQR_RATE] = 0;
+		drift[LQR_POSITION] = state[LQR_POSITION];
+		drift[LQR_VELOCITY] = state[LQR_VELOCITY];
+		accel = saturateQ15(accel + lqrUpdate(&gains, drift));
+	} else if (controller == BALANCE_CONTROLLER_PID) {
+		mode |= TELEMETRY_MODE_PID;
+		gainScheduleLookup(state[LQR_TILT], state[LQR_VELOCITY], &pidGains);
+		accel = pidUpdate(&tiltPid, &pidGains, error, state[LQR_RATE]);
+	} else if (motion.mode != MOTION_HOLD) {
+		// The outer loop owns position and speed while it runs
+		mode |= TELEMETRY_MODE_MOTION;
+		drift[LQR_TILT] = error;
+		drift[LQR_RATE] = state[LQR_RATE];
+		drift[LQR_POSITION] = 0;
+		drift[LQR_VELOCITY] = 0;
+		accel = lqrUpdate(&gains, drift);
+	} else {
+		accel = lqrUpdate(&gains, state);
+	}
+	if (sysidIsActive()) {
+		mode |= TELEMETRY_MODE_SYSID;
+	}
+	accel = sysidExcite(accel);
+	sysidLog(accel, state[LQR_TILT], state[LQR_RATE]);
+	velocityQ8 += accel;
+	if (velocityQ8 > (STEPPER_MAX_RATE << 8)) {
+		velocityQ8 = STEPPER_MAX_RATE << 8;
+	} else if (velocityQ8 < -(STEPPER_MAX_RATE << 8)) {
+		velocityQ8 = -(STEPPER_MAX_RATE << 8);
+	}
+	stepperSetRate(STEPPER_LEFT, velocityQ8 >> 8);
+	stepperSetRate(STEPPER_RIGHT, velocityQ8 >> 8);
+	profileStop(&balanceInnerProfile, start);
+	logTelemetry(tilt, accel, position, state[LQR_POSITION], mode);
+
+	// Outer loop after the wheels are commanded: it adds to this
+	// tick's total but never to the sensor to motor latency
+	if (outerPhase == 0) {
+		outerStart = profileCycles();
+		tiltSetpoint = motionUpdate(&motion, position);
+		profileStop(&balanceOuterProfile, outerStart);
+	}
+	updateAttitude();
+
+	profileStop(&balanceProfile, start);
+}
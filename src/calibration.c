@@ -0,0 +1,344 @@
+/************************************************************
+*
+* @file:      calibration.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Gyro bias, accel offset/scale and compass hard/soft
+*             iron calibration with single pass integer statistics
+*
+*             Each pose streams samples through one Welford
+*             accumulator per axis, so the RAM cost is fixed no
+*             matter how many samples are taken. Gyro bias is the
+*             mean over all still poses; accel offset and scale
+*             come from the six +-1 g poses.
+*
+*             The compass is turned through all headings while only
+*             the per axis extremes are kept: the midpoint is the
+*             hard iron offset and the axis radii are equalised to
+*             their mean for a diagonal soft iron correction.
+*
+************************************************************/
+
+#include "calibration.h"
+
+/************************************************************
+*
+* Function: welfordReset
+* @brief:   clear an accumulator
+*
+************************************************************/
+void welfordReset(welford_t *stats) {
+	stats->count = 0;
+	stats->mean = 0;
+	stats->remainder = 0;
+	stats->m2 = 0;
+}
+
+/************************************************************
+*
+* Function: welfordAdd
+* @brief:   fold one sample into the running mean and M2
+* @param:   value, int16_t, raw sample
+*
+************************************************************/
+void welfordAdd(welford_t *stats, int16_t value) {
+	int32_t scaled = (int32_t) value * (1 << CAL_MEAN_SHIFT);
+	int32_t delta = scaled - stats->mean;
+	// mean * count + remainder is the exact sum, so the truncation
+	// of each step does not pile up over a long pose
+	int32_t carried = stats->remainder + delta;
+
+	stats->count++;
+	stats->mean += carried / (int32_t) stats->count;
+	stats->remainder = carried % (int32_t) stats->count;
+	stats->m2 += (uint64_t) ((int64_t) delta * (scaled - stats->mean));
+}
+
+/************************************************************
+*
+* Function: welfordVariance
+* @brief:   sample variance of everything added so far
+* @return:  uint32_t, variance in raw LSB^2
+*
+************************************************************/
+uint32_t welfordVariance(const welford_t *stats) {
+	if (stats->count < 2) {
+		return 0;
+	}
+	return (uint32_t) ((stats->m2 / (stats->count - 1)) >> (2 * CAL_MEAN_SHIFT));
+}
+
+/************************************************************
+*
+* Function: calibrationIdentity
+* @brief:   coefficients that leave samples unchanged
+*
+************************************************************/
+void calibrationIdentity(imuCalibration_t *result) {
+	uint8_t i;
+
+	for (i = 0; i < IMU_AXIS_COUNT; i++) {
+		result->offset[i] = 0;
+		result->scale[i] = CAL_SCALE_ONE;
+	}
+}
+
+/************************************************************
+*
+* Function: calibrationBegin
+* @brief:   start a new calibration run
+* @param:   samplesPerPose, uint32_t, samples averaged per pose
+*
+************************************************************/
+void calibrationBegin(calibration_t *cal, uint32_t samplesPerPose) {
+	uint8_t i;
+
+	cal->samplesPerPose = samplesPerPose;
+	cal->poseMask = 0;
+	cal->gyroPoses = 0;
+	for (i = 0; i < 3; i++) {
+		cal->gyroBiasSum[i] = 0;
+	}
+	calibrationStartPose(cal);
+}
+
+/************************************************************
+*
+* Function: calibrationStartPose
+* @brief:   restart the statistics for the next (or a retried)
+*           pose
+*
+************************************************************/
+void calibrationStartPose(calibration_t *cal) {
+	uint8_t i;
+
+	for (i = 0; i < IMU_AXIS_COUNT; i++) {
+		welfordReset(&cal->stats[i]);
+	}
+	cal->aborted = 0;
+}
+
+static calStatus_t closePose(calibration_t *cal) {
+	int32_t mean[3];
+	int32_t magnitude;
+	uint8_t i;
+	int8_t major = -1;
+
+	for (i = IMU_GYRO_X; i <= IMU_GYRO_Z; i++) {
+		if (welfordVariance(&cal->stats[i]) > CAL_GYRO_MAX_VARIANCE) {
+			return CAL_MOTION;
+		}
+	}
+	for (i = IMU_ACCEL_X; i <= IMU_ACCEL_Z; i++) {
+		if (welfordVariance(&cal->stats[i]) > CAL_ACCEL_MAX_VARIANCE) {
+			return CAL_MOTION;
+		}
+		mean[i] = cal->stats[i].mean;
+		magnitude = mean[i] < 0 ? -mean[i] : mean[i];
+		if (magnitude > (CAL_POSE_MAJOR << CAL_MEAN_SHIFT)) {
+			major = i;
+		} else if (magnitude > (CAL_POSE_MINOR << CAL_MEAN_SHIFT)) {
+			return CAL_BAD_POSE;
+		}
+	}
+	if (major < 0) {
+		return CAL_BAD_POSE;
+	}
+
+	cal->poseMean[major * 2 + (mean[major] < 0)] = mean[major];
+	cal->poseMask |= 1 << (major * 2 + (mean[major] < 0));
+	for (i = 0; i < 3; i++) {
+		cal->gyroBiasSum[i] += cal->stats[IMU_GYRO_X + i].mean;
+	}
+	cal->gyroPoses++;
+	return CAL_POSE_DONE;
+}
+
+/************************************************************
+*
+* Function: calibrationAddSample
+* @brief:   stream one raw sample into the current pose
+* @return:  calStatus_t, CAL_RUNNING until samplesPerPose are in,
+*           then the verdict on the pose
+*
+************************************************************/
+calStatus_t calibrationAddSample(calibration_t *cal, const imuSample_t *sample) {
+	int32_t deviation;
+	uint8_t i;
+
+	if (cal->aborted) {
+		return CAL_MOTION;
+	}
+	for (i = 0; i < IMU_AXIS_COUNT; i++) {
+		welfordAdd(&cal->stats[i], sample->axis[i]);
+	}
+
+	// Catch a bump right away instead of waiting for the variance
+	if (cal->stats[IMU_GYRO_X].count > CAL_WARMUP_SAMPLES) {
+		for (i = IMU_GYRO_X; i <= IMU_GYRO_Z; i++) {
+			deviation = (int32_t) sample->axis[i] * (1 << CAL_MEAN_SHIFT) - cal->stats[i].mean;
+			if (deviation > (CAL_GYRO_MAX_DEVIATION << CAL_MEAN_SHIFT)
+					|| deviation < -(CAL_GYRO_MAX_DEVIATION << CAL_MEAN_SHIFT)) {
+				cal->aborted = 1;
+				return CAL_MOTION;
+			}
+		}
+	}
+
+	if (cal->stats[IMU_ACCEL_X].count < cal->samplesPerPose) {
+		return CAL_RUNNING;
+	}
+	return closePose(cal);
+}
+
+/************************************************************
+*
+* Function: calibrationFinish
+* @brief:   turn the accepted poses into coefficients; accel is
+*           left at identity unless all six poses were accepted
+* @return:  calStatus_t, CAL_DONE, CAL_INCOMPLETE, CAL_MOTION if
+*           no pose was accepted at all, or CAL_BAD_POSE if an
+*           accel scale is off by more than 50%
+*
+************************************************************/
+calStatus_t calibrationFinish(const calibration_t *cal, imuCalibration_t *result) {
+	int32_t plus;
+	int32_t minus;
+	int32_t scale;
+	uint8_t i;
+
+	calibrationIdentity(result);
+	if (cal->gyroPoses == 0) {
+		return CAL_MOTION;
+	}
+
+	for (i = 0; i < 3; i++) {
+		// Q8 mean to Q14 offset
+		result->offset[IMU_GYRO_X + i] = -(cal->gyroBiasSum[i] / cal->gyroPoses)
+				* (1 << (CAL_SCALE_SHIFT - CAL_MEAN_SHIFT));
+	}
+
+	if (cal->poseMask != CAL_ALL_POSES) {
+		return CAL_INCOMPLETE;
+	}
+	for (i = 0; i < 3; i++) {
+		plus = cal->poseMean[i * 2];
+		minus = cal->poseMean[i * 2 + 1];
+		// Map plus..minus onto exactly +-ACCEL_LSB_PER_G
+		scale = (int32_t) (((int64_t) (2 * ACCEL_LSB_PER_G) << (CAL_SCALE_SHIFT + CAL_MEAN_SHIFT))
+				/ (plus - minus));
+		if (scale < CAL_SCALE_ONE / 2 || scale > CAL_SCALE_ONE * 3 / 2) {
+			calibrationIdentity(result);
+			return CAL_BAD_POSE;
+		}
+		result->scale[IMU_ACCEL_X + i] = (int16_t) scale;
+		result->offset[IMU_ACCEL_X + i] = (int32_t) (-((int64_t) (plus + minus) / 2 * scale)
+				>> CAL_MEAN_SHIFT);
+	}
+	return CAL_DONE;
+}
+
+/************************************************************
+*
+* Function: magCalIdentity
+* @brief:   compass coefficients that leave samples unchanged
+*
+************************************************************/
+void magCalIdentity(magCalibration_t *result) {
+	uint8_t i;
+
+	for (i = 0; i < 3; i++) {
+		result->offset[i] = 0;
+		result->scale[i] = CAL_SCALE_ONE;
+	}
+}
+
+/************************************************************
+*
+* Function: magCalBegin
+* @brief:   start a compass calibration run
+*
+************************************************************/
+void magCalBegin(magCalCollector_t *collector) {
+	uint8_t i;
+
+	for (i = 0; i < 3; i++) {
+		collector->min[i] = INT16_MAX;
+		collector->max[i] = INT16_MIN;
+	}
+	collector->count = 0;
+}
+
+/************************************************************
+*
+* Function: magCalAddSample
+* @brief:   track the extremes of a valid compass reading
+*
+************************************************************/
+void magCalAddSample(magCalCollector_t *collector, const imuSample_t *sample) {
+	uint8_t i;
+
+	if (!sample->magValid) {
+		return;
+	}
+	for (i = 0; i < 3; i++) {
+		if (sample->mag[i] < collector->min[i]) {
+			collector->min[i] = sample->mag[i];
+		}
+		if (sample->mag[i] > collector->max[i]) {
+			collector->max[i] = sample->mag[i];
+		}
+	}
+	collector->count++;
+}
+
+/************************************************************
+*
+* Function: magCalFinish
+* @brief:   derive hard and soft iron terms from the extremes
+* @param:   asa, const uint8_t*, ASAX..ASAZ from
+*           mpu9250MagAdjustment, in AK8963 axis order
+* @return:  calStatus_t, CAL_DONE, CAL_INCOMPLETE if an axis
+*           was not swept far enough, or CAL_BAD_POSE if one
+*           radius is far below the others or a scale does not
+*           fit Q14; the result is identity unless CAL_DONE
+*
+************************************************************/
+calStatus_t magCalFinish(const magCalCollector_t *collector, const uint8_t *asa,
+		magCalibration_t *result) {
+	// mag[] is rotated: X and Y come from AK8963 Y and X
+	static const uint8_t asaIndex[3] = { 1, 0, 2 };
+	int32_t radius[3];
+	int32_t meanRadius = 0;
+	int32_t asaScale;
+	int32_t scale;
+	uint8_t i;
+
+	magCalIdentity(result);
+	for (i = 0; i < 3; i++) {
+		radius[i] = ((int32_t) collector->max[i] - collector->min[i]) / 2;
+		if (radius[i] * 2 < MAG_CAL_MIN_SPAN) {
+			return CAL_INCOMPLETE;
+		}
+		meanRadius += radius[i];
+	}
+	meanRadius /= 3;
+
+	for (i = 0; i < 3; i++) {
+		if (radius[i] < (meanRadius >> MAG_CAL_MIN_RADIUS_SHIFT)) {
+			magCalIdentity(result);
+			return CAL_BAD_POSE;
+		}
+		// Datasheet: Hadj = H * ((ASA - 128) / 256 + 1) = H * (ASA + 128) / 256
+		asaScale = (asa[asaIndex[i]] + 128) << (CAL_SCALE_SHIFT - 8);
+		scale = (meanRadius * asaScale) / radius[i];
+		if (scale > INT16_MAX) {
+			magCalIdentity(result);
+			return CAL_BAD_POSE;
+		}
+		result->offset[i] = (int16_t) (((int32_t) collector->max[i] + collector->min[i]) / 2);
+		result->scale[i] = (int16_t) scale;
+	}
+	return CAL_DONE;
+}
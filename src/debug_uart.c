@@ -0,0 +1,411 @@
+/************************************************************
+*
+* @file:      debug_uart.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     USART1 debug console, DMA line input and buffered
+*             output
+*
+*             USART1 on PA9 (TX) / PA10 (RX), AF1. DMA1 channel 5
+*             moves received bytes into a circular buffer; RX is
+*             remapped there through SYSCFG because channel 3 is
+*             the I2C1 RX channel. The buffer is scanned on every
+*             CR by the character match interrupt, so a line is
+*             queued as soon as it ends, when the receiver timeout
+*             sees the line go idle, for input ending in LF alone,
+*             and at the DMA half and full marks so a continuous
+*             stream is still scanned before it laps. Without the
+*             match, a line in a stream was queued only at the next
+*             mark, already held for up to half the buffer, and
+*             the stall below fired at 921600 before the
+*             background loop could see it (host/uart_test.c).
+*             CR or LF is overwritten by NUL in place and the line
+*             start queued for the background loop; lines are
+*             never copied, except that the part of a line past
+*             the buffer end is mirrored behind it to keep the
+*             line contiguous. Lines longer than the line size or
+*             arriving with the queue full are dropped. If the
+*             held lines back up to where the DMA could reach them
+*             before the next scan, its requests are switched off
+*             and input is dropped, as the old receiver did while
+*             a line was held; releasing a line then pends a scan
+*             to switch them back on.
+*             Output goes through a ring buffer that DMA1 channel
+*             4, USART1 TX remapped, sends in contiguous runs, so
+*             a write never waits on the wire and drops whatever
+*             does not fit. A run is only ever started from the
+*             DMA interrupt; writers pend it rather than touch the
+*             channel, so they cannot race its completion.
+*
+************************************************************/
+
+#include <string.h>
+#include "debug_uart.h"
+#include "divide.h"
+
+// USART1_RX and USART1_TX after SYSCFG_DMARemap_USART1Rx and _USART1Tx
+#define DEBUG_UART_RX_DMA           DMA1_Channel5
+#define DEBUG_UART_TX_DMA           DMA1_Channel4
+#define DEBUG_UART_RX_MASK          (DEBUG_UART_RX_SIZE - 1)
+// Held bytes that still leave the DMA half a buffer, the most it
+// writes between two scans, plus ~50 us of interrupt latency at
+// 3 Mbaud
+#define DEBUG_UART_RX_HELD_MAX      (DEBUG_UART_RX_SIZE / 2 - 16)
+
+// Room behind the circular part for the tail of a wrapped line
+static char rxBuffer[DEBUG_UART_RX_SIZE + DEBUG_UART_LINE_SIZE];
+static uint16_t rxScan = 0;             // next byte to look at, ISR only
+static uint16_t rxLineStart = 0;        // first byte of the open line, ISR only
+static uint8_t rxDiscard = 0;           // open line is too long, ISR only
+static volatile uint8_t rxStalled = 0;  // DMA requests off, written by ISR
+static uint16_t lineStarts[DEBUG_UART_LINE_QUEUE];
+static volatile uint8_t lineHead = 0;   // next free slot, written by ISR
+static volatile uint8_t lineTail = 0;   // oldest line, written by reader
+
+static char txBuffer[DEBUG_UART_TX_SIZE];
+static volatile uint16_t txHead = 0;    // first byte of the run in flight, ISR side
+static volatile uint16_t txTail = 0;    // next free slot, writer side
+static uint16_t txSending = 0;          // bytes in flight, ISR only
+
+/************************************************************
+*
+* Function: debugUartInit
+* @brief:   USART1 8N1 at DEBUG_UART_BAUD, RX by circular DMA
+*           with the receiver timeout and DMA interrupts, TX by
+*           one DMA run at a time
+*
+************************************************************/
+void debugUartInit(void) {
+	GPIO_InitTypeDef gpio;
+	USART_InitTypeDef usart;
+	DMA_InitTypeDef dma;
+
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_GPIOA | RCC_AHBPeriph_DMA1, ENABLE);
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_USART1 | RCC_APB2Periph_SYSCFG, ENABLE);
+	SYSCFG_DMAChannelRemapConfig(SYSCFG_DMARemap_USART1Rx | SYSCFG_DMARemap_USART1Tx, ENABLE);
+
+	GPIO_PinAFConfig(GPIOA, GPIO_PinSource9, GPIO_AF_1);
+	GPIO_PinAFConfig(GPIOA, GPIO_PinSource10, GPIO_AF_1);
+	GPIO_StructInit(&gpio);
+	gpio.GPIO_Pin = GPIO_Pin_9 | GPIO_Pin_10;
+	gpio.GPIO_Mode = GPIO_Mode_AF;
+	gpio.GPIO_Speed = GPIO_Speed_50MHz;
+	gpio.GPIO_PuPd = GPIO_PuPd_UP;
+	GPIO_Init(GPIOA, &gpio);
+
+	DMA_StructInit(&dma);
+	dma.DMA_PeripheralBaseAddr = (uint32_t) &USART1->RDR;
+	dma.DMA_MemoryBaseAddr = (uint32_t) rxBuffer;
+	dma.DMA_DIR = DMA_DIR_PeripheralSRC;
+	dma.DMA_BufferSize = DEBUG_UART_RX_SIZE;
+	dma.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	dma.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	dma.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+	dma.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+	dma.DMA_Mode = DMA_Mode_Circular;
+	dma.DMA_Priority = DMA_Priority_Low;
+	dma.DMA_M2M = DMA_M2M_Disable;
+	DMA_Init(DEBUG_UART_RX_DMA, &dma);
+	DMA_ITConfig(DEBUG_UART_RX_DMA, DMA_IT_HT | DMA_IT_TC, ENABLE);
+	DMA_Cmd(DEBUG_UART_RX_DMA, ENABLE);
+
+	// Address and length are set per run
+	dma.DMA_PeripheralBaseAddr = (uint32_t) &USART1->TDR;
+	dma.DMA_DIR = DMA_DIR_PeripheralDST;
+	dma.DMA_BufferSize = 1;
+	dma.DMA_Mode = DMA_Mode_Normal;
+	DMA_Init(DEBUG_UART_TX_DMA, &dma);
+	DMA_ITConfig(DEBUG_UART_TX_DMA, DMA_IT_TC, ENABLE);
+
+#if DEBUG_UART_BAUD > DEBUG_UART_OVER16_MAX
+	// Before USART_Init, which picks the divider for it
+	USART_OverSampling8Cmd(USART1, ENABLE);
+#endif
+	USART_StructInit(&usart);
+	usart.USART_BaudRate = DEBUG_UART_BAUD;
+	USART_Init(USART1, &usart);
+	USART_SetReceiverTimeOut(USART1, DEBUG_UART_RX_TIMEOUT);
+	USART_ReceiverTimeOutCmd(USART1, ENABLE);
+	// All 8 bits compared, ADD is only written with UE clear
+	USART_AddressDetectionConfig(USART1, USART_AddressLength_7b);
+	USART_SetAddress(USART1, '\r');
+	USART_ITConfig(USART1, USART_IT_RTO, ENABLE);
+	USART_ITConfig(USART1, USART_IT_CM, ENABLE);
+	USART_DMACmd(USART1, USART_DMAReq_Rx | USART_DMAReq_Tx, ENABLE);
+	USART_Cmd(USART1, ENABLE);
+
+	// Lowest priority, the console must never delay control; the
+	// two share it, so neither the scan nor a TX run start ever
+	// preempts itself
+	NVIC_SetPriority(USART1_IRQn, 3);
+	NVIC_EnableIRQ(USART1_IRQn);
+	NVIC_SetPriority(DMA1_Channel4_5_IRQn, 3);
+	NVIC_EnableIRQ(DMA1_Channel4_5_IRQn);
+}
+
+/************************************************************
+*
+* Function: scanInput
+* @brief:   look through the bytes the DMA wrote since the last
+*           scan, terminate complete lines in place and queue
+*           them; only called at the console priority
+*
+************************************************************/
+static void scanInput(void) {
+	uint16_t head = (uint16_t) ((DEBUG_UART_RX_SIZE
+			- DMA_GetCurrDataCounter(DEBUG_UART_RX_DMA)) & DEBUG_UART_RX_MASK);
+	uint16_t length;
+	uint16_t held;
+	char byte;
+
+	while (rxScan != head) {
+		byte = rxBuffer[rxScan];
+		length = (rxScan - rxLineStart) & DEBUG_UART_RX_MASK;
+		if (byte == '\r' || byte == '\n') {
+			if (!rxDiscard && length > 0
+					&& ((lineHead + 1) & (DEBUG_UART_LINE_QUEUE - 1)) != lineTail) {
+				if (rxScan < rxLineStart) {
+					// Wrapped: continue the line behind the buffer end
+					memcpy(&rxBuffer[DEBUG_UART_RX_SIZE], rxBuffer, rxScan);
+					rxBuffer[DEBUG_UART_RX_SIZE + rxScan] = '\0';
+				} else {
+					rxBuffer[rxScan] = '\0';
+				}
+				lineStarts[lineHead] = rxLineStart;
+				lineHead = (lineHead + 1) & (DEBUG_UART_LINE_QUEUE - 1);
+			}
+			rxDiscard = 0;
+			rxLineStart = (rxScan + 1) & DEBUG_UART_RX_MASK;
+		} else if (length >= DEBUG_UART_LINE_SIZE - 1) {
+			rxDiscard = 1;
+		}
+		rxScan = (rxScan + 1) & DEBUG_UART_RX_MASK;
+	}
+
+	held = lineHead != lineTail ? (head - lineStarts[lineTail]) & DEBUG_UART_RX_MASK : 0;
+	if (!rxStalled && held > DEBUG_UART_RX_HELD_MAX) {
+		USART_DMACmd(USART1, USART_DMAReq_Rx, DISABLE);
+		rxStalled = 1;
+	} else if (rxStalled && held <= DEBUG_UART_RX_HELD_MAX) {
+		// Bytes were lost, drop the open line up to its terminator.
+		// RDR still holds the byte from before the gap; were the DMA
+		// to take it and it be a CR, the torn line after the gap
+		// would end the discard and be queued, so flush it first
+		rxDiscard = 1;
+		rxStalled = 0;
+		USART_RequestCmd(USART1, USART_Request_RXFRQ, ENABLE);
+		USART_DMACmd(USART1, USART_DMAReq_Rx, ENABLE);
+	}
+}
+
+/************************************************************
+*
+* Function: debugUartGetLine
+* @brief:   fetch the oldest complete input line without its
+*           terminator
+* @return:  const char*, NUL terminated line in the receive
+*           buffer, NULL if none yet; valid until
+*           debugUartReleaseLine
+*
+************************************************************/
+const char *debugUartGetLine(void) {
+	return lineHead != lineTail ? &rxBuffer[lineStarts[lineTail]] : 0;
+}
+
+/************************************************************
+*
+* Function: debugUartReleaseLine
+* @brief:   drop the line returned by debugUartGetLine
+*
+************************************************************/
+void debugUartReleaseLine(void) {
+	if (lineHead != lineTail) {
+		lineTail = (lineTail + 1) & (DEBUG_UART_LINE_QUEUE - 1);
+	}
+	if (rxStalled) {
+		NVIC_SetPendingIRQ(USART1_IRQn);
+	}
+}
+
+/************************************************************
+*
+* Function: debugUartWrite
+* @brief:   queue text for transmission, never blocks
+* @return:  uint16_t, bytes queued
+*
+************************************************************/
+uint16_t debugUartWrite(const char *text) {
+	uint16_t count = 0;
+	uint16_t tail = txTail;
+
+	while (*text != '\0') {
+		if (((tail + 1) & (DEBUG_UART_TX_SIZE - 1)) == txHead) {
+			break;
+		}
+		txBuffer[tail] = *text++;
+		tail = (tail + 1) & (DEBUG_UART_TX_SIZE - 1);
+		count++;
+	}
+	txTail = tail;
+	NVIC_SetPendingIRQ(DMA1_Channel4_5_IRQn);
+	return count;
+}
+
+/************************************************************
+*
+* Function: debugUartWriteBytes
+* @brief:   queue raw bytes, e.g. a binary frame; check
+*           debugUartTxFree first to avoid sending a partial frame
+* @return:  uint16_t, bytes queued
+*
+************************************************************/
+uint16_t debugUartWriteBytes(const uint8_t *data, uint16_t length) {
+	uint16_t count = 0;
+	uint16_t tail = txTail;
+
+	while (count < length) {
+		if (((tail + 1) & (DEBUG_UART_TX_SIZE - 1)) == txHead) {
+			break;
+		}
+		txBuffer[tail] = (char) data[count++];
+		tail = (tail + 1) & (DEBUG_UART_TX_SIZE - 1);
+	}
+	txTail = tail;
+	NVIC_SetPendingIRQ(DMA1_Channel4_5_IRQn);
+	return count;
+}
+
+/************************************************************
+*
+* Function: debugUartTxFree
+* @return:  uint16_t, bytes that can be queued right now
+*
+************************************************************/
+uint16_t debugUartTxFree(void) {
+	return (uint16_t) ((txHead - txTail - 1) & (DEBUG_UART_TX_SIZE - 1));
+}
+
+/************************************************************
+*
+* Function: debugUartWriteInt
+* @brief:   queue a signed decimal number
+*
+************************************************************/
+void debugUartWriteInt(int32_t value) {
+	char digits[12];
+	char *cursor = &digits[sizeof(digits) - 1];
+	uint32_t magnitude = value < 0 ? -(uint32_t) value : (uint32_t) value;
+	uint32_t quotient;
+
+	*cursor = '\0';
+	do {
+		quotient = divideU32By10(magnitude);
+		*--cursor = (char) ('0' + (magnitude - quotient * 10));
+		magnitude = quotient;
+	} while (magnitude != 0);
+	if (value < 0) {
+		*--cursor = '-';
+	}
+	debugUartWrite(cursor);
+}
+
+/************************************************************
+*
+* Function: parseInt
+* @brief:   parse an optionally signed decimal after any spaces
+* @param:   cursor, const char**, advanced past the number
+* @param:   value, int32_t*, parsed value
+* @return:  int, 0 on success, -1 if no number was found or
+*           it does not fit in an int32_t; the cursor is then
+*           left where it was
+*
+************************************************************/
+int parseInt(const char **cursor, int32_t *value) {
+	const char *text = *cursor;
+	int32_t result = 0;
+	uint8_t negative = 0;
+
+	while (*text == ' ') {
+		text++;
+	}
+	if (*text == '-') {
+		negative = 1;
+		text++;
+	}
+	if (*text < '0' || *text > '9') {
+		return -1;
+	}
+	while (*text >= '0' && *text <= '9') {
+		// Stop before result * 10 + digit passes INT32_MAX
+		if (result > INT32_MAX / 10
+				|| (result == INT32_MAX / 10 && *text - '0' > INT32_MAX % 10)) {
+			return -1;
+		}
+		result = result * 10 + (*text++ - '0');
+	}
+	*value = negative ? -result : result;
+	*cursor = text;
+	return 0;
+}
+
+/************************************************************
+*
+* Function: debugUartIrqHandler
+* @brief:   USART1 character match and receiver timeout
+*           service, called from USART1_IRQHandler
+*
+************************************************************/
+void debugUartIrqHandler(void) {
+	if (USART1->ISR & USART_ISR_ORE) {
+		USART_ClearFlag(USART1, USART_FLAG_ORE);
+	}
+
+	// Also when pended by debugUartReleaseLine to resume the DMA
+	if ((USART1->ISR & (USART_ISR_CMF | USART_ISR_RTOF)) || rxStalled) {
+		USART_ClearFlag(USART1, USART_FLAG_CM | USART_FLAG_RTO);
+		scanInput();
+	}
+
+}
+
+/************************************************************
+*
+* Function: startTransmit
+* @brief:   send the queued bytes up to the buffer end as one DMA
+*           run, with the channel idle
+*
+************************************************************/
+static void startTransmit(void) {
+	uint16_t head = txHead;
+	uint16_t tail = txTail;
+
+	txSending = tail > head ? tail - head : DEBUG_UART_TX_SIZE - head;
+	DMA_Cmd(DEBUG_UART_TX_DMA, DISABLE);
+	DEBUG_UART_TX_DMA->CMAR = (uint32_t) &txBuffer[head];
+	DMA_SetCurrDataCounter(DEBUG_UART_TX_DMA, txSending);
+	DMA_Cmd(DEBUG_UART_TX_DMA, ENABLE);
+}
+
+/************************************************************
+*
+* Function: debugUartDmaIrqHandler
+* @brief:   RX DMA half and full marks and TX run completion,
+*           called from DMA1_Channel4_5_IRQHandler; also pended
+*           by the writers to start a run
+*
+************************************************************/
+void debugUartDmaIrqHandler(void) {
+	if (DMA_GetITStatus(DMA1_IT_GL5)) {
+		DMA_ClearITPendingBit(DMA1_IT_GL5);
+		scanInput();
+	}
+	if (DMA_GetITStatus(DMA1_IT_TC4)) {
+		DMA_ClearITPendingBit(DMA1_IT_GL4);
+		txHead = (txHead + txSending) & (DEBUG_UART_TX_SIZE - 1);
+		txSending = 0;
+	}
+	if (txSending == 0 && txHead != txTail) {
+		startTransmit();
+	}
+}
@@ -0,0 +1,305 @@
+/************************************************************
+*
+* @file:      fastmath.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Integer atan2, sqrt and inverse sqrt kernels
+*
+*             atan2Q15 folds the vector into the first octant,
+*             takes the ratio through the divide.h reciprocal
+*             table and evaluates a degree 9 odd minimax
+*             polynomial, 32 bit multiplies only. atan2Q31 runs
+*             CORDIC vectoring, shifts and adds only, for the
+*             extra bits. rsqrtU32 seeds from an interpolated
+*             table and refines by two Newton steps on mulhiU32;
+*             sqrtQ31 is x * rsqrt(x) on the same path. The
+*             floating point and CMSIS versions are all emulated
+*             or iterate bit by bit on this core.
+*
+************************************************************/
+
+#include "fastmath.h"
+#include "divide.h"
+
+// atan(t) / pi ~ t * (c1 + c3 t^2 + ... + c9 t^8) on [0, 1], Q17,
+// minimax error 3.6e-6 of pi
+#define ATAN_C1                     41716
+#define ATAN_C3                     (-13781)
+#define ATAN_C5                     7517
+#define ATAN_C7                     (-3553)
+#define ATAN_C9                     870
+
+// Q15 quarter and half turn
+#define ANGLE_Q15_QUARTER           0x4000
+#define ANGLE_Q15_HALF              0x8000
+
+// CORDIC input magnitude: the rotations grow the vector by 1.647
+// and the first one by up to sqrt(2), both must fit in 31 bits
+#define CORDIC_NORM_BITS            29
+
+// Seed interpolation: rsqrtSeedTable splits [2^30, 2^32) into
+// 3 * 2^(RSQRT_LUT_BITS - 2) intervals
+#define RSQRT_INDEX_SHIFT           (32 - RSQRT_LUT_BITS)
+#define RSQRT_INDEX_FIRST           (1 << (RSQRT_LUT_BITS - 2))
+#define RSQRT_FRAC_BITS             10
+#define RSQRT_ONE_Q30               0x40000000
+
+/************************************************************
+*
+* Function: atanOctantQ32
+* @brief:   atan(t) / pi for t = min / max in the first octant
+* @param:   min, uint32_t, smaller magnitude, at most max
+* @param:   max, uint32_t, larger magnitude, 1 .. 2^15
+* @return:  int32_t, Q32 fraction of pi, 0 .. 2^30
+*
+************************************************************/
+static int32_t atanOctantQ32(uint32_t min, uint32_t max) {
+	uint8_t shift;
+	uint32_t r = divideReciprocal((uint16_t) max, &shift);
+	int32_t t = (int32_t) ((min * r) >> (16 - shift));
+	int32_t t2;
+	int32_t p;
+
+	// The reciprocal only rounds up, t may pass 1.0 by one LSB
+	if (t > Q15_ONE + 1) {
+		t = Q15_ONE + 1;
+	}
+	t2 = (t * t) >> 15;
+	p = ATAN_C9;
+	p = ATAN_C7 + ((p * t2) >> 15);
+	p = ATAN_C5 + ((p * t2) >> 15);
+	p = ATAN_C3 + ((p * t2) >> 15);
+	p = ATAN_C1 + ((p * t2) >> 15);
+	return p * t;
+}
+
+/************************************************************
+*
+* Function: atan2Q15
+* @brief:   four quadrant atan2 of 16 bit components
+* @param:   y, int16_t, any scale shared with x
+* @return:  int16_t, Q15 fraction of pi, 0 for a zero vector
+*
+************************************************************/
+int16_t atan2Q15(int16_t y, int16_t x) {
+	uint32_t ax = x < 0 ? (uint32_t) -x : (uint32_t) x;
+	uint32_t ay = y < 0 ? (uint32_t) -y : (uint32_t) y;
+	int32_t angle;
+
+	if (ax == 0 && ay == 0) {
+		return 0;
+	}
+	if (ay <= ax) {
+		angle = (atanOctantQ32(ay, ax) + (1 << 16)) >> 17;
+	} else {
+		angle = ANGLE_Q15_QUARTER - ((atanOctantQ32(ax, ay) + (1 << 16)) >> 17);
+	}
+	if (x < 0) {
+		angle = ANGLE_Q15_HALF - angle;
+	}
+	if (y < 0) {
+		angle = -angle;
+	}
+	// +180 deg wraps to -180, the same binary angle
+	return (int16_t) angle;
+}
+
+/************************************************************
+*
+* Function: atan2Q31
+* @brief:   four quadrant atan2 of 32 bit components by CORDIC
+*           vectoring, ATAN_CORDIC_STEPS rotations
+* @param:   y, int32_t, any scale shared with x
+* @return:  int32_t, Q31 fraction of pi, 0 for a zero vector
+*
+************************************************************/
+int32_t atan2Q31(int32_t y, int32_t x) {
+	uint32_t ax = x < 0 ? 0u - (uint32_t) x : (uint32_t) x;
+	uint32_t ay = y < 0 ? 0u - (uint32_t) y : (uint32_t) y;
+	uint32_t max = ax > ay ? ax : ay;
+	uint32_t angle = 0;
+	int32_t nextX;
+	uint8_t i;
+
+	if (max == 0) {
+		return 0;
+	}
+	// Bring the larger magnitude to 2^(CORDIC_NORM_BITS - 1) .. 2^CORDIC_NORM_BITS
+	while (max >= (1u << CORDIC_NORM_BITS)) {
+		max >>= 1;
+		ax >>= 1;
+		ay >>= 1;
+	}
+	while (max < (1u << (CORDIC_NORM_BITS - 1))) {
+		max <<= 1;
+		ax <<= 1;
+		ay <<= 1;
+	}
+	// Rotate the left half plane by 180 deg, x >= 0 from here on
+	if (x < 0) {
+		angle = 0x80000000u;
+	}
+	y = (y < 0) != (x < 0) ? -(int32_t) ay : (int32_t) ay;
+	x = (int32_t) ax;
+
+	for (i = 0; i < ATAN_CORDIC_STEPS; i++) {
+		if (y > 0) {
+			nextX = x + (y >> i);
+			y -= x >> i;
+			angle += (uint32_t) atanCordicTable[i];
+		} else {
+			nextX = x - (y >> i);
+			y += x >> i;
+			angle -= (uint32_t) atanCordicTable[i];
+		}
+		x = nextX;
+	}
+	return (int32_t) angle;
+}
+
+/************************************************************
+*
+* Function: sqrtU32
+* @brief:   exact floor(sqrt(x)), one result bit per step with
+*           shifts and subtracts only
+*
+************************************************************/
+uint16_t sqrtU32(uint32_t x) {
+	uint32_t root = 0;
+	uint32_t bit = 1u << 30;
+
+	while (bit > x) {
+		bit >>= 2;
+	}
+	while (bit != 0) {
+		if (x >= root + bit) {
+			x -= root + bit;
+			root = (root >> 1) + bit;
+		} else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+	return (uint16_t) root;
+}
+
+/************************************************************
+*
+* Function: sqrtQ15
+* @brief:   exact floor of the Q15 square root
+* @param:   x, int16_t, Q15, negative gives 0
+*
+************************************************************/
+int16_t sqrtQ15(int16_t x) {
+	if (x <= 0) {
+		return 0;
+	}
+	return (int16_t) sqrtU32((uint32_t) x << 15);
+}
+
+/************************************************************
+*
+* Function: normalizeEven
+* @brief:   shift x left by an even count into [2^30, 2^32)
+* @param:   half, uint8_t*, set to half the shift count
+*
+************************************************************/
+static uint32_t normalizeEven(uint32_t x, uint8_t *half) {
+	uint8_t count = 0;
+
+	// No CLZ on the M0, halving steps as in divideReciprocal
+	if (x < 0x00010000) {
+		x <<= 16;
+		count += 8;
+	}
+	if (x < 0x01000000) {
+		x <<= 8;
+		count += 4;
+	}
+	if (x < 0x10000000) {
+		x <<= 4;
+		count += 2;
+	}
+	if (x < 0x40000000) {
+		x <<= 2;
+		count += 1;
+	}
+	*half = count;
+	return x;
+}
+
+/************************************************************
+*
+* Function: rsqrtNormalized
+* @brief:   1 / sqrt(a) for a = x / 2^32 in [1/4, 1)
+* @param:   x, uint32_t, in [2^30, 2^32)
+* @return:  uint32_t, Q30, in (2^30, 2^31)
+*
+************************************************************/
+static uint32_t rsqrtNormalized(uint32_t x) {
+	uint32_t index = (x >> RSQRT_INDEX_SHIFT) - RSQRT_INDEX_FIRST;
+	uint32_t frac = (x >> (RSQRT_INDEX_SHIFT - RSQRT_FRAC_BITS)) & ((1 << RSQRT_FRAC_BITS) - 1);
+	uint32_t r0 = 0x8000 + rsqrtSeedTable[index];
+	uint32_t r1 = 0x8000 + rsqrtSeedTable[index + 1];
+	uint32_t y = (r0 - (((r0 - r1) * frac) >> RSQRT_FRAC_BITS)) << 15;
+	uint32_t error;
+	uint8_t i;
+
+	// y += y (1 - a y^2) / 2, each step squares the relative error;
+	// the seed is a chord of a convex curve, 2^-11 high at worst
+	for (i = 0; i < 2; i++) {
+		// Keep y < 2 so y << 1 stays in 32 bits, only a = 1/4 hits it
+		if (y >= 0x80000000u) {
+			y = 0x7FFFFFFFu;
+		}
+		error = mulhiU32(x, mulhiU32(y << 1, y << 1));
+		if (error > RSQRT_ONE_Q30) {
+			y -= mulhiU32(y, (error - RSQRT_ONE_Q30) << 1);
+		} else {
+			y += mulhiU32(y, (RSQRT_ONE_Q30 - error) << 1);
+		}
+	}
+	return y;
+}
+
+/************************************************************
+*
+* Function: rsqrtU32
+* @brief:   inverse square root as a mantissa and a shift, since
+*           1 / sqrt(x) spans more range than any one Q format
+* @param:   x, uint32_t, not 0
+* @param:   shift, uint8_t*, set so that r ~ 2^(30 + shift) / sqrt(x),
+*           1 .. 16
+* @return:  uint32_t, r in (2^30, 2^31)
+*
+************************************************************/
+uint32_t rsqrtU32(uint32_t x, uint8_t *shift) {
+	uint8_t half;
+	uint32_t r = rsqrtNormalized(normalizeEven(x, &half));
+
+	*shift = 16 - half;
+	return r;
+}
+
+/************************************************************
+*
+* Function: sqrtQ31
+* @brief:   Q31 square root as x * rsqrt(x)
+* @param:   x, int32_t, Q31, negative gives 0
+*
+************************************************************/
+int32_t sqrtQ31(int32_t x) {
+	uint8_t half;
+	uint32_t normalized;
+	uint32_t root;
+
+	if (x <= 0) {
+		return 0;
+	}
+	// sqrt(x 2^31) = 2^15 sqrt(2 x), an even power keeps it exact
+	normalized = normalizeEven((uint32_t) x << 1, &half);
+	root = mulhiU32(normalized, rsqrtNormalized(normalized));
+	root = (root << 1) >> half;
+	return root > INT32_MAX ? INT32_MAX : (int32_t) root;
+}
@@ -0,0 +1,106 @@
+/************************************************************
+*
+* @file:      flash_store.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Settings record kept in a reserved flash page
+*
+*             Layout in halfwords: magic, count, count data
+*             halfwords, then the one's complement of their sum.
+*             Erasing a page stalls every flash fetch, interrupts
+*             included, for up to 40 ms; only save while the motors
+*             are off. The 100 ms IWDG window covers the stall.
+*
+************************************************************/
+
+#include "flash_store.h"
+
+#define FLASH_STORE_STRING(x)       #x
+#define FLASH_STORE_SYMBOL(x)       FLASH_STORE_STRING(x)
+
+// For the ASSERT in startup/flash_store.ld
+__asm__(".global __flash_store_start\n"
+		".set __flash_store_start, " FLASH_STORE_SYMBOL(FLASH_STORE_ADDRESS));
+
+static uint16_t checksum(const uint16_t *data, uint16_t count) {
+	uint16_t sum = 0;
+	uint16_t i;
+
+	for (i = 0; i < count; i++) {
+		sum += data[i];
+	}
+	return (uint16_t) ~sum;
+}
+
+/************************************************************
+*
+* Function: flashStoreLoad
+* @brief:   read the stored record
+* @param:   data, uint16_t*, receives count halfwords
+* @param:   count, uint16_t, expected payload length
+* @return:  int, 0 if a valid record of that length was read
+*
+************************************************************/
+int flashStoreLoad(uint16_t *data, uint16_t count) {
+	const uint16_t *page = (const uint16_t *) FLASH_STORE_ADDRESS;
+	uint16_t i;
+
+	if (count > FLASH_STORE_MAX_DATA || page[0] != FLASH_STORE_MAGIC || page[1] != count
+			|| page[2 + count] != checksum(&page[2], count)) {
+		return -1;
+	}
+	for (i = 0; i < count; i++) {
+		data[i] = page[2 + i];
+	}
+	return 0;
+}
+
+/************************************************************
+*
+* Function: flashStoreSave
+* @brief:   erase the page and program a new record with
+*           FLASH_ProgramHalfWord, then verify it
+* @return:  int, 0 on success, -1 on a flash error
+*
+************************************************************/
+int flashStoreSave(const uint16_t *data, uint16_t count) {
+	uint32_t address = FLASH_STORE_ADDRESS;
+	const uint16_t *page;
+	FLASH_Status status;
+	uint16_t i;
+
+	if (count > FLASH_STORE_MAX_DATA) {
+		return -1;
+	}
+	FLASH_Unlock();
+	FLASH_ClearFlag(FLASH_FLAG_EOP | FLASH_FLAG_PGERR | FLASH_FLAG_WRPERR);
+	status = FLASH_ErasePage(FLASH_STORE_ADDRESS);
+	if (status == FLASH_COMPLETE) {
+		status = FLASH_ProgramHalfWord(address, FLASH_STORE_MAGIC);
+		address += 2;
+	}
+	if (status == FLASH_COMPLETE) {
+		status = FLASH_ProgramHalfWord(address, count);
+		address += 2;
+	}
+	for (i = 0; i < count && status == FLASH_COMPLETE; i++) {
+		status = FLASH_ProgramHalfWord(address, data[i]);
+		address += 2;
+	}
+	if (status == FLASH_COMPLETE) {
+		status = FLASH_ProgramHalfWord(address, checksum(data, count));
+	}
+	FLASH_Lock();
+
+	if (status != FLASH_COMPLETE) {
+		return -1;
+	}
+	page = (const uint16_t *) FLASH_STORE_ADDRESS;
+	for (i = 0; i < count; i++) {
+		if (page[2 + i] != data[i]) {
+			return -1;
+		}
+	}
+	return page[2 + count] == checksum(data, count) ? 0 : -1;
+}
@@ -0,0 +1,112 @@
+/************************************************************
+*
+* @file:      gain_schedule.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     PID gains interpolated from a tilt x wheel speed
+*             table
+*
+*             Lookup is two shifts for the cell, two masks for the
+*             weights and three bilinear blends of four corners,
+*             about 150 cycles on the M0. The table can be edited
+*             at any time from the background loop; the PID keeps
+*             its integral in output units, so new gains never
+*             reset or bump the integrator.
+*
+************************************************************/
+
+#include "gain_schedule.h"
+
+#define GS_TILT_MASK                ((1 << GS_TILT_SHIFT) - 1)
+#define GS_SPEED_MASK               ((1 << GS_SPEED_SHIFT) - 1)
+
+// Rows by |tilt|, columns by |speed|; near upright is gentlest,
+// the D term falls off with speed where the loop is noisier
+pidGains_t gainTable[GS_TILT_POINTS][GS_SPEED_POINTS] = {
+	{ { 23656, 200, 7200 }, { 22500, 200, 6800 }, { 21500, 180, 6400 }, { 20500, 160, 6000 } },
+	{ { 25000, 200, 7400 }, { 24000, 200, 7000 }, { 23000, 180, 6600 }, { 22000, 160, 6200 } },
+	{ { 27000, 180, 7600 }, { 26000, 180, 7200 }, { 25000, 160, 6800 }, { 24000, 140, 6400 } },
+	{ { 29000, 160, 7800 }, { 28000, 160, 7400 }, { 27000, 140, 7000 }, { 26000, 120, 6600 } },
+	{ { 31000, 140, 8000 }, { 30000, 140, 7600 }, { 29000, 120, 7200 }, { 28000, 100, 6800 } },
+};
+
+static inline int16_t blend(int16_t a, int16_t b, int32_t weight, uint8_t shift) {
+	return (int16_t) (a + (((b - a) * weight) >> shift));
+}
+
+/************************************************************
+*
+* Function: gainScheduleLookup
+* @brief:   bilinear interpolation at the current operating
+*           point, clamped to the table edges
+* @param:   tilt, int16_t, Q15 tilt angle
+* @param:   speed, int16_t, wheel speed in steps/s
+* @param:   gains, pidGains_t*, interpolated result
+*
+************************************************************/
+void gainScheduleLookup(int16_t tilt, int16_t speed, pidGains_t *gains) {
+	int32_t tiltAbs = tilt < 0 ? -tilt : tilt;
+	int32_t speedAbs = speed < 0 ? -speed : speed;
+	uint32_t row = tiltAbs >> GS_TILT_SHIFT;
+	uint32_t col = speedAbs >> GS_SPEED_SHIFT;
+	int32_t tiltWeight = tiltAbs & GS_TILT_MASK;
+	int32_t speedWeight = speedAbs & GS_SPEED_MASK;
+	const pidGains_t *g00;
+	const pidGains_t *g01;
+	const pidGains_t *g10;
+	const pidGains_t *g11;
+
+	if (row >= GS_TILT_POINTS - 1) {
+		row = GS_TILT_POINTS - 2;
+		tiltWeight = 1 << GS_TILT_SHIFT;
+	}
+	if (col >= GS_SPEED_POINTS - 1) {
+		col = GS_SPEED_POINTS - 2;
+		speedWeight = 1 << GS_SPEED_SHIFT;
+	}
+	g00 = &gainTable[row][col];
+	g01 = &gainTable[row][col + 1];
+	g10 = &gainTable[row + 1][col];
+	g11 = &gainTable[row + 1][col + 1];
+
+	gains->kp = blend(blend(g00->kp, g01->kp, speedWeight, GS_SPEED_SHIFT),
+			blend(g10->kp, g11->kp, speedWeight, GS_SPEED_SHIFT), tiltWeight, GS_TILT_SHIFT);
+	gains->ki = blend(blend(g00->ki, g01->ki, speedWeight, GS_SPEED_SHIFT),
+			blend(g10->ki, g11->ki, speedWeight, GS_SPEED_SHIFT), tiltWeight, GS_TILT_SHIFT);
+	gains->kd = blend(blend(g00->kd, g01->kd, speedWeight, GS_SPEED_SHIFT),
+			blend(g10->kd, g11->kd, speedWeight, GS_SPEED_SHIFT), tiltWeight, GS_TILT_SHIFT);
+}
+
+/************************************************************
+*
+* Function: gainScheduleSet
+* @brief:   replace one table entry, takes effect next tick
+* @return:  int, 0 on success, -1 if the index is out of range
+*
+************************************************************/
+int gainScheduleSet(uint8_t tiltIndex, uint8_t speedIndex, const pidGains_t *gains) {
+	if (tiltIndex >= GS_TILT_POINTS || speedIndex >= GS_SPEED_POINTS) {
+		return -1;
+	}
+	gainTable[tiltIndex][speedIndex] = *gains;
+	return 0;
+}
+
+/************************************************************
+*
+* Function: gainScheduleFill
+* @brief:   flatten the table to one set of gains, e.g. an
+*           auto-tune result, to be reshaped by hand afterwards
+*
+************************************************************/
+void gainScheduleFill(const pidGains_t *gains) {
+	uint8_t tiltIndex;
+	uint8_t speedIndex;
+
+	for (tiltIndex = 0; tiltIndex < GS_TILT_POINTS; tiltIndex++) {
+		for (speedIndex = 0; speedIndex < GS_SPEED_POINTS; speedIndex++) {
+			gainTable[tiltIndex][speedIndex] = *gains;
+		}
+	}
+}
@@ -0,0 +1,420 @@
+/************************************************************
+*
+* @file:      i2c_master.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Interrupt driven, timeout bounded I2C1 master with
+*             a transaction queue and completion callbacks
+*
+*             A register write is one AUTOEND transfer of reg and
+*             payload. A burst read is a SOFTEND write of reg, then
+*             on TC a repeated START for the AUTOEND read. Every
+*             transaction ends at STOPF, so the bus is always left
+*             idle before the next one starts. Nothing in here
+*             waits on a flag without a bound.
+*
+*             Read payloads are moved by DMA1 channel 3, so a long
+*             burst costs three interrupts (TXIS, TC, STOPF) instead
+*             of one per byte.
+*
+************************************************************/
+
+#include "i2c_master.h"
+#include "timebase.h"
+
+// I2C1 on PB6 (SCL) / PB7 (SDA), AF1
+#define I2C_GPIO                GPIOB
+#define I2C_SCL_PIN             GPIO_Pin_6
+#define I2C_SDA_PIN             GPIO_Pin_7
+#define I2C_SCL_SOURCE          GPIO_PinSource6
+#define I2C_SDA_SOURCE          GPIO_PinSource7
+#define I2C_RECOVERY_CLOCKS     9
+// ~5 us half period at 48 MHz, the loop is about 4 cycles per count
+#define I2C_RECOVERY_DELAY      60
+
+// I2C1_RX request is hard wired to DMA1 channel 3 on the F051
+#define I2C_RX_DMA              DMA1_Channel3
+
+#define I2C_ERROR_FLAGS         (I2C_ISR_BERR | I2C_ISR_ARLO | I2C_ISR_OVR)
+#define I2C_ALL_IT              (I2C_IT_ERRI | I2C_IT_TCI | I2C_IT_STOPI \
+		| I2C_IT_NACKI | I2C_IT_TXI)
+
+typedef enum {
+	PHASE_IDLE = 0,
+	PHASE_REG,                  // sending the register address
+	PHASE_PAYLOAD,              // moving payload bytes
+	PHASE_STOP                  // waiting for STOPF
+} i2cPhase_t;
+
+static i2cTransaction_t queue[I2C_QUEUE_SIZE];
+static volatile uint8_t queueHead = 0;  // next to run, written by ISR
+static volatile uint8_t queueTail = 0;  // next free slot, written by submitter
+
+static volatile i2cPhase_t phase = PHASE_IDLE;
+static volatile i2cStatus_t result = I2C_STATUS_OK;
+static volatile uint32_t startTick = 0;
+static volatile uint32_t timeoutTicks = I2C_TIMEOUT_TICKS;
+static uint8_t payloadIndex = 0;
+static i2cStats_t stats;
+
+static void startNext(void);
+
+static void configurePins(void) {
+	GPIO_InitTypeDef gpio;
+
+	GPIO_PinAFConfig(I2C_GPIO, I2C_SCL_SOURCE, GPIO_AF_1);
+	GPIO_PinAFConfig(I2C_GPIO, I2C_SDA_SOURCE, GPIO_AF_1);
+	gpio.GPIO_Pin = I2C_SCL_PIN | I2C_SDA_PIN;
+	gpio.GPIO_Mode = GPIO_Mode_AF;
+	gpio.GPIO_Speed = GPIO_Speed_50MHz;
+	gpio.GPIO_OType = GPIO_OType_OD;
+	gpio.GPIO_PuPd = GPIO_PuPd_UP;
+	GPIO_Init(I2C_GPIO, &gpio);
+}
+
+static void recoveryDelay(void) {
+	volatile uint32_t i;
+
+	for (i = 0; i < I2C_RECOVERY_DELAY; i++);
+}
+
+/************************************************************
+* Bus recovery: reset the peripheral, then take SCL over as
+* an open drain GPIO and clock up to nine pulses so a slave
+* stuck mid-byte releases SDA, and finish with a STOP.
+************************************************************/
+static void recoverBus(void) {
+	GPIO_InitTypeDef gpio;
+	uint8_t i;
+
+	I2C_SoftwareResetCmd(I2C1, ENABLE);
+
+	GPIO_SetBits(I2C_GPIO, I2C_SCL_PIN | I2C_SDA_PIN);
+	gpio.GPIO_Pin = I2C_SCL_PIN | I2C_SDA_PIN;
+	gpio.GPIO_Mode = GPIO_Mode_OUT;
+	gpio.GPIO_Speed = GPIO_Speed_50MHz;
+	gpio.GPIO_OType = GPIO_OType_OD;
+	gpio.GPIO_PuPd = GPIO_PuPd_UP;
+	GPIO_Init(I2C_GPIO, &gpio);
+
+	for (i = 0; i < I2C_RECOVERY_CLOCKS; i++) {
+		if (GPIO_ReadInputDataBit(I2C_GPIO, I2C_SDA_PIN) == Bit_SET) {
+			break;
+		}
+		GPIO_ResetBits(I2C_GPIO, I2C_SCL_PIN);
+		recoveryDelay();
+		GPIO_SetBits(I2C_GPIO, I2C_SCL_PIN);
+		recoveryDelay();
+	}
+
+	// STOP: SDA low to high while SCL is high
+	GPIO_ResetBits(I2C_GPIO, I2C_SCL_PIN);
+	recoveryDelay();
+	GPIO_ResetBits(I2C_GPIO, I2C_SDA_PIN);
+	recoveryDelay();
+	GPIO_SetBits(I2C_GPIO, I2C_SCL_PIN);
+	recoveryDelay();
+	GPIO_SetBits(I2C_GPIO, I2C_SDA_PIN);
+	recoveryDelay();
+
+	configurePins();
+	I2C_SoftwareResetCmd(I2C1, DISABLE);
+	stats.recoveries++;
+}
+
+/************************************************************
+* Retire the head transaction and start the next one. Runs
+* with the I2C interrupt masked or from the I2C ISR itself.
+************************************************************/
+static void finish(i2cStatus_t status) {
+	i2cTransaction_t *current = &queue[queueHead];
+
+	phase = PHASE_IDLE;
+	I2C_ITConfig(I2C1, I2C_ALL_IT, DISABLE);
+	DMA_Cmd(I2C_RX_DMA, DISABLE);
+	if (status == I2C_STATUS_OK) {
+		stats.completed++;
+	} else {
+		stats.errors++;
+		if (status != I2C_STATUS_NACK) {
+			recoverBus();
+		}
+	}
+	queueHead = (queueHead + 1) & (I2C_QUEUE_SIZE - 1);
+	if (current->callback != 0) {
+		current->callback(status, current->context);
+	}
+	startNext();
+}
+
+static void startNext(void) {
+	i2cTransaction_t *next;
+
+	if (phase != PHASE_IDLE || queueHead == queueTail) {
+		return;
+	}
+	next = &queue[queueHead];
+	payloadIndex = 0;
+	result = I2C_STATUS_OK;
+	startTick = tickCount;
+	// Address, register and, for a read, the second address
+	timeoutTicks = I2C_TIMEOUT_TICKS + ((next->length + 3) >> I2C_TIMEOUT_BYTES_SHIFT);
+	phase = PHASE_REG;
+
+	I2C_ClearFlag(I2C1, I2C_ISR_NACKF | I2C_ISR_STOPF | I2C_ERROR_FLAGS);
+	I2C_ITConfig(I2C1, I2C_ALL_IT, ENABLE);
+	if (next->isRead) {
+		I2C_RX_DMA->CMAR = (uint32_t) next->data;
+		DMA_SetCurrDataCounter(I2C_RX_DMA, next->length);
+		DMA_Cmd(I2C_RX_DMA, ENABLE);
+		I2C_TransferHandling(I2C1, next->address << 1, 1,
+				I2C_SoftEnd_Mode, I2C_Generate_Start_Write);
+	} else {
+		I2C_TransferHandling(I2C1, next->address << 1, next->length + 1,
+				I2C_AutoEnd_Mode, I2C_Generate_Start_Write);
+	}
+}
+
+/************************************************************
+*
+* Function: i2cMasterInit
+* @brief:   configure I2C1 at 400 kHz on PB6/PB7, clear any
+*           stuck slave and enable the I2C1 interrupt
+*
+************************************************************/
+void i2cMasterInit(void) {
+	I2C_InitTypeDef init;
+	DMA_InitTypeDef dma;
+
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_GPIOB, ENABLE);
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_I2C1, ENABLE);
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+	RCC_I2CCLKConfig(RCC_I2C1CLK_HSI);
+
+	// Memory address and count are filled in per transaction
+	DMA_StructInit(&dma);
+	dma.DMA_PeripheralBaseAddr = (uint32_t) &I2C1->RXDR;
+	dma.DMA_DIR = DMA_DIR_PeripheralSRC;
+	dma.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	dma.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	dma.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+	dma.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+	dma.DMA_Mode = DMA_Mode_Normal;
+	dma.DMA_Priority = DMA_Priority_High;
+	dma.DMA_M2M = DMA_M2M_Disable;
+	DMA_Init(I2C_RX_DMA, &dma);
+
+	configurePins();
+	I2C_StructInit(&init);
+	init.I2C_Timing = I2C_TIMING_400KHZ;
+	init.I2C_AnalogFilter = I2C_AnalogFilter_Enable;
+	init.I2C_DigitalFilter = 0;
+	init.I2C_Mode = I2C_Mode_I2C;
+	init.I2C_Ack = I2C_Ack_Enable;
+	init.I2C_AcknowledgedAddress = I2C_AcknowledgedAddress_7bit;
+	I2C_Init(I2C1, &init);
+	I2C_DMACmd(I2C1, I2C_DMAReq_Rx, ENABLE);
+	I2C_Cmd(I2C1, ENABLE);
+
+	// A reset in the middle of a read can leave the slave holding SDA
+	recoverBus();
+	stats.recoveries = 0;
+
+	NVIC_SetPriority(I2C1_IRQn, 1);
+	NVIC_EnableIRQ(I2C1_IRQn);
+}
+
+/************************************************************
+*
+* Function: i2cMasterSubmit
+* @brief:   queue a copy of a transaction, it starts right away
+*           if the bus is idle
+* @param:   transaction, const i2cTransaction_t*, the request
+* @return:  int, 0 if queued, -1 if the queue is full or the
+*           transaction is malformed: empty, a read without a
+*           buffer, or a 255 byte write, whose register byte
+*           would make NBYTES 256
+*
+************************************************************/
+int i2cMasterSubmit(const i2cTransaction_t *transaction) {
+	uint32_t primask;
+	uint8_t tail;
+
+	if (transaction->length == 0 || (!transaction->isRead && transaction->length == 0xFF)
+			|| (transaction->isRead && transaction->data == 0)) {
+		return -1;
+	}
+
+	// Submitters may be the main loop, the control task or a
+	// completion callback, so mask everything, not just I2C1
+	primask = __get_PRIMASK();
+	__disable_irq();
+	tail = queueTail;
+	if (((tail + 1) & (I2C_QUEUE_SIZE - 1)) == queueHead) {
+		__set_PRIMASK(primask);
+		return -1;
+	}
+	queue[tail] = *transaction;
+	queueTail = (tail + 1) & (I2C_QUEUE_SIZE - 1);
+	startNext();
+	__set_PRIMASK(primask);
+	return 0;
+}
+
+/************************************************************
+*
+* Function: i2cMasterWriteReg
+* @brief:   queue a one byte register write
+* @return:  int, see i2cMasterSubmit
+*
+************************************************************/
+int i2cMasterWriteReg(uint8_t address, uint8_t reg, uint8_t value,
+		i2cCallback_t callback, void *context) {
+	i2cTransaction_t transaction;
+
+	transaction.address = address;
+	transaction.reg = reg;
+	transaction.isRead = 0;
+	transaction.length = 1;
+	transaction.data = 0;
+	transaction.value = value;
+	transaction.callback = callback;
+	transaction.context = context;
+	return i2cMasterSubmit(&transaction);
+}
+
+/************************************************************
+*
+* Function: i2cMasterReadRegs
+* @brief:   queue a burst read of length bytes starting at reg,
+*           data must stay valid until the callback runs
+* @return:  int, see i2cMasterSubmit
+*
+************************************************************/
+int i2cMasterReadRegs(uint8_t address, uint8_t reg, uint8_t *data, uint8_t length,
+		i2cCallback_t callback, void *context) {
+	i2cTransaction_t transaction;
+
+	transaction.address = address;
+	transaction.reg = reg;
+	transaction.isRead = 1;
+	transaction.length = length;
+	transaction.data = data;
+	transaction.value = 0;
+	transaction.callback = callback;
+	transaction.context = context;
+	return i2cMasterSubmit(&transaction);
+}
+
+/************************************************************
+*
+* Function: i2cMasterIsIdle
+* @return:  uint8_t, 1 if nothing is running or queued
+*
+************************************************************/
+uint8_t i2cMasterIsIdle(void) {
+	return phase == PHASE_IDLE && queueHead == queueTail;
+}
+
+/************************************************************
+*
+* Function: i2cMasterPoll
+* @brief:   called every tick from SysTick, aborts a transaction
+*           running longer than its timeout, I2C_TIMEOUT_TICKS
+*           plus its bus time, and recovers the bus
+*
+************************************************************/
+void i2cMasterPoll(void) {
+	if (phase == PHASE_IDLE || tickCount - startTick < timeoutTicks) {
+		return;
+	}
+	NVIC_DisableIRQ(I2C1_IRQn);
+	if (phase != PHASE_IDLE) {
+		stats.timeouts++;
+		finish(I2C_STATUS_TIMEOUT);
+	}
+	NVIC_EnableIRQ(I2C1_IRQn);
+}
+
+/************************************************************
+*
+* Function: i2cMasterIrqHandler
+* @brief:   I2C1 event and error state machine, called from
+*           I2C1_IRQHandler
+*
+************************************************************/
+void i2cMasterIrqHandler(void) {
+	i2cTransaction_t *current = &queue[queueHead];
+	uint32_t isr = I2C1->ISR;
+
+	if (phase == PHASE_IDLE) {
+		I2C_ITConfig(I2C1, I2C_ALL_IT, DISABLE);
+		return;
+	}
+
+	if (isr & I2C_ERROR_FLAGS) {
+		I2C_ClearFlag(I2C1, I2C_ERROR_FLAGS);
+		if (isr & I2C_ISR_BERR) {
+			finish(I2C_STATUS_BUS_ERROR);
+		} else if (isr & I2C_ISR_ARLO) {
+			finish(I2C_STATUS_ARB_LOST);
+		} else {
+			finish(I2C_STATUS_OVERRUN);
+		}
+		return;
+	}
+
+	if (isr & I2C_ISR_NACKF) {
+		// Hardware releases the bus with STOP in AUTOEND, SOFTEND needs one
+		I2C_ClearFlag(I2C1, I2C_ISR_NACKF);
+		result = I2C_STATUS_NACK;
+		if (!(I2C1->CR2 & I2C_CR2_AUTOEND)) {
+			I2C_GenerateSTOP(I2C1, ENABLE);
+		}
+		phase = PHASE_STOP;
+	}
+
+	if (isr & I2C_ISR_STOPF) {
+		I2C_ClearFlag(I2C1, I2C_ISR_STOPF);
+		if (current->isRead) {
+			payloadIndex = current->length - DMA_GetCurrDataCounter(I2C_RX_DMA);
+		}
+		if (result == I2C_STATUS_OK && payloadIndex != current->length) {
+			result = I2C_STATUS_BUS_ERROR;
+		}
+		finish(result);
+		return;
+	}
+
+	if (phase == PHASE_STOP) {
+		return;
+	}
+
+	if (isr & I2C_ISR_TXIS) {
+		if (phase == PHASE_REG) {
+			I2C_SendData(I2C1, current->reg);
+			phase = PHASE_PAYLOAD;
+		} else {
+			I2C_SendData(I2C1, current->data != 0
+					? current->data[payloadIndex] : current->value);
+			payloadIndex++;
+		}
+	}
+
+	if (isr & I2C_ISR_TC) {
+		// Only a read stops at TC: register sent, turn the bus around
+		I2C_TransferHandling(I2C1, current->address << 1, current->length,
+				I2C_AutoEnd_Mode, I2C_Generate_Start_Read);
+	}
+}
+
+/************************************************************
+*
+* Function: i2cMasterGetStats
+* @return:  const i2cStats_t*, running transfer counters
+*
+************************************************************/
+const i2cStats_t *i2cMasterGetStats(void) {
+	return &stats;
+}
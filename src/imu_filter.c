@@ -0,0 +1,104 @@
+/************************************************************
+*
+* @file:      imu_filter.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Per axis biquad cascade for IMU vibration
+*             rejection on CMSIS arm_biquad_cascade_df1_fast_q15
+*
+*             Samples arrive interleaved (one imuSample_t per FIFO
+*             record, a read returns every record waiting), while
+*             the CMSIS kernel wants one contiguous block per
+*             channel. imuFilterProcess takes the read's whole
+*             batch, gathers each enabled axis into a block,
+*             filters it with a single kernel call and scatters it
+*             back, so call and setup overhead is paid once per
+*             axis per batch rather than per sample. The headroom
+*             shift the fast kernel needs is folded into the
+*             gather/scatter copies.
+*
+************************************************************/
+
+#include "imu_filter.h"
+
+// tools/design_biquad.py --fs 1000 lowpass:40
+const imuFilterPreset_t IMU_FILTER_LOWPASS_40HZ = {
+	1, { 219, 0, 438, 219, 26992, -11483 }
+};
+
+// tools/design_biquad.py --fs 1000 lowpass:20
+const imuFilterPreset_t IMU_FILTER_LOWPASS_20HZ = {
+	1, { 59, 0, 119, 59, 29863, -13716 }
+};
+
+// tools/design_biquad.py --fs 1000 lowpass:40 notch:100:4
+const imuFilterPreset_t IMU_FILTER_LOWPASS_40HZ_NOTCH_100HZ = {
+	2, {
+		219, 0, 438, 219, 26992, -11483,
+		15263, 0, -24695, 15263, 24695, -14141,
+	}
+};
+
+// tools/design_biquad.py --fs 1000 notch:100:4
+const imuFilterPreset_t IMU_FILTER_NOTCH_100HZ = {
+	1, { 15263, 0, -24695, 15263, 24695, -14141 }
+};
+
+/************************************************************
+*
+* Function: imuFilterInit
+* @brief:   all axes start in bypass
+*
+************************************************************/
+void imuFilterInit(imuFilter_t *filter) {
+	filter->enabled = 0;
+}
+
+/************************************************************
+*
+* Function: imuFilterConfigure
+* @brief:   attach a preset to one axis and clear its history
+* @param:   preset, const imuFilterPreset_t*, NULL for bypass
+*
+************************************************************/
+void imuFilterConfigure(imuFilter_t *filter, imuAxis_t axis, const imuFilterPreset_t *preset) {
+	if (preset == 0) {
+		filter->enabled &= ~(1 << axis);
+		return;
+	}
+	// The kernel only reads the coefficients, the cast drops const for the old API
+	arm_biquad_cascade_df1_init_q15(&filter->instance[axis], preset->numStages,
+			(q15_t *) preset->coeffs, filter->state[axis], IMU_FILTER_POST_SHIFT);
+	filter->enabled |= 1 << axis;
+}
+
+/************************************************************
+*
+* Function: imuFilterProcess
+* @brief:   filter a batch of samples in place
+* @param:   samples, imuSample_t*, the batch
+* @param:   count, uint16_t, at most IMU_FILTER_MAX_BATCH
+*
+************************************************************/
+void imuFilterProcess(imuFilter_t *filter, imuSample_t *samples, uint16_t count) {
+	q15_t block[IMU_FILTER_MAX_BATCH];
+	uint16_t i;
+	uint8_t axis;
+
+	if (count > IMU_FILTER_MAX_BATCH) {
+		count = IMU_FILTER_MAX_BATCH;
+	}
+	for (axis = 0; axis < IMU_AXIS_COUNT; axis++) {
+		if (!(filter->enabled & (1 << axis))) {
+			continue;
+		}
+		for (i = 0; i < count; i++) {
+			block[i] = samples[i].axis[axis] >> IMU_FILTER_HEADROOM;
+		}
+		arm_biquad_cascade_df1_fast_q15(&filter->instance[axis], block, block, count);
+		for (i = 0; i < count; i++) {
+			samples[i].axis[axis] = saturateQ15((int32_t) block[i] * (1 << IMU_FILTER_HEADROOM));
+		}
+	}
+}
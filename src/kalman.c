@@ -0,0 +1,45 @@
+/************************************************************
+*
+* @file:      kalman.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Two state (tilt angle, gyro bias) steady state
+*             Kalman filter in Q31
+*
+*             The covariance converges to a fixed point for a time
+*             invariant model, so the gain is solved offline and
+*             the update is just predict, innovation and two
+*             multiply-adds; no matrix routines are needed.
+*
+************************************************************/
+
+#include "kalman.h"
+
+const kalmanGains_t KALMAN_GAINS_SMOOTH = { 3963246, -3392 };
+const kalmanGains_t KALMAN_GAINS_DEFAULT = { 11730099, -21416 };
+const kalmanGains_t KALMAN_GAINS_FAST = { 36225910, -95225 };
+
+/************************************************************
+*
+* Function: kalmanInit
+* @brief:   reset the state, bias starts at zero
+* @param:   initialAngle, int32_t, Q31 start angle, usually the
+*           first accel tilt
+*
+************************************************************/
+void kalmanInit(kalman_t *filter, const kalmanGains_t *gains, int32_t initialAngle) {
+	filter->angle = initialAngle;
+	filter->bias = 0;
+	filter->gains = *gains;
+}
+
+/************************************************************
+*
+* Function: kalmanSetGains
+* @brief:   switch gain set without touching the state
+*
+************************************************************/
+void kalmanSetGains(kalman_t *filter, const kalmanGains_t *gains) {
+	filter->gains = *gains;
+}
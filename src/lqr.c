@@ -0,0 +1,21 @@
+/************************************************************
+*
+* @file:      lqr.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Q15 full state feedback u = -K x for (tilt, tilt
+*             rate, wheel position, wheel velocity)
+*
+*             For a 1x4 by 4x1 product arm_mat_mult_q15 spends
+*             more on its loop and instance setup than on the
+*             four multiplies, so lqrUpdate is unrolled inline.
+*             host/lqr_bench.c puts it at ~130 cycles against ~38,
+*             and its Q15 result loses the LQR_GAIN_SHIFT low
+*             bits lqrUpdate keeps, up to 16 LSB of output.
+*
+************************************************************/
+
+#include "lqr.h"
+
+const lqrGains_t LQR_GAINS_DEFAULT = { { -23656, -7200, -6553, -1952 } };
@@ -9,12 +9,748 @@
 */
 
 
+#include <string.h>
 #include "stm32f0xx.h"
 #include "stm32f0_discovery.h"
-			
+#include "timebase.h"
+#include "watchdog.h"
+#include "i2c_master.h"
+#include "mpu9250.h"
+#include "sensor.h"
+#include "stepper.h"
+#include "balance.h"
+#include "debug_uart.h"
+#include "gain_schedule.h"
+#include "spectrum.h"
+#include "sysid.h"
+#include "autotune.h"
+#include "flash_store.h"
+#include "shell.h"
+#include "telemetry.h"
 
+// Max ticks the main loop may take between two check ins
+#define MAIN_LOOP_DEADLINE      20
+// Max ticks between two control ticks
+#define CONTROL_DEADLINE        5
+
+// Persisted settings record in halfwords: SETTINGS_HAS_ bits, then
+// the auto-tune result, the IMU and the compass calibration
+#define SETTINGS_VALID          0
+#define SETTINGS_TUNE           1
+#define SETTINGS_IMU            (SETTINGS_TUNE + 6)
+#define SETTINGS_MAG            (SETTINGS_IMU + 3 * IMU_AXIS_COUNT)
+#define SETTINGS_SIZE           (SETTINGS_MAG + 6)
+#define SETTINGS_HAS_TUNE       0x01
+#define SETTINGS_HAS_IMU        0x02
+#define SETTINGS_HAS_MAG        0x04
+
+// Perfect hash of the console tables, from tools/shell_hash.py
+#define COMMAND_HASH_BITS       5
+#define COMMAND_HASH_SEED       0x00000024
+#define PARAM_HASH_BITS         4
+#define PARAM_HASH_SEED         0x0000018A
+
+static uint8_t controlTask;
+static uint8_t mainLoopTask;
+static autotuneResult_t tuneResult;
+static imuCalibration_t imuResult;
+static magCalibration_t magResult;
+static uint8_t settingsValid = 0;       // SETTINGS_HAS_ bits installed
+static calibration_t calibration;
+static magCalCollector_t magCollector;
+static uint32_t calibrationSequence;    // of the last raw sample taken
+static uint8_t calibrating = 0;         // a pose is being collected
+static uint8_t calibrationOpen = 0;     // begun and not done yet
+static uint8_t magCalibrating = 0;      // compass extremes being collected
+
+// Names for get and set, slots from tools/shell_hash.py --bits 4
+static const shellEntry_t paramSlots[1 << PARAM_HASH_BITS] = {
+	[0] = { "lqr_pos", 0, BALANCE_PARAM_LQR_POSITION },
+	[1] = { "kf_angle", 0, BALANCE_PARAM_KALMAN_ANGLE },
+	[2] = { "ahrs_beta", 0, BALANCE_PARAM_AHRS_BETA },
+	[3] = { "kf_bias", 0, BALANCE_PARAM_KALMAN_BIAS },
+	[4] = { "lqr_tilt", 0, BALANCE_PARAM_LQR_TILT },
+	[6] = { "max_tilt", 0, BALANCE_PARAM_MAX_TILT },
+	[7] = { "speed_ki", 0, BALANCE_PARAM_SPEED_KI },
+	[8] = { "speed_kp", 0, BALANCE_PARAM_SPEED_KP },
+	[10] = { "pos_kp", 0, BALANCE_PARAM_POSITION_KP },
+	[13] = { "lqr_vel", 0, BALANCE_PARAM_LQR_VELOCITY },
+	[14] = { "lqr_rate", 0, BALANCE_PARAM_LQR_RATE },
+	[15] = { "max_speed", 0, BALANCE_PARAM_MAX_SPEED },
+};
+
+static const shellTable_t paramTable = { paramSlots, PARAM_HASH_SEED, PARAM_HASH_BITS };
+
+static void packTuneResult(const autotuneResult_t *result, uint16_t *record) {
+	record[0] = (uint16_t) result->ultimateGain;
+	record[1] = (uint16_t) ((uint32_t) result->ultimateGain >> 16);
+	record[2] = result->period;
+	record[3] = (uint16_t) result->gains.kp;
+	record[4] = (uint16_t) result->gains.ki;
+	record[5] = (uint16_t) result->gains.kd;
+}
+
+static void unpackTuneResult(const uint16_t *record, autotuneResult_t *result) {
+	result->ultimateGain = (int32_t) ((uint32_t) record[0] | ((uint32_t) record[1] << 16));
+	result->period = record[2];
+	result->gains.kp = (int16_t) record[3];
+	result->gains.ki = (int16_t) record[4];
+	result->gains.kd = (int16_t) record[5];
+}
+
+static void packImuCalibration(const imuCalibration_t *cal, uint16_t *record) {
+	uint8_t i;
+
+	for (i = 0; i < IMU_AXIS_COUNT; i++) {
+		record[i * 2] = (uint16_t) cal->offset[i];
+		record[i * 2 + 1] = (uint16_t) ((uint32_t) cal->offset[i] >> 16);
+		record[IMU_AXIS_COUNT * 2 + i] = (uint16_t) cal->scale[i];
+	}
+}
+
+static void unpackImuCalibration(const uint16_t *record, imuCalibration_t *cal) {
+	uint8_t i;
+
+	for (i = 0; i < IMU_AXIS_COUNT; i++) {
+		cal->offset[i] = (int32_t) ((uint32_t) record[i * 2] | ((uint32_t) record[i * 2 + 1] << 16));
+		cal->scale[i] = (int16_t) record[IMU_AXIS_COUNT * 2 + i];
+	}
+}
+
+static void packMagCalibration(const magCalibration_t *cal, uint16_t *record) {
+	uint8_t i;
+
+	for (i = 0; i < 3; i++) {
+		record[i] = (uint16_t) cal->offset[i];
+		record[3 + i] = (uint16_t) cal->scale[i];
+	}
+}
+
+static void unpackMagCalibration(const uint16_t *record, magCalibration_t *cal) {
+	uint8_t i;
+
+	for (i = 0; i < 3; i++) {
+		cal->offset[i] = (int16_t) record[i];
+		cal->scale[i] = (int16_t) record[3 + i];
+	}
+}
+
+/************************************************************
+*
+* Function: applyTuneResult
+* @brief:   load auto-tuned gains into the whole schedule
+*
+************************************************************/
+static void applyTuneResult(const autotuneResult_t *result) {
+	__disable_irq();
+	gainScheduleFill(&result->gains);
+	__enable_irq();
+	tuneResult = *result;
+	settingsValid |= SETTINGS_HAS_TUNE;
+}
+
+/************************************************************
+*
+* Function: applyImuCalibration
+* @brief:   install IMU coefficients and keep them for saving
+*
+************************************************************/
+static void applyImuCalibration(const imuCalibration_t *result) {
+	balanceSetCalibration(result);
+	imuResult = *result;
+	settingsValid |= SETTINGS_HAS_IMU;
+}
+
+/************************************************************
+*
+* Function: applyMagCalibration
+* @brief:   install compass coefficients and keep them for saving
+*
+************************************************************/
+static void applyMagCalibration(const magCalibration_t *result) {
+	balanceSetMagCalibration(result);
+	magResult = *result;
+	settingsValid |= SETTINGS_HAS_MAG;
+}
+
+/************************************************************
+*
+* Function: saveSettings
+* @brief:   persist everything installed so far as one record
+* @return:  int, 0 once written, -1 while balancing or during
+*           a calibration run
+*
+************************************************************/
+static int saveSettings(void) {
+	uint16_t record[SETTINGS_SIZE];
+	int status;
+
+	// Erasing stalls the CPU, never while balancing, and the motors
+	// stay off until it is done
+	if (calibrationOpen || magCalibrating || balanceInhibitMotors(1) != 0) {
+		return -1;
+	}
+	record[SETTINGS_VALID] = settingsValid;
+	packTuneResult(&tuneResult, &record[SETTINGS_TUNE]);
+	packImuCalibration(&imuResult, &record[SETTINGS_IMU]);
+	packMagCalibration(&magResult, &record[SETTINGS_MAG]);
+	status = flashStoreSave(record, SETTINGS_SIZE);
+	balanceInhibitMotors(0);
+	return status;
+}
+
+/************************************************************
+*
+* Function: loadSettings
+* @brief:   install each valid part of the stored record
+*
+************************************************************/
+static void loadSettings(void) {
+	uint16_t record[SETTINGS_SIZE];
+	autotuneResult_t tune;
+	imuCalibration_t imu;
+	magCalibration_t mag;
+
+	if (flashStoreLoad(record, SETTINGS_SIZE) != 0) {
+		return;
+	}
+	if (record[SETTINGS_VALID] & SETTINGS_HAS_TUNE) {
+		unpackTuneResult(&record[SETTINGS_TUNE], &tune);
+		applyTuneResult(&tune);
+	}
+	if (record[SETTINGS_VALID] & SETTINGS_HAS_IMU) {
+		unpackImuCalibration(&record[SETTINGS_IMU], &imu);
+		applyImuCalibration(&imu);
+	}
+	if (record[SETTINGS_VALID] & SETTINGS_HAS_MAG) {
+		unpackMagCalibration(&record[SETTINGS_MAG], &mag);
+		applyMagCalibration(&mag);
+	}
+}
+
+/************************************************************
+*
+* Function: reportAutotune
+* @brief:   background check for a finished auto-tune, the
+*           gains are applied but only saved on "tune save"
+*
+************************************************************/
+static void reportAutotune(void) {
+	autotuneResult_t result;
+	autotuneStatus_t status = balanceTakeAutotune(&result);
+
+	if (status == AUTOTUNE_FAILED) {
+		debugUartWrite("tune failed\r\n");
+	} else if (status == AUTOTUNE_DONE) {
+		applyTuneResult(&result);
+		debugUartWrite("tune ku ");
+		debugUartWriteInt(result.ultimateGain);
+		debugUartWrite(" tu ");
+		debugUartWriteInt(result.period);
+		debugUartWrite(" gains ");
+		debugUartWriteInt(result.gains.kp);
+		debugUartWrite(" ");
+		debugUartWriteInt(result.gains.ki);
+		debugUartWrite(" ");
+		debugUartWriteInt(result.gains.kd);
+		debugUartWrite("\r\n");
+	}
+}
+
+/************************************************************
+*
+* Function: reportProbe
+* @brief:   print "<name> <max> <mean>" in core cycles from a
+*           snapshot of the probe
+*
+************************************************************/
+static void reportProbe(const char *name, const profileProbe_t *probe) {
+	profileProbe_t copy;
+
+	profileSnapshot(probe, &copy);
+	debugUartWrite(name);
+	debugUartWrite(" ");
+	debugUartWriteInt((int32_t) copy.max);
+	debugUartWrite(" ");
+	debugUartWriteInt((int32_t) profileAverage(&copy));
+	debugUartWrite("\r\n");
+}
+
+/************************************************************
+*
+* Function: writeCentidegrees
+* @brief:   print " <angle>" of a Q31 fraction of pi in 0.01 deg,
+*           32 bit products only
+*
+************************************************************/
+static void writeCentidegrees(int32_t angle) {
+	debugUartWrite(" ");
+	debugUartWriteInt(((angle >> 16) * 18000) >> 15);
+}
+
+/************************************************************
+*
+* Function: pollCalibration
+* @brief:   feed each new raw sample to the pose in progress and
+*           report "cal <calStatus_t> <pose mask>" when it closes;
+*           the statistics run here, never in the control task
+*
+************************************************************/
+static void pollCalibration(void) {
+	imuSample_t raw;
+	uint32_t sequence;
+	calStatus_t status;
+
+	if (!calibrating) {
+		return;
+	}
+	sequence = balanceGetRawSample(&raw);
+	if (sequence == calibrationSequence) {
+		return;
+	}
+	calibrationSequence = sequence;
+	status = calibrationAddSample(&calibration, &raw);
+	if (status != CAL_RUNNING) {
+		calibrating = 0;
+		balanceCaptureRaw(0);
+		debugUartWrite("cal ");
+		debugUartWriteInt(status);
+		debugUartWrite(" ");
+		debugUartWriteInt(calibration.poseMask);
+		debugUartWrite("\r\n");
+	}
+}
+
+/************************************************************
+*
+* Function: pollMagCalibration
+* @brief:   feed each new raw compass reading to the collector
+*
+************************************************************/
+static void pollMagCalibration(void) {
+	imuSample_t raw;
+	uint32_t sequence;
+
+	if (!magCalibrating) {
+		return;
+	}
+	sequence = balanceGetRawSample(&raw);
+	if (sequence == calibrationSequence) {
+		return;
+	}
+	calibrationSequence = sequence;
+	magCalAddSample(&magCollector, &raw);
+}
+
+/************************************************************
+*
+* Function: startPose
+* @brief:   begin collecting one calibration pose from the next
+*           sample on
+*
+************************************************************/
+static void startPose(void) {
+	imuSample_t raw;
+
+	calibrationStartPose(&calibration);
+	calibrationSequence = balanceGetRawSample(&raw);
+	calibrating = 1;
+	balanceCaptureRaw(1);
+}
+
+static int commandGain(const shellArgs_t *args) {
+	pidGains_t gains;
+	int status;
+
+	if (!shellNumbers(args, 5)) {
+		return SHELL_ERROR;
+	}
+	gains.kp = (int16_t) args->value[2];
+	gains.ki = (int16_t) args->value[3];
+	gains.kd = (int16_t) args->value[4];
+	// The control task reads the table from PendSV
+	__disable_irq();
+	status = gainScheduleSet((uint8_t) args->value[0], (uint8_t) args->value[1], &gains);
+	__enable_irq();
+	return status == 0 ? SHELL_OK : SHELL_ERROR;
+}
+
+static int commandController(const shellArgs_t *args) {
+	if (!shellNumbers(args, 1)) {
+		return SHELL_ERROR;
+	}
+	balanceSetController(args->value[0] ? BALANCE_CONTROLLER_PID : BALANCE_CONTROLLER_LQR);
+	return SHELL_OK;
+}
+
+static int commandSpectrum(const shellArgs_t *args) {
+	if (!shellNumbers(args, 2)
+			|| spectrumStart((imuAxis_t) args->value[0], (uint8_t) args->value[1]) != 0) {
+		return SHELL_ERROR;
+	}
+	return SHELL_OK;
+}
+
+static int commandSysid(const shellArgs_t *args) {
+	const int32_t *value = args->value;
+
+	if (shellNumbers(args, 1) && value[0] == 0) {
+		sysidStop();
+		return SHELL_OK;
+	}
+	if (shellNumbers(args, 3) && value[0] > 0 && value[0] <= 32767 && value[1] > 0
+			&& value[1] <= 255 && sysidStart((int16_t) value[0], (uint8_t) value[1],
+					value[2] != 0) == 0) {
+		return SHELL_OK;
+	}
+	return SHELL_ERROR;
+}
+
+static int commandTune(const shellArgs_t *args) {
+	const int32_t *value = args->value;
+
+	if (args->count == 1 && shellIsWord(args, 0, "save")) {
+		if ((settingsValid & SETTINGS_HAS_TUNE) && saveSettings() == 0) {
+			return SHELL_OK;
+		}
+	} else if (shellNumbers(args, 3) && value[0] > 0 && value[0] <= 32767 && value[1] >= 0
+			&& value[1] <= 32767 && value[2] >= 0 && value[2] <= 32767
+			&& balanceStartAutotune((int16_t) value[0], (int16_t) value[1],
+					(int16_t) value[2]) == 0) {
+		return SHELL_OK;
+	}
+	return SHELL_ERROR;
+}
+
+static int commandSpeed(const shellArgs_t *args) {
+	if (!shellNumbers(args, 1) || args->value[0] < -32767 || args->value[0] > 32767
+			|| balanceSetSpeed((int16_t) args->value[0]) != 0) {
+		return SHELL_ERROR;
+	}
+	return SHELL_OK;
+}
+
+static int commandMove(const shellArgs_t *args) {
+	if (!shellNumbers(args, 1) || balanceMove(args->value[0]) != 0) {
+		return SHELL_ERROR;
+	}
+	return SHELL_OK;
+}
+
+static int commandHold(const shellArgs_t *args) {
+	if (args->count != 0) {
+		return SHELL_ERROR;
+	}
+	balanceHold();
+	return SHELL_OK;
+}
+
+static int commandProfile(const shellArgs_t *args) {
+	if (args->count != 0) {
+		return SHELL_ERROR;
+	}
+	reportProbe("inner", &balanceInnerProfile);
+	reportProbe("outer", &balanceOuterProfile);
+	reportProbe("ahrs", &balanceAhrsProfile);
+	reportProbe("tick", &balanceProfile);
+	reportProbe("spectrum", &spectrumProfile);
+	return SHELL_REPLIED;
+}
+
+static int commandAttitude(const shellArgs_t *args) {
+	int32_t angles[AHRS_ANGLE_COUNT];
+	uint8_t i;
+
+	if (args->count != 0) {
+		return SHELL_ERROR;
+	}
+	balanceGetAttitude(angles);
+	debugUartWrite("att");
+	for (i = 0; i < AHRS_ANGLE_COUNT; i++) {
+		writeCentidegrees(angles[i]);
+	}
+	debugUartWrite("\r\n");
+	return SHELL_REPLIED;
+}
+
+static int commandGet(const shellArgs_t *args) {
+	const shellEntry_t *param;
+	int32_t value;
+
+	if (args->count != 1) {
+		return SHELL_ERROR;
+	}
+	param = shellLookup(&paramTable, args->text[0], args->length[0]);
+	if (param == 0 || balanceGetParam((balanceParam_t) param->id, &value) != 0) {
+		return SHELL_ERROR;
+	}
+	debugUartWrite(param->name);
+	debugUartWrite(" ");
+	debugUartWriteInt(value);
+	debugUartWrite("\r\n");
+	return SHELL_REPLIED;
+}
+
+static int commandSet(const shellArgs_t *args) {
+	const shellEntry_t *param;
+
+	if (args->count != 2 || !(args->numbers & 2)) {
+		return SHELL_ERROR;
+	}
+	param = shellLookup(&paramTable, args->text[0], args->length[0]);
+	if (param == 0 || balanceSetParam((balanceParam_t) param->id, args->value[1]) != 0) {
+		return SHELL_ERROR;
+	}
+	return SHELL_OK;
+}
+
+static int commandTelemetry(const shellArgs_t *args) {
+	if (args->count == 0) {
+		debugUartWrite("tel ");
+		debugUartWriteInt(telemetryDropped());
+		debugUartWrite("\r\n");
+		return SHELL_REPLIED;
+	}
+	if (!shellNumbers(args, 1)) {
+		return SHELL_ERROR;
+	}
+	if (args->value[0] == 0) {
+		telemetryStop();
+		return SHELL_OK;
+	}
+	if (args->value[0] < 0 || args->value[0] > UINT16_MAX
+			|| telemetryStart((uint16_t) args->value[0]) != 0) {
+		return SHELL_ERROR;
+	}
+	return SHELL_OK;
+}
+
+static int commandCalibrate(const shellArgs_t *args) {
+	imuCalibration_t result;
+	calStatus_t status;
+
+	if (args->count != 1) {
+		return SHELL_ERROR;
+	}
+	if (shellIsWord(args, 0, "done")) {
+		if (!calibrationOpen) {
+			return SHELL_ERROR;
+		}
+		calibrating = 0;
+		calibrationOpen = 0;
+		balanceCaptureRaw(0);
+		balanceInhibitMotors(0);
+		status = calibrationFinish(&calibration, &result);
+		// Gyro bias alone is worth keeping, accel stays identity then
+		if (status == CAL_DONE || status == CAL_INCOMPLETE) {
+			applyImuCalibration(&result);
+		}
+		debugUartWrite("cal ");
+		debugUartWriteInt(status);
+		debugUartWrite("\r\n");
+		return SHELL_REPLIED;
+	}
+	if (calibrating || magCalibrating) {
+		return SHELL_ERROR;
+	}
+	if (shellIsWord(args, 0, "save")) {
+		return saveSettings() == 0 ? SHELL_OK : SHELL_ERROR;
+	}
+	if (shellIsWord(args, 0, "next") && calibrationOpen) {
+		startPose();
+		return SHELL_OK;
+	}
+	// Poses need the robot still and placed by hand, motors off
+	// from here to "cal done"
+	if (shellNumbers(args, 1) && args->value[0] > CAL_WARMUP_SAMPLES
+			&& balanceInhibitMotors(1) == 0) {
+		calibrationBegin(&calibration, (uint32_t) args->value[0]);
+		calibrationOpen = 1;
+		startPose();
+		return SHELL_OK;
+	}
+	return SHELL_ERROR;
+}
+
+static int commandMagCalibrate(const shellArgs_t *args) {
+	magCalibration_t result;
+	imuSample_t raw;
+	calStatus_t status;
+
+	if (args->count == 1 && shellIsWord(args, 0, "done") && magCalibrating) {
+		magCalibrating = 0;
+		balanceCaptureRaw(0);
+		balanceInhibitMotors(0);
+		status = magCalFinish(&magCollector, mpu9250MagAdjustment(), &result);
+		if (status == CAL_DONE) {
+			applyMagCalibration(&result);
+		}
+		debugUartWrite("mag ");
+		debugUartWriteInt(status);
+		debugUartWrite(" ");
+		debugUartWriteInt((int32_t) magCollector.count);
+		debugUartWrite("\r\n");
+		return SHELL_REPLIED;
+	}
+	// Turned by hand through every heading, motors off to "mag done"
+	if (args->count != 0 || calibrationOpen || magCalibrating || balanceInhibitMotors(1) != 0) {
+		return SHELL_ERROR;
+	}
+	magCalBegin(&magCollector);
+	calibrationSequence = balanceGetRawSample(&raw);
+	magCalibrating = 1;
+	balanceCaptureRaw(1);
+	return SHELL_OK;
+}
+
+static int commandHelp(const shellArgs_t *args);
+
+/************************************************************
+* Console commands, one per line:
+*   gain <tiltIndex> <speedIndex> <kp> <ki> <kd>
+*   ctrl <0 = LQR, 1 = PID>
+*   spec <imuAxis_t> <log2 windows>, binary frame follows
+*   sysid <amplitude> <ticks per bit> <1 = open loop>, frames
+*         follow until "sysid 0" or the robot falls
+*   tune <relay> <hysteresis> <lead>, relay auto-tune while
+*         balancing, lead is the Q11 kd / kp of the relay input;
+*         on host/plant.c relay 3000..16000 with hysteresis at
+*         most relay / 6 and lead 400..900 converge, e.g.
+*         "tune 6000 300 400"; below relay 3000 or lead 300 it
+*         mostly prints "tune failed"
+*   tune save, persist the last result with the calibration,
+*         motors must be off
+*   speed <steps/s>, move <steps>, hold: outer motion loop
+*   prof, worst and mean cycles of the timed sections
+*   att, AHRS roll, pitch and yaw in 0.01 deg; yaw is a free
+*         running gyro heading until a compass calibration is in
+*   get <param>, set <param> <value>: gains named in paramSlots
+*   tel <channel mask>, bit per telemetryChannel_t, frames every
+*         TELEMETRY_FRAME_RECORDS ticks until "tel 0"; "tel"
+*         alone reports the records dropped; TELEMETRY_REPLAY_MASK
+*         records what host/replay.c reruns
+*   cal <samples per pose>, cal next, cal done: IMU calibration,
+*         motors off; each pose reports "cal <calStatus_t> <mask>",
+*         done installs the result and reports its status;
+*         cal save persists it with the compass and tune results
+*   mag, mag done: compass calibration, motors off; turn the
+*         robot through every heading and tilt in between, done
+*         installs the result and reports "mag <calStatus_t>
+*         <samples>"
+*   help, list the commands
+*
+* Slots from tools/shell_hash.py --bits 5 with every command name
+************************************************************/
+static const shellEntry_t commandSlots[1 << COMMAND_HASH_BITS] = {
+	[0] = { "gain", commandGain, 0 },
+	[2] = { "tune", commandTune, 0 },
+	[3] = { "spec", commandSpectrum, 0 },
+	[4] = { "help", commandHelp, 0 },
+	[8] = { "hold", commandHold, 0 },
+	[10] = { "prof", commandProfile, 0 },
+	[14] = { "set", commandSet, 0 },
+	[15] = { "tel", commandTelemetry, 0 },
+	[18] = { "ctrl", commandController, 0 },
+	[19] = { "cal", commandCalibrate, 0 },
+	[20] = { "mag", commandMagCalibrate, 0 },
+	[23] = { "move", commandMove, 0 },
+	[25] = { "speed", commandSpeed, 0 },
+	[26] = { "att", commandAttitude, 0 },
+	[27] = { "sysid", commandSysid, 0 },
+	[30] = { "get", commandGet, 0 },
+};
+
+static const shellTable_t commandTable = { commandSlots, COMMAND_HASH_SEED, COMMAND_HASH_BITS };
+
+static int commandHelp(const shellArgs_t *args) {
+	uint8_t i;
+
+	if (args->count != 0) {
+		return SHELL_ERROR;
+	}
+	for (i = 0; i < (1 << COMMAND_HASH_BITS); i++) {
+		if (commandSlots[i].name != 0) {
+			debugUartWrite(commandSlots[i].name);
+			debugUartWrite(" ");
+		}
+	}
+	debugUartWrite("\r\n");
+	return SHELL_REPLIED;
+}
+
+/************************************************************
+*
+* Function: controlTick
+* @brief:   control task, run from PendSV once per system tick
+*
+************************************************************/
+void controlTick(void) {
+	balanceStep();
+	watchdogCheckIn(controlTask);
+}
+
+/************************************************************
+*
+* Function: firmwareInit
+* @brief:   bring up the peripherals and the estimator, load the
+*           stored settings and start the control tick
+*
+************************************************************/
+void firmwareInit(void) {
+	timebaseInit();
+	watchdogInit();
+	debugUartInit();
+	i2cMasterInit();
+	sensorInit();
+	stepperInit();
+	balanceInit();
+	spectrumInit();
+	calibrationIdentity(&imuResult);
+	magCalIdentity(&magResult);
+	loadSettings();
+	mainLoopTask = watchdogRegister(MAIN_LOOP_DEADLINE);
+	controlTask = watchdogRegister(CONTROL_DEADLINE);
+#if TELEMETRY_BOOT_MASK != 0
+	// From the very first tick, so host/replay.c starts from the
+	// same estimator state as the firmware
+	telemetryStart(TELEMETRY_BOOT_MASK);
+#endif
+	timebaseStartControl();
+}
+
+/************************************************************
+*
+* Function: firmwarePoll
+* @brief:   one pass of the background loop
+*
+************************************************************/
+void firmwarePoll(void) {
+	const char *line;
+
+	mpu9250MagInitPoll();
+	spectrumPoll();
+	sysidPoll();
+	reportAutotune();
+	pollCalibration();
+	pollMagCalibration();
+	telemetryPoll();
+	line = debugUartGetLine();
+	if (line != 0) {
+		shellExecute(&commandTable, line);
+		debugUartReleaseLine();
+	}
+	watchdogCheckIn(mainLoopTask);
+}
+
+// The Linux build in host/ supplies its own main and calls the two
+// above between virtual ticks
+#ifndef FIRMWARE_HOST
 int main(void)
 {
-
-	for(;;);
+	firmwareInit();
+	// Background only, the control task preempts it from PendSV
+	for(;;) {
+		firmwarePoll();
+	}
 }
+#endif
@@ -0,0 +1,132 @@
+/************************************************************
+*
+* @file:      motion.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Outer speed/distance loop producing the tilt
+*             setpoint of the balance loop at a lower rate
+*
+*             Cascade: position error -> speed reference (P,
+*             limited to maxSpeed) -> tilt setpoint (PI on speed,
+*             limited to maxTilt). Holding a forward tilt makes the
+*             inner loop accelerate forward, so a positive tilt
+*             setpoint speeds the robot up. Odometry is the
+*             commanded step count, so no encoder is needed;
+*             speed is its difference over one outer period. The
+*             inner loop runs MOTION_DIVIDER times between outer
+*             updates and sees the setpoint as a constant.
+*
+************************************************************/
+
+#include "motion.h"
+
+const motionGains_t MOTION_GAINS_DEFAULT = { 93, 1, 512, 4000, 5 * 182 };
+
+static int16_t limit(int32_t value, int32_t bound) {
+	if (value > bound) {
+		return (int16_t) bound;
+	}
+	if (value < -bound) {
+		return (int16_t) -bound;
+	}
+	return (int16_t) value;
+}
+
+/************************************************************
+*
+* Function: motionInit
+* @brief:   reset to hold with the given gains
+*
+************************************************************/
+void motionInit(motion_t *motion, const motionGains_t *gains) {
+	motion->gains = *gains;
+	motion->speed = 0;
+	motion->lastPosition = 0;
+	motionHold(motion);
+}
+
+/************************************************************
+*
+* Function: motionHold
+* @brief:   turn the outer loop off, the inner loop balances
+*           around a zero tilt setpoint
+*
+************************************************************/
+void motionHold(motion_t *motion) {
+	motion->mode = MOTION_HOLD;
+	motion->integral = 0;
+	motion->tiltSetpoint = 0;
+}
+
+/************************************************************
+*
+* Function: motionSetSpeed
+* @param:   position, int32_t, current wheel position, steps
+* @param:   speed, int16_t, steps/s, positive forward
+*
+************************************************************/
+void motionSetSpeed(motion_t *motion, int32_t position, int16_t speed) {
+	if (motion->mode == MOTION_HOLD) {
+		motion->lastPosition = position;
+		motion->speed = 0;
+	}
+	motion->targetSpeed = speed;
+	motion->mode = MOTION_SPEED;
+}
+
+/************************************************************
+*
+* Function: motionSetDistance
+* @param:   position, int32_t, current wheel position, steps
+* @param:   distance, int32_t, steps to travel from there
+*
+************************************************************/
+void motionSetDistance(motion_t *motion, int32_t position, int32_t distance) {
+	if (motion->mode == MOTION_HOLD) {
+		motion->lastPosition = position;
+		motion->speed = 0;
+	}
+	motion->targetPosition = position + distance;
+	motion->mode = MOTION_DISTANCE;
+}
+
+/************************************************************
+*
+* Function: motionUpdate
+* @brief:   one outer tick, call every MOTION_DIVIDER inner ticks
+* @param:   position, int32_t, commanded wheel position, steps
+* @return:  int16_t, Q15 tilt setpoint for the inner loop
+*
+************************************************************/
+int16_t motionUpdate(motion_t *motion, int32_t position) {
+	int32_t reference;
+	int32_t error;
+	int32_t bound;
+
+	motion->speed = limit((position - motion->lastPosition) * MOTION_RATE_HZ, INT16_MAX);
+	motion->lastPosition = position;
+	if (motion->mode == MOTION_HOLD) {
+		return 0;
+	}
+
+	if (motion->mode == MOTION_DISTANCE) {
+		reference = limit(((int32_t) motion->gains.positionKp
+				* limit(motion->targetPosition - position, INT16_MAX)) >> MOTION_GAIN_FRAC,
+				motion->gains.maxSpeed);
+	} else {
+		reference = motion->targetSpeed;
+	}
+	error = limit(reference - motion->speed, INT16_MAX);
+
+	bound = (int32_t) motion->gains.maxTilt << MOTION_GAIN_FRAC;
+	motion->integral += (int32_t) motion->gains.speedKi * error;
+	if (motion->integral > bound) {
+		motion->integral = bound;
+	} else if (motion->integral < -bound) {
+		motion->integral = -bound;
+	}
+	motion->tiltSetpoint = limit((((int32_t) motion->gains.speedKp * error)
+			+ motion->integral) >> MOTION_GAIN_FRAC, motion->gains.maxTilt);
+	return motion->tiltSetpoint;
+}
@@ -0,0 +1,261 @@
+/************************************************************
+*
+* @file:      mpu9250.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     MPU9250 accelerometer, gyroscope and AK8963 compass
+*             driver on top of the I2C master queue
+*
+*             The AK8963 is never addressed from the STM32. The
+*             MPU9250 auxiliary master's SLV0 copies HXL..ST2 into
+*             EXT_SENS_DATA every sample, and the FIFO stores each
+*             sample as one record of accel, temperature, gyro and
+*             that compass copy. A read is the two byte FIFO count,
+*             then one DMA burst from FIFO_R_W of every whole
+*             record waiting, up to the caller's batch, so samples
+*             are neither repeated nor lost when the sensor clock
+*             and the control tick drift apart or a read is late.
+*             SLV1 carries the AK8963 setup commands, leaving SLV0
+*             and the record length fixed from the start.
+*
+************************************************************/
+
+#include "mpu9250.h"
+#include "timebase.h"
+
+// Step opcodes in the reg column of magInitSteps
+#define MAG_STEP_WAIT               0xFF    // value = ticks to wait
+#define MAG_STEP_READ_ASA           0xFE    // fetch ASAX..ASAZ from SLV1's EXT_SENS_DATA
+
+// The aux master replays SLV1 every 1 kHz sample for as long as
+// SLV1_CTRL enables it, so each AK8963 command is set up with SLV1
+// off, enabled for a couple of samples and switched off again; a
+// half reprogrammed SLV1 never runs, and a write runs a few times
+// at most, never for a whole wait. Until the AK8963 is in 16 bit
+// mode SLV0 copies an ST2 without BITM, so records decode with
+// magValid clear.
+static const uint8_t magInitSteps[][2] = {
+	{ MPU9250_I2C_MST_CTRL, 0x0D },                 // 400 kHz aux bus
+	// SLV0 reads HXL..ST2 (reading ST2 releases the data latch)
+	{ MPU9250_I2C_SLV0_ADDR, 0x80 | AK8963_ADDRESS },
+	{ MPU9250_I2C_SLV0_REG, AK8963_HXL },
+	{ MPU9250_I2C_SLV0_CTRL, 0x80 | AK8963_READ_LENGTH },
+	// Records start from an empty FIFO
+	{ MPU9250_FIFO_EN, MPU9250_FIFO_RECORD_SOURCES },
+	{ MPU9250_USER_CTRL, MPU9250_USER_I2C_MST_EN | MPU9250_USER_FIFO_RST },
+	{ MPU9250_USER_CTRL, MPU9250_USER_I2C_MST_EN | MPU9250_USER_FIFO_EN },
+	// Soft reset
+	{ MPU9250_I2C_SLV1_CTRL, 0x00 },
+	{ MPU9250_I2C_SLV1_ADDR, AK8963_ADDRESS },
+	{ MPU9250_I2C_SLV1_REG, AK8963_CNTL2 },
+	{ MPU9250_I2C_SLV1_DO, 0x01 },
+	{ MPU9250_I2C_SLV1_CTRL, 0x81 },
+	{ MAG_STEP_WAIT, 2 },
+	{ MPU9250_I2C_SLV1_CTRL, 0x00 },
+	{ MAG_STEP_WAIT, 10 },
+	// Power down, required between any two modes
+	{ MPU9250_I2C_SLV1_REG, AK8963_CNTL1 },
+	{ MPU9250_I2C_SLV1_DO, 0x00 },
+	{ MPU9250_I2C_SLV1_CTRL, 0x81 },
+	{ MAG_STEP_WAIT, 2 },
+	{ MPU9250_I2C_SLV1_CTRL, 0x00 },
+	// Fuse ROM access, read the sensitivity adjustment; SLV1 data
+	// lands in EXT_SENS_DATA behind SLV0's
+	{ MPU9250_I2C_SLV1_DO, 0x0F },
+	{ MPU9250_I2C_SLV1_CTRL, 0x81 },
+	{ MAG_STEP_WAIT, 2 },
+	{ MPU9250_I2C_SLV1_CTRL, 0x00 },
+	{ MPU9250_I2C_SLV1_ADDR, 0x80 | AK8963_ADDRESS },
+	{ MPU9250_I2C_SLV1_REG, AK8963_ASAX },
+	{ MPU9250_I2C_SLV1_CTRL, 0x83 },
+	{ MAG_STEP_WAIT, 10 },
+	{ MAG_STEP_READ_ASA, 0 },
+	{ MPU9250_I2C_SLV1_CTRL, 0x00 },
+	// Power down, then 16 bit continuous mode 2 (100 Hz)
+	{ MPU9250_I2C_SLV1_ADDR, AK8963_ADDRESS },
+	{ MPU9250_I2C_SLV1_REG, AK8963_CNTL1 },
+	{ MPU9250_I2C_SLV1_DO, 0x00 },
+	{ MPU9250_I2C_SLV1_CTRL, 0x81 },
+	{ MAG_STEP_WAIT, 2 },
+	{ MPU9250_I2C_SLV1_CTRL, 0x00 },
+	{ MPU9250_I2C_SLV1_DO, 0x16 },
+	{ MPU9250_I2C_SLV1_CTRL, 0x81 },
+	{ MAG_STEP_WAIT, 2 },
+	{ MPU9250_I2C_SLV1_CTRL, 0x00 },
+};
+
+#define MAG_INIT_STEP_COUNT     (sizeof(magInitSteps) / sizeof(magInitSteps[0]))
+
+static uint8_t magStep = MAG_INIT_STEP_COUNT;
+static uint32_t magWaitUntil = 0;
+static volatile uint8_t magFailed = 0;
+static uint8_t magAdjustment[3] = { 128, 128, 128 };
+
+static void magStepDone(i2cStatus_t status, void *context) {
+	(void) context;
+	if (status != I2C_STATUS_OK) {
+		magFailed = 1;
+	}
+}
+
+/************************************************************
+*
+* Function: mpu9250Init
+* @brief:   queue the configuration writes: PLL clock, 1 kHz
+*           sample rate, 92 Hz DLPF, +-500 dps and +-4 g; the
+*           FIFO starts with mpu9250MagInitStart
+* @return:  int, 0 if all writes were queued, -1 otherwise
+*
+************************************************************/
+int mpu9250Init(void) {
+	static const uint8_t config[][2] = {
+		{ MPU9250_PWR_MGMT_1, 0x01 },       // auto select PLL
+		{ MPU9250_SMPLRT_DIV, 0x00 },       // 1 kHz / (1 + 0)
+		{ MPU9250_CONFIG, 0x42 },           // full FIFO keeps old data, gyro DLPF 92 Hz
+		{ MPU9250_GYRO_CONFIG, 0x08 },      // +-500 dps
+		{ MPU9250_ACCEL_CONFIG, 0x08 },     // +-4 g
+		{ MPU9250_ACCEL_CONFIG2, 0x02 },    // accel DLPF 99 Hz
+	};
+	uint8_t i;
+
+	for (i = 0; i < sizeof(config) / sizeof(config[0]); i++) {
+		if (i2cMasterWriteReg(MPU9250_ADDRESS, config[i][0], config[i][1], 0, 0) != 0) {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/************************************************************
+*
+* Function: mpu9250StartCount
+* @brief:   queue the read of FIFO_COUNTH and FIFO_COUNTL
+* @param:   count, uint8_t*, 2 bytes for mpu9250StartFifoRead
+* @return:  int, see i2cMasterSubmit
+*
+************************************************************/
+int mpu9250StartCount(uint8_t *count, i2cCallback_t callback, void *context) {
+	return i2cMasterReadRegs(MPU9250_ADDRESS, MPU9250_FIFO_COUNTH, count, 2,
+			callback, context);
+}
+
+/************************************************************
+*
+* Function: mpu9250StartFifoRead
+* @brief:   queue one burst of the oldest whole records; a count
+*           that is not whole records means the FIFO filled and
+*           cut one short, so it is reset and read from scratch
+* @param:   count, const uint8_t*, as read by mpu9250StartCount
+* @param:   buffer, uint8_t*, maxRecords * MPU9250_RECORD_LENGTH
+* @return:  uint8_t, records queued, 0 if none or not queued
+*
+************************************************************/
+uint8_t mpu9250StartFifoRead(const uint8_t *count, uint8_t *buffer, uint8_t maxRecords,
+		i2cCallback_t callback, void *context) {
+	uint16_t bytes = (uint16_t) (((count[0] & 0x1F) << 8) | count[1]);
+	uint16_t records = bytes / MPU9250_RECORD_LENGTH;
+
+	if (bytes != records * MPU9250_RECORD_LENGTH) {
+		i2cMasterWriteReg(MPU9250_ADDRESS, MPU9250_USER_CTRL,
+				MPU9250_USER_I2C_MST_EN | MPU9250_USER_FIFO_RST, 0, 0);
+		i2cMasterWriteReg(MPU9250_ADDRESS, MPU9250_USER_CTRL,
+				MPU9250_USER_I2C_MST_EN | MPU9250_USER_FIFO_EN, 0, 0);
+		return 0;
+	}
+	if (records > maxRecords) {
+		records = maxRecords;
+	}
+	if (records == 0 || i2cMasterReadRegs(MPU9250_ADDRESS, MPU9250_FIFO_R_W, buffer,
+			(uint8_t) (records * MPU9250_RECORD_LENGTH), callback, context) != 0) {
+		return 0;
+	}
+	return (uint8_t) records;
+}
+
+/************************************************************
+*
+* Function: mpu9250Decode
+* @brief:   convert a FIFO record into a sample; the AK8963 part
+*           is little endian and its X/Y are swapped and Z
+*           inverted relative to the accel/gyro frame
+*
+************************************************************/
+void mpu9250Decode(const uint8_t *buffer, imuSample_t *sample) {
+	sample->axis[IMU_ACCEL_X] = (int16_t) ((buffer[0] << 8) | buffer[1]);
+	sample->axis[IMU_ACCEL_Y] = (int16_t) ((buffer[2] << 8) | buffer[3]);
+	sample->axis[IMU_ACCEL_Z] = (int16_t) ((buffer[4] << 8) | buffer[5]);
+	sample->temperature = (int16_t) ((buffer[6] << 8) | buffer[7]);
+	sample->axis[IMU_GYRO_X] = (int16_t) ((buffer[8] << 8) | buffer[9]);
+	sample->axis[IMU_GYRO_Y] = (int16_t) ((buffer[10] << 8) | buffer[11]);
+	sample->axis[IMU_GYRO_Z] = (int16_t) ((buffer[12] << 8) | buffer[13]);
+
+	sample->mag[0] = (int16_t) ((buffer[17] << 8) | buffer[16]);
+	sample->mag[1] = (int16_t) ((buffer[15] << 8) | buffer[14]);
+	sample->mag[2] = (int16_t) -((buffer[19] << 8) | buffer[18]);
+	sample->magValid = (buffer[20] & (AK8963_ST2_BITM | AK8963_ST2_HOFL)) == AK8963_ST2_BITM;
+}
+
+/************************************************************
+*
+* Function: mpu9250MagInitStart
+* @brief:   start the FIFO and configure the AK8963 through the
+*           auxiliary I2C master, call after mpu9250Init; reads
+*           find the FIFO empty until the first few steps ran
+*
+************************************************************/
+void mpu9250MagInitStart(void) {
+	magStep = 0;
+	magFailed = 0;
+	magWaitUntil = tickCount;
+}
+
+/************************************************************
+*
+* Function: mpu9250MagInitPoll
+* @brief:   advance the AK8963 setup, call from the background
+*           loop until it stops returning MAG_INIT_BUSY
+* @return:  magInitStatus_t, progress of the setup
+*
+************************************************************/
+magInitStatus_t mpu9250MagInitPoll(void) {
+	uint8_t reg;
+	uint8_t value;
+
+	if (magFailed) {
+		return MAG_INIT_FAILED;
+	}
+	if (!i2cMasterIsIdle() || (int32_t) (tickCount - magWaitUntil) < 0) {
+		return MAG_INIT_BUSY;
+	}
+	if (magStep >= MAG_INIT_STEP_COUNT) {
+		return MAG_INIT_DONE;
+	}
+
+	reg = magInitSteps[magStep][0];
+	value = magInitSteps[magStep][1];
+	if (reg == MAG_STEP_WAIT) {
+		magWaitUntil = tickCount + value;
+	} else if (reg == MAG_STEP_READ_ASA) {
+		if (i2cMasterReadRegs(MPU9250_ADDRESS, MPU9250_EXT_SENS_DATA_00 + AK8963_READ_LENGTH,
+				magAdjustment, 3, magStepDone, 0) != 0) {
+			return MAG_INIT_BUSY;
+		}
+	} else if (i2cMasterWriteReg(MPU9250_ADDRESS, reg, value, magStepDone, 0) != 0) {
+		return MAG_INIT_BUSY;
+	}
+	magStep++;
+	return MAG_INIT_BUSY;
+}
+
+/************************************************************
+*
+* Function: mpu9250MagAdjustment
+* @brief:   AK8963 factory sensitivity adjustment ASAX..ASAZ,
+*           in the AK8963 axis order, valid after setup is done
+* @return:  const uint8_t*, three ASA bytes
+*
+************************************************************/
+const uint8_t *mpu9250MagAdjustment(void) {
+	return magAdjustment;
+}
@@ -0,0 +1,56 @@
+/************************************************************
+*
+* @file:      profile.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Cycle accurate section timing from SysTick, the M0
+*             has no DWT cycle counter
+*
+************************************************************/
+
+#include "profile.h"
+
+/************************************************************
+*
+* Function: profileReset
+* @brief:   clear a probe
+*
+************************************************************/
+void profileReset(profileProbe_t *probe) {
+	seqlockWriteBegin(&probe->lock);
+	probe->last = 0;
+	probe->max = 0;
+	probe->total = 0;
+	probe->count = 0;
+	seqlockWriteEnd(&probe->lock);
+}
+
+/************************************************************
+*
+* Function: profileSnapshot
+* @brief:   consistent copy of a probe updated at a higher
+*           priority, without masking interrupts
+*
+************************************************************/
+void profileSnapshot(const profileProbe_t *probe, profileProbe_t *copy) {
+	uint32_t sequence;
+
+	do {
+		sequence = seqlockReadBegin(&probe->lock);
+		*copy = *probe;
+	} while (seqlockReadRetry(&probe->lock, sequence));
+}
+
+/************************************************************
+*
+* Function: profileAverage
+* @return:  uint32_t, mean cycles per run, 0 before any run
+*
+************************************************************/
+uint32_t profileAverage(const profileProbe_t *probe) {
+	if (probe->count == 0) {
+		return 0;
+	}
+	return probe->total / probe->count;
+}
@@ -0,0 +1,56 @@
+/************************************************************
+*
+* @file:      sensor_mpu9250.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     sensor.h backend for the MPU9250 on I2C1
+*
+************************************************************/
+
+#ifndef SENSOR_SIM
+
+#include "sensor_mpu9250.h"
+
+uint8_t sensorBuffer[SENSOR_MAX_BATCH * MPU9250_RECORD_LENGTH];
+imuSample_t sensorSamples[SENSOR_MAX_BATCH];
+uint8_t sensorCount[2];
+volatile uint8_t sensorReady = 0;
+volatile uint8_t sensorBusy = 0;
+static uint8_t sensorRecords = 0;
+
+/************************************************************
+*
+* Function: sensorFifoDone
+* @brief:   I2C completion of the FIFO burst, a failed read
+*           loses its records and produces no samples this cycle
+*
+************************************************************/
+static void sensorFifoDone(i2cStatus_t status, void *context) {
+	(void) context;
+	if (status == I2C_STATUS_OK) {
+		sensorReady = sensorRecords;
+	}
+	sensorBusy = 0;
+}
+
+/************************************************************
+*
+* Function: sensorCountDone
+* @brief:   I2C completion of the FIFO count, queues the burst
+*           of the records waiting, if any
+*
+************************************************************/
+void sensorCountDone(i2cStatus_t status, void *context) {
+	(void) context;
+	sensorRecords = 0;
+	if (status == I2C_STATUS_OK) {
+		sensorRecords = mpu9250StartFifoRead(sensorCount, sensorBuffer, SENSOR_MAX_BATCH,
+				sensorFifoDone, 0);
+	}
+	if (sensorRecords == 0) {
+		sensorBusy = 0;
+	}
+}
+
+#endif
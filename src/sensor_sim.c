@@ -0,0 +1,20 @@
+/************************************************************
+*
+* @file:      sensor_sim.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     sensor.h backend for host builds, samples are fed
+*             by the harness with sensorSimPush
+*
+************************************************************/
+
+#ifdef SENSOR_SIM
+
+#include "sensor_sim.h"
+
+imuSample_t sensorSimSamples[SENSOR_MAX_BATCH];
+uint8_t sensorSimPending = 0;
+uint8_t sensorSimReady = 0;
+
+#endif
@@ -0,0 +1,150 @@
+/************************************************************
+*
+* @file:      shell.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Console command interpreter on perfect hashed
+*             static tables, parsing lines in place
+*
+*             A table is a const array of 2^bits slots in flash.
+*             The seed is chosen by tools/shell_hash.py so that
+*             the FNV-1a hash of every name lands in a slot of its
+*             own; a lookup is one pass over the word and one
+*             string compare, however many names there are. A
+*             word not in the table hashes to an empty slot or
+*             fails the compare. Arguments are located in the
+*             received line and converted where numeric, nothing
+*             is copied and nothing is allocated. Called from the
+*             background loop only.
+*
+************************************************************/
+
+#include <string.h>
+#include "shell.h"
+#include "debug_uart.h"
+
+/************************************************************
+*
+* Function: shellHash
+* @brief:   FNV-1a of a word, top bits as the slot
+* @param:   length, size_t, characters of word
+* @param:   bits, uint8_t, log2 of the table size, 1 .. 8
+* @return:  uint8_t, slot 0 .. 2^bits - 1
+*
+************************************************************/
+uint8_t shellHash(const char *word, size_t length, uint32_t seed, uint8_t bits) {
+	uint32_t hash = seed;
+
+	while (length-- > 0) {
+		hash = (hash ^ (uint8_t) *word++) * SHELL_HASH_PRIME;
+	}
+	return (uint8_t) (hash >> (32 - bits));
+}
+
+/************************************************************
+*
+* Function: shellLookup
+* @brief:   find a word in a perfect hashed table
+* @param:   word, const char*, need not be terminated
+* @return:  const shellEntry_t*, the entry or 0 if absent
+*
+************************************************************/
+const shellEntry_t *shellLookup(const shellTable_t *table, const char *word, size_t length) {
+	const shellEntry_t *entry = &table->slots[shellHash(word, length, table->seed, table->bits)];
+
+	if (entry->name == 0 || strncmp(entry->name, word, length) != 0
+			|| entry->name[length] != '\0') {
+		return 0;
+	}
+	return entry;
+}
+
+/************************************************************
+*
+* Function: splitArgs
+* @brief:   locate the space separated arguments of a line
+* @param:   cursor, const char*, just after the command name
+* @return:  int, 0 on success, -1 if there are too many
+*
+************************************************************/
+static int splitArgs(const char *cursor, shellArgs_t *args) {
+	const char *start;
+	const char *number;
+	uint8_t i;
+
+	args->count = 0;
+	args->numbers = 0;
+	for (;;) {
+		while (*cursor == ' ') {
+			cursor++;
+		}
+		if (*cursor == '\0') {
+			return 0;
+		}
+		if (args->count == SHELL_MAX_ARGS) {
+			return -1;
+		}
+		start = cursor;
+		while (*cursor != ' ' && *cursor != '\0') {
+			cursor++;
+		}
+		i = args->count++;
+		args->text[i] = start;
+		args->length[i] = (uint8_t) (cursor - start);
+		number = start;
+		if (parseInt(&number, &args->value[i]) == 0 && number == cursor) {
+			args->numbers |= 1 << i;
+		}
+	}
+}
+
+/************************************************************
+*
+* Function: shellExecute
+* @brief:   run one console line and send the "ok" or "err"
+*           reply unless the handler replied itself
+* @param:   line, const char*, NUL terminated, name first
+*
+************************************************************/
+void shellExecute(const shellTable_t *table, const char *line) {
+	const shellEntry_t *command;
+	const char *cursor = line;
+	shellArgs_t args;
+	int status = SHELL_ERROR;
+
+	while (*cursor != ' ' && *cursor != '\0') {
+		cursor++;
+	}
+	command = shellLookup(table, line, (size_t) (cursor - line));
+	if (command != 0 && command->handler != 0 && splitArgs(cursor, &args) == 0) {
+		status = command->handler(&args);
+	}
+	if (status == SHELL_OK) {
+		debugUartWrite("ok\r\n");
+	} else if (status == SHELL_ERROR) {
+		debugUartWrite("err\r\n");
+	}
+}
+
+/************************************************************
+*
+* Function: shellNumbers
+* @return:  uint8_t, 1 if there are exactly count arguments and
+*           all of them are numbers
+*
+************************************************************/
+uint8_t shellNumbers(const shellArgs_t *args, uint8_t count) {
+	return args->count == count && args->numbers == (1 << count) - 1;
+}
+
+/************************************************************
+*
+* Function: shellIsWord
+* @return:  uint8_t, 1 if argument index is the given word
+*
+************************************************************/
+uint8_t shellIsWord(const shellArgs_t *args, uint8_t index, const char *word) {
+	return index < args->count && strlen(word) == args->length[index]
+			&& strncmp(args->text[index], word, args->length[index]) == 0;
+}
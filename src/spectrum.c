@@ -0,0 +1,265 @@
+/************************************************************
+*
+* @file:      spectrum.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     On target vibration spectrum of one IMU axis,
+*             Hann windowed arm_rfft_q15 streamed as magnitude bins
+*
+*             The control task only copies one value per tick into
+*             the capture window. Once it is full the main loop
+*             removes the mean, normalizes the window to use the
+*             full Q15 range (block floating point, the shift is
+*             undone when accumulating), applies the Hann window and
+*             runs the FFT; the capture buffer is handed back before
+*             the FFT so the next window fills meanwhile. Magnitudes
+*             of 2^averageShift windows are averaged and sent as a
+*             single binary frame, decoded by tools/spectrum_decode.py.
+*
+*             Scaling: arm_rfft_q15 divides by the FFT length and
+*             the magnitude is halved, as arm_cmplx_mag_q15 would,
+*             so a sine of amplitude A counts under the Hann window
+*             shows a peak bin of A / 8. Accumulated bins are Q8 of
+*             that, sent as bin << exponent. The magnitude is the
+*             exact sqrtU32 of the 32 bit power rather than
+*             arm_cmplx_mag_q15, which drops 17 bits of it before
+*             the root and reads every bin under ~181 counts as
+*             zero (host/rfft_test.c).
+*
+************************************************************/
+
+#include "spectrum.h"
+#include "timebase.h"
+#include "debug_uart.h"
+#include "tables.h"
+#include "fastmath.h"
+
+#if HANN_WINDOW_LEN != SPECTRUM_FFT_LEN
+#error "hannWindow length differs, rerun tools/gen_tables.py --hann-len"
+#endif
+
+#define SPECTRUM_FFT_SHIFT          7    // log2(SPECTRUM_FFT_LEN)
+#define SPECTRUM_MAX_NORMALIZE      8
+#define SPECTRUM_ACC_SHIFT          8
+
+typedef enum {
+	SPECTRUM_IDLE = 0,
+	SPECTRUM_CAPTURING,      // control task fills captureBuffer
+	SPECTRUM_WINDOW_READY,   // main loop owns captureBuffer
+	SPECTRUM_PROCESSING,     // last window in the FFT, capture stopped
+	SPECTRUM_SENDING         // frame built, waiting for UART room
+} spectrumState_t;
+
+profileProbe_t spectrumProfile;
+
+static arm_rfft_instance_q15 rfft;
+static arm_cfft_radix4_instance_q15 cfft;
+static q15_t captureBuffer[SPECTRUM_FFT_LEN];
+static q15_t fftInput[SPECTRUM_FFT_LEN];
+// FFT output, reused to build the outgoing frame
+static q15_t fftOutput[2 * SPECTRUM_FFT_LEN];
+static uint32_t accumulator[SPECTRUM_BINS];
+
+static volatile spectrumState_t state = SPECTRUM_IDLE;
+static volatile uint8_t captureCount;
+static imuAxis_t captureAxis;
+static uint8_t windowShift;
+static uint8_t windowsDone;
+
+/************************************************************
+*
+* Function: prepareWindow
+* @brief:   copy the capture out without its mean, normalized
+*           and windowed
+* @return:  uint8_t, normalization shift applied
+*
+************************************************************/
+static uint8_t prepareWindow(void) {
+	int32_t sum = 0;
+	int32_t peak = 0;
+	int32_t value;
+	int16_t mean;
+	uint8_t shift = 0;
+	uint16_t i;
+
+	for (i = 0; i < SPECTRUM_FFT_LEN; i++) {
+		sum += captureBuffer[i];
+	}
+	mean = (int16_t) (sum >> SPECTRUM_FFT_SHIFT);
+	for (i = 0; i < SPECTRUM_FFT_LEN; i++) {
+		value = captureBuffer[i] - mean;
+		value = value < 0 ? -value : value;
+		if (value > peak) {
+			peak = value;
+		}
+	}
+	// Keep one bit of margin below full scale
+	while (shift < SPECTRUM_MAX_NORMALIZE && (peak << (shift + 1)) < 16384) {
+		shift++;
+	}
+	for (i = 0; i < SPECTRUM_FFT_LEN; i++) {
+		value = (captureBuffer[i] - mean) << shift;
+		fftInput[i] = (q15_t) (value > 32767 ? 32767 : (value < -32768 ? -32768 : value));
+	}
+	arm_mult_q15(fftInput, (q15_t *) hannWindow, fftInput, SPECTRUM_FFT_LEN);
+	return shift;
+}
+
+/************************************************************
+*
+* Function: buildFrame
+* @brief:   average the accumulated bins into a frame in the
+*           fftOutput buffer
+*
+************************************************************/
+static void buildFrame(void) {
+	uint8_t *frame = (uint8_t *) fftOutput;
+	uint32_t largest = 0;
+	uint32_t bin;
+	uint8_t exponent = 0;
+	uint8_t checksum = 0;
+	uint16_t length = 0;
+	uint16_t i;
+
+	for (i = 0; i < SPECTRUM_BINS; i++) {
+		accumulator[i] >>= windowShift;
+		if (accumulator[i] > largest) {
+			largest = accumulator[i];
+		}
+	}
+	while ((largest >> exponent) > 0xFFFF) {
+		exponent++;
+	}
+
+	frame[length++] = SPECTRUM_SYNC0;
+	frame[length++] = SPECTRUM_SYNC1;
+	frame[length++] = SPECTRUM_FRAME_TYPE;
+	frame[length++] = (uint8_t) captureAxis;
+	frame[length++] = (uint8_t) (1 << windowShift);
+	frame[length++] = exponent;
+	frame[length++] = (uint8_t) SPECTRUM_FFT_LEN;
+	frame[length++] = (uint8_t) (SPECTRUM_FFT_LEN >> 8);
+	frame[length++] = (uint8_t) TICK_RATE_HZ;
+	frame[length++] = (uint8_t) (TICK_RATE_HZ >> 8);
+	for (i = 0; i < SPECTRUM_BINS; i++) {
+		bin = accumulator[i] >> exponent;
+		frame[length++] = (uint8_t) bin;
+		frame[length++] = (uint8_t) (bin >> 8);
+	}
+	for (i = 2; i < length; i++) {
+		checksum += frame[i];
+	}
+	frame[length] = checksum;
+}
+
+/************************************************************
+*
+* Function: spectrumInit
+* @brief:   set up the CMSIS real FFT, nothing is captured until
+*           spectrumStart
+*
+************************************************************/
+void spectrumInit(void) {
+	arm_rfft_init_q15(&rfft, &cfft, SPECTRUM_FFT_LEN, 0, 1);
+	profileReset(&spectrumProfile);
+	state = SPECTRUM_IDLE;
+}
+
+/************************************************************
+*
+* Function: spectrumStart
+* @brief:   begin capturing one axis, main loop only
+* @param:   axis, imuAxis_t, axis to analyse
+* @param:   averageShift, uint8_t, average 2^averageShift windows
+* @return:  int, 0 on success, -1 if busy or out of range
+*
+************************************************************/
+int spectrumStart(imuAxis_t axis, uint8_t averageShift) {
+	uint16_t i;
+
+	if (state != SPECTRUM_IDLE || (uint32_t) axis >= IMU_AXIS_COUNT
+			|| averageShift > SPECTRUM_MAX_AVERAGE_SHIFT) {
+		return -1;
+	}
+	for (i = 0; i < SPECTRUM_BINS; i++) {
+		accumulator[i] = 0;
+	}
+	captureAxis = axis;
+	windowShift = averageShift;
+	windowsDone = 0;
+	captureCount = 0;
+	state = SPECTRUM_CAPTURING;
+	return 0;
+}
+
+/************************************************************
+*
+* Function: spectrumCapture
+* @brief:   record one sample, called by the control task
+*
+************************************************************/
+void spectrumCapture(const imuSample_t *sample) {
+	if (state != SPECTRUM_CAPTURING) {
+		return;
+	}
+	captureBuffer[captureCount] = sample->axis[captureAxis];
+	if (++captureCount == SPECTRUM_FFT_LEN) {
+		state = SPECTRUM_WINDOW_READY;
+	}
+}
+
+/************************************************************
+*
+* Function: spectrumPoll
+* @brief:   background step: transform a full window or send a
+*           finished frame; the FFT takes a few ms and relies on
+*           the control task preempting the main loop
+*
+************************************************************/
+void spectrumPoll(void) {
+	uint32_t start;
+	int32_t re;
+	int32_t im;
+	uint8_t shift;
+	uint16_t i;
+
+	if (state == SPECTRUM_WINDOW_READY) {
+		start = profileCycles();
+		shift = prepareWindow();
+		windowsDone++;
+		if (windowsDone < (1 << windowShift)) {
+			captureCount = 0;
+			state = SPECTRUM_CAPTURING;
+		} else {
+			state = SPECTRUM_PROCESSING;
+		}
+		arm_rfft_q15(&rfft, fftInput, fftOutput);
+		for (i = 0; i < SPECTRUM_BINS; i++) {
+			re = fftOutput[2 * i];
+			im = fftOutput[2 * i + 1];
+			accumulator[i] += (uint32_t) (sqrtU32((uint32_t) (re * re)
+					+ (uint32_t) (im * im)) >> 1) << (SPECTRUM_ACC_SHIFT - shift);
+		}
+		profileStop(&spectrumProfile, start);
+		if (state == SPECTRUM_PROCESSING) {
+			buildFrame();
+			state = SPECTRUM_SENDING;
+		}
+	} else if (state == SPECTRUM_SENDING) {
+		if (debugUartTxFree() >= SPECTRUM_FRAME_SIZE) {
+			debugUartWriteBytes((const uint8_t *) fftOutput, SPECTRUM_FRAME_SIZE);
+			state = SPECTRUM_IDLE;
+		}
+	}
+}
+
+/************************************************************
+*
+* Function: spectrumBusy
+* @return:  uint8_t, 1 while a capture or frame is in progress
+*
+************************************************************/
+uint8_t spectrumBusy(void) {
+	return state != SPECTRUM_IDLE;
+}
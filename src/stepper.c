@@ -0,0 +1,239 @@
+/************************************************************
+*
+* @file:      stepper.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Step/direction driver (A4988) for the two wheel
+*             steppers, step pulses come from timer PWM outputs
+*
+*             Each wheel owns a timer in PWM mode 1: the period is
+*             the step period and the compare value the pulse
+*             width, so steps need no CPU time. The update
+*             interrupt fires once per step and keeps the signed
+*             step count used as wheel odometry. ARR is preloaded,
+*             so a new rate starts at the next step boundary.
+*
+*             Left:  STEP PA1 (TIM2_CH2, AF2), DIR PC0
+*             Right: STEP PB4 (TIM3_CH1, AF1), DIR PC1
+*             Both:  ENABLE PC2, active low
+*
+************************************************************/
+
+#include "stepper.h"
+#include "divide.h"
+
+#define STEPPER_DIR_GPIO            GPIOC
+// STEPPER_TIMER_HZ = PERIOD_MANTISSA << PERIOD_EXPONENT, the
+// mantissa must fit 16 bits for the reciprocal multiply
+#define PERIOD_EXPONENT             6
+#define PERIOD_MANTISSA             (STEPPER_TIMER_HZ >> PERIOD_EXPONENT)
+#if (PERIOD_MANTISSA << PERIOD_EXPONENT) != STEPPER_TIMER_HZ || PERIOD_MANTISSA > 0xFFFF
+#error "STEPPER_TIMER_HZ needs another PERIOD_EXPONENT"
+#endif
+#define STEPPER_ENABLE_PIN          GPIO_Pin_2
+
+typedef struct {
+	TIM_TypeDef *timer;
+	uint16_t dirPin;
+	uint8_t invert;             // right wheel is mirrored
+} stepperConfig_t;
+
+static const stepperConfig_t stepperConfig[STEPPER_COUNT] = {
+	{ TIM2, GPIO_Pin_0, 0 },
+	{ TIM3, GPIO_Pin_1, 1 },
+};
+
+static volatile int32_t position[STEPPER_COUNT];
+static volatile int8_t direction[STEPPER_COUNT];
+static int32_t rate[STEPPER_COUNT];
+
+static void setCompare(stepperId_t id, uint32_t value) {
+	if (id == STEPPER_LEFT) {
+		TIM_SetCompare2(TIM2, value);
+	} else {
+		TIM_SetCompare1(TIM3, value);
+	}
+}
+
+static void initTimer(TIM_TypeDef *timer, uint8_t channel) {
+	TIM_TimeBaseInitTypeDef base;
+	TIM_OCInitTypeDef oc;
+
+	TIM_TimeBaseStructInit(&base);
+	base.TIM_Prescaler = SystemCoreClock / STEPPER_TIMER_HZ - 1;
+	base.TIM_Period = 0xFFFF;
+	base.TIM_CounterMode = TIM_CounterMode_Up;
+	TIM_TimeBaseInit(timer, &base);
+	TIM_ARRPreloadConfig(timer, ENABLE);
+
+	TIM_OCStructInit(&oc);
+	oc.TIM_OCMode = TIM_OCMode_PWM1;
+	oc.TIM_OutputState = TIM_OutputState_Enable;
+	oc.TIM_OCPolarity = TIM_OCPolarity_High;
+	oc.TIM_Pulse = 0;
+	if (channel == 1) {
+		TIM_OC1Init(timer, &oc);
+		TIM_OC1PreloadConfig(timer, TIM_OCPreload_Enable);
+	} else {
+		TIM_OC2Init(timer, &oc);
+		TIM_OC2PreloadConfig(timer, TIM_OCPreload_Enable);
+	}
+
+	TIM_ITConfig(timer, TIM_IT_Update, ENABLE);
+	TIM_Cmd(timer, ENABLE);
+}
+
+/************************************************************
+*
+* Function: stepperInit
+* @brief:   set up both STEP timers, DIR and ENABLE pins; the
+*           drivers start disabled and stopped
+*
+************************************************************/
+void stepperInit(void) {
+	GPIO_InitTypeDef gpio;
+
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_GPIOA | RCC_AHBPeriph_GPIOB
+			| RCC_AHBPeriph_GPIOC, ENABLE);
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2 | RCC_APB1Periph_TIM3, ENABLE);
+
+	GPIO_StructInit(&gpio);
+	gpio.GPIO_Mode = GPIO_Mode_OUT;
+	gpio.GPIO_OType = GPIO_OType_PP;
+	gpio.GPIO_Speed = GPIO_Speed_50MHz;
+	gpio.GPIO_Pin = GPIO_Pin_0 | GPIO_Pin_1 | STEPPER_ENABLE_PIN;
+	GPIO_Init(STEPPER_DIR_GPIO, &gpio);
+	stepperEnable(0);
+
+	gpio.GPIO_Mode = GPIO_Mode_AF;
+	gpio.GPIO_Pin = GPIO_Pin_1;
+	GPIO_Init(GPIOA, &gpio);
+	GPIO_PinAFConfig(GPIOA, GPIO_PinSource1, GPIO_AF_2);
+	gpio.GPIO_Pin = GPIO_Pin_4;
+	GPIO_Init(GPIOB, &gpio);
+	GPIO_PinAFConfig(GPIOB, GPIO_PinSource4, GPIO_AF_1);
+
+	initTimer(TIM2, 2);
+	initTimer(TIM3, 1);
+
+	// Above I2C: a late odometry count is a lost step
+	NVIC_SetPriority(TIM2_IRQn, 0);
+	NVIC_SetPriority(TIM3_IRQn, 0);
+	NVIC_EnableIRQ(TIM2_IRQn);
+	NVIC_EnableIRQ(TIM3_IRQn);
+}
+
+/************************************************************
+*
+* Function: stepperEnable
+* @brief:   energize (1) or release (0) both motors
+*
+************************************************************/
+void stepperEnable(uint8_t enable) {
+	if (enable) {
+		GPIO_ResetBits(STEPPER_DIR_GPIO, STEPPER_ENABLE_PIN);
+	} else {
+		GPIO_SetBits(STEPPER_DIR_GPIO, STEPPER_ENABLE_PIN);
+	}
+}
+
+/************************************************************
+*
+* Function: stepPeriod
+* @brief:   STEPPER_TIMER_HZ / rate, exact, from the reciprocal
+*           table; the estimate is never low and at most one
+*           count high for any 16 bit rate, trimmed by one
+*           multiply
+*
+************************************************************/
+static uint32_t stepPeriod(uint16_t stepRate) {
+	uint8_t shift;
+	uint32_t reciprocal = divideReciprocal(stepRate, &shift);
+	uint32_t period = (PERIOD_MANTISSA * reciprocal) >> (31 - PERIOD_EXPONENT - shift);
+
+	if (period * stepRate > STEPPER_TIMER_HZ) {
+		period--;
+	}
+	return period;
+}
+
+/************************************************************
+*
+* Function: stepperSetRate
+* @brief:   command a signed step rate, positive drives the
+*           robot forward; rates under STEPPER_MIN_RATE stop
+* @param:   newRate, int32_t, steps per second
+*
+************************************************************/
+void stepperSetRate(stepperId_t id, int32_t newRate) {
+	const stepperConfig_t *config = &stepperConfig[id];
+	uint32_t magnitude = newRate < 0 ? -newRate : newRate;
+	uint8_t reverse;
+
+	if (magnitude < STEPPER_MIN_RATE) {
+		setCompare(id, 0);
+		direction[id] = 0;
+		rate[id] = 0;
+		return;
+	}
+	if (magnitude > STEPPER_MAX_RATE) {
+		magnitude = STEPPER_MAX_RATE;
+	}
+
+	reverse = (newRate < 0) ^ config->invert;
+	if (reverse) {
+		GPIO_SetBits(STEPPER_DIR_GPIO, config->dirPin);
+	} else {
+		GPIO_ResetBits(STEPPER_DIR_GPIO, config->dirPin);
+	}
+	direction[id] = newRate < 0 ? -1 : 1;
+	rate[id] = newRate < 0 ? -(int32_t) magnitude : (int32_t) magnitude;
+	TIM_SetAutoreload(config->timer, stepPeriod((uint16_t) magnitude) - 1);
+	setCompare(id, STEPPER_PULSE_TICKS);
+}
+
+/************************************************************
+*
+* Function: stepperGetRate
+* @return:  int32_t, last commanded rate after clamping
+*
+************************************************************/
+int32_t stepperGetRate(stepperId_t id) {
+	return rate[id];
+}
+
+/************************************************************
+*
+* Function: stepperGetPosition
+* @return:  int32_t, signed steps issued since reset
+*
+************************************************************/
+int32_t stepperGetPosition(stepperId_t id) {
+	return position[id];
+}
+
+/************************************************************
+*
+* Function: stepperGetPeriod
+* @return:  uint16_t, current step period in timer counts
+*           (the auto-reload value + 1), 0 when stopped
+*
+************************************************************/
+uint16_t stepperGetPeriod(stepperId_t id) {
+	if (direction[id] == 0) {
+		return 0;
+	}
+	return (uint16_t) (stepperConfig[id].timer->ARR + 1);
+}
+
+/************************************************************
+*
+* Function: stepperUpdateHandler
+* @brief:   timer update, one step was issued
+*
+************************************************************/
+void stepperUpdateHandler(stepperId_t id) {
+	stepperConfig[id].timer->SR = (uint16_t) ~TIM_IT_Update;
+	position[id] += direction[id];
+}
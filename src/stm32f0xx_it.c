@@ -0,0 +1,80 @@
+/**
+  ******************************************************************************
+  * @file    stm32f0xx_it.c
+  * @author  Weili An
+  * @version v1.0.0
+  * @date    Oct. 19th, 2026
+  * @brief   Cortex-M0 exception handlers for Adjustic
+  ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f0xx_it.h"
+#include "timebase.h"
+#include "watchdog.h"
+#include "i2c_master.h"
+#include "stepper.h"
+#include "debug_uart.h"
+
+/******************************************************************************/
+/*            Cortex-M0 Processor Exceptions Handlers                         */
+/******************************************************************************/
+
+void NMI_Handler(void)
+{
+}
+
+void HardFault_Handler(void)
+{
+	/* Hang here, the IWDG resets the board */
+	while (1)
+	{
+	}
+}
+
+void SVC_Handler(void)
+{
+}
+
+void PendSV_Handler(void)
+{
+	controlTick();
+}
+
+void SysTick_Handler(void)
+{
+	timebaseTick();
+	i2cMasterPoll();
+	if ((tickCount % WATCHDOG_SERVICE_PERIOD) == 0) {
+		watchdogService();
+	}
+}
+
+/******************************************************************************/
+/*                 STM32F0xx Peripherals Interrupt Handlers                   */
+/******************************************************************************/
+
+void I2C1_IRQHandler(void)
+{
+	i2cMasterIrqHandler();
+}
+
+void TIM2_IRQHandler(void)
+{
+	stepperUpdateHandler(STEPPER_LEFT);
+}
+
+void TIM3_IRQHandler(void)
+{
+	stepperUpdateHandler(STEPPER_RIGHT);
+}
+
+void USART1_IRQHandler(void)
+{
+	debugUartIrqHandler();
+}
+
+void DMA1_Channel4_5_IRQHandler(void)
+{
+	debugUartDmaIrqHandler();
+}
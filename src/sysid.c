@@ -0,0 +1,186 @@
+/************************************************************
+*
+* @file:      sysid.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     System identification mode: PRBS excitation on the
+*             wheel acceleration command and a binary log of
+*             (command, tilt, rate) at the control rate
+*
+*             The control task adds a +/- amplitude PRBS to the
+*             controller output (closed loop, robot balancing) or
+*             applies it alone (open loop, robot held upright), and
+*             pushes one record per tick into a ring. The main loop
+*             drains the ring into frames of SYSID_FRAME_RECORDS,
+*             ~6.4 KB/s, 2% of the default 3 Mbaud and still
+*             within 115200 baud. tools/sysid_fit.py fits a model to the log.
+*
+************************************************************/
+
+#include "sysid.h"
+#include "fixmath.h"
+#include "debug_uart.h"
+
+static sysidRecord_t ring[SYSID_RING_SIZE];
+// Sequence number of each record, frames end at a gap
+static uint16_t ringSequence[SYSID_RING_SIZE];
+static volatile uint8_t ringHead = 0;   // control task side
+static volatile uint8_t ringTail = 0;   // main loop side
+static uint16_t sequence = 0;           // control task side
+static volatile uint16_t dropped = 0;
+static uint8_t frame[SYSID_FRAME_SIZE];
+
+static volatile uint8_t active = 0;
+static int16_t level;
+static uint8_t bitTicks;
+static uint8_t bitCountdown;
+static uint8_t openLoop;
+static uint16_t lfsr;
+
+/************************************************************
+*
+* Function: sysidStart
+* @brief:   start excitation and logging, main loop only
+* @param:   amplitude, int16_t, Q15 PRBS amplitude
+* @param:   ticksPerBit, uint8_t, ticks each PRBS bit is held,
+*           sets the excitation bandwidth to ~rate / ticksPerBit
+* @param:   open, uint8_t, 1 to drop the controller output
+* @return:  int, 0 on success, -1 if bad arguments or running
+*
+************************************************************/
+int sysidStart(int16_t amplitude, uint8_t ticksPerBit, uint8_t open) {
+	if (active || amplitude <= 0 || ticksPerBit == 0) {
+		return -1;
+	}
+	level = amplitude;
+	bitTicks = ticksPerBit;
+	bitCountdown = ticksPerBit;
+	openLoop = open;
+	lfsr = SYSID_LFSR_SEED;
+	dropped = 0;
+	active = 1;
+	return 0;
+}
+
+/************************************************************
+*
+* Function: sysidStop
+* @brief:   stop excitation, buffered records are still sent
+*
+************************************************************/
+void sysidStop(void) {
+	active = 0;
+}
+
+/************************************************************
+*
+* Function: sysidIsActive
+* @return:  uint8_t, 1 while the excitation is applied
+*
+************************************************************/
+uint8_t sysidIsActive(void) {
+	return active;
+}
+
+/************************************************************
+*
+* Function: sysidExcite
+* @brief:   apply the excitation to the controller output,
+*           called by the control task
+* @param:   command, int16_t, Q15 controller output
+* @return:  int16_t, command to apply
+*
+************************************************************/
+int16_t sysidExcite(int16_t command) {
+	if (!active) {
+		return command;
+	}
+	if (--bitCountdown == 0) {
+		bitCountdown = bitTicks;
+		lfsr = (lfsr >> 1) ^ ((lfsr & 1) ? SYSID_LFSR_MASK : 0);
+	}
+	return saturateQ15((openLoop ? 0 : command) + ((lfsr & 1) ? level : -level));
+}
+
+/************************************************************
+*
+* Function: sysidLog
+* @brief:   record one tick, called by the control task
+*
+************************************************************/
+void sysidLog(int16_t command, int16_t tilt, int16_t rate) {
+	uint8_t head = ringHead;
+
+	if (!active) {
+		return;
+	}
+	if (((head + 1) & (SYSID_RING_SIZE - 1)) == ringTail) {
+		dropped++;
+	} else {
+		ring[head].command = command;
+		ring[head].tilt = tilt;
+		ring[head].rate = rate;
+		ringSequence[head] = sequence;
+		ringHead = (head + 1) & (SYSID_RING_SIZE - 1);
+	}
+	sequence++;
+}
+
+/************************************************************
+*
+* Function: sysidPoll
+* @brief:   background step, send a full frame once enough
+*           records are buffered, or what is left after a stop
+*
+************************************************************/
+void sysidPoll(void) {
+	uint8_t tail = ringTail;
+	uint8_t pending = (ringHead - tail) & (SYSID_RING_SIZE - 1);
+	uint16_t first = ringSequence[tail];
+	uint8_t count = 0;
+	uint8_t checksum = 0;
+	uint8_t length = 0;
+	uint8_t i;
+
+	if (pending == 0 || (pending < SYSID_FRAME_RECORDS && active)
+			|| debugUartTxFree() < SYSID_FRAME_SIZE) {
+		return;
+	}
+	while (count < pending && count < SYSID_FRAME_RECORDS
+			&& ringSequence[(tail + count) & (SYSID_RING_SIZE - 1)] == (uint16_t) (first + count)) {
+		count++;
+	}
+
+	frame[length++] = SYSID_SYNC0;
+	frame[length++] = SYSID_SYNC1;
+	frame[length++] = SYSID_FRAME_TYPE;
+	frame[length++] = count;
+	frame[length++] = (uint8_t) first;
+	frame[length++] = (uint8_t) (first >> 8);
+	for (i = 0; i < count; i++) {
+		frame[length++] = (uint8_t) ring[tail].command;
+		frame[length++] = (uint8_t) (ring[tail].command >> 8);
+		frame[length++] = (uint8_t) ring[tail].tilt;
+		frame[length++] = (uint8_t) (ring[tail].tilt >> 8);
+		frame[length++] = (uint8_t) ring[tail].rate;
+		frame[length++] = (uint8_t) (ring[tail].rate >> 8);
+		tail = (tail + 1) & (SYSID_RING_SIZE - 1);
+	}
+	for (i = 2; i < length; i++) {
+		checksum += frame[i];
+	}
+	frame[length++] = checksum;
+	ringTail = tail;
+	debugUartWriteBytes(frame, length);
+}
+
+/************************************************************
+*
+* Function: sysidDropped
+* @return:  uint16_t, records lost to a full ring since start
+*
+************************************************************/
+uint16_t sysidDropped(void) {
+	return dropped;
+}
@@ -0,0 +1,183 @@
+/************************************************************
+*
+* @file:      tables.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     Const lookup tables, placed in flash
+*
+*             Generated, do not edit; rerun:
+*             tools/gen_tables.py --divide-bits 8 --cordic-steps 28 --rsqrt-bits 6
+*             --hann-len 128 --notch 1000:20:450:5 --notch-q 4,
+*             or pass --check to verify.
+*
+************************************************************/
+
+#include "tables.h"
+
+// 2^31 / (2^15 + 128 i) - 2^15, rounded up
+const uint16_t divideReciprocalTable[DIVIDE_LUT_SIZE] = {
+	32768, 32513, 32260, 32009, 31760, 31513, 31268, 31024,
+	30783, 30543, 30305, 30069, 29834, 29601, 29370, 29141,
+	28913, 28688, 28463, 28241, 28020, 27800, 27582, 27366,
+	27151, 26938, 26726, 26516, 26307, 26100, 25894, 25690,
+	25487, 25285, 25085, 24886, 24689, 24493, 24298, 24104,
+	23912, 23721, 23532, 23344, 23157, 22971, 22786, 22603,
+	22421, 22240, 22060, 21881, 21704, 21528, 21353, 21179,
+	21006, 20834, 20663, 20494, 20325, 20157, 19991, 19826,
+	19661, 19498, 19336, 19174, 19014, 18855, 18696, 18539,
+	18383, 18227, 18073, 17919, 17766, 17615, 17464, 17314,
+	17165, 17017, 16869, 16723, 16577, 16433, 16289, 16146,
+	16003, 15862, 15722, 15582, 15443, 15305, 15167, 15031,
+	14895, 14760, 14626, 14492, 14360, 14228, 14096, 13966,
+	13836, 13707, 13578, 13451, 13324, 13197, 13072, 12947,
+	12823, 12699, 12576, 12454, 12333, 12212, 12091, 11972,
+	11853, 11734, 11617, 11500, 11383, 11267, 11152, 11037,
+	10923, 10810, 10697, 10584, 10473, 10362, 10251, 10141,
+	10032, 9923, 9814, 9706, 9599, 9492, 9386, 9281,
+	9176, 9071, 8967, 8863, 8760, 8658, 8556, 8454,
+	8353, 8253, 8153, 8053, 7954, 7855, 7757, 7660,
+	7562, 7466, 7369, 7274, 7178, 7083, 6989, 6895,
+	6801, 6708, 6616, 6523, 6432, 6340, 6249, 6159,
+	6069, 5979, 5890, 5801, 5712, 5624, 5537, 5449,
+	5363, 5276, 5190, 5104, 5019, 4934, 4850, 4765,
+	4682, 4598, 4515, 4433, 4350, 4268, 4187, 4106,
+	4025, 3944, 3864, 3784, 3705, 3626, 3547, 3468,
+	3390, 3313, 3235, 3158, 3081, 3005, 2929, 2853,
+	2777, 2702, 2627, 2553, 2479, 2405, 2331, 2258,
+	2185, 2112, 2040, 1968, 1896, 1825, 1754, 1683,
+	1612, 1542, 1472, 1402, 1333, 1263, 1194, 1126,
+	1058, 989, 922, 854, 787, 720, 653, 587,
+	521, 455, 389, 324, 259, 194, 129, 65,
+	0,
+};
+
+// round(atan(2^-i) / pi * 2^31)
+const int32_t atanCordicTable[ATAN_CORDIC_STEPS] = {
+	536870912, 316933406, 167458907, 85004756, 42667331, 21354465, 10679838, 5340245,
+	2670163, 1335087, 667544, 333772, 166886, 83443, 41722, 20861,
+	10430, 5215, 2608, 1304, 652, 326, 163, 81,
+	41, 20, 10, 5,
+};
+
+// round(2^15 / sqrt(1/4 + i / 64)) - 2^15
+const uint16_t rsqrtSeedTable[RSQRT_LUT_SIZE] = {
+	32768, 30811, 29020, 27372, 25849, 24437, 23121, 21893,
+	20742, 19661, 18643, 17682, 16773, 15911, 15093, 14314,
+	13573, 12865, 12189, 11542, 10923, 10328, 9757, 9209,
+	8681, 8172, 7682, 7209, 6752, 6310, 5883, 5470,
+	5069, 4681, 4305, 3940, 3585, 3240, 2905, 2579,
+	2262, 1954, 1653, 1360, 1075, 796, 524, 259,
+	0,
+};
+
+// Periodic Hann window, Q15
+const int16_t hannWindow[HANN_WINDOW_LEN] = {
+	0, 20, 79, 177, 315, 491, 705, 958,
+	1247, 1573, 1935, 2331, 2761, 3224, 3719, 4244,
+	4799, 5381, 5990, 6624, 7282, 7961, 8661, 9379,
+	10114, 10864, 11628, 12403, 13188, 13980, 14778, 15580,
+	16384, 17188, 17990, 18788, 19580, 20365, 21140, 21904,
+	22654, 23389, 24107, 24807, 25486, 26144, 26778, 27387,
+	27969, 28524, 29049, 29544, 30007, 30437, 30833, 31195,
+	31521, 31810, 32063, 32277, 32453, 32591, 32689, 32748,
+	32767, 32748, 32689, 32591, 32453, 32277, 32063, 31810,
+	31521, 31195, 30833, 30437, 30007, 29544, 29049, 28524,
+	27969, 27387, 26778, 26144, 25486, 24807, 24107, 23389,
+	22654, 21904, 21140, 20365, 19580, 18788, 17990, 17188,
+	16384, 15580, 14778, 13980, 13188, 12403, 11628, 10864,
+	10114, 9379, 8661, 7961, 7282, 6624, 5990, 5381,
+	4799, 4244, 3719, 3224, 2761, 2331, 1935, 1573,
+	1247, 958, 705, 491, 315, 177, 79, 20,
+};
+
+// RBJ notches, Q 4 at 1000 Hz, {b0, 0, b1, b2, -a1, -a2} in Q14
+const int16_t notchCoefficients[NOTCH_BINS][6] = {
+	{ 16131, 0, -32008, 16131, 32008, -15879 },  // 20 Hz
+	{ 16070, 0, -31744, 16070, 31744, -15756 },  // 25 Hz
+	{ 16009, 0, -31451, 16009, 31451, -15634 },  // 30 Hz
+	{ 15949, 0, -31130, 15949, 31130, -15514 },  // 35 Hz
+	{ 15890, 0, -30782, 15890, 30782, -15396 },  // 40 Hz
+	{ 15832, 0, -30407, 15832, 30407, -15280 },  // 45 Hz
+	{ 15775, 0, -30005, 15775, 30005, -15165 },  // 50 Hz
+	{ 15718, 0, -29578, 15718, 29578, -15053 },  // 55 Hz
+	{ 15663, 0, -29127, 15663, 29127, -14942 },  // 60 Hz
+	{ 15609, 0, -28651, 15609, 28651, -14834 },  // 65 Hz
+	{ 15556, 0, -28151, 15556, 28151, -14728 },  // 70 Hz
+	{ 15504, 0, -27629, 15504, 27629, -14624 },  // 75 Hz
+	{ 15453, 0, -27084, 15453, 27084, -14523 },  // 80 Hz
+	{ 15404, 0, -26517, 15404, 26517, -14424 },  // 85 Hz
+	{ 15356, 0, -25930, 15356, 25930, -14327 },  // 90 Hz
+	{ 15308, 0, -25323, 15308, 25323, -14233 },  // 95 Hz
+	{ 15263, 0, -24695, 15263, 24695, -14141 },  // 100 Hz
+	{ 15218, 0, -24049, 15218, 24049, -14052 },  // 105 Hz
+	{ 15175, 0, -23385, 15175, 23385, -13966 },  // 110 Hz
+	{ 15133, 0, -22703, 15133, 22703, -13882 },  // 115 Hz
+	{ 15093, 0, -22004, 15093, 22004, -13801 },  // 120 Hz
+	{ 15053, 0, -21289, 15053, 21289, -13723 },  // 125 Hz
+	{ 15016, 0, -20558, 15016, 20558, -13647 },  // 130 Hz
+	{ 14979, 0, -19812, 14979, 19812, -13575 },  // 135 Hz
+	{ 14945, 0, -19052, 14945, 19052, -13505 },  // 140 Hz
+	{ 14911, 0, -18278, 14911, 18278, -13438 },  // 145 Hz
+	{ 14879, 0, -17492, 14879, 17492, -13375 },  // 150 Hz
+	{ 14849, 0, -16693, 14849, 16693, -13314 },  // 155 Hz
+	{ 14820, 0, -15882, 14820, 15882, -13256 },  // 160 Hz
+	{ 14792, 0, -15060, 14792, 15060, -13201 },  // 165 Hz
+	{ 14767, 0, -14228, 14767, 14228, -13149 },  // 170 Hz
+	{ 14742, 0, -13386, 14742, 13386, -13100 },  // 175 Hz
+	{ 14719, 0, -12534, 14719, 12534, -13054 },  // 180 Hz
+	{ 14698, 0, -11674, 14698, 11674, -13012 },  // 185 Hz
+	{ 14678, 0, -10807, 14678, 10807, -12972 },  // 190 Hz
+	{ 14660, 0, -9932, 14660, 9932, -12936 },  // 195 Hz
+	{ 14643, 0, -9050, 14643, 9050, -12902 },  // 200 Hz
+	{ 14628, 0, -8162, 14628, 8162, -12872 },  // 205 Hz
+	{ 14615, 0, -7269, 14615, 7269, -12845 },  // 210 Hz
+	{ 14603, 0, -6371, 14603, 6371, -12821 },  // 215 Hz
+	{ 14592, 0, -5469, 14592, 5469, -12801 },  // 220 Hz
+	{ 14584, 0, -4563, 14584, 4563, -12783 },  // 225 Hz
+	{ 14576, 0, -3654, 14576, 3654, -12769 },  // 230 Hz
+	{ 14571, 0, -2742, 14571, 2742, -12757 },  // 235 Hz
+	{ 14567, 0, -1829, 14567, 1829, -12749 },  // 240 Hz
+	{ 14564, 0, -915, 14564, 915, -12745 },  // 245 Hz
+	{ 14564, 0, 0, 14564, 0, -12743 },  // 250 Hz
+	{ 14564, 0, 915, 14564, -915, -12745 },  // 255 Hz
+	{ 14567, 0, 1829, 14567, -1829, -12749 },  // 260 Hz
+	{ 14571, 0, 2742, 14571, -2742, -12757 },  // 265 Hz
+	{ 14576, 0, 3654, 14576, -3654, -12769 },  // 270 Hz
+	{ 14584, 0, 4563, 14584, -4563, -12783 },  // 275 Hz
+	{ 14592, 0, 5469, 14592, -5469, -12801 },  // 280 Hz
+	{ 14603, 0, 6371, 14603, -6371, -12821 },  // 285 Hz
+	{ 14615, 0, 7269, 14615, -7269, -12845 },  // 290 Hz
+	{ 14628, 0, 8162, 14628, -8162, -12872 },  // 295 Hz
+	{ 14643, 0, 9050, 14643, -9050, -12902 },  // 300 Hz
+	{ 14660, 0, 9932, 14660, -9932, -12936 },  // 305 Hz
+	{ 14678, 0, 10807, 14678, -10807, -12972 },  // 310 Hz
+	{ 14698, 0, 11674, 14698, -11674, -13012 },  // 315 Hz
+	{ 14719, 0, 12534, 14719, -12534, -13054 },  // 320 Hz
+	{ 14742, 0, 13386, 14742, -13386, -13100 },  // 325 Hz
+	{ 14767, 0, 14228, 14767, -14228, -13149 },  // 330 Hz
+	{ 14792, 0, 15060, 14792, -15060, -13201 },  // 335 Hz
+	{ 14820, 0, 15882, 14820, -15882, -13256 },  // 340 Hz
+	{ 14849, 0, 16693, 14849, -16693, -13314 },  // 345 Hz
+	{ 14879, 0, 17492, 14879, -17492, -13375 },  // 350 Hz
+	{ 14911, 0, 18278, 14911, -18278, -13438 },  // 355 Hz
+	{ 14945, 0, 19052, 14945, -19052, -13505 },  // 360 Hz
+	{ 14979, 0, 19812, 14979, -19812, -13575 },  // 365 Hz
+	{ 15016, 0, 20558, 15016, -20558, -13647 },  // 370 Hz
+	{ 15053, 0, 21289, 15053, -21289, -13723 },  // 375 Hz
+	{ 15093, 0, 22004, 15093, -22004, -13801 },  // 380 Hz
+	{ 15133, 0, 22703, 15133, -22703, -13882 },  // 385 Hz
+	{ 15175, 0, 23385, 15175, -23385, -13966 },  // 390 Hz
+	{ 15218, 0, 24049, 15218, -24049, -14052 },  // 395 Hz
+	{ 15263, 0, 24695, 15263, -24695, -14141 },  // 400 Hz
+	{ 15308, 0, 25323, 15308, -25323, -14233 },  // 405 Hz
+	{ 15356, 0, 25930, 15356, -25930, -14327 },  // 410 Hz
+	{ 15404, 0, 26517, 15404, -26517, -14424 },  // 415 Hz
+	{ 15453, 0, 27084, 15453, -27084, -14523 },  // 420 Hz
+	{ 15504, 0, 27629, 15504, -27629, -14624 },  // 425 Hz
+	{ 15556, 0, 28151, 15556, -28151, -14728 },  // 430 Hz
+	{ 15609, 0, 28651, 15609, -28651, -14834 },  // 435 Hz
+	{ 15663, 0, 29127, 15663, -29127, -14942 },  // 440 Hz
+	{ 15718, 0, 29578, 15718, -29578, -15053 },  // 445 Hz
+	{ 15775, 0, 30005, 15775, -30005, -15165 },  // 450 Hz
+};
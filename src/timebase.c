@@ -0,0 +1,60 @@
+/************************************************************
+*
+* @file:      timebase.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     SysTick based system tick shared by all tasks
+*
+*             SysTick only counts and pends PendSV; the control
+*             task runs from PendSV so any background work in the
+*             main loop, however long, is preempted on time. A
+*             control tick still pending when the next SysTick
+*             arrives collapses into one, so a late tick is
+*             skipped, not replayed.
+*
+************************************************************/
+
+#include "timebase.h"
+
+volatile uint32_t tickCount = 0;
+static volatile uint8_t controlEnabled = 0;
+
+/************************************************************
+*
+* Function: timebaseInit
+* @brief:   start SysTick at TICK_RATE_HZ from the core clock
+*
+************************************************************/
+void timebaseInit(void) {
+	tickCount = 0;
+	controlEnabled = 0;
+	SysTick_Config(SystemCoreClock / TICK_RATE_HZ);
+	NVIC_SetPriority(SysTick_IRQn, TICK_IRQ_PRIORITY);
+	NVIC_SetPriority(PendSV_IRQn, CONTROL_IRQ_PRIORITY);
+}
+
+/************************************************************
+*
+* Function: timebaseStartControl
+* @brief:   start running controlTick, call once every module
+*           it touches is initialized
+*
+************************************************************/
+void timebaseStartControl(void) {
+	controlEnabled = 1;
+}
+
+/************************************************************
+*
+* Function: timebaseTick
+* @brief:   advance the tick and request a control tick, called
+*           from SysTick_Handler
+*
+************************************************************/
+void timebaseTick(void) {
+	tickCount++;
+	if (controlEnabled) {
+		SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+	}
+}
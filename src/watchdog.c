@@ -0,0 +1,111 @@
+/************************************************************
+*
+* @file:      watchdog.c
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     IWDG supervisor feeding the watchdog only while
+*             every registered task checks in on time
+*
+************************************************************/
+
+#include "watchdog.h"
+
+watchdogTask_t watchdogTasks[WATCHDOG_MAX_TASKS];
+
+static volatile uint8_t taskCount = 0;
+static volatile uint8_t failedTask = WATCHDOG_NO_TASK;
+static uint8_t lastFailure = WATCHDOG_NO_TASK;
+
+/************************************************************
+*
+* Function: watchdogInit
+* @brief:   read back the task that caused the previous IWDG
+*           reset, then start the IWDG from LSI
+*
+************************************************************/
+void watchdogInit(void) {
+	uint32_t record;
+
+	// LSI clocks both the IWDG and the RTC domain holding the backup registers
+	RCC_LSICmd(ENABLE);
+	while (RCC_GetFlagStatus(RCC_FLAG_LSIRDY) == RESET);
+
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_PWR, ENABLE);
+	PWR_BackupAccessCmd(ENABLE);
+	RCC_RTCCLKConfig(RCC_RTCCLKSource_LSI);
+	RCC_RTCCLKCmd(ENABLE);
+
+	record = RTC_ReadBackupRegister(WATCHDOG_BKP_REG);
+	if (RCC_GetFlagStatus(RCC_FLAG_IWDGRST) != RESET
+			&& (record & 0xFFFF0000) == WATCHDOG_BKP_MAGIC) {
+		lastFailure = (uint8_t) record;
+	}
+	RTC_WriteBackupRegister(WATCHDOG_BKP_REG, 0);
+	RCC_ClearFlag();
+
+	// LSI ~40 kHz / 32 = 1.25 kHz, 0.8 ms per count
+	IWDG_WriteAccessCmd(IWDG_WriteAccess_Enable);
+	IWDG_SetPrescaler(IWDG_Prescaler_32);
+	IWDG_SetReload(WATCHDOG_TIMEOUT_MS * 5 / 4);
+	IWDG_ReloadCounter();
+	IWDG_Enable();
+}
+
+/************************************************************
+*
+* Function: watchdogRegister
+* @brief:   add a task that must check in at least every
+*           deadline ticks, the task counts as alive right now
+* @param:   deadline, uint32_t, max ticks between check ins
+* @return:  uint8_t, task id, WATCHDOG_NO_TASK if table is full
+*
+************************************************************/
+uint8_t watchdogRegister(uint32_t deadline) {
+	uint8_t id = taskCount;
+
+	if (id >= WATCHDOG_MAX_TASKS) {
+		return WATCHDOG_NO_TASK;
+	}
+	watchdogTasks[id].deadline = deadline;
+	watchdogTasks[id].lastCheckIn = tickCount;
+	taskCount = id + 1;
+	return id;
+}
+
+/************************************************************
+*
+* Function: watchdogService
+* @brief:   called from SysTick, feeds the IWDG only if no task
+*           overran its deadline; the first late task is saved
+*           to the backup register and the IWDG is left to bite
+*
+************************************************************/
+void watchdogService(void) {
+	uint32_t now = tickCount;
+	uint8_t i;
+
+	if (failedTask != WATCHDOG_NO_TASK) {
+		return;
+	}
+	for (i = 0; i < taskCount; i++) {
+		if (now - watchdogTasks[i].lastCheckIn > watchdogTasks[i].deadline) {
+			failedTask = i;
+			RTC_WriteBackupRegister(WATCHDOG_BKP_REG, WATCHDOG_BKP_MAGIC | i);
+			return;
+		}
+	}
+	IWDG_ReloadCounter();
+}
+
+/************************************************************
+*
+* Function: watchdogLastFailure
+* @brief:   task that missed its deadline before the last reset
+* @return:  uint8_t, task id, WATCHDOG_NO_TASK if the last reset
+*           was not caused by the supervisor
+*
+************************************************************/
+uint8_t watchdogLastFailure(void) {
+	return lastFailure;
+}
@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+"""Biquad coefficients for the IMU filter stage (src/imu_filter.c).
+
+Designs RBJ cookbook low-pass and notch sections and prints them in the
+arm_biquad_cascade_df1_q15 layout {b0, 0, b1, b2, -a1, -a2}. Values are
+Q14 for postShift = 1, which allows coefficients in [-2, 2).
+
+    python3 tools/design_biquad.py --fs 1000 lowpass:40 notch:120:4
+
+Prints one filter. Each section is lowpass:FC[:Q] or notch:F0[:Q]. The
+adaptive notch's table of one notch per centre frequency is part of
+src/tables.c, written by tools/gen_tables.py --notch with notch() and
+quantize() from here.
+"""
+
+import argparse
+import math
+
+POST_SHIFT = 1
+SCALE = 1 << (15 - POST_SHIFT)
+
+
+def lowpass(fs, fc, q=1 / math.sqrt(2)):
+    w0 = 2 * math.pi * fc / fs
+    alpha = math.sin(w0) / (2 * q)
+    cosw = math.cos(w0)
+    b = [(1 - cosw) / 2, 1 - cosw, (1 - cosw) / 2]
+    a = [1 + alpha, -2 * cosw, 1 - alpha]
+    return b, a
+
+
+def notch(fs, f0, q=4.0):
+    w0 = 2 * math.pi * f0 / fs
+    alpha = math.sin(w0) / (2 * q)
+    cosw = math.cos(w0)
+    b = [1, -2 * cosw, 1]
+    a = [1 + alpha, -2 * cosw, 1 - alpha]
+    return b, a
+
+
+def quantize(b, a):
+    """Normalize by a0 and convert to the CMSIS q15 DF1 layout."""
+    values = [b[0] / a[0], 0.0, b[1] / a[0], b[2] / a[0], -a[1] / a[0], -a[2] / a[0]]
+    out = []
+    for v in values:
+        q = int(round(v * SCALE))
+        if not -32768 <= q <= 32767:
+            raise SystemExit("coefficient %.4f does not fit Q14" % v)
+        out.append(q)
+    return out
+
+
+def section(fs, spec):
+    kind, *params = spec.split(":")
+    params = [float(p) for p in params]
+    if kind == "lowpass":
+        return quantize(*lowpass(fs, *params))
+    if kind == "notch":
+        return quantize(*notch(fs, *params))
+    raise SystemExit("unknown section " + spec)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--fs", type=float, default=1000.0, help="sample rate (Hz)")
+    parser.add_argument("sections", nargs="+")
+    args = parser.parse_args()
+
+    for spec in args.sections:
+        print("\t%s,  // %s" % (", ".join(str(v) for v in section(args.fs, spec)), spec))
+
+
+if __name__ == "__main__":
+    main()
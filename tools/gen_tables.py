@@ -0,0 +1,213 @@
+#!/usr/bin/env python3
+"""Constant lookup tables for the firmware (inc/tables.h, src/tables.c).
+
+Every table the kernels index at run time is generated here and lands
+in flash as const data; nothing is computed at boot. Host and target
+builds compile the same generated source, so host tests see exactly
+the bytes the target runs on.
+
+    python3 tools/gen_tables.py
+    python3 tools/gen_tables.py --rsqrt-bits 7 --hann-len 512
+    python3 tools/gen_tables.py --check
+
+Each option sets one table's resolution. Its numeric format is fixed
+by the kernel that reads it and is stated in the table's comment; the
+sizes are exported as macros so those kernels follow a resize.
+--check regenerates in memory and fails if the checked in files
+differ, e.g. after a hand edit; pass it the options recorded in the
+files' header.
+"""
+
+import argparse
+import math
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import design_biquad  # noqa: E402
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+HEADER_PATH = os.path.join("inc", "tables.h")
+SOURCE_PATH = os.path.join("src", "tables.c")
+PER_ROW = 8
+
+FILE_BLOCK = """/************************************************************
+*
+* @file:      %s
+* @author:    Weili An
+* @version:   v1.0.0
+* @date:      Oct. 19th, 2026
+* @brief:     %s
+*
+*             Generated, do not edit; rerun%s
+*             or pass --check to verify.
+*
+************************************************************/
+"""
+
+
+class Table:
+    def __init__(self, name, ctype, dims, values, comment, labels=None):
+        self.name = name
+        self.ctype = ctype
+        self.dims = dims
+        self.values = values
+        self.comment = comment
+        self.labels = labels
+
+    def declaration(self):
+        return "extern const %s %s%s;" % (self.ctype, self.name,
+                                          "".join("[%s]" % d for d in self.dims))
+
+    def definition(self):
+        lines = ["// " + line for line in self.comment]
+        lines.append("const %s %s%s = {" % (self.ctype, self.name,
+                                             "".join("[%s]" % d for d in self.dims)))
+        if self.labels:
+            for row, label in zip(self.values, self.labels):
+                lines.append("\t{ %s },  // %s" % (", ".join(str(v) for v in row), label))
+        else:
+            for i in range(0, len(self.values), PER_ROW):
+                lines.append("\t" + ", ".join(str(v) for v in self.values[i:i + PER_ROW]) + ",")
+        lines.append("};")
+        return "\n".join(lines)
+
+
+def check_range(name, values, low, high):
+    for v in values:
+        if not low <= v <= high:
+            raise SystemExit("%s: %d does not fit [%d, %d]" % (name, v, low, high))
+
+
+def divide_reciprocal(bits):
+    """Q31 reciprocal over [2^15, 2^16), offset by 2^15 into 16 bits.
+
+    Exact integer ceiling, divideReciprocal relies on never reading low.
+    """
+    step = 1 << (15 - bits)
+    values = [-(-(1 << 31) // ((1 << 15) + i * step)) - (1 << 15) for i in range((1 << bits) + 1)]
+    check_range("divideReciprocalTable", values, 0, 0xFFFF)
+    comment = ["2^31 / (2^15 + %d i) - 2^15, rounded up" % step]
+    return Table("divideReciprocalTable", "uint16_t", ["DIVIDE_LUT_SIZE"], values, comment)
+
+
+def atan_cordic(steps):
+    """Q31 fractions of pi, one per CORDIC rotation."""
+    values = [round(math.atan(2.0 ** -i) / math.pi * 2 ** 31) for i in range(steps)]
+    comment = ["round(atan(2^-i) / pi * 2^31)"]
+    return Table("atanCordicTable", "int32_t", ["ATAN_CORDIC_STEPS"], values, comment)
+
+
+def rsqrt_seed(bits):
+    """Q15 1/sqrt(a) - 2^15 over a in [1/4, 1), 3 * 2^(bits - 2) intervals."""
+    count = 3 << (bits - 2)
+    values = [round(2 ** 15 / math.sqrt(0.25 + i / 2 ** bits)) - 2 ** 15 for i in range(count + 1)]
+    check_range("rsqrtSeedTable", values, 0, 0xFFFF)
+    comment = ["round(2^15 / sqrt(1/4 + i / %d)) - 2^15" % (1 << bits)]
+    return Table("rsqrtSeedTable", "uint16_t", ["RSQRT_LUT_SIZE"], values, comment)
+
+
+def hann(length):
+    """Periodic Hann window in Q15, the peak saturates to 32767."""
+    values = [min(round(32768 * 0.5 * (1 - math.cos(2 * math.pi * i / length))), 32767)
+              for i in range(length)]
+    comment = ["Periodic Hann window, Q15"]
+    return Table("hannWindow", "int16_t", ["HANN_WINDOW_LEN"], values, comment)
+
+
+def notch_table(fs, first, last, step, q):
+    """CMSIS DF1 notch sections in Q14, one per centre frequency."""
+    freqs = list(range(first, last + 1, step))
+    rows = [design_biquad.quantize(*design_biquad.notch(fs, f, q)) for f in freqs]
+    comment = ["RBJ notches, Q %g at %d Hz, {b0, 0, b1, b2, -a1, -a2} in Q14" % (q, fs)]
+    return Table("notchCoefficients", "int16_t", ["NOTCH_BINS", "6"], rows, comment,
+                 ["%d Hz" % f for f in freqs])
+
+
+def render(args, command):
+    tables = [
+        divide_reciprocal(args.divide_bits),
+        atan_cordic(args.cordic_steps),
+        rsqrt_seed(args.rsqrt_bits),
+        hann(args.hann_len),
+        notch_table(*args.notch, args.notch_q),
+    ]
+    fs, first, last, step = args.notch
+    defines = [
+        ("DIVIDE_LUT_BITS", args.divide_bits, "divide.h reciprocal, 2^bits intervals"),
+        ("DIVIDE_LUT_SIZE", "((1 << DIVIDE_LUT_BITS) + 1)", None),
+        ("ATAN_CORDIC_STEPS", args.cordic_steps, "fastmath.h atan2Q31 rotations"),
+        ("RSQRT_LUT_BITS", args.rsqrt_bits, "fastmath.h rsqrt seed, index bits"),
+        ("RSQRT_LUT_SIZE", "((3 << (RSQRT_LUT_BITS - 2)) + 1)", None),
+        ("HANN_WINDOW_LEN", args.hann_len, "spectrum.c window"),
+        ("NOTCH_SAMPLE_HZ", fs, "adaptive_notch.c bins"),
+        ("NOTCH_FIRST_HZ", first, None),
+        ("NOTCH_LAST_HZ", last, None),
+        ("NOTCH_STEP_HZ", step, None),
+        ("NOTCH_BINS", "((NOTCH_LAST_HZ - NOTCH_FIRST_HZ) / NOTCH_STEP_HZ + 1)", None),
+        ("NOTCH_Q", "%g" % args.notch_q, None),
+    ]
+    invocation = ":\n*             " + command + ","
+
+    header = [FILE_BLOCK % ("tables.h", "Sizes and declarations of the const lookup tables",
+                            invocation),
+              "#ifndef __TABLES_H__", "#define __TABLES_H__", "", "#include <stdint.h>", ""]
+    for name, value, comment in defines:
+        if comment:
+            header.append("// " + comment)
+        header.append("#define %-27s %s" % (name, value))
+    header.append("")
+    header.extend(table.declaration() for table in tables)
+    header.extend(["", "#endif", ""])
+
+    source = [FILE_BLOCK % ("tables.c", "Const lookup tables, placed in flash", invocation),
+              '#include "tables.h"', ""]
+    for table in tables:
+        source.append(table.definition())
+        source.append("")
+    return "\n".join(header), "\n".join(source)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--divide-bits", type=int, default=8, help="reciprocal index bits")
+    parser.add_argument("--cordic-steps", type=int, default=28, help="atan2Q31 rotations")
+    parser.add_argument("--rsqrt-bits", type=int, default=6, help="rsqrt seed index bits")
+    parser.add_argument("--hann-len", type=int, default=128, help="spectrum window length")
+    parser.add_argument("--notch", default="1000:20:450:5", help="FS:F_FIRST:F_LAST:F_STEP (Hz)")
+    parser.add_argument("--notch-q", type=float, default=4.0, help="notch Q")
+    parser.add_argument("--check", action="store_true", help="compare instead of writing")
+    args = parser.parse_args()
+    args.notch = [int(v) for v in args.notch.split(":")]
+    if not 1 <= args.divide_bits <= 15:
+        raise SystemExit("--divide-bits must be 1 .. 15")
+    if not 2 <= args.rsqrt_bits <= 10:
+        raise SystemExit("--rsqrt-bits must be 2 .. 10")
+
+    # The files record every parameter, so they can be reproduced as is
+    command = ("tools/gen_tables.py --divide-bits %d --cordic-steps %d --rsqrt-bits %d"
+               "\n*             --hann-len %d --notch %s --notch-q %g"
+               % (args.divide_bits, args.cordic_steps, args.rsqrt_bits, args.hann_len,
+                  ":".join(str(v) for v in args.notch), args.notch_q))
+    outputs = dict(zip((HEADER_PATH, SOURCE_PATH), render(args, command)))
+
+    stale = []
+    for path, text in outputs.items():
+        full = os.path.join(ROOT, path)
+        if args.check:
+            try:
+                with open(full) as f:
+                    if f.read() != text:
+                        stale.append(path)
+            except FileNotFoundError:
+                stale.append(path)
+        else:
+            with open(full, "w") as f:
+                f.write(text)
+    if stale:
+        raise SystemExit("out of date: %s" % ", ".join(stale))
+
+
+if __name__ == "__main__":
+    main()
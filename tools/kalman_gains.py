@@ -0,0 +1,41 @@
+#!/usr/bin/env python3
+"""Steady state gains for the two state tilt Kalman filter (src/kalman.c).
+
+Model per sample: angle' = angle + rate - bias, bias' = bias, measured
+angle = angle. Iterates the Riccati recursion to its fixed point and
+prints the gains in Q31.
+
+    python3 tools/kalman_gains.py Q_ANGLE Q_BIAS R
+"""
+
+import sys
+
+
+def steady_state(q_angle, q_bias, r, iterations=200000):
+    p00, p01, p10, p11 = 1.0, 0.0, 0.0, 1.0
+    k0 = k1 = 0.0
+    for _ in range(iterations):
+        # Predict with F = [1 -1; 0 1]
+        a00 = p00 - p10 - p01 + p11 + q_angle
+        a01 = p01 - p11
+        a10 = p10 - p11
+        a11 = p11 + q_bias
+        # Correct with H = [1 0]
+        s = a00 + r
+        k0, k1 = a00 / s, a10 / s
+        p00, p01 = (1 - k0) * a00, (1 - k0) * a01
+        p10, p11 = a10 - k1 * a00, a11 - k1 * a01
+    return k0, k1
+
+
+def main():
+    if len(sys.argv) != 4:
+        sys.exit(__doc__)
+    q_angle, q_bias, r = (float(arg) for arg in sys.argv[1:])
+    k0, k1 = steady_state(q_angle, q_bias, r)
+    print("K0 = %.9g  K1 = %.9g" % (k0, k1))
+    print("{ %d, %d }" % (round(k0 * 2 ** 31), round(k1 * 2 ** 31)))
+
+
+if __name__ == "__main__":
+    main()
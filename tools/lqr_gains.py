@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+"""Offline LQR gains for the balance controller (src/lqr.c).
+
+Linearized wheeled inverted pendulum driven by wheel acceleration a:
+
+    tilt'' = (g * tilt - a) / l      x'' = a
+
+with state (tilt, tilt rate, wheel position, wheel velocity). The model
+is discretized at the control rate, the DARE is solved by structured
+doubling, and K is scaled into the Q15 state and output units from
+inc/lqr.h.
+
+    python3 tools/lqr_gains.py [--l 0.12] [--wheel 0.065] [--rate 1000]
+                               [--q 100,1,10,1] [--r 1]
+"""
+
+import argparse
+import math
+
+# Must match inc/stepper.h and inc/lqr.h
+STEPS_PER_REV = 3200
+POS_SHIFT = 2
+ACCEL_FULL_SCALE = 128000       # steps/s^2 at u = 1.0
+GAIN_SHIFT = 4
+GYRO_FULL_SCALE = 32768 / 65.5  # deg/s at x = 1.0
+
+
+def matmul(a, b):
+    return [[sum(a[i][k] * b[k][j] for k in range(len(b)))
+             for j in range(len(b[0]))] for i in range(len(a))]
+
+
+def add(a, b):
+    return [[a[i][j] + b[i][j] for j in range(len(a[0]))] for i in range(len(a))]
+
+
+def scale(a, s):
+    return [[v * s for v in row] for row in a]
+
+
+def transpose(a):
+    return [list(row) for row in zip(*a)]
+
+
+def identity(n):
+    return [[1.0 if i == j else 0.0 for j in range(n)] for i in range(n)]
+
+
+def inverse(a):
+    n = len(a)
+    m = [row[:] + ident for row, ident in zip(a, identity(n))]
+    for col in range(n):
+        pivot = max(range(col, n), key=lambda r: abs(m[r][col]))
+        m[col], m[pivot] = m[pivot], m[col]
+        p = m[col][col]
+        m[col] = [v / p for v in m[col]]
+        for r in range(n):
+            if r != col:
+                f = m[r][col]
+                m[r] = [v - f * w for v, w in zip(m[r], m[col])]
+    return [row[n:] for row in m]
+
+
+def discretize(a, b, dt, terms=12):
+    """Zero order hold by truncated series: Ad = e^(A dt), Bd = int e^(A t) dt B."""
+    n = len(a)
+    ad = identity(n)
+    integral = scale(identity(n), dt)
+    power = identity(n)
+    for k in range(1, terms):
+        power = scale(matmul(power, a), dt / k)
+        ad = add(ad, power)
+        integral = add(integral, scale(power, dt / (k + 1)))
+    return ad, matmul(integral, b)
+
+
+def dare(a, b, q, r, iterations=60):
+    """Structured doubling algorithm for the discrete algebraic Riccati equation."""
+    n = len(a)
+    g = scale(matmul(b, transpose(b)), 1.0 / r)
+    h = q
+    for _ in range(iterations):
+        w = inverse(add(identity(n), matmul(g, h)))
+        a_next = matmul(matmul(a, w), a)
+        g = add(g, matmul(matmul(matmul(a, w), g), transpose(a)))
+        h = add(h, matmul(matmul(matmul(transpose(a), h), w), a))
+        a = a_next
+    return h
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--l", type=float, default=0.12, help="axle to centre of mass (m)")
+    parser.add_argument("--wheel", type=float, default=0.065, help="wheel diameter (m)")
+    parser.add_argument("--rate", type=float, default=1000.0, help="control rate (Hz)")
+    parser.add_argument("--q", default="100,1,10,1", help="state weights")
+    parser.add_argument("--r", type=float, default=1.0, help="input weight")
+    args = parser.parse_args()
+
+    g = 9.81
+    a = [[0, 1, 0, 0], [g / args.l, 0, 0, 0], [0, 0, 0, 1], [0, 0, 0, 0]]
+    b = [[0], [-1 / args.l], [0], [1]]
+    weights = [float(v) for v in args.q.split(",")]
+    q = [[weights[i] if i == j else 0.0 for j in range(4)] for i in range(4)]
+
+    ad, bd = discretize(a, b, 1.0 / args.rate)
+    p = dare(ad, bd, q, args.r)
+    btp = matmul(transpose(bd), p)
+    k = scale(matmul(btp, ad), 1.0 / (args.r + matmul(btp, bd)[0][0]))[0]
+
+    # Physical value of a Q15 full scale state / output
+    step = math.pi * args.wheel / STEPS_PER_REV
+    state_scale = [math.pi, math.radians(GYRO_FULL_SCALE),
+                   32768 * (1 << POS_SHIFT) * step, 32768 * step]
+    out_scale = ACCEL_FULL_SCALE * step
+
+    print("K (SI) = [%s]" % ", ".join("%.5g" % v for v in k))
+    gains = []
+    for ki, si in zip(k, state_scale):
+        value = round(ki * si / out_scale * (1 << (15 - GAIN_SHIFT)))
+        if not -32768 <= value <= 32767:
+            raise SystemExit("gain %.3g overflows, raise LQR_GAIN_SHIFT" % (ki * si / out_scale))
+        gains.append(value)
+    print("{ { %s } }" % ", ".join(str(v) for v in gains))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+"""Perfect hash seeds for the console tables (src/shell.c, src/main.c).
+
+Searches for the first seed that puts the FNV-1a hash of every name in
+a slot of its own in a table of 2^bits slots, the same hash as
+shellHash, and prints the seed and the slot of each name for the
+table's designated initializers. Rerun it whenever a name is added,
+removed or renamed.
+
+    python3 tools/shell_hash.py --bits 5 gain ctrl spec ...
+"""
+
+import argparse
+import sys
+
+FNV_PRIME = 16777619
+MAX_SEEDS = 1 << 24
+
+
+def shell_hash(name, seed, bits):
+    value = seed
+    for byte in name.encode("ascii"):
+        value = ((value ^ byte) * FNV_PRIME) & 0xFFFFFFFF
+    return value >> (32 - bits)
+
+
+def find_seed(names, bits):
+    for seed in range(MAX_SEEDS):
+        slots = {shell_hash(name, seed, bits) for name in names}
+        if len(slots) == len(names):
+            return seed
+    return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--bits", type=int, required=True, help="log2 of the table size, 1 .. 8")
+    parser.add_argument("names", nargs="+")
+    args = parser.parse_args()
+
+    if not 1 <= args.bits <= 8 or len(args.names) > 1 << args.bits:
+        sys.exit("names do not fit in 2^%d slots" % args.bits)
+    if len(set(args.names)) != len(args.names):
+        sys.exit("duplicate names")
+    seed = find_seed(args.names, args.bits)
+    if seed is None:
+        sys.exit("no seed below %d, try one more bit" % MAX_SEEDS)
+    print("seed 0x%08X, %d of %d slots" % (seed, len(args.names), 1 << args.bits))
+    for name in sorted(args.names, key=lambda name: shell_hash(name, seed, args.bits)):
+        print("\t[%d] = \"%s\"" % (shell_hash(name, seed, args.bits), name))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""Decode and plot spectrum frames sent after a "spec" console command
+(src/spectrum.c).
+
+Reads a raw capture file, or a serial port when pyserial is installed,
+skips console text between frames and prints every valid frame as
+frequency / amplitude pairs with a text bar graph. Amplitudes are in
+raw sensor counts of a sine at the bin centre. With --plot and
+matplotlib installed the last frame is also drawn.
+
+    python3 tools/spectrum_decode.py capture.bin
+    python3 tools/spectrum_decode.py --port /dev/ttyUSB0 --axis 4 --average 3
+"""
+
+import argparse
+import struct
+import sys
+
+SYNC = b"\xa5\x5a"
+FRAME_TYPE = ord("S")
+HEADER = struct.Struct("<BBBBHH")
+AXES = ["accel x", "accel y", "accel z", "gyro x", "gyro y", "gyro z"]
+# Hann window, rfft 1/N and magnitude 1/2: sine amplitude A peaks at A / 8
+HANN_PEAK_GAIN = 8.0
+ACC_SHIFT = 8
+
+
+def parse_frames(data):
+    """Yield (axis, averages, rate, amplitudes) for each valid frame."""
+    index = 0
+    while True:
+        index = data.find(SYNC, index)
+        if index < 0 or index + 2 + HEADER.size > len(data):
+            return
+        body = index + 2
+        kind, axis, averages, exponent, length, rate = HEADER.unpack_from(data, body)
+        size = HEADER.size + 2 * (length // 2) + 1
+        if kind != FRAME_TYPE or length == 0 or body + size > len(data):
+            index += 1
+            continue
+        if sum(data[body:body + size - 1]) & 0xFF != data[body + size - 1]:
+            index += 1
+            continue
+        bins = struct.unpack_from("<%dH" % (length // 2), data, body + HEADER.size)
+        scale = HANN_PEAK_GAIN * (1 << exponent) / (1 << ACC_SHIFT)
+        yield axis, averages, length, rate, [value * scale for value in bins]
+        index = body + size
+
+
+def print_frame(axis, averages, length, rate, amplitudes, width=50):
+    name = AXES[axis] if axis < len(AXES) else str(axis)
+    print("%s, %d window(s) of %d at %d Hz" % (name, averages, length, rate))
+    largest = max(amplitudes[1:]) or 1.0
+    for index, amplitude in enumerate(amplitudes):
+        bar = "#" * int(round(width * amplitude / largest)) if index else ""
+        print("%7.1f Hz %10.2f %s" % (index * rate / length, amplitude, bar))
+
+
+def read_port(args):
+    try:
+        import serial
+    except ImportError:
+        sys.exit("--port needs pyserial")
+    with serial.Serial(args.port, args.baud, timeout=args.timeout) as port:
+        port.write(b"spec %d %d\r\n" % (args.axis, args.average))
+        data = b""
+        while True:
+            chunk = port.read(256)
+            if not chunk:
+                return data
+            data += chunk
+            if any(True for _ in parse_frames(data)):
+                return data
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture", nargs="?", help="raw bytes captured from the UART")
+    parser.add_argument("--port", help="serial port, sends the spec command itself")
+    parser.add_argument("--baud", type=int, default=3000000)
+    parser.add_argument("--timeout", type=float, default=5.0)
+    parser.add_argument("--axis", type=int, default=3, help="imuAxis_t, default gyro x")
+    parser.add_argument("--average", type=int, default=2, help="log2 of windows averaged")
+    parser.add_argument("--plot", action="store_true", help="draw with matplotlib")
+    args = parser.parse_args()
+
+    if args.port:
+        data = read_port(args)
+    elif args.capture:
+        with open(args.capture, "rb") as capture:
+            data = capture.read()
+    else:
+        data = sys.stdin.buffer.read()
+
+    frames = list(parse_frames(data))
+    if not frames:
+        sys.exit("no valid spectrum frame found")
+    for frame in frames:
+        print_frame(*frame)
+
+    if args.plot:
+        import matplotlib.pyplot as plt
+        axis, averages, length, rate, amplitudes = frames[-1]
+        plt.semilogy([index * rate / length for index in range(len(amplitudes))],
+                     [max(amplitude, 1e-3) for amplitude in amplitudes])
+        plt.xlabel("Hz")
+        plt.ylabel("amplitude, counts")
+        plt.title(AXES[axis] if axis < len(AXES) else str(axis))
+        plt.show()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,210 @@
+#!/usr/bin/env python3
+"""Fit a discrete time plant model to a "sysid" log (src/sysid.c).
+
+Frames are located in a raw UART capture, console text between them is
+skipped and a gap in the record sequence splits the log. The log is cut
+into segments; every HOLDOUT-th segment is held out and the rest are
+used for a least squares ARX fit
+
+    y[k] = -a1 y[k-1] - ... - a_na y[k-na]
+           + b1 u[k-nk] + ... + b_nb u[k-nk-nb+1]
+
+with u the applied wheel acceleration command and y the tilt or the raw
+gyro rate. The model is then simulated on every held out segment from
+the measured initial outputs, over HORIZON samples at a time since the
+open loop plant is unstable, and the fit is reported as
+100 * (1 - |y - y_sim| / |y - mean(y)|).
+
+    python3 tools/sysid_fit.py capture.bin --na 2 --nb 2 --nk 1
+"""
+
+import argparse
+import cmath
+import math
+import struct
+import sys
+
+SYNC = b"\xa5\x5a"
+FRAME_TYPE = ord("I")
+HEADER = struct.Struct("<BBH")
+RECORD = struct.Struct("<hhh")
+
+
+def parse_records(data):
+    """Return {sequence: (command, tilt, rate)} for every valid frame."""
+    records = {}
+    index = 0
+    while True:
+        index = data.find(SYNC, index)
+        if index < 0 or index + 2 + HEADER.size > len(data):
+            return records
+        body = index + 2
+        kind, count, first = HEADER.unpack_from(data, body)
+        size = HEADER.size + RECORD.size * count + 1
+        if kind != FRAME_TYPE or count == 0 or body + size > len(data) \
+                or sum(data[body:body + size - 1]) & 0xFF != data[body + size - 1]:
+            index += 1
+            continue
+        for offset in range(count):
+            records[(first + offset) & 0xFFFF] = RECORD.unpack_from(
+                data, body + HEADER.size + RECORD.size * offset)
+        index = body + size
+
+
+def contiguous_runs(records):
+    """Split records into runs of consecutive sequence numbers."""
+    runs = []
+    run = []
+    previous = None
+    # Sequence numbers wrap at 16 bits, follow the capture order
+    for sequence in records:
+        if previous is not None and sequence != (previous + 1) & 0xFFFF:
+            runs.append(run)
+            run = []
+        run.append(records[sequence])
+        previous = sequence
+    if run:
+        runs.append(run)
+    return runs
+
+
+def solve(matrix, vector):
+    """Gaussian elimination with partial pivoting."""
+    size = len(vector)
+    rows = [list(matrix[i]) + [vector[i]] for i in range(size)]
+    for column in range(size):
+        pivot = max(range(column, size), key=lambda row: abs(rows[row][column]))
+        if abs(rows[pivot][column]) < 1e-12:
+            sys.exit("regression is singular, is the excitation on?")
+        rows[column], rows[pivot] = rows[pivot], rows[column]
+        for row in range(column + 1, size):
+            factor = rows[row][column] / rows[column][column]
+            for k in range(column, size + 1):
+                rows[row][k] -= factor * rows[column][k]
+    solution = [0.0] * size
+    for row in reversed(range(size)):
+        total = rows[row][size] - sum(rows[row][k] * solution[k] for k in range(row + 1, size))
+        solution[row] = total / rows[row][row]
+    return solution
+
+
+def regressor(y, u, k, na, nb, nk):
+    return [-y[k - i] for i in range(1, na + 1)] + [u[k - nk - j] for j in range(nb)]
+
+
+def fit(segments, na, nb, nk):
+    order = na + nb
+    normal = [[0.0] * order for _ in range(order)]
+    target = [0.0] * order
+    start = max(na, nk + nb - 1)
+    for u, y in segments:
+        for k in range(start, len(y)):
+            phi = regressor(y, u, k, na, nb, nk)
+            for i in range(order):
+                target[i] += phi[i] * y[k]
+                for j in range(order):
+                    normal[i][j] += phi[i] * phi[j]
+    theta = solve(normal, target)
+    return theta[:na], theta[na:]
+
+
+def simulate(a, b, nk, u, y, horizon):
+    """Free run simulation restarted from measured outputs every horizon."""
+    na, nb = len(a), len(b)
+    start = max(na, nk + nb - 1)
+    predicted = list(y)
+    for k in range(start, len(y)):
+        if (k - start) % horizon == 0:
+            history = list(y)
+        value = sum(-a[i] * history[k - 1 - i] for i in range(na))
+        value += sum(b[j] * u[k - nk - j] for j in range(nb))
+        history[k] = value
+        predicted[k] = value
+    return predicted[start:], y[start:]
+
+
+def fit_percent(predicted, measured):
+    mean = sum(measured) / len(measured)
+    error = math.sqrt(sum((p - m) ** 2 for p, m in zip(predicted, measured)))
+    spread = math.sqrt(sum((m - mean) ** 2 for m in measured)) or 1.0
+    return 100.0 * (1.0 - error / spread)
+
+
+def roots(coefficients):
+    """Durand-Kerner roots of z^n + c1 z^(n-1) + ... + cn."""
+    degree = len(coefficients)
+    if degree == 0:
+        return []
+    guesses = [complex(0.4, 0.9) ** i for i in range(degree)]
+    for _ in range(500):
+        updated = []
+        for i, z in enumerate(guesses):
+            value = z ** degree + sum(c * z ** (degree - 1 - k) for k, c in enumerate(coefficients))
+            denominator = 1.0 + 0j
+            for j, other in enumerate(guesses):
+                if j != i:
+                    denominator *= z - other
+            updated.append(z - value / denominator if denominator != 0 else z)
+        guesses = updated
+    return guesses
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture", help="raw bytes captured from the UART")
+    parser.add_argument("--output", choices=("tilt", "rate"), default="tilt")
+    parser.add_argument("--na", type=int, default=2)
+    parser.add_argument("--nb", type=int, default=2)
+    parser.add_argument("--nk", type=int, default=1)
+    parser.add_argument("--decimate", type=int, default=1, help="average blocks of N ticks")
+    parser.add_argument("--segment", type=int, default=1000, help="samples per segment")
+    parser.add_argument("--holdout", type=int, default=4, help="hold out every Nth segment")
+    parser.add_argument("--horizon", type=int, default=100, help="free run length")
+    parser.add_argument("--rate", type=float, default=1000.0, help="log rate, Hz")
+    args = parser.parse_args()
+
+    with open(args.capture, "rb") as capture:
+        records = parse_records(capture.read())
+    if not records:
+        sys.exit("no sysid frame found")
+    column = 1 if args.output == "tilt" else 2
+
+    estimation, validation = [], []
+    total = 0
+    for run in contiguous_runs(records):
+        u = [float(record[0]) for record in run]
+        y = [float(record[column]) for record in run]
+        if args.decimate > 1:
+            blocks = len(u) // args.decimate
+            u = [sum(u[i * args.decimate:(i + 1) * args.decimate]) / args.decimate
+                 for i in range(blocks)]
+            y = [sum(y[i * args.decimate:(i + 1) * args.decimate]) / args.decimate
+                 for i in range(blocks)]
+        for start in range(0, len(u) - args.segment + 1, args.segment):
+            segment = (u[start:start + args.segment], y[start:start + args.segment])
+            total += 1
+            (validation if total % args.holdout == 0 else estimation).append(segment)
+    if not estimation or not validation:
+        sys.exit("log too short: %d segment(s) of %d samples" % (total, args.segment))
+
+    a, b = fit(estimation, args.na, args.nb, args.nk)
+    print("%d records, %d estimation and %d validation segments"
+          % (len(records), len(estimation), len(validation)))
+    print("a = [%s]" % ", ".join("%.6g" % value for value in a))
+    print("b = [%s]" % ", ".join("%.6g" % value for value in b))
+    sample_rate = args.rate / args.decimate
+    for pole in roots(a):
+        s = cmath.log(pole) * sample_rate if pole != 0 else float("-inf")
+        print("pole z = %.5f%+.5fj  s = %.2f%+.2fj rad/s" % (pole.real, pole.imag, s.real, s.imag))
+
+    scores = []
+    for index, (u, y) in enumerate(validation):
+        predicted, measured = simulate(a, b, args.nk, u, y, args.horizon)
+        scores.append(fit_percent(predicted, measured))
+        print("validation segment %d: fit %.1f%%" % (index, scores[-1]))
+    print("mean fit %.1f%%" % (sum(scores) / len(scores)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,229 @@
+#!/usr/bin/env python3
+"""Decode telemetry frames sent after a "tel <mask>" console command
+(src/telemetry.c) into full rate time series.
+
+Reads a raw capture file, or a serial port when pyserial is installed,
+skips console text between frames, checks every frame and undoes the
+zigzag varint delta coding. Writes one CSV row per control tick with
+an empty cell for each record that never arrived, then reports the
+frames received and rejected, the records missing from sequence gaps
+and the compression ratio against plain int16 records.
+
+"--mask replay" records the channels host/replay.c reruns through the
+filters, the Kalman tilt and the LQR:
+
+    python3 tools/telemetry_decode.py capture.bin --csv run.csv
+    python3 tools/telemetry_decode.py --port /dev/ttyUSB0 --baud 3000000 \\
+        --mask replay --seconds 10 --save capture.bin --csv run.csv
+
+"--mask imu" records the six accel and gyro channels host/ahrs_bench.c
+fuses against its float reference.
+"""
+
+import argparse
+import csv
+import struct
+import sys
+import time
+
+SYNC = b"\xa5\x5a"
+FRAME_TYPE = ord("T")
+HEADER = struct.Struct("<BBHHH")
+# telemetryChannel_t
+CHANNELS = ["accel_x", "accel_y", "accel_z", "gyro_x", "gyro_y", "gyro_z",
+            "tilt", "setpoint", "command", "velocity", "position",
+            "step_left", "step_right", "hold_error", "mode"]
+# Written as uint16_t, the rest as int16_t
+UNSIGNED = {"step_left", "step_right", "mode"}
+MAX_CHANNELS = 12
+# TELEMETRY_REPLAY_MASK
+REPLAY_CHANNELS = ["accel_y", "accel_z", "gyro_x", "tilt", "setpoint", "command", "velocity",
+                   "step_left", "step_right", "hold_error", "mode"]
+REPLAY_MASK = sum(1 << CHANNELS.index(name) for name in REPLAY_CHANNELS)
+# TELEMETRY_IMU_MASK
+IMU_MASK = sum(1 << CHANNELS.index(name) for name in CHANNELS[:6])
+
+
+def mask_channels(mask):
+    return [index for index in range(len(CHANNELS)) if mask >> index & 1]
+
+
+def parse_mask(text):
+    return {"replay": REPLAY_MASK, "imu": IMU_MASK}.get(text) or int(text, 0)
+
+
+def to_int16(value):
+    value &= 0xFFFF
+    return value - 0x10000 if value & 0x8000 else value
+
+
+def read_varint(payload, index):
+    value = 0
+    shift = 0
+    while True:
+        byte = payload[index]
+        index += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, index
+
+
+def decode_payload(payload, count, width):
+    """Records of width int16 values, or None if the payload does not fit."""
+    records = []
+    previous = None
+    index = 0
+    try:
+        for _ in range(count):
+            record = []
+            for column in range(width):
+                code, index = read_varint(payload, index)
+                value = (code >> 1) ^ -(code & 1)
+                record.append(to_int16(value if previous is None else previous[column] + value))
+            records.append(record)
+            previous = record
+    except IndexError:
+        return None
+    return records if index == len(payload) else None
+
+
+class Stats:
+    def __init__(self):
+        self.frames = 0
+        self.rejected = 0
+        self.frame_bytes = 0
+        self.records = 0
+        self.values = 0
+
+
+def parse_frames(data, stats):
+    """Yield (sequence, mask, records) for each valid frame."""
+    index = 0
+    while True:
+        index = data.find(SYNC, index)
+        if index < 0 or index + 2 + HEADER.size > len(data):
+            return
+        body = index + 2
+        kind, count, size, sequence, mask = HEADER.unpack_from(data, body)
+        end = body + HEADER.size + size
+        if kind != FRAME_TYPE or end >= len(data):
+            index += 1
+            continue
+        width = len(mask_channels(mask))
+        records = None
+        if (sum(data[body:end]) & 0xFF == data[end] and 0 < width <= MAX_CHANNELS
+                and mask >> len(CHANNELS) == 0):
+            records = decode_payload(data[body + HEADER.size:end], count, width)
+        if records is None:
+            stats.rejected += 1
+            index += 1
+            continue
+        stats.frames += 1
+        stats.frame_bytes += end + 1 - index
+        stats.records += count
+        stats.values += count * width
+        yield sequence, mask, records
+        index = end + 1
+
+
+def rebuild(frames):
+    """Unwrap the 16 bit sequence into ticks; return rows, mask and gaps."""
+    rows = {}
+    mask = None
+    tick = None
+    gaps = 0
+    for sequence, frame_mask, records in frames:
+        if mask is None:
+            mask = frame_mask
+        elif frame_mask != mask:
+            sys.stderr.write("channel mask changed at tick %d, later frames skipped\n" % tick)
+            break
+        if tick is None:
+            tick = sequence
+        else:
+            # Next expected tick, moved forward by the 16 bit difference
+            step = (sequence - tick) & 0xFFFF
+            if step:
+                gaps += 1
+            tick += step
+        for record in records:
+            rows[tick] = record
+            tick += 1
+    return rows, mask, gaps
+
+
+def read_port(args):
+    try:
+        import serial
+    except ImportError:
+        sys.exit("--port needs pyserial")
+    data = b""
+    with serial.Serial(args.port, args.baud, timeout=0.1) as port:
+        port.write(b"tel 0\r\n")
+        time.sleep(0.2)
+        port.reset_input_buffer()
+        port.write(b"tel %d\r\n" % args.mask)
+        stop = time.time() + args.seconds
+        while time.time() < stop:
+            data += port.read(65536)
+        port.write(b"tel 0\r\n")
+        data += port.read(65536)
+    return data
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture", nargs="?", help="raw bytes captured from the UART")
+    parser.add_argument("--port", help="serial port, sends the tel commands itself")
+    parser.add_argument("--baud", type=int, default=3000000)
+    parser.add_argument("--mask", type=parse_mask, default=0x1C8,
+                        help="telemetryChannel_t bits, \"replay\" or \"imu\", default gyro x, tilt, "
+                        "setpoint, command")
+    parser.add_argument("--seconds", type=float, default=5.0)
+    parser.add_argument("--save", help="also write the raw capture here")
+    parser.add_argument("--csv", help="write the series here, default stdout")
+    args = parser.parse_args()
+
+    if args.port:
+        data = read_port(args)
+    elif args.capture:
+        with open(args.capture, "rb") as capture:
+            data = capture.read()
+    else:
+        data = sys.stdin.buffer.read()
+    if args.save:
+        with open(args.save, "wb") as save:
+            save.write(data)
+
+    stats = Stats()
+    rows, mask, gaps = rebuild(parse_frames(data, stats))
+    if not rows:
+        sys.exit("no valid telemetry frame found")
+    columns = mask_channels(mask)
+    first, last = min(rows), max(rows)
+    output = open(args.csv, "w", newline="") if args.csv else sys.stdout
+    writer = csv.writer(output)
+    names = [CHANNELS[column] for column in columns]
+    writer.writerow(["tick"] + names)
+    for tick in range(first, last + 1):
+        record = rows.get(tick)
+        if record:
+            record = [value & 0xFFFF if name in UNSIGNED else value
+                      for name, value in zip(names, record)]
+        writer.writerow([tick] + (record if record else [""] * len(columns)))
+    if args.csv:
+        output.close()
+
+    missing = last + 1 - first - len(rows)
+    raw = 2 * stats.values
+    sys.stderr.write("%d frames, %d rejected, %d records over %d ticks, %d missing in %d gaps\n"
+                     % (stats.frames, stats.rejected, len(rows), last + 1 - first, missing, gaps))
+    sys.stderr.write("%d bytes for %d bytes of int16 records, ratio %.2f (%.2f bytes per value)\n"
+                     % (stats.frame_bytes, raw, raw / stats.frame_bytes,
+                        stats.frame_bytes / stats.values))
+
+
+if __name__ == "__main__":
+    main()